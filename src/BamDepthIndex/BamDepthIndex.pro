@@ -0,0 +1,3 @@
+include("../app_cli.pri")
+
+SOURCES += main.cpp
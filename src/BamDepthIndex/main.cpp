@@ -0,0 +1,54 @@
+#include "ToolBase.h"
+#include "DepthIndex.h"
+
+class ConcreteTool
+		: public ToolBase
+{
+	Q_OBJECT
+
+public:
+	ConcreteTool(int& argc, char *argv[])
+		: ToolBase(argc, argv)
+	{
+	}
+
+	virtual void setup()
+	{
+		setDescription("Creates a per-base depth index of a BAM/CRAM file.");
+		setExtendedDescription(QStringList() << "The depth index is a run-length encoded, compressed per-base depth track that can be used by BedCoverage, BedLowCoverage and BedHighCoverage instead of the BAM/CRAM file (parameter 'depth_index')."
+											 << "The read filter parameters are stored in the index. Coverage calculations with different parameters are rejected."
+											 << "Note that only read start/end are used. Thus, deletions in the CIGAR string are treated as covered.");
+		addInfile("in", "Input BAM/CRAM file.", false);
+		//optional
+		addOutfile("out", "Output depth index file. If unset, '[in].depth' is used.", true);
+		addInt("min_mapq", "Minimum mapping quality to consider a read.", true, 1);
+		addInt("min_baseq", "Minimum base quality to consider a base.", true, 0);
+		addFlag("skip_mismapped", "Skip reads with mapping quality less than 20 that are not properly paired (they are often mis-mapped).");
+		addInt("threads", "Number of threads used.", true, 1);
+		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
+
+		changeLog(2026, 10, 19, "First version.");
+	}
+
+	virtual void main()
+	{
+		//init
+		QString in = getInfile("in");
+		QString out = getOutfile("out");
+		if (out.isEmpty()) out = DepthIndex::defaultFileName(in);
+		DepthIndex::Parameters params;
+		params.min_mapq = getInt("min_mapq");
+		params.min_baseq = getInt("min_baseq");
+		params.skip_mismapped = getFlag("skip_mismapped");
+
+		DepthIndex::create(in, out, params, getInt("threads"), getInfile("ref"));
+	}
+};
+
+#include "main.moc"
+
+int main(int argc, char *argv[])
+{
+	ConcreteTool tool(argc, argv);
+	return tool.execute();
+}
@@ -1,5 +1,7 @@
 #include "ToolBase.h"
 #include "BamWriter.h"
+#include "ReadNameIndex.h"
+#include <algorithm>
 
 class ConcreteTool
 		: public ToolBase
@@ -20,7 +22,9 @@ public:
 		addOutfile("out", "Output BAM/CRAM file with matching reads.", false);
 		addOutfile("out2", "Output BAM/CRAM file with not matching reads.", true);
 		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
+		addInfile("index", "Read name index created with BamReadNameIndex. If unset, '[in].rni' is used if it exists. Without index, all alignments are read. The index is not used if 'out2' is given.", true);
 
+		changeLog(2026, 10, 19, "Added read name index support (parameter 'index').");
 		changeLog(2023, 11, 30, "Initial implementation.");
 	}
 
@@ -44,11 +48,54 @@ public:
 		file->close();
         stdout_stream << "Read IDs: " << ids.count() << Qt::endl;
 
+		//determine read name index
+		QString in = getInfile("in");
+		QString index_file = getInfile("index");
+		if (index_file.isEmpty() && QFile::exists(ReadNameIndex::defaultFileName(in))) index_file = ReadNameIndex::defaultFileName(in);
+		if (out2!="") index_file.clear();
+
 		//open intput/output streams
-		BamReader reader(getInfile("in"), ref);
+		BamReader reader(in, ref);
 		BamWriter writer(getOutfile("out"), ref);
 		writer.writeHeader(reader);
 
+		//extract alignments using the index
+		if (!index_file.isEmpty())
+		{
+			ReadNameIndex index(index_file);
+			if (!index.isIndexOf(in)) THROW(ArgumentException, "Read name index " + index_file + " was not created from " + in + "!");
+			stdout_stream << "Read name index: " << index_file << Qt::endl;
+
+			//determine offsets (sorted to write alignments in the order of the input file)
+			QVector<qint64> offsets;
+			foreach(const QByteArray& id, ids)
+			{
+				foreach(qint64 offset, index.offsets(id))
+				{
+					offsets << offset;
+				}
+			}
+			std::sort(offsets.begin(), offsets.end());
+			offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+
+			long long c_match = 0;
+			BamAlignment al;
+			foreach(qint64 offset, offsets)
+			{
+				reader.seek(offset);
+				if (!reader.getNextAlignment(al)) THROW(FileParseException, "Could not read alignment at virtual file offset " + QString::number(offset) + " of " + in);
+
+				//skip alignments with the same name hash
+				if (!ids.contains(al.name())) continue;
+
+				writer.writeAlignment(al);
+				++c_match;
+			}
+
+			stdout_stream << "Reads written to 'out': " << c_match<< Qt::endl;
+			return;
+		}
+
 		QSharedPointer<BamWriter> writer2;
 		if (out2!="")
 		{
@@ -0,0 +1,45 @@
+#include "ToolBase.h"
+#include "ReadNameIndex.h"
+
+class ConcreteTool
+		: public ToolBase
+{
+	Q_OBJECT
+
+public:
+	ConcreteTool(int& argc, char *argv[])
+		: ToolBase(argc, argv)
+	{
+	}
+
+	virtual void setup()
+	{
+		setDescription("Creates a read name index of a BAM file.");
+		setExtendedDescription(QStringList() << "The index contains the read name hash and virtual file offset of each alignment, sorted by hash."
+											 << "It is used by BamExtract to seek directly to the alignments of the given read names instead of reading the complete BAM file."
+											 << "CRAM files are not supported.");
+		addInfile("in", "Input BAM file.", false);
+		//optional
+		addOutfile("out", "Output read name index file. If unset, '[in].rni' is used.", true);
+		addInt("max_entries", "Maximum number of index entries kept in memory. If the BAM file contains more alignments, sorted chunks are written to temporary files and merged.", true, 50000000);
+
+		changeLog(2026, 10, 19, "First version.");
+	}
+
+	virtual void main()
+	{
+		QString in = getInfile("in");
+		QString out = getOutfile("out");
+		if (out.isEmpty()) out = ReadNameIndex::defaultFileName(in);
+
+		ReadNameIndex::create(in, out, getInt("max_entries"));
+	}
+};
+
+#include "main.moc"
+
+int main(int argc, char *argv[])
+{
+	ConcreteTool tool(argc, argv);
+	return tool.execute();
+}
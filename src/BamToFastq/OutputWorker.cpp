@@ -1,20 +1,20 @@
 #include "OutputWorker.h"
 
-OutputWorker::OutputWorker(ReadPairPool& pair_pool, QString out1, QString out2, int compression_level)
+OutputWorker::OutputWorker(ReadPairPool& pair_pool, QString out1, QString out2, int compression_level, int compression_threads, bool bgzf)
 	: QRunnable()
 	, terminate_(false)
 	, pair_pool_(pair_pool)
-	, ostream1_(new FastqOutfileStream(out1, compression_level))
-	, ostream2_(new FastqOutfileStream(out2, compression_level))
+	, ostream1_(new FastqOutfileStream(out1, compression_level, Z_DEFAULT_STRATEGY, compression_threads, bgzf))
+	, ostream2_(new FastqOutfileStream(out2, compression_level, Z_DEFAULT_STRATEGY, compression_threads, bgzf))
 {
 	setAutoDelete(false);
 }
 
-OutputWorker::OutputWorker(ReadPairPool& pair_pool, QString out, int compression_level)
+OutputWorker::OutputWorker(ReadPairPool& pair_pool, QString out, int compression_level, int compression_threads, bool bgzf)
 	: QRunnable()
 	, terminate_(false)
 	, pair_pool_(pair_pool)
-	, ostream1_(new FastqOutfileStream(out, compression_level))
+	, ostream1_(new FastqOutfileStream(out, compression_level, Z_DEFAULT_STRATEGY, compression_threads, bgzf))
 	, ostream2_(nullptr)
 {
 	setAutoDelete(false);
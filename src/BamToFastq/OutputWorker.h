@@ -34,8 +34,8 @@ class OutputWorker
 	: public QRunnable
 {
 public:
-	OutputWorker(ReadPairPool& pair_pool, QString out1, QString out2, int compression_level);
-	OutputWorker(ReadPairPool& pair_pool, QString out, int compression_level);
+	OutputWorker(ReadPairPool& pair_pool, QString out1, QString out2, int compression_level, int compression_threads, bool bgzf);
+	OutputWorker(ReadPairPool& pair_pool, QString out, int compression_level, int compression_threads, bool bgzf);
 	void run();
 	void terminate()
 	{
@@ -4,6 +4,7 @@
 #include <QThreadPool>
 #include "OutputWorker.h"
 #include "BamReader.h"
+#include "MatePairBuffer.h"
 
 class ConcreteTool
 		: public ToolBase
@@ -27,11 +28,16 @@ public:
 		addString("reg", "Export only reads in the given region. Format: chr:start-end.", true);
 		addFlag("remove_duplicates", "Does not export reads marked as duplicates in SAM flags into the FASTQ file.");
 		addInt("compression_level", "Output FASTQ compression level from 1 (fastest) to 9 (best compression).", true, 1);
+		addInt("compression_threads", "Number of threads used to compress each output FASTQ file. If larger than 1, the data is compressed in independent blocks.", true, 1);
+		addFlag("bgzf", "Writes output FASTQ files in BGZF format, which can be indexed and decompressed in parallel.");
 		addInt("write_buffer_size", "Output write buffer size (number of FASTQ entry pairs).", true, 100);
 		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
 		addInt("extend", "Extend all reads to the given length. Base 'N' and base qualiy '2' are used for extension.", true, 0);
 		addFlag("fix", "Keep only one read pair if several have the same name (note: needs much memory as read names are kept in memory).");
+		addInt("max_cached", "Maximum number of reads cached in memory while waiting for their mate. If exceeded, reads are written to temporary files and paired at the end (0 means no limit).", true, 5000000);
 
+		changeLog(2026, 10, 19, "Added 'compression_threads' and 'bgzf' parameters.");
+		changeLog(2026, 10, 19, "Added 'max_cached' parameter to limit the memory usage.");
 		changeLog(2024, 12, 13, "Added 'fix' parameter.");
 		changeLog(2024, 12,  9, "Added 'extend' parameter.");
 		changeLog(2020, 11, 27, "Added CRAM support.");
@@ -40,14 +46,14 @@ public:
 		changeLog(2023,  3, 22, "Added mode for single-end samples (long reads).");
 	}
 
-	static void alignmentToFastq(const QSharedPointer<BamAlignment>& al, FastqEntry& e, int extend)
+	static void alignmentToFastq(const BamAlignment& al, FastqEntry& e, int extend)
 	{
-		e.header = "@" + al->name();
-		e.bases = al->bases();
+		e.header = "@" + al.name();
+		e.bases = al.bases();
 		e.header2 = "+";
-		e.qualities = al->qualities();
+		e.qualities = al.qualities();
 
-		if (al->isReverseStrand())
+		if (al.isReverseStrand())
 		{
 			e.bases.reverseComplement();
 			std::reverse(e.qualities.begin(), e.qualities.end());
@@ -104,7 +110,10 @@ public:
 		int write_buffer_size = getInt("write_buffer_size");
 
 		int compression_level = getInt("compression_level");
+		int compression_threads = getInt("compression_threads");
+		bool bgzf = getFlag("bgzf");
 		int extend = getInt("extend");
+		int max_cached = getInt("max_cached");
 
 		//create background FASTQ writer
 		ReadPairPool pair_pool(write_buffer_size);
@@ -114,11 +123,11 @@ public:
 		const bool is_pe = !out2.trimmed().isEmpty();
 		if (is_pe)
 		{
-			output_worker = new OutputWorker(pair_pool, out1, out2, compression_level);
+			output_worker = new OutputWorker(pair_pool, out1, out2, compression_level, compression_threads, bgzf);
 		}
 		else //single-end
 		{
-			output_worker = new OutputWorker(pair_pool, out1, compression_level);
+			output_worker = new OutputWorker(pair_pool, out1, compression_level, compression_threads, bgzf);
 		}
 		analysis_pool.start(output_worker);
 
@@ -127,9 +136,26 @@ public:
 		long long c_duplicates = 0;
 		long long c_single_end = 0;
 		long long c_fixed = 0;
-		int max_cached = 0;
+		long long c_unmatched = 0;
+		auto write_pair = [&](const BamAlignment& al, const BamAlignment& mate)
+		{
+			ReadPair& pair = pair_pool.nextFreePair();
+			if (al.isRead1())
+			{
+				alignmentToFastq(al, pair.e1, extend);
+				alignmentToFastq(mate, pair.e2, extend);
+			}
+			else
+			{
+				alignmentToFastq(mate, pair.e1, extend);
+				alignmentToFastq(al, pair.e2, extend);
+			}
+			pair.status = ReadPair::TO_BE_WRITTEN;
+			++c_paired;
+		};
+
 		//iterate through reads
-		QHash<QByteArray, QSharedPointer<BamAlignment>> al_cache;
+		MatePairBuffer al_cache(reader, max_cached);
 		QHash<QByteArray, ReadWritten> reads_processed;
 		QSharedPointer<BamAlignment> al = QSharedPointer<BamAlignment>(new BamAlignment());
 		while (reader.getNextAlignment(*al))
@@ -165,48 +191,35 @@ public:
 					continue;
 				}
 
-				//store cached read when we encounter the mate
-				QByteArray name = al->name();
-				if (al_cache.contains(name))
+				//write pair when we encounter the mate, cache read for later retrieval otherwise
+				QSharedPointer<BamAlignment> mate = al_cache.add(al);
+				if (mate.isNull())
 				{
-					QSharedPointer<BamAlignment> mate = al_cache.take(name);					
-					ReadPair& pair = pair_pool.nextFreePair();
-					if (al->isRead1())
-					{
-						alignmentToFastq(al, pair.e1, extend);
-						alignmentToFastq(mate, pair.e2, extend);
-					}
-					else
-					{
-						alignmentToFastq(mate, pair.e1, extend);
-						alignmentToFastq(al, pair.e2, extend);
-					}
-					pair.status = ReadPair::TO_BE_WRITTEN;
-					++c_paired;
+					al = QSharedPointer<BamAlignment>(new BamAlignment());
 				}
-				else //cache read for later retrieval
+				else
 				{
-					al_cache.insert(name, al);
-					al = QSharedPointer<BamAlignment>(new BamAlignment());
+					write_pair(*al, *mate);
 				}
-
-                max_cached = std::max(static_cast<qsizetype>(max_cached), static_cast<qsizetype>(al_cache.size()));
 			}
 			else //single-end
 			{
 				ReadPair& pair = pair_pool.nextFreePair();
-				alignmentToFastq(al, pair.e1, extend);
+				alignmentToFastq(*al, pair.e1, extend);
 				pair.status = ReadPair::TO_BE_WRITTEN;
 				++c_single_end;
 			}
 		}
 
+		//pair reads that were cached on disk
+		al_cache.resolve(write_pair, [&](const BamAlignment& /*al*/){ ++c_unmatched; });
+
 		//write debug output
 		if(is_pe)
 		{
             out << "Pair reads (written)            : " << c_paired << Qt::endl;
             out << "Unpaired reads (skipped)        : " << c_unpaired << Qt::endl;
-            out << "Unmatched paired reads (skipped): " << al_cache.size() << Qt::endl;
+            out << "Unmatched paired reads (skipped): " << c_unmatched << Qt::endl;
 		}
 		else //single-end
 		{
@@ -221,7 +234,11 @@ public:
             out << "Duplicate name reads (skipped)  : " << c_fixed << Qt::endl;
 		}
         out << Qt::endl;
-        out << "Maximum cached reads            : " << max_cached << Qt::endl;
+        out << "Maximum cached reads            : " << al_cache.maxSize() << Qt::endl;
+		if (al_cache.spilledCount()>0)
+		{
+			out << "Reads cached on disk            : " << al_cache.spilledCount() << Qt::endl;
+		}
         out << "Time elapsed                    : " << Helper::elapsedTime(timer, true) << Qt::endl;
 
 		//terminate FASTQ writer after all reads are written
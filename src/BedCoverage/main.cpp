@@ -1,4 +1,5 @@
 #include "BedFile.h"
+#include "BedFileStream.h"
 #include "ToolBase.h"
 #include "Statistics.h"
 #include <QFileInfo>
@@ -29,7 +30,11 @@ public:
 		addFlag("random_access", "Use random access via index to get reads from BAM/CRAM instead of chromosome-wise sweep. Random access is quite slow, especially on CRAM, so use it only if a small subset of the file needs to be accessed.");
 		addFlag("debug", "Enable debug output.");
 		addFlag("skip_mismapped", "Skip reads with mapping quality less than 20 that are not properly paired (they are often mis-mapped).");
+		addInfileList("depth_index", "Depth index file(s) created with BamDepthIndex. If given, the coverage is calculated from the depth index instead of the BAM/CRAM file. For each 'bam' file, a depth index has to be provided in the same order.", true);
+		addFlag("stream", "Streaming mode for large files: the input file is processed chromosome by chromosome, i.e. only the regions of one chromosome are kept in memory. Output files ending with '.gz' are bgzip-compressed.");
 
+		changeLog(2026, 10, 19, "Added 'stream' parameter.");
+		changeLog(2026, 10, 19, "Added 'depth_index' parameter.");
 		changeLog(2025,  9, 15, "Added 'skip_mismapped' parameter.");
 		changeLog(2024,  6, 26, "Added 'random_access' parameter.");
 		changeLog(2022,  9, 16, "Added 'threads' parameter and removed 'dup' parameter.");
@@ -41,30 +46,84 @@ public:
 
 	virtual void main()
 	{
-		//load regions
-		BedFile file;
-		file.load(getInfile("in"));
-
-		//clear previous annotations
-		if (getFlag("clear"))
+		//check depth indices
+		QStringList bams = getInfileList("bam");
+		QStringList depth_indices = getInfileList("depth_index");
+		if (!depth_indices.isEmpty() && depth_indices.count()!=bams.count()) THROW(CommandLineParsingException, "Number of 'depth_index' files does not match the number of 'bam' files!");
+		QList<QSharedPointer<DepthIndex>> depth_index_list;
+		for (int i=0; i<depth_indices.count(); ++i)
 		{
-			file.clearHeaders();
-			file.clearAnnotations();
+			QSharedPointer<DepthIndex> depth_index(new DepthIndex(depth_indices[i]));
+			if (!depth_index->isIndexOf(bams[i])) THROW(ArgumentException, "Depth index " + depth_indices[i] + " was not created from " + bams[i] + "!");
+			depth_index_list << depth_index;
 		}
 
-		//get coverage info for bam files
+		//create header
 		QByteArray header = "#chr\tstart\tend";
-		QStringList bams = getInfileList("bam");
-		foreach(QString bam, bams)
+		foreach(const QString& bam, bams)
 		{
-			Statistics::avgCoverage(file, bam, getInt("min_mapq"), getInt("threads"), getInt("decimals"), getInfile("ref"), getFlag("random_access"), getFlag("skip_mismapped"), getFlag("debug"));
-            header += "\t" + QFileInfo(bam).baseName().toUtf8();
+			header += "\t" + QFileInfo(bam).baseName().toUtf8();
+		}
+
+		//streaming mode
+		if (getFlag("stream"))
+		{
+			BedFileStream in(getInfile("in"), true, false);
+			BedOutfileStream out(getOutfile("out"));
+			QByteArrayList headers;
+			if (!getFlag("clear")) headers = in.headers();
+			headers << header;
+			out.writeHeaders(headers);
+
+			//process regions chromosome by chromosome
+			BedFile file;
+			BedLine line;
+			while(in.next(line))
+			{
+				file.append(line);
+				if (in.atEnd() || in.peek().chr()!=line.chr())
+				{
+					annotateCoverage(file, bams, depth_index_list);
+					for (long long i=0; i<file.count(); ++i)
+					{
+						out.write(file[i]);
+					}
+					file.clear();
+				}
+			}
+			out.close();
+			return;
 		}
 
+		//load regions
+		BedFile file;
+		file.load(getInfile("in"));
+		annotateCoverage(file, bams, depth_index_list);
+
 		//store
+		if (getFlag("clear")) file.clearHeaders();
 		file.appendHeader(header);
 		file.store(getOutfile("out"));
 	}
+
+	//annotates the average coverage of each BAM/CRAM file
+	void annotateCoverage(BedFile& file, const QStringList& bams, const QList<QSharedPointer<DepthIndex>>& depth_index_list)
+	{
+		//clear previous annotations
+		if (getFlag("clear")) file.clearAnnotations();
+
+		for (int i=0; i<bams.count(); ++i)
+		{
+			if (depth_index_list.isEmpty())
+			{
+				Statistics::avgCoverage(file, bams[i], getInt("min_mapq"), getInt("threads"), getInt("decimals"), getInfile("ref"), getFlag("random_access"), getFlag("skip_mismapped"), getFlag("debug"));
+			}
+			else
+			{
+				Statistics::avgCoverage(file, *depth_index_list[i], getInt("min_mapq"), getInt("decimals"), getFlag("skip_mismapped"));
+			}
+		}
+	}
 };
 
 #include "main.moc"
@@ -1,4 +1,5 @@
 #include "BedFile.h"
+#include "BedSweep.h"
 #include "ToolBase.h"
 
 class ConcreteTool
@@ -25,10 +26,46 @@ public:
 		//optional
 		addInfile("in", "Input BED file. If unset, reads from STDIN.", true);
 		addOutfile("out", "Output BED file. If unset, writes to STDOUT.", true);
+		addFlag("stream", "Streaming mode for large files: the input files are processed line by line with constant memory usage. Both input files have to be sorted. The output contains the same lines as in the default mode, but split regions are written directly after each other instead of being appended at the end, i.e. the line order can differ. Output files ending with '.gz' are bgzip-compressed.");
+
+		changeLog(2026, 10, 19, "Added 'stream' parameter.");
 	}
 
 	virtual void main()
 	{
+		QString mode = getEnum("mode");
+
+		//streaming mode
+		if (getFlag("stream"))
+		{
+			BedFileStream in(getInfile("in"));
+			BedFileStream in2(getInfile("in2"));
+			BedOutfileStream out(getOutfile("out"));
+			if (mode=="intersect")
+			{
+				//back-to-back regions are merged only if the in-memory mode would merge them (if the file is read from STDIN, they are always merged)
+				QString anno = getEnum("annotation");
+				if (anno == "in2")
+				{
+					BedSweep::intersect(in2, in, out, true, getInfile("in").isEmpty() || !BedSweep::isMergedAndSorted(getInfile("in")));
+				}
+				else
+				{
+					BedSweep::intersect(in, in2, out, anno == "in", getInfile("in2").isEmpty() || !BedSweep::isMergedAndSorted(getInfile("in2")));
+				}
+			}
+			else if (mode=="in")
+			{
+				BedSweep::overlapping(in, in2, out);
+			}
+			else if (mode=="in2")
+			{
+				BedSweep::overlapping(in2, in, out);
+			}
+			out.close();
+			return;
+		}
+
 		//input
 		BedFile in;
 		in.load(getInfile("in"));
@@ -36,7 +73,6 @@ public:
 		in2.load(getInfile("in2"));
 		
 		//calculate
-		QString mode = getEnum("mode");
 		if (mode=="intersect")
 		{
 			if (!in2.isMergedAndSorted()) in2.merge();
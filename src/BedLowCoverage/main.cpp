@@ -29,7 +29,9 @@ public:
 		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
 		addInt("threads", "Number of threads used.", true, 1);
 		addFlag("debug", "Enable debug output.");
+		addInfile("depth_index", "Depth index file created from 'bam' with BamDepthIndex. If given, the coverage is calculated from the depth index instead of the BAM/CRAM file.", true);
 
+		changeLog(2026, 10, 19, "Added 'depth_index' parameter.");
 		changeLog(2024,  7,  3, "Added 'random_access' and 'debug' parameters and removed 'wgs' parameter.");
 		changeLog(2022,  9, 19, "Added 'threads' parameter.");
 		changeLog(2020,  11, 27, "Added CRAM support.");
@@ -47,7 +49,18 @@ public:
 		BedFile file;
 		file.load(in);
 		file.merge(true, true);
-		BedFile output = Statistics::lowCoverage(file, bam, getInt("cutoff"), getInt("min_mapq"), getInt("min_baseq"), getInt("threads"), getInfile("ref"), getFlag("random_access"), getFlag("debug"));
+		BedFile output;
+		QString depth_index_file = getInfile("depth_index");
+		if (depth_index_file.isEmpty())
+		{
+			output = Statistics::lowCoverage(file, bam, getInt("cutoff"), getInt("min_mapq"), getInt("min_baseq"), getInt("threads"), getInfile("ref"), getFlag("random_access"), getFlag("debug"));
+		}
+		else
+		{
+			DepthIndex depth_index(depth_index_file);
+			if (!depth_index.isIndexOf(bam)) THROW(ArgumentException, "Depth index " + depth_index_file + " was not created from " + bam + "!");
+			output = Statistics::lowCoverage(file, depth_index, getInt("cutoff"), getInt("min_mapq"), getInt("min_baseq"));
+		}
 
 		output.appendHeader("#BAM: " + QFileInfo(bam).fileName().toUtf8());
 		output.appendHeader("#ROI: " + QFileInfo(in).fileName().toUtf8());
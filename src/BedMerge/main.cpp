@@ -1,4 +1,5 @@
 #include "BedFile.h"
+#include "BedSweep.h"
 #include "ToolBase.h"
 
 class ConcreteTool
@@ -20,10 +21,23 @@ public:
 		addOutfile("out", "Output BED file. If unset, writes to STDOUT.", true);
 		addFlag("keep_b2b", "Do not merge non-overlapping but adjacent (back-to-back) regions.");
 		addFlag("merge_names", "Merge name columns instead of removing all annotations.");
+		addFlag("stream", "Streaming mode for large files: the input file is processed line by line with constant memory usage. The input file has to be sorted. Output files ending with '.gz' are bgzip-compressed.");
+
+		changeLog(2026, 10, 19, "Added 'stream' parameter.");
 	}
 
 	virtual void main()
 	{
+		//streaming mode
+		if (getFlag("stream"))
+		{
+			BedFileStream in(getInfile("in"));
+			BedOutfileStream out(getOutfile("out"));
+			BedSweep::merge(in, out, !getFlag("keep_b2b"), getFlag("merge_names"));
+			out.close();
+			return;
+		}
+
 		BedFile file;
 		file.load(getInfile("in"));
 		file.merge(!getFlag("keep_b2b"), getFlag("merge_names"));
@@ -1,4 +1,5 @@
 #include "BedFile.h"
+#include "BedSweep.h"
 #include "ToolBase.h"
 
 class ConcreteTool
@@ -19,10 +20,24 @@ public:
 		//optional
 		addInfile("in", "Input BED file. If unset, reads from STDIN.", true);
 		addOutfile("out", "Output BED file. If unset, writes to STDOUT.", true);
+		addFlag("stream", "Streaming mode for large files: the input files are processed line by line with constant memory usage. Both input files have to be sorted. The output contains the same lines as in the default mode, but split regions are written directly after each other instead of being appended at the end, i.e. the line order can differ. Output files ending with '.gz' are bgzip-compressed.");
+
+		changeLog(2026, 10, 19, "Added 'stream' parameter.");
 	}
 
 	virtual void main()
 	{
+		//streaming mode
+		if (getFlag("stream"))
+		{
+			BedFileStream file1(getInfile("in"));
+			BedFileStream file2(getInfile("in2"));
+			BedOutfileStream out(getOutfile("out"));
+			BedSweep::subtract(file1, file2, out);
+			out.close();
+			return;
+		}
+
 		//input
 		BedFile file1;
 		file1.load(getInfile("in"));
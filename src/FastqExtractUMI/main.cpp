@@ -24,7 +24,10 @@ public:
 		addInt("cut1", "Number of bases from the head of read 1 to use as UMI.", true, 0);
 		addInt("cut2", "Number of bases from the head of read 2 to use as UMI.", true, 0);
 		addInt("compression_level", "Output FASTQ compression level from 1 (fastest) to 9 (best compression).", true, Z_BEST_SPEED);
+		addInt("compression_threads", "Number of threads used to compress each output FASTQ file. If larger than 1, the data is compressed in independent blocks.", true, 1);
+		addFlag("bgzf", "Writes output FASTQ files in BGZF format, which can be indexed and decompressed in parallel.");
 
+		changeLog(2026, 10, 19, "Added 'compression_threads' and 'bgzf' parameters.");
 		changeLog(2020, 7, 15, "Added 'compression_level' parameter.");
 	}
 
@@ -42,8 +45,10 @@ public:
 		FastqFileStream input_stream2(in2, false);
 
 		int compression_level = getInt("compression_level");
-		FastqOutfileStream outstream1(out1, compression_level);
-		FastqOutfileStream outstream2(out2, compression_level);
+		int compression_threads = getInt("compression_threads");
+		bool bgzf = getFlag("bgzf");
+		FastqOutfileStream outstream1(out1, compression_level, Z_DEFAULT_STRATEGY, compression_threads, bgzf);
+		FastqOutfileStream outstream2(out2, compression_level, Z_DEFAULT_STRATEGY, compression_threads, bgzf);
 
 		while (!input_stream1.atEnd() && !input_stream2.atEnd())
 		{
@@ -0,0 +1,121 @@
+#include "SampleDataLoader.h"
+#include "FilterCascade.h"
+
+SampleDataLoader::SampleDataLoader(int load_id, QString filename)
+	: BackgroundWorkerBase(jobName(SMALL_VARIANTS))
+	, load_id_(load_id)
+	, type_(SMALL_VARIANTS)
+	, filename_(filename)
+{
+}
+
+SampleDataLoader::SampleDataLoader(int load_id, DataType type, QSharedPointer<FileLocationProvider> file_locations)
+	: BackgroundWorkerBase(jobName(type))
+	, load_id_(load_id)
+	, type_(type)
+	, file_locations_(file_locations)
+{
+	if (type==SMALL_VARIANTS) THROW(ProgrammingException, "SampleDataLoader: small variants have to be loaded from a GSvar file!");
+	if (file_locations_.isNull()) THROW(ProgrammingException, "SampleDataLoader: file location provider not set!");
+}
+
+void SampleDataLoader::process()
+{
+	if (type_==SMALL_VARIANTS)
+	{
+		variants_.load(filename_);
+	}
+	else if (type_==CNVS)
+	{
+		FileLocation cnv_loc = file_locations_->getAnalysisCnvFile();
+		if (!cnv_loc.exists) return;
+
+		cnvs_.load(cnv_loc.filename);
+		prefilterCnvs();
+	}
+	else if (type_==SVS)
+	{
+		FileLocation sv_loc = file_locations_->getAnalysisSvFile();
+		if (!sv_loc.exists) return;
+
+		svs_.load(sv_loc.filename);
+	}
+	else if (type_==RES)
+	{
+		FileLocationList re_locs = file_locations_->getRepeatExpansionFiles(false);
+		if (re_locs.count()==0 || !re_locs[0].exists) return;
+
+		res_.load(re_locs[0].filename);
+	}
+}
+
+void SampleDataLoader::prefilterCnvs()
+{
+	int cnv_count_initial = cnvs_.count();
+	double min_ll = 0.0;
+	while (cnvs_.count()>50000)
+	{
+		min_ll += 1.0;
+		FilterResult result(cnvs_.count());
+		FilterCnvLoglikelihood filter;
+		filter.setDouble("min_ll", min_ll);
+		filter.apply(cnvs_, result);
+		result.removeFlagged(cnvs_);
+	}
+	if (min_ll>0)
+	{
+		message_ = "The CNV calls file contains too many CNVs: " + QString::number(cnv_count_initial) +".\nOnly CNVs with log-likelyhood >= " + QString::number(min_ll) +" are displayed: " + QString::number(cnvs_.count()) +".";
+	}
+}
+
+int SampleDataLoader::loadId() const
+{
+	return load_id_;
+}
+
+SampleDataLoader::DataType SampleDataLoader::type() const
+{
+	return type_;
+}
+
+const QString& SampleDataLoader::message() const
+{
+	return message_;
+}
+
+const VariantList& SampleDataLoader::variants() const
+{
+	return variants_;
+}
+
+const CnvList& SampleDataLoader::cnvs() const
+{
+	return cnvs_;
+}
+
+const BedpeFile& SampleDataLoader::svs() const
+{
+	return svs_;
+}
+
+const RepeatLocusList& SampleDataLoader::res() const
+{
+	return res_;
+}
+
+QString SampleDataLoader::jobName(DataType type)
+{
+	switch(type)
+	{
+		case SMALL_VARIANTS:
+			return "Loading small variants";
+		case CNVS:
+			return "Loading CNVs";
+		case SVS:
+			return "Loading SVs";
+		case RES:
+			return "Loading REs";
+	}
+
+	THROW(ProgrammingException, "Unhandled sample data type " + QString::number(type) + "!");
+}
@@ -0,0 +1,69 @@
+#ifndef SAMPLEDATALOADER_H
+#define SAMPLEDATALOADER_H
+
+#include "VariantList.h"
+#include "CnvList.h"
+#include "BedpeFile.h"
+#include "RepeatLocusList.h"
+#include "FileLocationProvider.h"
+#include "Background/BackgroundWorkerBase.h"
+#include <QSharedPointer>
+
+///Worker that loads one variant list of a sample (small variants, CNVs, SVs or REs).
+///The load ID is used by the GUI to discard results of samples that are no longer open.
+class SampleDataLoader
+		: public BackgroundWorkerBase
+{
+	Q_OBJECT
+
+public:
+	///Variant list type
+	enum DataType
+	{
+		SMALL_VARIANTS,
+		CNVS,
+		SVS,
+		RES
+	};
+
+	///Constructor for small variants (GSvar file or URL).
+	SampleDataLoader(int load_id, QString filename);
+	///Constructor for CNVs, SVs and REs. The file is determined using the file location provider of the sample.
+	SampleDataLoader(int load_id, DataType type, QSharedPointer<FileLocationProvider> file_locations);
+	void process() override;
+
+	///Returns the load ID.
+	int loadId() const;
+	///Returns the variant list type.
+	DataType type() const;
+	///Returns an informational message for the user, or an empty string if there is nothing to report (e.g. CNV pre-filtering).
+	const QString& message() const;
+
+	///Returns the loaded small variants.
+	const VariantList& variants() const;
+	///Returns the loaded CNVs (empty if the sample has no CNV file).
+	const CnvList& cnvs() const;
+	///Returns the loaded SVs (empty if the sample has no SV file).
+	const BedpeFile& svs() const;
+	///Returns the loaded REs (empty if the sample has no RE file).
+	const RepeatLocusList& res() const;
+
+private:
+	int load_id_;
+	DataType type_;
+	QString filename_;
+	QSharedPointer<FileLocationProvider> file_locations_;
+	QString message_;
+
+	VariantList variants_;
+	CnvList cnvs_;
+	BedpeFile svs_;
+	RepeatLocusList res_;
+
+	//Returns the job name shown in the background job dialog
+	static QString jobName(DataType type);
+	//Reduces the CNV count to a number that can be handled in the GUI
+	void prefilterCnvs();
+};
+
+#endif // SAMPLEDATALOADER_H
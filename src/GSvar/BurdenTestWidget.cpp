@@ -880,6 +880,24 @@ QSet<int> BurdenTestWidget::removeDiseaseStatus(const QSet<int>& s_list, const Q
 	return s_ids;
 }
 
+const GenotypeMatrix* BurdenTestWidget::genotypeMatrix()
+{
+	QString filename = Settings::string("burden_test_genotype_matrix", true).trimmed();
+	if (filename.isEmpty() || !QFile::exists(filename)) return nullptr;
+
+	//load matrix only once
+	if (genotype_matrix_.isNull())
+	{
+		QElapsedTimer timer;
+		timer.start();
+		genotype_matrix_ = QSharedPointer<GenotypeMatrix>(new GenotypeMatrix());
+		genotype_matrix_->load(filename);
+		qDebug() << "loading genotype matrix: " << Helper::elapsedTime(timer);
+	}
+
+	return genotype_matrix_.data();
+}
+
 void BurdenTestWidget::performBurdenTest()
 {
 
@@ -940,6 +958,18 @@ void BurdenTestWidget::performBurdenTest()
 	qDebug() << parameters.toText();
 
 	GeneBurdenTest burden_test(case_samples_, control_samples_, selected_genes_, parameters, Settings::integer("threads"), false, false);
+	const GenotypeMatrix* genotype_matrix = genotypeMatrix();
+	if (genotype_matrix!=nullptr)
+	{
+		try
+		{
+			burden_test.setGenotypeMatrix(genotype_matrix);
+		}
+		catch (Exception& e)
+		{
+			qDebug() << "genotype matrix not used: " << e.message();
+		}
+	}
 	qDebug() << "init burden test: " << Helper::elapsedTime(timer);
 
 	QList<BurdenTestResult> results = burden_test.run_burden_test();
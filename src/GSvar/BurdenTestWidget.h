@@ -55,6 +55,8 @@ private:
 	QTextEdit* te_excluded_regions_;
 	QStringList excluded_regions_file_names;
 	QTableWidget* tw_warnings_;
+	QSharedPointer<GenotypeMatrix> genotype_matrix_;
+	const GenotypeMatrix* genotypeMatrix();
 	QStringList createChromosomeQueryList(int max_ngsd, double max_gnomad_af, const BedFile& regions, const QStringList& impacts, bool predict_pathogenic, bool include_mosaic);
 	int countOccurences(const QSet<int>& variant_ids, const QSet<int>& ps_ids, const QMap<int, QSet<int> >& detected_variants, Inheritance inheritance, QMap<QString, QString>& ps_names);
 	int countOccurencesCNV(const QSet<int>& callset_ids, const BedFile& regions, const BedFile& cnv_polymorphism_region, const ChromosomalIndex<BedFile>& cnv_polymorphism_region_index, QMap<QString, QString>& ps_names);
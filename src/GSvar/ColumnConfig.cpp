@@ -1,6 +1,7 @@
 #include "ColumnConfig.h"
 #include "Exceptions.h"
 #include "GUIHelper.h"
+#include <QHeaderView>
 
 ColumnConfig::ColumnConfig()
 	: columns_()
@@ -196,7 +197,53 @@ void ColumnConfig::applyHidden(QTableWidget* table)
 		}
 	}
 }
+void ColumnConfig::applyColumnWidths(QTableView* table, int max_width_for_not_contained)
+{
+	//general resize
+	table->horizontalHeader()->setResizeContentsPrecision(1000);
+	table->resizeColumnsToContents();
+
+	//apply column settings
+	QAbstractItemModel* model = table->model();
+	for (int i=0; i<model->columnCount(); ++i)
+	{
+		int width = std::min(table->columnWidth(i), 1000);
+		table->setColumnWidth(i, width);
+		QString col = model->headerData(i, Qt::Horizontal).toString();
+		if (contains(col))
+		{
+			ColumnInfo info = this->info(col);
+			if (width<info.min_width)
+			{
+				table->setColumnWidth(i, info.min_width);
+			}
+			if (info.max_width>0 && width>info.max_width)
+			{
+				table->setColumnWidth(i, info.max_width);
+			}
+		}
+		else
+		{
+			if (width>max_width_for_not_contained)
+			{
+				table->setColumnWidth(i, max_width_for_not_contained);
+			}
+		}
+	}
+}
 
+void ColumnConfig::applyHidden(QTableView* table)
+{
+	QAbstractItemModel* model = table->model();
+	for (int c=0; c<model->columnCount(); ++c)
+	{
+		QString col = model->headerData(c, Qt::Horizontal).toString();
+		if (contains(col) && infos_[col].hidden)
+		{
+			table->setColumnHidden(c, true);
+		}
+	}
+}
 
 QString ColumnConfig::toString() const
 {
@@ -4,6 +4,7 @@
 #include <QString>
 #include <QHash>
 #include <QTableWidget>
+#include <QTableView>
 #include "VariantList.h"
 #include "CnvList.h"
 #include "BedpeFile.h"
@@ -39,6 +40,10 @@ public:
 	void applyColumnWidths(QTableWidget* table, int max_width_for_not_contained=200);
 	//Apply column hidden settings to table
 	void applyHidden(QTableWidget* table);
+	//Apply column width settings to model-based table (only the first 1000 rows are considered when resizing to contents)
+	void applyColumnWidths(QTableView* table, int max_width_for_not_contained=200);
+	//Apply column hidden settings to model-based table
+	void applyHidden(QTableView* table);
 
 	//Returns a tab-separated list of column configs. The fields of the inividual columns are separated by |. Used for storing the config in the settings INI.
 	QString toString() const;
@@ -175,6 +175,18 @@ QString GSvarHelper::buildAsString(bool grch)
 }
 
 void GSvarHelper::colorGeneItem(QTableWidgetItem* item, const GeneSet& genes)
+{
+	QStringList messages = geneWarnings(genes);
+
+	//mark gene
+	if (!messages.isEmpty())
+	{
+        item->setBackground(QBrush(QColor(Qt::yellow)));
+		item->setToolTip(messages.join('\n'));
+	}
+}
+
+QStringList GSvarHelper::geneWarnings(const GeneSet& genes)
 {
 	//init
 	static const GeneSet& imprinting_genes = impritingGenes();
@@ -200,14 +212,9 @@ void GSvarHelper::colorGeneItem(QTableWidgetItem* item, const GeneSet& genes)
 	{
 		messages << (gene + ": Has pseudogene(s)");
 	}
+	messages.sort();
 
-	//mark gene
-	if (!messages.isEmpty())
-	{
-		messages.sort();
-        item->setBackground(QBrush(QColor(Qt::yellow)));
-		item->setToolTip(messages.join('\n'));
-	}
+	return messages;
 }
 
 void GSvarHelper::colorQcItem(QTableWidgetItem* item, const QString& qc_class)
@@ -35,6 +35,8 @@ public:
 
 	//colors imprinting and non-haploinsufficiency genes.
 	static void colorGeneItem(QTableWidgetItem* item, const GeneSet& genes);
+	//Returns the sorted warnings for imprinting, non-haploinsufficiency and pseudogene genes (used for coloring gene items).
+	static QStringList geneWarnings(const GeneSet& genes);
 	//colors QC metric item background. Returns if the item was assigned a background color.
 	static void colorQcItem(QTableWidgetItem* item, const QString& qc_class);
 
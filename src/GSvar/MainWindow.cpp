@@ -147,6 +147,9 @@ MainWindow::MainWindow(QWidget *parent)
 	, background_job_label_(new ClickableLabel())
 	, filename_()
 	, variants_changed_()
+	, sample_load_id_(0)
+	, sample_loaders_pending_(0)
+	, sample_load_show_only_error_issues_(false)
 	, last_report_path_(QDir::homePath())
 	, init_timer_(this, true)
 	, server_version_()   
@@ -267,7 +270,7 @@ MainWindow::MainWindow(QWidget *parent)
 
 	connect(ui_.filters, SIGNAL(filtersChanged()), this, SLOT(refreshVariantTable()));
 	connect(ui_.vars, SIGNAL(itemSelectionChanged()), this, SLOT(updateVariantDetails()));
-	connect(ui_.vars, SIGNAL(cellDoubleClicked(int, int)), this, SLOT(variantCellDoubleClicked(int, int)));
+	connect(ui_.vars, SIGNAL(doubleClicked(QModelIndex)), this, SLOT(variantCellDoubleClicked(QModelIndex)));
 	connect(ui_.vars, SIGNAL(showMatchingCnvsAndSvs(BedLine)), this, SLOT(showMatchingCnvsAndSvs(BedLine)));
 	connect(ui_.vars->verticalHeader(), SIGNAL(sectionDoubleClicked(int)), this, SLOT(variantHeaderDoubleClicked(int)));
 	ui_.vars->verticalHeader()->setContextMenuPolicy(Qt::CustomContextMenu);
@@ -860,6 +863,7 @@ void MainWindow::on_actionDeleteIgvFolder_triggered()
 void MainWindow::on_actionSV_triggered()
 {
 	if(filename_ == "") return;
+	if (sampleDataLoading()) return;
 
 	if (!svs_.isValid())
 	{
@@ -943,6 +947,7 @@ void MainWindow::on_actionSV_triggered()
 void MainWindow::on_actionCNV_triggered()
 {
 	if (filename_=="") return;
+	if (sampleDataLoading()) return;
 
 	if (!cnvs_.isValid())
 	{
@@ -1430,6 +1435,7 @@ void MainWindow::on_actionRE_triggered()
 {
 	if (filename_=="") return;
 	if (variants_.type()!=GERMLINE_SINGLESAMPLE) return;
+	if (sampleDataLoading()) return;
 
 	//show dialog
 	QString sys_name = "";
@@ -1750,9 +1756,9 @@ void MainWindow::delayedInitialization()
 	}
 }
 
-void MainWindow::variantCellDoubleClicked(int row, int /*col*/)
+void MainWindow::variantCellDoubleClicked(const QModelIndex& index)
 {
-    const Variant& v = variants_[ui_.vars->rowToVariantIndex(row)];
+    const Variant& v = variants_[ui_.vars->rowToVariantIndex(index.row())];
     IgvSessionManager::get(0).gotoInIGV(v.chr().str() + ":" + QString::number(v.start()) + "-" + QString::number(v.end()), true);
 }
 
@@ -2716,133 +2722,198 @@ void MainWindow::loadFile(QString filename, bool show_only_error_issues)
 	ui_.filters->reset(true);
 	Log::perf("Clearing variant table took ", timer);
 
+	//cancel loading of the previous sample (results of running loaders are discarded)
+	++sample_load_id_;
+	sample_loaders_pending_ = 0;
+	sample_load_file_locations_.clear();
+
 	if (filename=="") return;
 
-	//load data
-	QApplication::setOverrideCursor(Qt::BusyCursor);
+	//determine file locations from the GSvar header (only the header is read, so this is fast)
+	sample_load_timer_.start();
+	sample_load_filename_ = filename;
+	sample_load_show_only_error_issues_ = show_only_error_issues;
+	AnalysisType type;
 	try
 	{
-		//load variants
-		timer.restart();
-		variants_.load(filename);
-		Log::perf("Loading small variant list took ", timer);
-		QString mode_title = "";
+		VariantList header;
+		header.loadHeaderOnly(filename);
+		type = header.type();
+		sample_load_mode_title_ = "";
 		if (Helper::isHttpUrl(filename))
 		{
-			GlobalServiceProvider::setFileLocationProvider(QSharedPointer<FileLocationProviderRemote>(new FileLocationProviderRemote(filename)));
+			sample_load_file_locations_ = QSharedPointer<FileLocationProviderRemote>(new FileLocationProviderRemote(filename));
 		}
 		else
 		{
-			GlobalServiceProvider::setFileLocationProvider(QSharedPointer<FileLocationProviderLocal>(new FileLocationProviderLocal(filename, variants_.getSampleHeader(), variants_.type())));
-			mode_title = " (local mode)";
+			sample_load_file_locations_ = QSharedPointer<FileLocationProviderLocal>(new FileLocationProviderLocal(filename, header.getSampleHeader(), type));
+			sample_load_mode_title_ = " (local mode)";
 		}
-        lazyLoadIGVfiles(filename);
+	}
+	catch(Exception& e)
+	{
+		QMessageBox::warning(this, "Error", "Loading the file '" + filename + "' or displaying the contained variants failed!\nError message:\n" + e.message());
+		loadFile();
+		return;
+	}
 
-		//load CNVs
-		timer.restart();
-		FileLocation cnv_loc = GlobalServiceProvider::fileLocationProvider().getAnalysisCnvFile();
-		if (cnv_loc.exists)
-		{
-			try
-			{
-				cnvs_.load(cnv_loc.filename);
-				int cnv_count_initial = cnvs_.count();
-				double min_ll = 0.0;
-				while (cnvs_.count()>50000)
-				{
-					min_ll += 1.0;
-					FilterResult result(cnvs_.count());
-					FilterCnvLoglikelihood filter;
-					filter.setDouble("min_ll", min_ll);
-					filter.apply(cnvs_, result);
-					result.removeFlagged(cnvs_);
-				}
-				if (min_ll>0)
-				{
-					QMessageBox::information(this, "CNV pre-filtering applied", "The CNV calls file contains too many CNVs: " + QString::number(cnv_count_initial) +".\nOnly CNVs with log-likelyhood >= " + QString::number(min_ll) +" are displayed: " + QString::number(cnvs_.count()) +".");
-				}
-			}
-			catch(Exception& e)
-			{
-				QMessageBox::warning(this, "Error loading CNVs", e.message());
-				cnvs_.clear();
-			}
-		}
-		else
-		{
-			cnvs_.clear();
-		}
-		Log::perf("Loading CNV list took ", timer);
+	//load small variants, CNVs, SVs and REs in parallel in the background (see sampleDataLoaded)
+	startSampleDataLoader(new SampleDataLoader(sample_load_id_, filename));
+	startSampleDataLoader(new SampleDataLoader(sample_load_id_, SampleDataLoader::CNVS, sample_load_file_locations_));
+	startSampleDataLoader(new SampleDataLoader(sample_load_id_, SampleDataLoader::SVS, sample_load_file_locations_));
+	if (type==GERMLINE_SINGLESAMPLE)
+	{
+		startSampleDataLoader(new SampleDataLoader(sample_load_id_, SampleDataLoader::RES, sample_load_file_locations_));
+	}
+	ui_.statusBar->showMessage("Loading variant list...");
+}
 
-		//load SVs
-		timer.restart();
-		FileLocation sv_loc = GlobalServiceProvider::fileLocationProvider().getAnalysisSvFile();
-		if (sv_loc.exists)
-		{
-			try
-			{
-				svs_.load(sv_loc.filename);
-			}
-			catch(Exception& e)
-			{
-				QMessageBox::warning(this, "Error loading SVs", e.message());
-				svs_.clear();
-			}
-		}
-		else
-		{
-			svs_.clear();
-		}
-		Log::perf("Loading SV list took ", timer);
+void MainWindow::startSampleDataLoader(SampleDataLoader* loader)
+{
+	connect(loader, SIGNAL(finished()), this, SLOT(sampleDataLoaded()));
+	connect(loader, SIGNAL(failed()), this, SLOT(sampleDataLoadingFailed()));
+	++sample_loaders_pending_;
+	startJob(loader, false);
+}
+
+void MainWindow::sampleDataLoaded()
+{
+	SampleDataLoader* loader = qobject_cast<SampleDataLoader*>(sender());
+	if (loader==nullptr) THROW(ProgrammingException, "MainWindow::sampleDataLoaded called by QObject that is not a SampleDataLoader!");
+
+	//the loader can be deleted while a message box is shown (nested event loop), so only use it before
+	const int load_id = loader->loadId();
+	const SampleDataLoader::DataType type = loader->type();
 
+	//ignore results of samples that were closed in the meantime
+	if (load_id!=sample_load_id_) return;
+	--sample_loaders_pending_;
 
-		//load REs
-		FileLocationList re_locs = GlobalServiceProvider::fileLocationProvider().getRepeatExpansionFiles(false);
-		if (variants_.type()==GERMLINE_SINGLESAMPLE && re_locs.count()>0 && re_locs[0].exists)
+	//small variants
+	if (type==SampleDataLoader::SMALL_VARIANTS)
+	{
+		QString filename = sample_load_filename_;
+		QApplication::setOverrideCursor(Qt::BusyCursor);
+		try
 		{
-			timer.restart();
-			try
-			{
-				res_.load(re_locs[0].filename);
-			}
-			catch(Exception& e)
-			{
-				QMessageBox::warning(this, "Error loading REs", e.message());
-				res_.clear();
-			}
-			Log::perf("Loading RE list took ", timer);
+			variants_ = loader->variants();
+			Log::perf("Loading small variant list took ", sample_load_timer_);
+			GlobalServiceProvider::setFileLocationProvider(sample_load_file_locations_);
+			lazyLoadIGVfiles(filename);
+
+			//determine valid filter entries from filter column (and add new filters low_mappability/mosaic to make outdated GSvar files work as well)
+			QStringList valid_filter_entries = variants_.filters().keys();
+			if (!valid_filter_entries.contains("low_mappability")) valid_filter_entries << "low_mappability";
+			if (!valid_filter_entries.contains("mosaic")) valid_filter_entries << "mosaic";
+			ui_.filters->setValidFilterEntries(valid_filter_entries);
+
+			//update data structures
+			Settings::setPath("path_variantlists", filename);
+			filename_ = filename;
+
+			//update GUI
+			setWindowTitle(appName() + " - " + variants_.analysisName() + sample_load_mode_title_);
+			if (sample_loaders_pending_>0) ui_.statusBar->showMessage("Loaded variant list with " + QString::number(variants_.count()) + " variants. Loading CNVs/SVs/REs...");
+
+			refreshVariantTable(false);
+
+			QApplication::restoreOverrideCursor();
 		}
-		else
+		catch(Exception& e)
 		{
-			res_.clear();
+			QApplication::restoreOverrideCursor();
+			QMessageBox::warning(this, "Error", "Loading the file '" + filename + "' or displaying the contained variants failed!\nError message:\n" + e.message());
+			loadFile();
+			return;
 		}
+	}
+	else if (type==SampleDataLoader::CNVS)
+	{
+		cnvs_ = loader->cnvs();
+		Log::perf("Loading CNV list finished after ", sample_load_timer_);
+	}
+	else if (type==SampleDataLoader::SVS)
+	{
+		svs_ = loader->svs();
+		Log::perf("Loading SV list finished after ", sample_load_timer_);
+	}
+	else if (type==SampleDataLoader::RES)
+	{
+		res_ = loader->res();
+		Log::perf("Loading RE list finished after ", sample_load_timer_);
+	}
+	bool all_loaded = sample_loaders_pending_==0;
 
-		//determine valid filter entries from filter column (and add new filters low_mappability/mosaic to make outdated GSvar files work as well)
-		QStringList valid_filter_entries = variants_.filters().keys();
-		if (!valid_filter_entries.contains("low_mappability")) valid_filter_entries << "low_mappability";
-		if (!valid_filter_entries.contains("mosaic")) valid_filter_entries << "mosaic";
-		ui_.filters->setValidFilterEntries(valid_filter_entries);
+	//show message, e.g. about CNV pre-filtering (the message box runs an event loop, i.e. other loaders can finish or the sample can be closed in the meantime)
+	if (type==SampleDataLoader::CNVS && !loader->message().isEmpty())
+	{
+		QMessageBox::information(this, "CNV pre-filtering applied", loader->message());
+	}
+	if (load_id!=sample_load_id_) return;
 
-		//update data structures
-		Settings::setPath("path_variantlists", filename);
-		filename_ = filename;
+	if (all_loaded) sampleLoadingFinished();
+}
 
-		//update GUI
-		setWindowTitle(appName() + " - " + variants_.analysisName() + mode_title);
-		ui_.statusBar->showMessage("Loaded variant list with " + QString::number(variants_.count()) + " variants.");
+void MainWindow::sampleDataLoadingFailed()
+{
+	SampleDataLoader* loader = qobject_cast<SampleDataLoader*>(sender());
+	if (loader==nullptr) THROW(ProgrammingException, "MainWindow::sampleDataLoadingFailed called by QObject that is not a SampleDataLoader!");
 
-		refreshVariantTable(false);
+	//the loader can be deleted while a message box is shown (nested event loop), so only use it before
+	const int load_id = loader->loadId();
+	const SampleDataLoader::DataType type = loader->type();
+	const QString error = loader->error();
 
-		QApplication::restoreOverrideCursor();
-	}
-	catch(Exception& e)
+	//ignore errors of samples that were closed in the meantime
+	if (load_id!=sample_load_id_) return;
+	--sample_loaders_pending_;
+
+	if (type==SampleDataLoader::SMALL_VARIANTS)
 	{
-		QApplication::restoreOverrideCursor();
-		QMessageBox::warning(this, "Error", "Loading the file '" + filename + "' or displaying the contained variants failed!\nError message:\n" + e.message());
+		QMessageBox::warning(this, "Error", "Loading the file '" + sample_load_filename_ + "' or displaying the contained variants failed!\nError message:\n" + error);
 		loadFile();
 		return;
 	}
 
+	//CNVs, SVs and REs are optional: show error and continue without them
+	bool all_loaded = sample_loaders_pending_==0;
+	if (type==SampleDataLoader::CNVS)
+	{
+		cnvs_.clear();
+		QMessageBox::warning(this, "Error loading CNVs", error);
+	}
+	else if (type==SampleDataLoader::SVS)
+	{
+		svs_.clear();
+		QMessageBox::warning(this, "Error loading SVs", error);
+	}
+	else if (type==SampleDataLoader::RES)
+	{
+		res_.clear();
+		QMessageBox::warning(this, "Error loading REs", error);
+	}
+	if (load_id!=sample_load_id_) return;
+
+	if (all_loaded) sampleLoadingFinished();
+}
+
+bool MainWindow::sampleDataLoading(bool show_message)
+{
+	if (sample_loaders_pending_==0) return false;
+
+	if (show_message)
+	{
+		QMessageBox::information(this, "Sample loading", "The data of the current sample is still being loaded.\nPlease try again when loading has finished!");
+	}
+	return true;
+}
+
+void MainWindow::sampleLoadingFinished()
+{
+	bool show_only_error_issues = sample_load_show_only_error_issues_;
+	ui_.statusBar->showMessage("Loaded variant list with " + QString::number(variants_.count()) + " variants.");
+	Log::perf("Loading sample data took ", sample_load_timer_);
+
 	//check analysis for issues (outdated, missing columns, wrong genome build, bad quality, ...)
 	QList<QPair<Log::LogLevel, QString>> issues;
 	try
@@ -3418,6 +3489,7 @@ void MainWindow::generateEvaluationSheet()
 {
 	//check if applicable
 	if (!germlineReportSupported()) return;
+	if (sampleDataLoading()) return;
 
 	QString base_name = germlineReportSample();
 
@@ -3541,6 +3613,7 @@ void MainWindow::showReportConfigInfo()
 void MainWindow::editOtherCausalVariant()
 {
 	QString title = "Add/edit other causal variant";
+	if (sampleDataLoading()) return;
 	try
 	{
 		//check if applicable
@@ -3580,6 +3653,7 @@ void MainWindow::editOtherCausalVariant()
 void MainWindow::deleteOtherCausalVariant()
 {
 	QString title = "Delete other causal variant";
+	if (sampleDataLoading()) return;
 	try
 	{
 		//check if applicable
@@ -3612,6 +3686,7 @@ void MainWindow::deleteOtherCausalVariant()
 void MainWindow::finalizeReportConfig()
 {
 	QString title = "Finalize report configuration";
+	if (sampleDataLoading()) return;
 	try
 	{
 		//check if applicable
@@ -3646,6 +3721,7 @@ void MainWindow::finalizeReportConfig()
 void MainWindow::generateReport()
 {
 	if (filename_=="") return;
+	if (sampleDataLoading()) return;
 
 	QString error;
 
@@ -5838,7 +5914,7 @@ void MainWindow::columnContextMenu(QPoint pos)
 	int col_index = ui_.vars->indexAt(pos).column();
 	if (col_index==-1) return;
 
-	QString col = ui_.vars->horizontalHeaderItem(col_index)->text();
+	QString col = ui_.vars->columnName(col_index);
 	bool col_is_annotation = variants_.annotationIndexByName(col, true, false)!=-1;
 
 	//set up menu
@@ -6444,6 +6520,8 @@ void MainWindow::updateVariantDetails()
 
 void MainWindow::editVariantReportConfiguration(int index)
 {
+	if (sampleDataLoading()) return;
+
 	if (!germlineReportSupported() && !somaticReportSupported())
 	{
 		QMessageBox::information(this, "Report configuration error", "Report configuration not supported for this type of analysis!");
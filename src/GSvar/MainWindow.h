@@ -2,6 +2,7 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QElapsedTimer>
 #include "ui_MainWindow.h"
 #include "VariantList.h"
 #include "BedFile.h"
@@ -15,6 +16,7 @@
 #include "ImportDialog.h"
 #include "RepeatLocusList.h"
 #include "Background/BackgroundJobDialog.h"
+#include "Background/SampleDataLoader.h"
 
 ///Tab type
 enum class TabType
@@ -113,6 +115,12 @@ public slots:
 	void checkProcessedSamplesInNGSD(QList<QPair<Log::LogLevel, QString>>& issues);
 	///Shows a dialog with issues in analysis. Returns the DialogCode.
 	int showAnalysisIssues(QList<QPair<Log::LogLevel, QString> >& issues, bool show_only_error_issues);
+	///Applies the data of a background loader of the current sample
+	void sampleDataLoaded();
+	///Handles errors of a background loader of the current sample
+	void sampleDataLoadingFailed();
+	///Returns if CNVs/SVs/REs of the current sample are still being loaded in the background. If @p show_message is set, the user is informed.
+	bool sampleDataLoading(bool show_message = true);
 	///Open dialog
 	void on_actionOpen_triggered();
 	///Open dialog by name (using NGSD)
@@ -367,7 +375,7 @@ public slots:
 	///Loads the command line input file.
 	void delayedInitialization();
 	///A variant has been double-clicked > open in IGV
-	void variantCellDoubleClicked(int row, int col);
+	void variantCellDoubleClicked(const QModelIndex& index);
 	///A variant header has beed double-clicked > edit report config
 	void variantHeaderDoubleClicked(int row);
 	///Opens a custom track in IGV
@@ -536,6 +544,13 @@ private:
 	CnvList cnvs_;
 	BedpeFile svs_;
 	RepeatLocusList res_;
+	int sample_load_id_; //ID of the current sample load - incremented when a file is opened/closed to discard results of loaders of the previous sample
+	int sample_loaders_pending_; //number of background loaders of the current sample that are not finished yet
+	QString sample_load_filename_;
+	QSharedPointer<FileLocationProvider> sample_load_file_locations_; //file location provider of the sample that is being loaded (determined from the GSvar header)
+	QString sample_load_mode_title_;
+	bool sample_load_show_only_error_issues_;
+	QElapsedTimer sample_load_timer_;
 	FilterResult filter_result_;
 	QString last_report_path_;
 	PhenotypeList last_phenos_; //phenotypes used to generate phenotype ROI (needed to check if they changed)
@@ -16,16 +16,24 @@
 #include "Settings.h"
 #include <QMetaMethod>
 #include <QClipboard>
+#include <QHeaderView>
 
 VariantTable::VariantTable(QWidget* parent)
-	: QTableWidget(parent)
+	: QTableView(parent)
+	, model_(new VariantTableModel(this))
+	, variants_(nullptr)
 	, registered_actions_()
 	, active_phenotypes_()
 {
+	setModel(model_);
+
+	//no sorting until the user clicks a column header
+	horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+
 	//make sure the selection is visible when the table looses focus
 	QString fg = GUIHelper::colorToQssFormat(palette().color(QPalette::Active, QPalette::HighlightedText));
 	QString bg = GUIHelper::colorToQssFormat(palette().color(QPalette::Active, QPalette::Highlight));
-	setStyleSheet(QString("QTableWidget:!active { selection-color: %1; selection-background-color: %2; }").arg(fg, bg));
+	setStyleSheet(QString("QTableView:!active { selection-color: %1; selection-background-color: %2; }").arg(fg, bg));
 	setContextMenuPolicy(Qt::ContextMenuPolicy::CustomContextMenu);
 	connect(this, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(customContextMenu(QPoint)));
 }
@@ -70,7 +78,8 @@ void VariantTable::customContextMenu(QPoint pos)
 
 	int index = indices[0];
 	QString selected_text;
-	if (!selectedItems().empty()) selected_text = selectedItems().at(0)->text().trimmed();
+	QModelIndexList selected_indices = selectedIndexes();
+	if (!selected_indices.empty()) selected_text = selected_indices.at(0).data().toString().trimmed();
 
 	if (registered_actions_.count() > 0)
 	{
@@ -449,250 +458,17 @@ void VariantTable::updateTable(VariantList& variants, const FilterResult& filter
 	//update local reference to the variants
 	variants_ = &variants;
 
-	//set rows and cols
-	int row_count_new = std::min(filter_result.countPassing(), max_variants);
-	int col_count_new = 5 + variants.annotations().count();
-	if (rowCount()!=row_count_new || columnCount()!=col_count_new)
-	{
-		//completely clear items (is faster than resizing)
-		clearContents();
-		//set new size
-		setRowCount(row_count_new);
-		setColumnCount(col_count_new);
-	}
-
-	//header
-	setHorizontalHeaderItem(0, createTableItem("chr"));
-	horizontalHeaderItem(0)->setToolTip("Chromosome the variant is located on.");
-	setHorizontalHeaderItem(1, createTableItem("start"));
-	horizontalHeaderItem(1)->setToolTip("Start position of the variant on the chromosome.\nFor insertions, the position of the base before the insertion is shown.");
-	setHorizontalHeaderItem(2, createTableItem("end"));
-	horizontalHeaderItem(2)->setToolTip("End position of the variant on the chromosome.\nFor insertions, the position of the base before the insertion is shown.");
-	setHorizontalHeaderItem(3, createTableItem("ref"));
-	horizontalHeaderItem(3)->setToolTip("Reference bases in the reference genome at the variant position.\n`-` in case of an insertion.");
-	setHorizontalHeaderItem(4, createTableItem("obs"));
-	horizontalHeaderItem(4)->setToolTip("Alternate bases observed in the sample.\n`-` in case of an deletion.");
-
-	//add columns
-	ColumnConfig config = ColumnConfig::fromString(Settings::string("column_config_small_variant", true));
-	QStringList col_order;
-	QList<int> anno_index_order;
-	config.getOrder(variants, col_order, anno_index_order);
-
-	for (int i=0; i<col_order.count(); ++i)
-	{
-		QString anno = col_order[i];
-		QTableWidgetItem* header = new QTableWidgetItem(anno);
-
-		//additional descriptions for filter column
-		QString add_desc = "";
-		if (anno=="filter")
-		{
-			auto it = variants.filters().cbegin();
-			while (it!=variants.filters().cend())
-			{
-				add_desc += "\n - "+it.key() + ": " + it.value();
-				++it;
-			}
-		}
-
-		//additional descriptions and color for genotype columns
-		SampleHeaderInfo sample_data = variants.getSampleHeader();
-		foreach(const SampleInfo& info, sample_data)
-		{
-			if (info.name==anno)
-			{
-				auto it = info.properties.cbegin();
-				while(it != info.properties.cend())
-				{
-					add_desc += "\n - " + it.key() + ": " + it.value();
-
-					if (info.isAffected())
-					{
-						header->setForeground(QBrush(Qt::darkRed));
-					}
-
-					++it;
-				}
-			}
-		}
+	//update model (cells are rendered on demand)
+	model_->setVariants(variants, filter_result, index_show_report_icon, index_causal, max_variants);
 
-		QString header_desc = variants.annotationDescriptionByName(anno, false).description();
-		header->setToolTip(header_desc + add_desc);
-		setHorizontalHeaderItem(i+5, header);
-	}
-
-	//content
-	int i_genes = variants.annotationIndexByName("gene", true, false);
-	int i_co_sp = variants.annotationIndexByName("coding_and_splicing", true, false);
-	int i_validation = variants.annotationIndexByName("validation", true, false);
-	int i_classification = variants.annotationIndexByName("classification", true, false);
-	int i_comment = variants.annotationIndexByName("comment", true, false);
-	int i_ihdb_hom = variants.annotationIndexByName("NGSD_hom", true, false);
-	int i_ihdb_het = variants.annotationIndexByName("NGSD_het", true, false);
-	int i_clinvar = variants.annotationIndexByName("ClinVar", true, false);
-	int i_hgmd = variants.annotationIndexByName("HGMD", true, false);
-	int i_spliceai = variants.annotationIndexByName("SpliceAI", true, false);
-	int i_maxentscan = variants.annotationIndexByName("MaxEntScan", true, false);
-	int r = -1;
-	for (int i=0; i<variants.count(); ++i)
+	//keep sort order selected by the user
+	if (isSortingEnabled() && horizontalHeader()->sortIndicatorSection()>=0)
 	{
-		if (!filter_result.passing(i)) continue;
-
-		++r;
-		if (r>=max_variants) break; //maximum number of variants reached > abort
-		const Variant& variant = variants[i];
-
-		setItem(r, 0, createTableItem(variant.chr().str()));
-		if (!variant.chr().isAutosome())
-		{
-            item(r,0)->setBackground(QBrush(QColor(Qt::yellow)));
-			item(r,0)->setToolTip("Not autosome");
-		}
-		setItem(r, 1, createTableItem(QByteArray::number(variant.start())));
-		setItem(r, 2, createTableItem(QByteArray::number(variant.end())));
-		setItem(r, 3, createTableItem(variant.ref()));
-		setItem(r, 4, createTableItem(variant.obs()));
-		bool is_warning_line = false;
-		bool is_notice_line = false;
-		bool is_ngsd_benign = false;
-		for (int j=0; j<variant.annotations().count(); ++j)
-		{
-			int anno_index = anno_index_order[j];
-			const QByteArray& anno = variant.annotations().at(anno_index);
-			QTableWidgetItem* item = createTableItem(anno);
-
-			//warning
-			if (anno_index==i_co_sp && anno.contains(":HIGH:"))
-			{
-                item->setBackground(QBrush(QColor(Qt::red)));
-				is_warning_line = true;
-			}
-			else if (anno_index==i_classification && (anno=="3" || anno=="M" || anno=="R"))
-			{
-                item->setBackground(QBrush(QColor(QColor(255, 135, 60)))); //orange
-				is_notice_line = true;
-			}
-			else if (anno_index==i_classification && (anno=="4" || anno=="5"))
-			{
-                item->setBackground(QBrush(QColor(Qt::red)));
-				is_warning_line = true;
-			}
-			else if (anno_index==i_clinvar && anno.contains("pathogenic") && !anno.contains("conflicting interpretations of pathogenicity")) //matches "pathogenic" and "likely pathogenic"
-			{
-                item->setBackground(QBrush(QColor(Qt::red)));
-				is_warning_line = true;
-			}
-			else if (anno_index==i_hgmd && anno.contains("CLASS=DM")) //matches both "DM" and "DM?"
-			{
-                item->setBackground(QBrush(QColor(Qt::red)));
-				is_warning_line = true;
-			}
-			else if (anno_index==i_spliceai && NGSHelper::maxSpliceAiScore(anno) >= 0.8)
-			{
-                item->setBackground(QBrush(QColor(Qt::red)));
-				is_notice_line = true;
-			}
-			else if (anno_index==i_spliceai && NGSHelper::maxSpliceAiScore(anno) >= 0.5)
-			{
-                item->setBackground(QBrush(QColor(QColor(255, 135, 60)))); //orange
-				is_notice_line = true;
-			}
-			else if (anno_index==i_maxentscan && !anno.isEmpty())
-			{
-				//iterate over predictions per transcript
-				QList<MaxEntScanImpact> impacts;
-				foreach(const QByteArray& entry, anno.split(','))
-				{
-					QByteArray anno_with_percentages;
-					try
-					{
-						impacts << NGSHelper::maxEntScanImpact(entry.split('/'), anno_with_percentages, false);
-					}
-					catch (Exception& e) //catch error of outdated MaxEntScan annotation
-					{
-						qDebug() << e.message();
-					}
-				}
-
-				//output: max import
-				if (impacts.contains(MaxEntScanImpact::HIGH))
-				{
-                    item->setBackground(QBrush(QColor(Qt::red))); //orange
-					is_notice_line = true;
-				}
-				else if (impacts.contains(MaxEntScanImpact::MODERATE))
-				{
-                    item->setBackground(QBrush(QColor(QColor(255, 135, 60)))); //orange
-					is_notice_line = true;
-				}
-			}
-
-			//non-pathogenic
-			if (anno_index==i_classification && (anno=="1" || anno=="2"))
-			{
-                item->setBackground(QBrush(QColor(Qt::green)));
-				is_ngsd_benign = true;
-			}
-
-			//highlighed
-			if (anno_index==i_validation && anno.contains("TP"))
-			{
-                item->setBackground(QBrush(QColor(Qt::yellow)));
-			}
-			else if (anno_index==i_comment && anno!="")
-			{
-                item->setBackground(QBrush(QColor(Qt::yellow)));
-			}
-			else if (anno_index==i_ihdb_hom && anno=="0")
-			{
-                item->setBackground(QBrush(QColor(Qt::yellow)));
-			}
-			else if (anno_index==i_ihdb_het && anno=="0")
-			{
-                item->setBackground(QBrush(QColor(Qt::yellow)));
-			}
-			else if (anno_index==i_clinvar && anno.contains("(confirmed)"))
-			{
-                item->setBackground(QBrush(QColor(Qt::yellow)));
-			}
-			else if (anno_index==i_genes)
-			{
-				GeneSet anno_genes = GeneSet::createFromText(anno, ',');
-				GSvarHelper::colorGeneItem(item, anno_genes);
-			}
-
-			setItem(r, 5+j, item);
-		}
-
-		//vertical headers - warning (red), notice (orange)
-		QTableWidgetItem* item = createTableItem(QByteArray::number(i+1));
-		item->setData(Qt::UserRole, i); //store variant index in user data (for selection methods)
-		if (!is_ngsd_benign)
-		{
-			if (is_warning_line)
-			{
-				item->setForeground(QBrush(Qt::red));
-				QFont font;
-				font.setWeight(QFont::Bold);
-				item->setFont(font);
-			}
-			else if (is_notice_line)
-			{
-				item->setForeground(QBrush(QColor(255, 135, 60)));
-				QFont font;
-				font.setWeight(QFont::Bold);
-				item->setFont(font);
-			}
-		}
-		if (index_show_report_icon.contains(i))
-		{
-			item->setIcon(reportIcon(index_show_report_icon.value(i), index_causal.contains(i)));
-		}
-		setVerticalHeaderItem(r, item);
+		model_->sort(horizontalHeader()->sortIndicatorSection(), horizontalHeader()->sortIndicatorOrder());
 	}
 
 	//hide columns if requested
+	ColumnConfig config = ColumnConfig::fromString(Settings::string("column_config_small_variant", true));
 	config.applyHidden(this);
 }
 
@@ -726,26 +502,27 @@ void VariantTable::update(VariantList& variants, const FilterResult& filter_resu
 
 void VariantTable::updateVariantHeaderIcon(const ReportSettings& report_settings, int variant_index)
 {
-	int row = variantIndexToRow(variant_index);
-
-	QIcon report_icon;
 	if (report_settings.report_config->exists(VariantType::SNVS_INDELS, variant_index))
 	{
 		const ReportVariantConfiguration& rc = report_settings.report_config->get(VariantType::SNVS_INDELS, variant_index);
-		report_icon = reportIcon(rc.showInReport(), rc.causal);
+		model_->setReportIcon(variant_index, true, rc.showInReport(), rc.causal);
+	}
+	else
+	{
+		model_->setReportIcon(variant_index, false, false, false);
 	}
-	verticalHeaderItem(row)->setIcon(report_icon);
 }
 
 void VariantTable::updateVariantHeaderIcon(const SomaticReportSettings &report_settings, int variant_index)
 {
-	int row = variantIndexToRow(variant_index);
-	QIcon report_icon;
 	if(report_settings.report_config->exists(VariantType::SNVS_INDELS, variant_index))
 	{
-		report_icon = reportIcon(report_settings.report_config->get(VariantType::SNVS_INDELS, variant_index).showInReport(), false);
+		model_->setReportIcon(variant_index, true, report_settings.report_config->get(VariantType::SNVS_INDELS, variant_index).showInReport(), false);
+	}
+	else
+	{
+		model_->setReportIcon(variant_index, false, false, false);
 	}
-	verticalHeaderItem(row)->setIcon(report_icon);
 }
 
 int VariantTable::selectedVariantIndex(bool gui_indices) const
@@ -761,10 +538,10 @@ QList<int> VariantTable::selectedVariantsIndices(bool gui_indices) const
 {
 	QList<int> output;
 
-	QList<QTableWidgetSelectionRange> ranges = selectedRanges();
-	foreach(const QTableWidgetSelectionRange& range, ranges)
+	QItemSelection ranges = selectionModel()->selection();
+	foreach(const QItemSelectionRange& range, ranges)
 	{
-		for(int row=range.topRow(); row<=range.bottomRow(); ++row)
+		for(int row=range.top(); row<=range.bottom(); ++row)
 		{
 			if (gui_indices)
 			{
@@ -784,43 +561,27 @@ QList<int> VariantTable::selectedVariantsIndices(bool gui_indices) const
 
 int VariantTable::rowToVariantIndex(int row) const
 {
-	//get header (variant index is stored in user data)
-	QTableWidgetItem* header = verticalHeaderItem(row);
-	if (header==nullptr) THROW(ProgrammingException, "Variant table row header not set!");
-
-	//convert header text to integer
-	bool ok;
-	int variant_index = header->data(Qt::UserRole).toInt(&ok);
-	if (!ok) THROW(ProgrammingException, "Variant table row header user data '" + header->data(Qt::UserRole).toString() + "' is not an integer!");
-
-	return variant_index;
+	return model_->rowToVariantIndex(row);
 }
 
 int VariantTable::variantIndexToRow(int index) const
 {
-	for (int row=0; row<verticalHeader()->count(); ++row)
-	{
-		QTableWidgetItem* item = verticalHeaderItem(row);
-		if (item==nullptr) THROW(ProgrammingException, "Variant table row header not set for row '" + QString::number(row) + "'!");
+	int row = model_->variantIndexToRow(index);
+	if (row==-1) THROW(ProgrammingException, "Variant table row not found for variant with index '" + QString::number(index) + "'!");
 
-		bool ok;
-		int index_header = item->data(Qt::UserRole).toInt(&ok);
-		if (!ok) THROW(ProgrammingException, "Variant table row header user data '" + item->data(Qt::UserRole).toString() + "' is not an integer!");
-
-		if(index_header==index)
-		{
-			return row;
-		}
-	}
+	return row;
+}
 
-	THROW(ProgrammingException, "Variant table row header not found for variant with index '" + QString::number(index) + "'!");
+QString VariantTable::columnName(int column) const
+{
+	return model_->headerData(column, Qt::Horizontal).toString();
 }
 
 QList<int> VariantTable::columnWidths() const
 {
 	QList<int> output;
 
-	for (int c=0; c<columnCount(); ++c)
+	for (int c=0; c<model_->columnCount(); ++c)
 	{
 		output << columnWidth(c);
 	}
@@ -830,7 +591,7 @@ QList<int> VariantTable::columnWidths() const
 
 void VariantTable::setColumnWidths(const QList<int>& widths)
 {
-    int col_count = std::min(static_cast<qsizetype>(widths.count()), static_cast<qsizetype>(columnCount()));
+    int col_count = std::min(static_cast<qsizetype>(widths.count()), static_cast<qsizetype>(model_->columnCount()));
 	for (int c=0; c<col_count; ++c)
 	{
 		setColumnWidth(c, widths[c]);
@@ -839,28 +600,26 @@ void VariantTable::setColumnWidths(const QList<int>& widths)
 
 void VariantTable::adaptRowHeights()
 {
-	if (rowCount()==0) return;
+	int row_count = model_->rowCount();
+	if (row_count==0) return;
 
 	//determine minimum height of first 10 rows
 	resizeRowToContents(0);
 	int height = rowHeight(0);
-	for (int i=1; i<std::min(10, rowCount()); ++i)
+	for (int i=1; i<std::min(10, row_count); ++i)
 	{
 		resizeRowToContents(i);
 		if (rowHeight(i)<height) height = rowHeight(i);
 	}
 
-	//set height for all columns
-	for (int i=0; i<rowCount(); ++i)
-	{
-		setRowHeight(i, height);
-	}
+	//set height for all rows (default section size is applied to all sections without creating per-row data)
+	verticalHeader()->setDefaultSectionSize(height);
 }
 
 void VariantTable::clearContents()
 {
-	setRowCount(0);
-	setColumnCount(0);
+	variants_ = nullptr;
+	model_->clear();
 }
 
 void VariantTable::adaptColumnWidths()
@@ -900,7 +659,7 @@ void VariantTable::adaptColumnWidths()
 
 void VariantTable::showAllColumns()
 {
-	for (int c=0; c<columnCount(); ++c)
+	for (int c=0; c<model_->columnCount(); ++c)
 	{
 		if(isColumnHidden(c))
 		{
@@ -917,15 +676,19 @@ void VariantTable::showAllColumns()
 
 void VariantTable::copyToClipboard(bool split_quality, bool include_header_one_row)
 {
+	int row_count = model_->rowCount();
+	int col_count = model_->columnCount();
+	QItemSelection selection = selectionModel()->selection();
+
 	// Data to be copied is not selected en bloc
-	if (selectedRanges().count()!=1 && !split_quality)
+	if (selection.count()!=1 && !split_quality)
 	{
 		//Create 2d list with empty QStrings (size equal to QTable in Main Window)
 		QList< QList<QString> > data;
-		for(int r=0;r<rowCount();++r)
+		for(int r=0;r<row_count;++r)
 		{
 			QList<QString> line;
-			for(int c=0;c<columnCount();++c)
+			for(int c=0;c<col_count;++c)
 			{
 				line.append("");
 			}
@@ -934,23 +697,24 @@ void VariantTable::copyToClipboard(bool split_quality, bool include_header_one_r
 
 		//Fill data with non-empty entries from QTable in Main Window
 		QBitArray empty_columns;
-		empty_columns.fill(true,columnCount());
-		QList<QTableWidgetItem*> all_items = selectedItems();
-		foreach(QTableWidgetItem* item,all_items)
+		empty_columns.fill(true,col_count);
+		QModelIndexList all_indices = selectedIndexes();
+		foreach(const QModelIndex& index, all_indices)
 		{
-			if(!item->text().isEmpty())
+			QString text = index.data().toString();
+			if(!text.isEmpty())
 			{
-				data[item->row()][item->column()] = item->text();
-				empty_columns[item->column()] = false;
+				data[index.row()][index.column()] = text;
+				empty_columns[index.column()] = false;
 			}
 		}
 
 		//Remove empty columns
-		for(int c=columnCount()-1;c>=0;--c)
+		for(int c=col_count-1;c>=0;--c)
 		{
 			if(empty_columns[c])
 			{
-				for(int r=0;r<rowCount();++r)
+				for(int r=0;r<row_count;++r)
 				{
 					data[r].removeAt(c);
 				}
@@ -958,7 +722,7 @@ void VariantTable::copyToClipboard(bool split_quality, bool include_header_one_r
 		}
 
 		//Remove empty rows
-		for(int r=rowCount()-1;r>=0;--r)
+		for(int r=row_count-1;r>=0;--r)
 		{
 			bool row_is_empty = true;
 			for(int c=0;c<data[r].count();++c)
@@ -986,8 +750,9 @@ void VariantTable::copyToClipboard(bool split_quality, bool include_header_one_r
 
 		return;
 	}
+	if (selection.isEmpty()) return;
 
-	QTableWidgetSelectionRange range = selectedRanges().at(0);
+	QItemSelectionRange range = selection.at(0);
 
 	//check quality column is present
 	QStringList quality_keys;
@@ -995,7 +760,7 @@ void VariantTable::copyToClipboard(bool split_quality, bool include_header_one_r
 	int qual_index = -1;
 	if (split_quality)
 	{
-		qual_index =  GUIHelper::columnIndex(this, "quality", false);
+		qual_index = model_->columnIndex("quality");
 		if (qual_index==-1)
 		{
 			QMessageBox::warning(this, "Copy to clipboard", "Column with index 6 has other name than quality. Aborting!");
@@ -1006,39 +771,39 @@ void VariantTable::copyToClipboard(bool split_quality, bool include_header_one_r
 
 	//copy header
 	QString selected_text = "";
-	if (range.rowCount()!=1 || include_header_one_row)
+	if (range.height()!=1 || include_header_one_row)
 	{
 		selected_text += "#";
-		for (int col=range.leftColumn(); col<=range.rightColumn(); ++col)
+		for (int col=range.left(); col<=range.right(); ++col)
 		{
-			if (col!=range.leftColumn()) selected_text.append("\t");
+			if (col!=range.left()) selected_text.append("\t");
 			if (split_quality && col==qual_index)
 			{
 				selected_text.append(quality_keys.join('\t'));
 			}
 			else
 			{
-				selected_text.append(horizontalHeaderItem(col)->text());
+				selected_text.append(columnName(col));
 			}
 		}
 	}
 
 	//copy rows
-	for (int row=range.topRow(); row<=range.bottomRow(); ++row)
+	for (int row=range.top(); row<=range.bottom(); ++row)
 	{
 		if (selected_text!="") selected_text.append("\n");
-		for (int col=range.leftColumn(); col<=range.rightColumn(); ++col)
+		for (int col=range.left(); col<=range.right(); ++col)
 		{
-			if (col!=range.leftColumn()) selected_text.append("\t");
+			if (col!=range.left()) selected_text.append("\t");
 
-			QTableWidgetItem* current_item = item(row, col);
-			if (current_item==nullptr) continue;
+			QString text = model_->index(row, col).data().toString();
+			if (text.isEmpty()) continue;
 
 			if (split_quality && col==qual_index)
 			{
 				QStringList quality_values;
 				for(int i=0; i<quality_keys.count(); ++i) quality_values.append("");
-				QStringList entries = current_item->text().split(';');
+				QStringList entries = text.split(';');
 				foreach(const QString& entry, entries)
 				{
 					QStringList key_value = entry.split('=');
@@ -1060,7 +825,7 @@ void VariantTable::copyToClipboard(bool split_quality, bool include_header_one_r
 			}
 			else
 			{
-				selected_text.append(current_item->text().replace('\n',' ').replace('\r', ""));
+				selected_text.append(text.replace('\n',' ').replace('\r', ""));
 			}
 		}
 	}
@@ -1092,6 +857,13 @@ void VariantTable::keyPressEvent(QKeyEvent* event)
 	}
 	else //default key-press event
 	{
-		QTableWidget::keyPressEvent(event);
+		QTableView::keyPressEvent(event);
 	}
 }
+
+void VariantTable::selectionChanged(const QItemSelection& selected, const QItemSelection& deselected)
+{
+	QTableView::selectionChanged(selected, deselected);
+
+	emit itemSelectionChanged();
+}
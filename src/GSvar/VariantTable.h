@@ -1,14 +1,15 @@
 #ifndef VARIANTTABLE_H
 #define VARIANTTABLE_H
 
-#include <QTableWidget>
+#include <QTableView>
 #include "FilterCascade.h"
 #include "ReportSettings.h"
 #include "SomaticReportSettings.h"
+#include "VariantTableModel.h"
 
-//GUI representation of (filtered) variant table
+//GUI representation of (filtered) variant table. Cells are rendered on demand by VariantTableModel.
 class VariantTable
-	: public QTableWidget
+	: public QTableView
 {
 	Q_OBJECT
 
@@ -32,17 +33,10 @@ public:
 
 	///Convert table row to variant index.
 	int rowToVariantIndex(int row) const;
-	///Convert variant index to table row (attention this can be slow because it is done by linear search).
+	///Convert variant index to table row.
 	int variantIndexToRow(int index) const;
-
-	///Creates table widget items, or nullptr if the text is empty.
-	QTableWidgetItem* createTableItem(const QString& text) const
-	{
-		//no text > no item (optimization for WGS - empty items are big and take a lot of RAM)
-		if (text.isEmpty()) return nullptr;
-
-		return new QTableWidgetItem(text);
-	}
+	///Returns the header text of a column.
+	QString columnName(int column) const;
 
 	///Add custom context menu actions
 	void addCustomContextMenuActions(QList<QAction*> actions);
@@ -86,6 +80,8 @@ signals:
 	void alamutTriggered(QAction* action);
 	///Signal to show CNVs/SVs matching a variant
 	void showMatchingCnvsAndSvs(BedLine region);
+	///Signal emitted when the selection changed
+	void itemSelectionChanged();
 
 protected:
 
@@ -94,8 +90,11 @@ protected:
 
 	///Override copy command
 	void keyPressEvent(QKeyEvent* event) override;
+	///Override to emit itemSelectionChanged()
+	void selectionChanged(const QItemSelection& selected, const QItemSelection& deselected) override;
 
 private:
+	VariantTableModel* model_;
 	VariantList* variants_;
 	QList<QAction*> registered_actions_;
 	PhenotypeList active_phenotypes_;
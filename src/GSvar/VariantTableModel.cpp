@@ -0,0 +1,458 @@
+#include "VariantTableModel.h"
+#include "VariantTable.h"
+#include "ColumnConfig.h"
+#include "GSvarHelper.h"
+#include "Settings.h"
+#include "Exceptions.h"
+#include <QBrush>
+#include <QFont>
+
+VariantTableModel::VariantTableModel(QObject* parent)
+	: QAbstractTableModel(parent)
+	, variants_(nullptr)
+{
+}
+
+void VariantTableModel::setVariants(const VariantList& variants, const FilterResult& filter_result, const QHash<int, bool>& index_show_report_icon, const QSet<int>& index_causal, int max_variants)
+{
+	beginResetModel();
+
+	variants_ = &variants;
+	index_show_report_icon_ = index_show_report_icon;
+	index_causal_ = index_causal;
+
+	//rows
+	rows_.clear();
+	variant_to_row_.clear();
+	for (int i=0; i<variants.count(); ++i)
+	{
+		if (!filter_result.passing(i)) continue;
+		if (rows_.count()>=max_variants) break; //maximum number of variants reached > abort
+
+		variant_to_row_.insert(i, rows_.count());
+		rows_ << i;
+	}
+	line_flags_.fill(-1, rows_.count());
+
+	//columns
+	QStringList col_order;
+	ColumnConfig config = ColumnConfig::fromString(Settings::string("column_config_small_variant", true));
+	config.getOrder(variants, col_order, anno_index_order_);
+
+	headers_ = QStringList() << "chr" << "start" << "end" << "ref" << "obs";
+	header_tooltips_ = QStringList() << "Chromosome the variant is located on."
+									 << "Start position of the variant on the chromosome.\nFor insertions, the position of the base before the insertion is shown."
+									 << "End position of the variant on the chromosome.\nFor insertions, the position of the base before the insertion is shown."
+									 << "Reference bases in the reference genome at the variant position.\n`-` in case of an insertion."
+									 << "Alternate bases observed in the sample.\n`-` in case of an deletion.";
+	affected_columns_.clear();
+	SampleHeaderInfo sample_data = variants.getSampleHeader();
+	for (int i=0; i<col_order.count(); ++i)
+	{
+		const QString& anno = col_order[i];
+
+		//additional descriptions for filter column
+		QString add_desc = "";
+		if (anno=="filter")
+		{
+			auto it = variants.filters().cbegin();
+			while (it!=variants.filters().cend())
+			{
+				add_desc += "\n - "+it.key() + ": " + it.value();
+				++it;
+			}
+		}
+
+		//additional descriptions and color for genotype columns
+		foreach(const SampleInfo& info, sample_data)
+		{
+			if (info.name==anno)
+			{
+				auto it = info.properties.cbegin();
+				while(it != info.properties.cend())
+				{
+					add_desc += "\n - " + it.key() + ": " + it.value();
+
+					if (info.isAffected())
+					{
+						affected_columns_ << (i+5);
+					}
+
+					++it;
+				}
+			}
+		}
+
+		headers_ << anno;
+		header_tooltips_ << (variants.annotationDescriptionByName(anno, false).description() + add_desc);
+	}
+
+	//special annotation columns
+	i_genes_ = variants.annotationIndexByName("gene", true, false);
+	i_co_sp_ = variants.annotationIndexByName("coding_and_splicing", true, false);
+	i_validation_ = variants.annotationIndexByName("validation", true, false);
+	i_classification_ = variants.annotationIndexByName("classification", true, false);
+	i_comment_ = variants.annotationIndexByName("comment", true, false);
+	i_ihdb_hom_ = variants.annotationIndexByName("NGSD_hom", true, false);
+	i_ihdb_het_ = variants.annotationIndexByName("NGSD_het", true, false);
+	i_clinvar_ = variants.annotationIndexByName("ClinVar", true, false);
+	i_hgmd_ = variants.annotationIndexByName("HGMD", true, false);
+	i_spliceai_ = variants.annotationIndexByName("SpliceAI", true, false);
+	i_maxentscan_ = variants.annotationIndexByName("MaxEntScan", true, false);
+
+	endResetModel();
+}
+
+void VariantTableModel::clear()
+{
+	beginResetModel();
+
+	variants_ = nullptr;
+	rows_.clear();
+	variant_to_row_.clear();
+	line_flags_.clear();
+	anno_index_order_.clear();
+	headers_.clear();
+	header_tooltips_.clear();
+	affected_columns_.clear();
+	index_show_report_icon_.clear();
+	index_causal_.clear();
+
+	endResetModel();
+}
+
+void VariantTableModel::setReportIcon(int variant_index, bool exists, bool show_in_report, bool causal)
+{
+	if (exists)
+	{
+		index_show_report_icon_[variant_index] = show_in_report;
+		if (causal) index_causal_ << variant_index;
+		else index_causal_.remove(variant_index);
+	}
+	else
+	{
+		index_show_report_icon_.remove(variant_index);
+		index_causal_.remove(variant_index);
+	}
+
+	int row = variantIndexToRow(variant_index);
+	if (row!=-1) emit headerDataChanged(Qt::Vertical, row, row);
+}
+
+int VariantTableModel::rowToVariantIndex(int row) const
+{
+	if (row<0 || row>=rows_.count()) THROW(ProgrammingException, "Variant table row '" + QString::number(row) + "' out of range!");
+
+	return rows_[row];
+}
+
+int VariantTableModel::variantIndexToRow(int index) const
+{
+	return variant_to_row_.value(index, -1);
+}
+
+int VariantTableModel::columnIndex(const QString& name) const
+{
+	return headers_.indexOf(name);
+}
+
+int VariantTableModel::rowCount(const QModelIndex& parent) const
+{
+	if (parent.isValid()) return 0;
+
+	return rows_.count();
+}
+
+int VariantTableModel::columnCount(const QModelIndex& parent) const
+{
+	if (parent.isValid()) return 0;
+
+	return headers_.count();
+}
+
+QByteArray VariantTableModel::cellText(int variant_index, int column) const
+{
+	const Variant& variant = (*variants_)[variant_index];
+	switch(column)
+	{
+		case 0: return variant.chr().str();
+		case 1: return QByteArray::number(variant.start());
+		case 2: return QByteArray::number(variant.end());
+		case 3: return variant.ref();
+		case 4: return variant.obs();
+	}
+
+	return variant.annotations().at(anno_index_order_[column-5]);
+}
+
+QVariant VariantTableModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid() || variants_==nullptr) return QVariant();
+	if (role!=Qt::DisplayRole && role!=Qt::BackgroundRole && role!=Qt::ToolTipRole) return QVariant();
+
+	int variant_index = rows_[index.row()];
+	int col = index.column();
+	QByteArray text = cellText(variant_index, col);
+
+	if (role==Qt::DisplayRole)
+	{
+		if (text.isEmpty()) return QVariant();
+		return QString::fromUtf8(text);
+	}
+
+	//chromosome
+	if (col==0)
+	{
+		if ((*variants_)[variant_index].chr().isAutosome()) return QVariant();
+		if (role==Qt::BackgroundRole) return QBrush(QColor(Qt::yellow));
+		return "Not autosome";
+	}
+	if (col<5 || text.isEmpty()) return QVariant();
+
+	//annotations
+	int anno_index = anno_index_order_[col-5];
+	if (anno_index==i_genes_)
+	{
+		QString tooltip = GSvarHelper::geneWarnings(GeneSet::createFromText(text, ',')).join('\n');
+		if (tooltip.isEmpty()) return QVariant();
+		if (role==Qt::BackgroundRole) return QBrush(QColor(Qt::yellow));
+		return tooltip;
+	}
+	if (role==Qt::BackgroundRole)
+	{
+		int line_flags = 0;
+		QColor color = annotationColor(anno_index, text, line_flags);
+		if (color.isValid()) return QBrush(color);
+	}
+
+	return QVariant();
+}
+
+QColor VariantTableModel::annotationColor(int anno_index, const QByteArray& anno, int& line_flags) const
+{
+	QColor color;
+
+	//warning
+	if (anno_index==i_co_sp_ && anno.contains(":HIGH:"))
+	{
+		color = Qt::red;
+		line_flags |= WARNING;
+	}
+	else if (anno_index==i_classification_ && (anno=="3" || anno=="M" || anno=="R"))
+	{
+		color = QColor(255, 135, 60); //orange
+		line_flags |= NOTICE;
+	}
+	else if (anno_index==i_classification_ && (anno=="4" || anno=="5"))
+	{
+		color = Qt::red;
+		line_flags |= WARNING;
+	}
+	else if (anno_index==i_clinvar_ && anno.contains("pathogenic") && !anno.contains("conflicting interpretations of pathogenicity")) //matches "pathogenic" and "likely pathogenic"
+	{
+		color = Qt::red;
+		line_flags |= WARNING;
+	}
+	else if (anno_index==i_hgmd_ && anno.contains("CLASS=DM")) //matches both "DM" and "DM?"
+	{
+		color = Qt::red;
+		line_flags |= WARNING;
+	}
+	else if (anno_index==i_spliceai_ && NGSHelper::maxSpliceAiScore(anno) >= 0.8)
+	{
+		color = Qt::red;
+		line_flags |= NOTICE;
+	}
+	else if (anno_index==i_spliceai_ && NGSHelper::maxSpliceAiScore(anno) >= 0.5)
+	{
+		color = QColor(255, 135, 60); //orange
+		line_flags |= NOTICE;
+	}
+	else if (anno_index==i_maxentscan_ && !anno.isEmpty())
+	{
+		//iterate over predictions per transcript
+		QList<MaxEntScanImpact> impacts;
+		foreach(const QByteArray& entry, anno.split(','))
+		{
+			QByteArray anno_with_percentages;
+			try
+			{
+				impacts << NGSHelper::maxEntScanImpact(entry.split('/'), anno_with_percentages, false);
+			}
+			catch (Exception& e) //catch error of outdated MaxEntScan annotation
+			{
+				qDebug() << e.message();
+			}
+		}
+
+		//output: max import
+		if (impacts.contains(MaxEntScanImpact::HIGH))
+		{
+			color = Qt::red;
+			line_flags |= NOTICE;
+		}
+		else if (impacts.contains(MaxEntScanImpact::MODERATE))
+		{
+			color = QColor(255, 135, 60); //orange
+			line_flags |= NOTICE;
+		}
+	}
+
+	//non-pathogenic
+	if (anno_index==i_classification_ && (anno=="1" || anno=="2"))
+	{
+		color = Qt::green;
+		line_flags |= BENIGN;
+	}
+
+	//highlighed
+	if (anno_index==i_validation_ && anno.contains("TP"))
+	{
+		color = Qt::yellow;
+	}
+	else if (anno_index==i_comment_ && anno!="")
+	{
+		color = Qt::yellow;
+	}
+	else if (anno_index==i_ihdb_hom_ && anno=="0")
+	{
+		color = Qt::yellow;
+	}
+	else if (anno_index==i_ihdb_het_ && anno=="0")
+	{
+		color = Qt::yellow;
+	}
+	else if (anno_index==i_clinvar_ && anno.contains("(confirmed)"))
+	{
+		color = Qt::yellow;
+	}
+
+	return color;
+}
+
+int VariantTableModel::lineFlags(int row) const
+{
+	if (line_flags_[row]==-1)
+	{
+		int line_flags = 0;
+		const Variant& variant = (*variants_)[rows_[row]];
+		foreach(int anno_index, anno_index_order_)
+		{
+			const QByteArray& anno = variant.annotations().at(anno_index);
+			if (anno.isEmpty()) continue;
+			annotationColor(anno_index, anno, line_flags);
+		}
+		line_flags_[row] = line_flags;
+	}
+
+	return line_flags_[row];
+}
+
+QVariant VariantTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation==Qt::Horizontal)
+	{
+		if (section<0 || section>=headers_.count()) return QVariant();
+
+		if (role==Qt::DisplayRole) return headers_[section];
+		if (role==Qt::ToolTipRole) return header_tooltips_[section];
+		if (role==Qt::ForegroundRole && affected_columns_.contains(section)) return QBrush(Qt::darkRed);
+
+		return QVariant();
+	}
+
+	//vertical headers - variant index, report icon and warning (red) or notice (orange)
+	if (section<0 || section>=rows_.count()) return QVariant();
+	int variant_index = rows_[section];
+
+	if (role==Qt::DisplayRole) return QString::number(variant_index+1);
+	if (role==Qt::DecorationRole && index_show_report_icon_.contains(variant_index))
+	{
+		return VariantTable::reportIcon(index_show_report_icon_.value(variant_index), index_causal_.contains(variant_index));
+	}
+	if (role==Qt::ForegroundRole || role==Qt::FontRole)
+	{
+		int line_flags = lineFlags(section);
+		if (line_flags&BENIGN || !(line_flags&(WARNING|NOTICE))) return QVariant();
+
+		if (role==Qt::FontRole)
+		{
+			QFont font;
+			font.setWeight(QFont::Bold);
+			return font;
+		}
+		if (line_flags&WARNING) return QBrush(Qt::red);
+		return QBrush(QColor(255, 135, 60));
+	}
+
+	return QVariant();
+}
+
+void VariantTableModel::sort(int column, Qt::SortOrder order)
+{
+	if (variants_==nullptr || column>=headers_.count()) return;
+
+	emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+
+	//sort variant indices
+	QModelIndexList old_indices = persistentIndexList();
+	QVector<int> old_rows = rows_;
+	if (column<0)
+	{
+		std::sort(rows_.begin(), rows_.end());
+	}
+	else
+	{
+		//use numeric comparison if all values are numeric (empty values are sorted like zero)
+		bool numeric = true;
+		QHash<int, double> values;
+		foreach(int variant_index, rows_)
+		{
+			QByteArray text = cellText(variant_index, column);
+			if (text.isEmpty()) continue;
+			bool ok = false;
+			values[variant_index] = text.toDouble(&ok);
+			if (!ok)
+			{
+				numeric = false;
+				break;
+			}
+		}
+
+		if (numeric)
+		{
+			std::stable_sort(rows_.begin(), rows_.end(), [&](int a, int b)
+			{
+				double value_a = values.value(a, 0.0);
+				double value_b = values.value(b, 0.0);
+				return order==Qt::AscendingOrder ? value_a<value_b : value_a>value_b;
+			});
+		}
+		else
+		{
+			std::stable_sort(rows_.begin(), rows_.end(), [&](int a, int b)
+			{
+				int cmp = cellText(a, column).compare(cellText(b, column));
+				return order==Qt::AscendingOrder ? cmp<0 : cmp>0;
+			});
+		}
+	}
+
+	//update row data
+	for (int row=0; row<rows_.count(); ++row)
+	{
+		variant_to_row_[rows_[row]] = row;
+		line_flags_[row] = -1;
+	}
+
+	//update persistent indices (e.g. selection)
+	QModelIndexList new_indices;
+	foreach(const QModelIndex& index, old_indices)
+	{
+		int new_row = variant_to_row_.value(old_rows[index.row()]);
+		new_indices << this->index(new_row, index.column());
+	}
+	changePersistentIndexList(old_indices, new_indices);
+
+	emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+}
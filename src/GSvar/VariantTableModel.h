@@ -0,0 +1,86 @@
+#ifndef VARIANTTABLEMODEL_H
+#define VARIANTTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QIcon>
+#include "VariantList.h"
+#include "FilterCascade.h"
+
+//Table model for the (filtered) variant table. Cells are rendered on demand from the variant list, i.e. memory usage does not depend on the number of shown variants.
+class VariantTableModel
+	: public QAbstractTableModel
+{
+	Q_OBJECT
+
+public:
+	VariantTableModel(QObject* parent = nullptr);
+
+	///Sets the variants to show. Only passing variants are shown, at most @p max_variants. Report icon data is given by variant index.
+	///Note: the variant list must not be deleted or resized while the model uses it - call clear() or setVariants() again before.
+	void setVariants(const VariantList& variants, const FilterResult& filter_result, const QHash<int, bool>& index_show_report_icon, const QSet<int>& index_causal, int max_variants);
+	///Removes all rows and columns.
+	void clear();
+	///Sets the report icon of a variant. An empty icon is shown if @p exists is false.
+	void setReportIcon(int variant_index, bool exists, bool show_in_report, bool causal);
+
+	///Convert table row to variant index.
+	int rowToVariantIndex(int row) const;
+	///Convert variant index to table row, or -1 if the variant is not shown.
+	int variantIndexToRow(int index) const;
+	///Returns the index of the column with the given name, or -1 if not found.
+	int columnIndex(const QString& name) const;
+
+	int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+	///Sorts the rows by permuting the variant indices. A negative column restores the original order of the variant list.
+	void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+protected:
+	//highlighting of variant lines (vertical header)
+	enum LineFlags
+	{
+		WARNING = 0x1,
+		NOTICE = 0x2,
+		BENIGN = 0x4
+	};
+
+	///Returns the text of a cell.
+	QByteArray cellText(int variant_index, int column) const;
+	///Returns the background color of an annotation cell (invalid color if not highlighted). Line flags of the annotation are added to @p line_flags.
+	QColor annotationColor(int anno_index, const QByteArray& anno, int& line_flags) const;
+	///Returns the highlighting flags of a variant line (cached).
+	int lineFlags(int row) const;
+
+private:
+	const VariantList* variants_;
+	QVector<int> rows_; //variant index of each row
+	QHash<int, int> variant_to_row_; //row of each variant index
+	mutable QVector<qint8> line_flags_; //cached line flags of each row (-1 if not determined yet)
+
+	//column data
+	QList<int> anno_index_order_; //annotation index of each annotation column
+	QStringList headers_;
+	QStringList header_tooltips_;
+	QSet<int> affected_columns_;
+
+	//report config data
+	QHash<int, bool> index_show_report_icon_;
+	QSet<int> index_causal_;
+
+	//indices of annotations with special highlighting
+	int i_genes_;
+	int i_co_sp_;
+	int i_validation_;
+	int i_classification_;
+	int i_comment_;
+	int i_ihdb_hom_;
+	int i_ihdb_het_;
+	int i_clinvar_;
+	int i_hgmd_;
+	int i_spliceai_;
+	int i_maxentscan_;
+};
+
+#endif // VARIANTTABLEMODEL_H
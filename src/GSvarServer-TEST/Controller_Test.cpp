@@ -1,6 +1,8 @@
 #include "TestFramework.h"
 #include "ServerController.h"
 #include "ServerController.cpp"
+#include "CoverageJobManager.cpp"
+#include "RegionQueryManager.cpp"
 #include "ToolBase.h"
 
 TEST_CLASS(Controller_Test)
@@ -421,4 +423,82 @@ private:
         // it will always change when items are added or deleted
 		I_EQUAL(static_cast<int>(PathType::OTHER), 49);
     }
+
+	TEST_METHOD(test_coverage_jobs)
+	{
+		if (!ServerHelper::settingsValid(true))
+		{
+			SKIP("Server has not been configured correctly");
+		}
+
+		QString bam_file = TESTDATA("../cppNGS-TEST/data_in/panel.bam");
+		BedFile roi;
+		roi.append(BedLine("chr1", 11013718, 11013975));
+
+		//the same calculation is executed only once
+		QString avg_id = CoverageJobManager::submit(CoverageJobType::AVG_COVERAGE, roi, bam_file);
+		S_EQUAL(CoverageJobManager::submit(CoverageJobType::AVG_COVERAGE, roi, bam_file), avg_id);
+		IS_TRUE(CoverageJobManager::jobId(CoverageJobType::LOW_COVERAGE, roi, bam_file, 20)!=CoverageJobManager::jobId(CoverageJobType::LOW_COVERAGE, roi, bam_file, 30));
+		IS_TRUE(CoverageJobManager::jobId(CoverageJobType::AVG_COVERAGE, roi, bam_file, 0)!=CoverageJobManager::jobId(CoverageJobType::READ_DEPTH, roi, bam_file, 0));
+
+		CoverageJob avg_job = CoverageJobManager::waitForJob(avg_id, 60000);
+		S_EQUAL(CoverageJobManager::statusToString(avg_job.status), "finished");
+		BedFile avg_cov = BedFile::fromText(avg_job.result);
+		I_EQUAL(avg_cov.count(), 1);
+		I_EQUAL(avg_cov[0].start(), 11013718);
+
+		//read depth of a single region is its average depth
+		CoverageJob depth_job = CoverageJobManager::waitForJob(CoverageJobManager::submit(CoverageJobType::READ_DEPTH, roi, bam_file), 60000);
+		S_EQUAL(CoverageJobManager::statusToString(depth_job.status), "finished");
+		S_EQUAL(depth_job.result, avg_cov[0].annotations()[0]);
+
+		//unknown job
+		S_EQUAL(CoverageJobManager::statusToString(CoverageJobManager::job("unknown_id").status), "unknown");
+
+		//failed calculation (missing BAM file)
+		CoverageJob failed_job = CoverageJobManager::waitForJob(CoverageJobManager::submit(CoverageJobType::LOW_COVERAGE, roi, bam_file + "_missing", 20), 60000);
+		S_EQUAL(CoverageJobManager::statusToString(failed_job.status), "failed");
+		IS_FALSE(failed_job.error.isEmpty());
+	}
+
+	TEST_METHOD(test_region_queries)
+	{
+		//tabix-indexed file
+		QString vcf_file = TESTDATA("../cppNGS-TEST/data_in/TabixIndexedFile_in1.vcf.gz");
+		QByteArrayList lines = RegionQueryManager::query(vcf_file, Chromosome("chr1"), 3831039, 3836572).split('\n');
+		I_EQUAL(lines.count(), 4);
+		S_EQUAL(lines[0], "chr1	3831039	.	T	C	1286	.	MQM=60;SAP=88;ABP=0	GT:DP:AO:GQ	1/1:43:43:148");
+		S_EQUAL(lines[2], "chr1	3836572	.	A	T	7952	.	MQM=60;SAP=19;ABP=0	GT:DP:AO:GQ	1/1:247:247:160");
+		S_EQUAL(lines[3], "");
+		S_EQUAL(RegionQueryManager::query(vcf_file, Chromosome("chr1"), 17380, 17384), "");
+
+		//the file is opened only once
+		int cached_files = RegionQueryManager::cachedFileCount();
+		RegionQueryManager::query(vcf_file, Chromosome("chr1"), 6554355, 6554355);
+		I_EQUAL(RegionQueryManager::cachedFileCount(), cached_files);
+
+		//BAM file (pileup)
+		QString bam_file = TESTDATA("../cppNGS-TEST/data_in/panel.bam");
+		lines = RegionQueryManager::query(bam_file, Chromosome("chr1"), 11013718, 11013727).split('\n');
+		I_EQUAL(lines.count(), 12);
+		S_EQUAL(lines[0], "#chr	pos	depth	A	C	G	T	N	deletions");
+		BamReader reader(bam_file);
+		Pileup pileup = reader.getPileup(Chromosome("chr1"), 11013718, -1, 1);
+		S_EQUAL(lines[1], "chr1	11013718	" + QByteArray::number(pileup.depth(true)) + "	" + QByteArray::number(pileup.a()) + "	" + QByteArray::number(pileup.c()) + "	" + QByteArray::number(pileup.g()) + "	" + QByteArray::number(pileup.t()) + "	" + QByteArray::number(pileup.n()) + "	" + QByteArray::number(pileup.depth(true) - pileup.depth(false)));
+		IS_TRUE(lines[10].startsWith("chr1	11013727	"));
+		IS_THROWN(ArgumentException, RegionQueryManager::query(bam_file, Chromosome("chr1"), 1, RegionQueryManager::MAX_PILEUP_REGION+1));
+
+		//bigWig file
+		QString bw_file = TESTDATA("../cppNGS-TEST/data_in/BigWigReader.bw");
+		lines = RegionQueryManager::query(bw_file, Chromosome("chr1"), 101, 110).split('\n');
+		I_EQUAL(lines.count(), 2);
+		S_EQUAL(lines[0], "chr1	100	150	1.4");
+		lines = RegionQueryManager::query(bw_file, Chromosome("chr1"), 1, 3).split('\n');
+		I_EQUAL(lines.count(), 4);
+		S_EQUAL(lines[0], "chr1	0	1	0.1");
+		S_EQUAL(RegionQueryManager::query(bw_file, Chromosome("chr1"), 81, 90), "");
+
+		//unsupported file type
+		IS_THROWN(ArgumentException, RegionQueryManager::query(TESTDATA("data/text.txt"), Chromosome("chr1"), 1, 10));
+	}
 };
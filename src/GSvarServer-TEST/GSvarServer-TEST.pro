@@ -24,6 +24,7 @@ INCLUDEPATH += $$PWD/../cppTFW
 
 SOURCES += \
     Controller_Test.cpp \
+    QueuingEngineController_Test.cpp \
     ServerIntegration_Test.cpp \
     main.cpp
 
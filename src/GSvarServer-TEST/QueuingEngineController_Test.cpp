@@ -0,0 +1,144 @@
+#include "TestFramework.h"
+#include "QueuingEngineController.cpp"
+#include "QueuingEngineControllerGeneric.cpp"
+#include "QueuingEngineControllerSge.cpp"
+#include "QueuingEngineControllerSlurm.cpp"
+
+//Controllers that update the jobs of the given (test) database
+class TestControllerSlurm
+	: public QueuingEngineControllerSlurm
+{
+public:
+	void update(NGSD& db)
+	{
+		processJobs(db);
+	}
+};
+
+class TestControllerSge
+	: public QueuingEngineControllerSge
+{
+public:
+	void update(NGSD& db)
+	{
+		processJobs(db);
+	}
+};
+
+TEST_CLASS(QueuingEngineController_Test)
+{
+private:
+
+	//Adds started single sample jobs with consecutive queuing engine ids
+	void addStartedJobs(NGSD& db, int first_qe_id, int count)
+	{
+		for (int i=0; i<count; ++i)
+		{
+			SqlQuery query = db.getQuery();
+			query.exec("INSERT INTO `analysis_job`(`type`, `high_priority`, `args`, `sge_id`, `sge_queue`) VALUES ('single sample', 0, '', '" + QString::number(first_qe_id + i) + "', '')");
+			QString job_id = query.lastInsertId().toString();
+			query.exec("INSERT INTO `analysis_job_sample`(`analysis_job_id`, `processed_sample_id`, `info`) VALUES (" + job_id + ", 3999, '')");
+			query.exec("INSERT INTO `analysis_job_history`(`analysis_job_id`, `user_id`, `status`, `output`) VALUES (" + job_id + ", 99, 'queued', ''), (" + job_id + ", null, 'started', '')");
+		}
+	}
+
+	//Returns the number of added jobs with the given last status
+	int jobCount(NGSD& db, QString last_status)
+	{
+		return db.getValue("SELECT COUNT(*) FROM analysis_job j JOIN (SELECT analysis_job_id, MAX(id) as last_id FROM analysis_job_history GROUP BY analysis_job_id) lh ON lh.analysis_job_id=j.id JOIN analysis_job_history jh ON jh.id=lh.last_id WHERE j.id>1 AND jh.status='" + last_status + "'").toInt();
+	}
+
+	//Puts the stand-in scheduler commands first in PATH and returns the file the scheduler calls are logged to
+	QString initScheduler(QString running)
+	{
+		QString folder = QFileInfo(TESTDATA("data/scheduler/squeue")).absolutePath();
+		if (!qgetenv("PATH").startsWith(folder.toUtf8()))
+		{
+			qputenv("PATH", folder.toUtf8() + ":" + qgetenv("PATH"));
+		}
+		qputenv("SCHEDULER_RUNNING", running.toUtf8());
+
+		QString call_log = Helper::tempFileName(".txt");
+		qputenv("SCHEDULER_CALL_LOG", call_log.toUtf8());
+
+		return call_log;
+	}
+
+	void initDb(NGSD& db)
+	{
+		db.init();
+		db.executeQueriesFromFile(TESTDATA("../cppNGSD-TEST/data_in/NGSD_in1.sql"));
+
+		if (!PipelineSettings::isInitialized())
+		{
+			PipelineSettings::loadSettings(TESTDATA("../cppNGS-TEST/data_in/megSAP_settings.ini"));
+		}
+	}
+
+	TEST_METHOD(test_slurm_update_of_many_jobs)
+	{
+		SKIP_IF_NO_TEST_NGSD();
+
+		NGSD db(true);
+		initDb(db);
+
+		//300 started jobs, the first 150 of them are still queued/running
+		addStartedJobs(db, 1000, 300);
+		QString call_log = initScheduler("1000-1149");
+
+		TestControllerSlurm controller;
+		controller.update(db);
+
+		//squeue and sacct are called once for all jobs
+		QStringList calls = Helper::loadTextFile(call_log, true, QChar::Null, true);
+		I_EQUAL(calls.count(), 2);
+		IS_TRUE(calls[0].startsWith("squeue"));
+		IS_TRUE(calls[1].startsWith("sacct"));
+		I_EQUAL(calls[1].split(' ').last().split(',').count(), 150);
+
+		//status of completed jobs
+		I_EQUAL(jobCount(db, "started"), 150);
+		I_EQUAL(jobCount(db, "finished"), 135);
+		I_EQUAL(jobCount(db, "error"), 15);
+		S_EQUAL(db.analysisInfo(db.getValue("SELECT id FROM analysis_job WHERE sge_id='1160'").toInt()).history.last().output.first(), "job exit code: 1");
+
+		//queue of running jobs
+		I_EQUAL(db.getValue("SELECT COUNT(*) FROM analysis_job WHERE sge_queue='default_srv018'").toInt(), 75);
+		S_EQUAL(db.getValue("SELECT sge_queue FROM analysis_job WHERE sge_id='1002'").toString(), "default_srv018");
+		S_EQUAL(db.getValue("SELECT sge_queue FROM analysis_job WHERE sge_id='1003'").toString(), "");
+
+		//second cycle: completed jobs are no longer checked, sacct is not called if all jobs are still running
+		call_log = initScheduler("1000-1149");
+		controller.update(db);
+		calls = Helper::loadTextFile(call_log, true, QChar::Null, true);
+		I_EQUAL(calls.count(), 1);
+		IS_TRUE(calls[0].startsWith("squeue"));
+		I_EQUAL(jobCount(db, "started"), 150);
+	}
+
+	TEST_METHOD(test_sge_update_of_many_jobs)
+	{
+		SKIP_IF_NO_TEST_NGSD();
+
+		NGSD db(true);
+		initDb(db);
+
+		//100 started jobs, the first 80 of them are still queued/running
+		addStartedJobs(db, 2000, 100);
+		QString call_log = initScheduler("2000-2079");
+
+		TestControllerSge controller;
+		controller.update(db);
+
+		//qstat is called once for all jobs, qacct once per completed job
+		QStringList calls = Helper::loadTextFile(call_log, true, QChar::Null, true);
+		I_EQUAL(calls.count(), 21);
+		IS_TRUE(calls[0].startsWith("qstat"));
+		I_EQUAL(calls.filter("qacct").count(), 20);
+
+		I_EQUAL(jobCount(db, "started"), 80);
+		I_EQUAL(jobCount(db, "finished"), 18);
+		I_EQUAL(jobCount(db, "error"), 2);
+		I_EQUAL(db.getValue("SELECT COUNT(*) FROM analysis_job WHERE sge_queue='default_srv018'").toInt(), 40);
+	}
+};
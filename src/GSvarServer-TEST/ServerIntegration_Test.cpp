@@ -15,6 +15,9 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QNetworkProxy>
+#include <QSslSocket>
+#include <QElapsedTimer>
+#include <QtMath>
 
 bool ignoreProxySettings()
 {
@@ -41,6 +44,38 @@ int sendGetRequest(QByteArray& reply, QString url, HttpHeaders headers)
 	return server_reply.status_code;
 }
 
+//Reads the next response from a persistent connection (only responses with 'Content-Length' are supported). Returns the status code or 0 on errors.
+int readPersistentConnectionResponse(QSslSocket& socket, QByteArray& buffer, QByteArray& body)
+{
+	QElapsedTimer timer;
+	timer.start();
+	while (timer.elapsed() < 10000)
+	{
+		int header_end = buffer.indexOf("\r\n\r\n");
+		if (header_end > -1)
+		{
+			QList<QByteArray> header_lines = buffer.left(header_end).split('\n');
+			int status_code = header_lines[0].split(' ').value(1).toInt();
+			qint64 length = -1;
+			foreach(const QByteArray& line, header_lines)
+			{
+				if (line.toLower().startsWith("content-length:")) length = line.mid(15).trimmed().toLongLong();
+			}
+			if (length == -1) return 0;
+			if (buffer.size() >= header_end + 4 + length)
+			{
+				body = buffer.mid(header_end + 4, length);
+				buffer.remove(0, header_end + 4 + length);
+				return status_code;
+			}
+		}
+
+		if (!socket.waitForReadyRead(1000) && socket.state() != QAbstractSocket::ConnectedState) return 0;
+		buffer.append(socket.readAll());
+	}
+	return 0;
+}
+
 TEST_CLASS(Server_Integration_Test)
 {
 private:
@@ -239,6 +274,148 @@ private:
 		IS_TRUE(doc.object()["htslib_version"].toString().startsWith("1."));
 	}
 
+	TEST_METHOD(test_persistent_connections_load)
+	{
+		if (!ServerHelper::settingsValid(true))
+		{
+			SKIP("Server has not been configured correctly");
+		}
+
+		const int connection_count = 8;
+		const int batch_count = 25;
+		const int pipeline_depth = 4;
+
+		//open persistent connections
+		QUrl url(ClientHelper::serverApiUrl());
+		QList<QSharedPointer<QSslSocket>> sockets;
+		QList<QByteArray> buffers;
+		for (int c=0; c<connection_count; ++c)
+		{
+			QSharedPointer<QSslSocket> socket(new QSslSocket());
+			socket->setPeerVerifyMode(QSslSocket::VerifyNone);
+			socket->connectToHostEncrypted(url.host(), url.port(8443));
+			if (!socket->waitForEncrypted(5000))
+			{
+				SKIP("This test requieres a running server");
+			}
+			sockets << socket;
+			buffers << QByteArray();
+		}
+
+		//send pipelined requests in batches and measure the latency of each request (from sending the batch until the response is read)
+		QByteArray request = "GET " + url.path().toUtf8() + "info HTTP/1.1\r\nHost: " + url.host().toUtf8() + "\r\nAccept: application/json\r\n\r\n";
+		QVector<qint64> latencies;
+		QElapsedTimer timer;
+		timer.start();
+		for (int b=0; b<batch_count; ++b)
+		{
+			QVector<qint64> start_times(connection_count);
+			for (int c=0; c<connection_count; ++c)
+			{
+				start_times[c] = timer.nsecsElapsed();
+				sockets[c]->write(request.repeated(pipeline_depth));
+				sockets[c]->flush();
+			}
+			for (int c=0; c<connection_count; ++c)
+			{
+				for (int r=0; r<pipeline_depth; ++r)
+				{
+					QByteArray body;
+					I_EQUAL(readPersistentConnectionResponse(*sockets[c], buffers[c], body), 200);
+					IS_TRUE(QJsonDocument::fromJson(body).object().contains("version"));
+					latencies << timer.nsecsElapsed() - start_times[c];
+				}
+			}
+		}
+		double seconds = timer.nsecsElapsed() / 1e9;
+
+		std::sort(latencies.begin(), latencies.end());
+		int request_count = latencies.count();
+		I_EQUAL(request_count, connection_count * batch_count * pipeline_depth);
+		double p99_ms = latencies[qCeil(0.99 * request_count) - 1] / 1e6;
+		Log::info("Persistent connections load test: " + QString::number(request_count) + " requests over " + QString::number(connection_count) + " connections (pipeline depth " + QString::number(pipeline_depth) + "): " + QString::number(request_count / seconds, 'f', 1) + " requests/s, p99 latency " + QString::number(p99_ms, 'f', 2) + " ms");
+
+		//all requests were answered using the initial connections
+		foreach(QSharedPointer<QSslSocket> socket, sockets)
+		{
+			IS_TRUE(socket->state() == QAbstractSocket::ConnectedState);
+		}
+
+		//the server closes the connection if requested by the client
+		QByteArray close_request = request;
+		close_request.insert(close_request.length() - 2, "Connection: close\r\n");
+		sockets[0]->write(close_request);
+		QByteArray body;
+		I_EQUAL(readPersistentConnectionResponse(*sockets[0], buffers[0], body), 200);
+		if (sockets[0]->state() != QAbstractSocket::UnconnectedState) sockets[0]->waitForDisconnected(5000);
+		IS_TRUE(sockets[0]->state() == QAbstractSocket::UnconnectedState);
+	}
+
+	TEST_METHOD(test_range_request_throughput)
+	{
+		if (!ServerHelper::settingsValid(true))
+		{
+			SKIP("Server has not been configured correctly");
+		}
+
+		const qint64 range_size = 1024*1024;
+		const int request_count = 256;
+		const int ranges_per_request = 4;
+
+		QUrl url(ClientHelper::serverApiUrl());
+		QSslSocket socket;
+		socket.setPeerVerifyMode(QSslSocket::VerifyNone);
+		socket.connectToHostEncrypted(url.host(), url.port(8443));
+		if (!socket.waitForEncrypted(5000))
+		{
+			SKIP("This test requieres a running server");
+		}
+
+		//large file served by the server (the reference genome, like BAM files read by IGV)
+		QByteArray request_start = "GET " + url.path().toUtf8() + "genome/GRCh38.fa HTTP/1.1\r\nHost: " + url.host().toUtf8() + "\r\nRange: bytes=";
+		QByteArray buffer;
+		QByteArray body;
+		socket.write(request_start + "0-0\r\n\r\n");
+		if (readPersistentConnectionResponse(socket, buffer, body) != 206)
+		{
+			SKIP("This test requires the reference genome on the server");
+		}
+
+		//single ranges
+		QElapsedTimer timer;
+		timer.start();
+		qint64 bytes = 0;
+		for (int r=0; r<request_count; ++r)
+		{
+			qint64 start = r * range_size;
+			socket.write(request_start + QByteArray::number(start) + "-" + QByteArray::number(start + range_size - 1) + "\r\n\r\n");
+			I_EQUAL(readPersistentConnectionResponse(socket, buffer, body), 206);
+			I_EQUAL(body.size(), range_size);
+			bytes += body.size();
+		}
+		double mb_per_s = bytes / 1024.0 / 1024.0 / (timer.nsecsElapsed() / 1e9);
+		Log::info("Range request throughput (" + QString::number(request_count) + " x 1 range of " + QString::number(range_size) + " bytes): " + QString::number(mb_per_s, 'f', 1) + " MB/s");
+
+		//multi-range requests (sent as multipart response)
+		timer.restart();
+		bytes = 0;
+		for (int r=0; r<request_count/ranges_per_request; ++r)
+		{
+			QByteArrayList ranges;
+			for (int i=0; i<ranges_per_request; ++i)
+			{
+				qint64 start = (r * ranges_per_request + i) * 2 * range_size;
+				ranges << QByteArray::number(start) + "-" + QByteArray::number(start + range_size - 1);
+			}
+			socket.write(request_start + ranges.join(",") + "\r\n\r\n");
+			I_EQUAL(readPersistentConnectionResponse(socket, buffer, body), 206);
+			IS_TRUE(body.size() > ranges_per_request * range_size);
+			bytes += body.size();
+		}
+		mb_per_s = bytes / 1024.0 / 1024.0 / (timer.nsecsElapsed() / 1e9);
+		Log::info("Range request throughput (" + QString::number(request_count/ranges_per_request) + " x " + QString::number(ranges_per_request) + " ranges of " + QString::number(range_size) + " bytes): " + QString::number(mb_per_s, 'f', 1) + " MB/s");
+	}
+
 	TEST_METHOD(test_client_info_retrieval)
 	{
 		if (!ServerHelper::settingsValid(true))
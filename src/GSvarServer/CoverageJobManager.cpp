@@ -0,0 +1,301 @@
+#include "CoverageJobManager.h"
+#include "Statistics.h"
+#include "Settings.h"
+#include "Log.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDeadlineTimer>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+
+CoverageJobManager::CoverageJobManager()
+	: mutex_()
+	, job_finished_()
+	, jobs_()
+	, pool_()
+	, cache_folder_(Settings::string("coverage_cache_folder", true))
+{
+	pool_.setMaxThreadCount(Settings::contains("coverage_job_threads") ? Settings::integer("coverage_job_threads") : 2);
+
+	if (cache_folder_.isEmpty()) cache_folder_ = QDir::tempPath() + QDir::separator() + QCoreApplication::applicationName() + "_coverage_cache";
+	if (!QDir().mkpath(cache_folder_))
+	{
+		Log::warn("Could not create the coverage cache folder " + cache_folder_ + " - coverage results are cached in memory only");
+		cache_folder_.clear();
+	}
+}
+
+CoverageJobManager& CoverageJobManager::instance()
+{
+	static CoverageJobManager coverage_job_manager;
+	return coverage_job_manager;
+}
+
+QString CoverageJobManager::submit(CoverageJobType type, const BedFile& roi, const QString& bam_file, int cutoff)
+{
+	QString id = jobId(type, roi, bam_file, cutoff);
+
+	CoverageJobManager& manager = instance();
+	QMutexLocker locker(&manager.mutex_);
+
+	// running or finished calculation (failed calculations are repeated)
+	if (manager.jobs_.contains(id) && manager.jobs_[id].status!=CoverageJobStatus::FAILED)
+	{
+		manager.jobs_[id].last_access = QDateTime::currentDateTime();
+		return id;
+	}
+
+	CoverageJob job;
+	job.id = id;
+	job.type = type;
+	job.bam_file = bam_file;
+	job.cutoff = cutoff;
+	job.last_access = QDateTime::currentDateTime();
+
+	// result calculated before (also by an earlier server instance)
+	QFile cache_file(manager.cacheFile(id));
+	if (!cache_file.fileName().isEmpty() && cache_file.exists() && cache_file.open(QFile::ReadWrite))
+	{
+		job.result = cache_file.readAll();
+		job.status = CoverageJobStatus::FINISHED;
+		cache_file.setFileTime(job.last_access, QFileDevice::FileModificationTime);
+		manager.jobs_.insert(id, job);
+		return id;
+	}
+
+	job.roi = roi;
+	job.status = CoverageJobStatus::QUEUED;
+	manager.jobs_.insert(id, job);
+	manager.pool_.start([&manager, id]()
+	{
+		manager.run(id);
+	});
+
+	return id;
+}
+
+CoverageJob CoverageJobManager::job(const QString& id)
+{
+	CoverageJobManager& manager = instance();
+	QMutexLocker locker(&manager.mutex_);
+
+	if (!manager.jobs_.contains(id)) return CoverageJob();
+
+	manager.jobs_[id].last_access = QDateTime::currentDateTime();
+	return manager.jobs_[id];
+}
+
+CoverageJob CoverageJobManager::waitForJob(const QString& id, int timeout)
+{
+	CoverageJobManager& manager = instance();
+	QDeadlineTimer deadline = (timeout<0) ? QDeadlineTimer(QDeadlineTimer::Forever) : QDeadlineTimer(timeout);
+
+	QMutexLocker locker(&manager.mutex_);
+	while (manager.jobs_.contains(id))
+	{
+		CoverageJobStatus status = manager.jobs_[id].status;
+		if (status==CoverageJobStatus::FINISHED || status==CoverageJobStatus::FAILED) break;
+		if (!manager.job_finished_.wait(&manager.mutex_, deadline)) break;
+	}
+
+	if (!manager.jobs_.contains(id)) return CoverageJob();
+
+	manager.jobs_[id].last_access = QDateTime::currentDateTime();
+	return manager.jobs_[id];
+}
+
+void CoverageJobManager::removeExpiredJobs()
+{
+	CoverageJobManager& manager = instance();
+	QDateTime now = QDateTime::currentDateTime();
+
+	int removed_jobs = 0;
+	{
+		QMutexLocker locker(&manager.mutex_);
+		QStringList ids = manager.jobs_.keys();
+		foreach(const QString& id, ids)
+		{
+			const CoverageJob& job = manager.jobs_[id];
+			if (job.status!=CoverageJobStatus::FINISHED && job.status!=CoverageJobStatus::FAILED) continue;
+			if (job.last_access.secsTo(now) < JOB_LIFETIME) continue;
+
+			manager.jobs_.remove(id);
+			++removed_jobs;
+		}
+	}
+
+	int removed_files = 0;
+	if (!manager.cache_folder_.isEmpty())
+	{
+		QFileInfoList cache_files = QDir(manager.cache_folder_).entryInfoList(QStringList() << "*.txt", QDir::Files);
+		foreach(const QFileInfo& cache_file, cache_files)
+		{
+			if (cache_file.lastModified().secsTo(now) < CACHE_LIFETIME) continue;
+			if (QFile::remove(cache_file.absoluteFilePath())) ++removed_files;
+		}
+	}
+
+	Log::info("Number of removed coverage jobs: " + QString::number(removed_jobs) + ", removed cache files: " + QString::number(removed_files));
+}
+
+QString CoverageJobManager::statusToString(CoverageJobStatus status)
+{
+	switch(status)
+	{
+		case CoverageJobStatus::UNKNOWN:
+			return "unknown";
+		case CoverageJobStatus::QUEUED:
+			return "queued";
+		case CoverageJobStatus::RUNNING:
+			return "running";
+		case CoverageJobStatus::FINISHED:
+			return "finished";
+		case CoverageJobStatus::FAILED:
+			return "failed";
+	}
+
+	THROW(ProgrammingException, "Unhandled coverage job status " + QString::number(static_cast<int>(status)));
+}
+
+QString CoverageJobManager::jobId(CoverageJobType type, const BedFile& roi, const QString& bam_file, int cutoff)
+{
+	// the size and modification time of the BAM file invalidate results of older versions of the file
+	QFileInfo bam_info(bam_file);
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(QByteArray::number(static_cast<int>(type)) + "\t");
+	hash.addData(bam_info.absoluteFilePath().toUtf8() + "\t");
+	hash.addData(QByteArray::number(bam_info.size()) + "\t");
+	hash.addData(QByteArray::number(bam_info.lastModified().toMSecsSinceEpoch()) + "\t");
+	hash.addData(QByteArray::number(cutoff) + "\t");
+	hash.addData(roi.toText().toUtf8());
+
+	return hash.result().toHex();
+}
+
+QByteArray CoverageJobManager::calculate(const CoverageJob& job)
+{
+	int threads = Settings::integer("threads");
+	QString ref_file = Settings::string("reference_genome", true);
+
+	// use the depth index next to the BAM/CRAM file, if it was created from it with matching parameters
+	QSharedPointer<DepthIndex> depth_index;
+	QString depth_index_file = DepthIndex::defaultFileName(job.bam_file);
+	if (QFile::exists(depth_index_file))
+	{
+		try
+		{
+			depth_index.reset(new DepthIndex(depth_index_file));
+			const DepthIndex::Parameters& params = depth_index->parameters();
+			if (!depth_index->isIndexOf(job.bam_file) || params.min_mapq!=1 || params.min_baseq!=0 || params.skip_mismapped)
+			{
+				depth_index.clear();
+			}
+		}
+		catch (Exception& e)
+		{
+			Log::warn("Ignoring depth index " + depth_index_file + ": " + e.message());
+			depth_index.clear();
+		}
+	}
+
+	if (job.type==CoverageJobType::LOW_COVERAGE)
+	{
+		if (!depth_index.isNull()) return Statistics::lowCoverage(job.roi, *depth_index, job.cutoff, 1, 0).toText().toUtf8();
+		return Statistics::lowCoverage(job.roi, job.bam_file, job.cutoff, 1, 0, threads, ref_file).toText().toUtf8();
+	}
+
+	if (job.type==CoverageJobType::AVG_COVERAGE)
+	{
+		BedFile roi = job.roi;
+		if (!depth_index.isNull())
+		{
+			Statistics::avgCoverage(roi, *depth_index, 1, 2);
+		}
+		else
+		{
+			Statistics::avgCoverage(roi, job.bam_file, 1, threads, 2, ref_file);
+		}
+		return roi.toText().toUtf8();
+	}
+
+	// depth of each region weighted by the region length (only the depth is needed, no complete mapping QC)
+	BedFile roi = job.roi;
+	roi.clearAnnotations();
+	if (!depth_index.isNull())
+	{
+		Statistics::avgCoverage(roi, *depth_index, 1, 10);
+	}
+	else
+	{
+		Statistics::avgCoverage(roi, job.bam_file, 1, threads, 10, ref_file);
+	}
+
+	double depth = 0.0;
+	double length_sum = 0.0;
+	for (int i=0; i<roi.count(); ++i)
+	{
+		depth += roi[i].annotations()[0].toDouble() * roi[i].length();
+		length_sum += roi[i].length();
+	}
+	if (length_sum==0) THROW(ArgumentException, "Cannot calculate the read depth of an empty target region");
+
+	return QByteArray::number(depth/length_sum, 'f', 2);
+}
+
+void CoverageJobManager::run(const QString& id)
+{
+	CoverageJob job;
+	{
+		QMutexLocker locker(&mutex_);
+		jobs_[id].status = CoverageJobStatus::RUNNING;
+		job = jobs_[id];
+	}
+
+	QByteArray result;
+	QString error;
+	try
+	{
+		result = calculate(job);
+	}
+	catch (Exception& e)
+	{
+		error = e.message();
+	}
+	catch (...)
+	{
+		error = "Unexpected error during the coverage calculation";
+	}
+
+	if (error.isEmpty())
+	{
+		QSaveFile cache_file(cacheFile(id));
+		if (!cache_file.fileName().isEmpty() && (!cache_file.open(QFile::WriteOnly) || cache_file.write(result)!=result.size() || !cache_file.commit()))
+		{
+			Log::warn("Could not write the coverage cache file " + cache_file.fileName() + ": " + cache_file.errorString());
+		}
+	}
+	else
+	{
+		Log::error("Coverage calculation for " + job.bam_file + " failed: " + error);
+	}
+
+	{
+		QMutexLocker locker(&mutex_);
+		CoverageJob& current = jobs_[id];
+		current.status = error.isEmpty() ? CoverageJobStatus::FINISHED : CoverageJobStatus::FAILED;
+		current.result = result;
+		current.error = error;
+		current.roi = BedFile(); // not needed anymore
+		current.last_access = QDateTime::currentDateTime();
+	}
+	job_finished_.wakeAll();
+}
+
+QString CoverageJobManager::cacheFile(const QString& id) const
+{
+	if (cache_folder_.isEmpty()) return QString();
+
+	return cache_folder_ + QDir::separator() + id + ".txt";
+}
@@ -0,0 +1,79 @@
+#ifndef COVERAGEJOBMANAGER_H
+#define COVERAGEJOBMANAGER_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
+#include <QHash>
+#include <QDateTime>
+#include "BedFile.h"
+
+enum class CoverageJobType
+{
+	LOW_COVERAGE, // regions below a depth cutoff
+	AVG_COVERAGE, // average depth of each region
+	READ_DEPTH // average depth of the complete target region
+};
+
+enum class CoverageJobStatus
+{
+	UNKNOWN,
+	QUEUED,
+	RUNNING,
+	FINISHED,
+	FAILED
+};
+
+struct CoverageJob
+{
+	QString id;
+	CoverageJobType type = CoverageJobType::LOW_COVERAGE;
+	BedFile roi;
+	QString bam_file;
+	int cutoff = 0;
+	CoverageJobStatus status = CoverageJobStatus::UNKNOWN;
+	QByteArray result; // BED file or depth as text
+	QString error;
+	QDateTime last_access;
+};
+
+// Coverage calculations of the server (e.g. low coverage regions for the report of GSvar). Each calculation
+// is identified by the BAM file (incl. size and modification time), the target region and the parameters.
+// It is executed only once in a bounded thread pool, even if several users request it at the same time.
+// The results are cached on disk, i.e. they are invalidated when the BAM file changes.
+class CoverageJobManager
+{
+public:
+	/// Returns the id of the calculation and starts it, if it has neither been calculated nor cached before
+	static QString submit(CoverageJobType type, const BedFile& roi, const QString& bam_file, int cutoff = 0);
+	/// Returns the job with the given id (status UNKNOWN, if there is no such job)
+	static CoverageJob job(const QString& id);
+	/// Waits until the job has finished or failed, or the timeout (milliseconds, -1 for no timeout) has been reached
+	static CoverageJob waitForJob(const QString& id, int timeout = -1);
+	/// Removes finished jobs from memory that have not been accessed for a while and expired cache files
+	static void removeExpiredJobs();
+
+	static QString statusToString(CoverageJobStatus status);
+	/// Returns the id of the calculation
+	static QString jobId(CoverageJobType type, const BedFile& roi, const QString& bam_file, int cutoff);
+
+protected:
+	CoverageJobManager();
+
+private:
+	static const qint64 JOB_LIFETIME = 60*60; // in seconds (in memory)
+	static const qint64 CACHE_LIFETIME = 7*24*60*60; // in seconds (on disk)
+
+	static CoverageJobManager& instance();
+	static QByteArray calculate(const CoverageJob& job);
+	void run(const QString& id);
+	QString cacheFile(const QString& id) const;
+
+	QMutex mutex_;
+	QWaitCondition job_finished_;
+	QHash<QString, CoverageJob> jobs_;
+	QThreadPool pool_;
+	QString cache_folder_;
+};
+
+#endif // COVERAGEJOBMANAGER_H
@@ -16,10 +16,12 @@ CONFIG -= app_bundle
 DEFINES += QT_DEPRECATED_WARNINGS
 
 SOURCES += \
+        CoverageJobManager.cpp \
         QueuingEngineController.cpp \
         QueuingEngineControllerGeneric.cpp \
         QueuingEngineControllerSge.cpp \
         QueuingEngineControllerSlurm.cpp \
+        RegionQueryManager.cpp \
         ScheduledCacheCleaner.cpp \
         ServerController.cpp \
         ServerWrapper.cpp \
@@ -31,10 +33,12 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
 HEADERS += \
+    CoverageJobManager.h \
     QueuingEngineController.h \
     QueuingEngineControllerGeneric.h \
     QueuingEngineControllerSge.h \
     QueuingEngineControllerSlurm.h \
+    RegionQueryManager.h \
     ScheduledCacheCleaner.h \
     ServerController.h \
     ServerWrapper.h
@@ -27,44 +27,10 @@ void QueuingEngineController::run()
 		NGSD db;
 
 		//process jobs
-		SqlQuery query = db.getQuery();
-		query.exec("SELECT id FROM analysis_job ORDER BY id ASC");
-		while(query.next())
-		{
-			int job_id  = query.value("id").toInt();
-			AnalysisJob job = db.analysisInfo(job_id);
-			QString status = job.lastStatus();
-			try
-			{
-				if(status=="queued")
-				{
-					job.checkValid(job_id);
-					startAnalysis(db, job, job_id);
-				}
-				if(status=="started")
-				{
-					job.checkValid(job_id);
-					updateAnalysisStatus(db, job, job_id);
-				}
-				if(status=="cancel")
-				{
-					job.checkValid(job_id);
-					deleteJob(db, job, job_id);
-				}
-			}
-			catch (Exception& e)
-			{
-				if (debug_) QTextStream(stdout) << engine << " job (id=" << QString::number(job_id) << ") update failed: " << e.message() << Qt::endl;
-				Log::info(engine + " job (id=" + QString::number(job_id) + ") update failed: " + e.message());
-			}
-			catch (...)
-			{
-				if (debug_) QTextStream(stdout) << engine << " job (id=" << QString::number(job_id) << ") update failed with unkown error" << Qt::endl;
-				Log::info(engine + " job (id=" + QString::number(job_id) + ") update failed with unkown error");
-			}
-		}
+		processJobs(db);
 
 		//delete jobs that are older than 60 days
+		SqlQuery query = db.getQuery();
 		query.exec("SELECT res.id FROM (SELECT j.id as id , MAX(jh.time) as last_update FROM analysis_job j, analysis_job_history jh WHERE jh.analysis_job_id=j.id GROUP BY j.id) as res WHERE res.last_update < SUBDATE(NOW(), INTERVAL 60 DAY)");
 		while(query.next())
 		{
@@ -92,6 +58,70 @@ void QueuingEngineController::run()
 	}
 }
 
+void QueuingEngineController::processJobs(NGSD& db)
+{
+	QString engine = getEngineName();
+
+	//load jobs that are not finished (last history entry is 'queued', 'started' or 'cancel')
+	QList<int> job_ids;
+	QList<AnalysisJob> jobs;
+	QStringList started_qe_ids;
+	SqlQuery query = db.getQuery();
+	query.exec("SELECT j.id FROM analysis_job j JOIN (SELECT analysis_job_id, MAX(id) as last_id FROM analysis_job_history GROUP BY analysis_job_id) lh ON lh.analysis_job_id=j.id JOIN analysis_job_history jh ON jh.id=lh.last_id WHERE jh.status IN ('queued','started','cancel') ORDER BY j.id ASC");
+	while(query.next())
+	{
+		int job_id = query.value("id").toInt();
+		AnalysisJob job = db.analysisInfo(job_id);
+		if (job.lastStatus()=="started" && !job.sge_id.isEmpty()) started_qe_ids << job.sge_id;
+
+		job_ids << job_id;
+		jobs << job;
+	}
+	if (debug_) QTextStream(stdout) << engine << " jobs to update: " << jobs.count() << " (started: " << started_qe_ids.count() << ")" << Qt::endl;
+
+	//query the state of all started jobs at once
+	if (!started_qe_ids.isEmpty()) queryJobStates(started_qe_ids);
+
+	for (int i=0; i<jobs.count(); ++i)
+	{
+		int job_id = job_ids[i];
+		AnalysisJob& job = jobs[i];
+		QString status = job.lastStatus();
+		try
+		{
+			if(status=="queued")
+			{
+				job.checkValid(job_id);
+				startAnalysis(db, job, job_id);
+			}
+			if(status=="started")
+			{
+				job.checkValid(job_id);
+				updateAnalysisStatus(db, job, job_id);
+			}
+			if(status=="cancel")
+			{
+				job.checkValid(job_id);
+				deleteJob(db, job, job_id);
+			}
+		}
+		catch (Exception& e)
+		{
+			if (debug_) QTextStream(stdout) << engine << " job (id=" << QString::number(job_id) << ") update failed: " << e.message() << Qt::endl;
+			Log::info(engine + " job (id=" + QString::number(job_id) + ") update failed: " + e.message());
+		}
+		catch (...)
+		{
+			if (debug_) QTextStream(stdout) << engine << " job (id=" << QString::number(job_id) << ") update failed with unkown error" << Qt::endl;
+			Log::info(engine + " job (id=" + QString::number(job_id) + ") update failed with unkown error");
+		}
+	}
+}
+
+void QueuingEngineController::queryJobStates(const QStringList& /*qe_job_ids*/)
+{
+}
+
 void QueuingEngineController::startAnalysis(NGSD& db, const AnalysisJob& job, int job_id)
 {
 	if (debug_) QTextStream(stdout) << "Starting job " << job_id << " (type: " << job.type << ")" << Qt::endl;
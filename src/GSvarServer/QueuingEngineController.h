@@ -5,6 +5,7 @@
 #include <QTextStream>
 #include "PipelineSettings.h"
 #include <QRunnable>
+#include <QHash>
 #include "NGSD.h"
 
 class QueuingEngineController
@@ -17,12 +18,26 @@ public:
 	void run() override;
 
 protected:
+	// State of a queued/running job as reported by the queuing engine
+	struct JobState
+	{
+		QByteArray status;
+		QByteArray queue;
+	};
+
+	// Updates all queued, started and canceled jobs (only jobs in these states are loaded from NGSD)
+	void processJobs(NGSD& db);
+
 	// Returns the name of a queuing engine
 	virtual QString getEngineName() const = 0;
 
 	// Submits a job to a queuing engine and returns an exit code
 	virtual void submitJob(NGSD& db, int threads, QStringList queues, QStringList pipeline_args, QString working_directory, QString script, int job_id) const = 0;
 
+	// Called once per update cycle with the queuing engine ids of all started jobs, before 'updateRunningJob' is called for them.
+	// Engines query the state of all jobs here with a single command instead of one command per job. The default implementation does nothing.
+	virtual void queryJobStates(const QStringList& qe_job_ids);
+
 	// Updates the status of a running job in NGSD and returns if the job is finished
 	virtual bool updateRunningJob(NGSD& db, const AnalysisJob &job, int job_id) const = 0;
 
@@ -34,6 +49,12 @@ protected:
 
 	bool debug_ = false;
 
+	// Results of 'queryJobStates' for the current update cycle
+	bool job_states_valid_ = false; // false if the state query failed - running jobs are not updated then
+	QHash<QString, JobState> job_states_; // states of queued/running jobs by queuing engine id
+	bool exit_codes_valid_ = false; // false if the accounting query failed - completed jobs are not updated then
+	QHash<QString, QString> exit_codes_; // exit codes of completed jobs by queuing engine id (only for engines with batched accounting)
+
 private:
 	void startAnalysis(NGSD& db, const AnalysisJob& job, int job_id);
 	void updateAnalysisStatus(NGSD& db, const AnalysisJob& job, int job_id);
@@ -74,49 +74,58 @@ void QueuingEngineControllerSge::submitJob(NGSD& db, int threads, QStringList qu
 	}
 }
 
-bool QueuingEngineControllerSge::updateRunningJob(NGSD& db, const AnalysisJob &job, int job_id) const
+void QueuingEngineControllerSge::queryJobStates(const QStringList& /*qe_job_ids*/)
 {
-	bool job_finished = true;
+	job_states_.clear();
+
+	//queued/running jobs (one qstat call for all jobs)
 	QByteArrayList result;
 	QString command = "qstat";
 	QStringList qstat_args = QStringList() << "-u" << "*";
 	int exit_code = Helper::executeCommand(command, qstat_args, &result);
 	Log::info(command + " " + qstat_args.join(" "));
 
-	if (exit_code == 0)
+	job_states_valid_ = (exit_code == 0);
+	if (!job_states_valid_)
 	{
-		foreach(QByteArray line, result)
-		{
-			line = line.simplified();
-			if (line.startsWith(job.sge_id.toLatin1() + ' '))
-			{
-				job_finished = false;
-				QByteArrayList parts = line.split(' ');
-				if (parts.count()<8) continue;
-
-				QByteArray status = parts[4].trimmed().toLower();
-				if (debug_) QTextStream(stdout) << "  Job queued/running (state: " << status << " queue: " << job.sge_queue << ")" << Qt::endl;
-
-				if (status=="r" && job.sge_queue.isEmpty())
-				{
-					QByteArray queue = parts[7].split('@')[0].trimmed();
-
-					SqlQuery query = db.getQuery();
-					query.prepare("UPDATE analysis_job SET sge_queue=:0 WHERE id=:1");
-					query.bindValue(0, queue);
-					query.bindValue(1, job_id);
-					query.exec();
-					break;
-				}
-			}
-		}
+		Log::warn(command + " " + qstat_args.join(" ") + " failed with exit code " + QString::number(exit_code) + " - skipping update of running SGE jobs");
+		return;
 	}
-	else
+
+	foreach(QByteArray line, result)
+	{
+		QByteArrayList parts = line.simplified().split(' ');
+		if (parts.count()<5) continue;
+
+		//the queue is only listed for running jobs
+		JobState state;
+		state.status = parts[4].trimmed().toLower();
+		if (parts.count()>=8) state.queue = parts[7].split('@')[0].trimmed();
+		job_states_[parts[0]] = state;
+	}
+
+	//completed jobs are checked one by one in 'checkCompletedJob' because qacct accepts only one job id
+}
+
+bool QueuingEngineControllerSge::updateRunningJob(NGSD& db, const AnalysisJob &job, int job_id) const
+{
+	if (!job_states_valid_) return false;
+
+	if (!job_states_.contains(job.sge_id)) return true;
+
+	const JobState& state = job_states_[job.sge_id];
+	if (debug_) QTextStream(stdout) << "  Job queued/running (state: " << state.status << " queue: " << job.sge_queue << ")" << Qt::endl;
+
+	if (state.status=="r" && job.sge_queue.isEmpty() && !state.queue.isEmpty())
 	{
-		Log::warn(command + " " + qstat_args.join(" ") + " failed - skipping update of SGE job with id " + job.sge_id);
+		SqlQuery query = db.getQuery();
+		query.prepare("UPDATE analysis_job SET sge_queue=:0 WHERE id=:1");
+		query.bindValue(0, state.queue);
+		query.bindValue(1, job_id);
+		query.exec();
 	}
 
-	return job_finished;
+	return false;
 }
 
 void QueuingEngineControllerSge::checkCompletedJob(NGSD& db, QString qe_job_id, QByteArrayList stdout_stderr, int job_id) const
@@ -12,6 +12,7 @@ public:
 protected:
 	QString getEngineName() const override;
 	void submitJob(NGSD& db, int threads, QStringList queues, QStringList pipeline_args, QString working_directory, QString script, int job_id) const override;
+	void queryJobStates(const QStringList& qe_job_ids) override;
 	bool updateRunningJob(NGSD& db, const AnalysisJob &job, int job_id) const override;
 	void checkCompletedJob(NGSD& db, QString qe_job_id, QByteArrayList stdout_stderr, int job_id) const override;
 	void deleteJob(NGSD &db, const AnalysisJob &job, int job_id) const override;
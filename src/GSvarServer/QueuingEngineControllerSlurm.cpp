@@ -95,86 +95,108 @@ void QueuingEngineControllerSlurm::submitJob(NGSD& db, int threads, QStringList
 	}
 }
 
-bool QueuingEngineControllerSlurm::updateRunningJob(NGSD& db, const AnalysisJob &job, int job_id) const
+void QueuingEngineControllerSlurm::queryJobStates(const QStringList& qe_job_ids)
 {
-	bool job_finished = true;
+	job_states_.clear();
+	exit_codes_.clear();
+
+	//queued/running jobs (one squeue call for all jobs)
 	QByteArrayList result;
 	QString command = "squeue";
 	QStringList squeue_args = QStringList();
 	int exit_code = Helper::executeCommand(command, squeue_args, &result);
 	Log::info(command + " " + squeue_args.join(" "));
 
-	if (exit_code == 0)
+	job_states_valid_ = (exit_code == 0);
+	if (!job_states_valid_)
 	{
-		foreach(QByteArray line, result)
-		{
-			line = line.simplified();
-			if (line.startsWith(job.sge_id.toLatin1() + ' '))
-			{
-				job_finished = false;
-				QByteArrayList parts = line.split(' ');
-				if (parts.count()<8) continue;
-
-				QByteArray status = parts[4].trimmed().toLower();
-				if (debug_) QTextStream(stdout) << "  Job queued/running (state: " << status << " queue: " << job.sge_queue << ")" << Qt::endl;
-
-				if (status=="r" && job.sge_queue.isEmpty())
-				{
-					QByteArray queue = parts[1].split('@')[0].trimmed();
-
-					SqlQuery query = db.getQuery();
-					query.prepare("UPDATE analysis_job SET sge_queue=:0 WHERE id=:1");
-					query.bindValue(0, queue);
-					query.bindValue(1, job_id);
-					query.exec();
-					break;
-				}
-			}
-		}
+		Log::warn(command + " " + squeue_args.join(" ") + " failed with exit code " + QString::number(exit_code) + " - skipping update of running Slurm jobs");
+		exit_codes_valid_ = false;
+		return;
 	}
-	else
+
+	foreach(QByteArray line, result)
+	{
+		QByteArrayList parts = line.simplified().split(' ');
+		if (parts.count()<5) continue;
+
+		JobState state;
+		state.status = parts[4].trimmed().toLower();
+		state.queue = parts[1].split('@')[0].trimmed();
+		job_states_[parts[0]] = state;
+	}
+
+	//completed jobs (one sacct call for all jobs that are no longer listed by squeue)
+	QStringList completed;
+	foreach(const QString& qe_job_id, qe_job_ids)
 	{
-		Log::warn(command + " " + squeue_args.join(" ") + " failed - skipping update of Slurm job with id " + job.sge_id);
+		if (!job_states_.contains(qe_job_id)) completed << qe_job_id;
+	}
+	if (completed.isEmpty())
+	{
+		exit_codes_valid_ = true;
+		return;
+	}
+
+	result.clear();
+	command = "sacct";
+	QStringList sacct_args = QStringList() << "--parsable" << "--format=JobID,ExitCode" << "-j" << completed.join(",");
+	exit_code = Helper::executeCommand(command, sacct_args, &result);
+	Log::info(command + " " + sacct_args.join(" "));
+
+	exit_codes_valid_ = (exit_code == 0);
+	if (!exit_codes_valid_)
+	{
+		Log::warn(command + " " + sacct_args.join(" ") + "' failed with exit code " + QString::number(exit_code));
+		return;
 	}
 
-	return job_finished;
+	foreach(QByteArray line, result)
+	{
+		//only the main job line is used (skips the header and job steps, which have the format "<id>.<step>")
+		QByteArrayList parts = line.trimmed().split('|');
+		if (parts.count()<2 || !Helper::isNumeric(parts[0])) continue;
+
+		exit_codes_[parts[0]] = parts[1].split(':')[0];
+	}
 }
 
-void QueuingEngineControllerSlurm::checkCompletedJob(NGSD& db, QString qe_job_id, QByteArrayList stdout_stderr, int job_id) const
+bool QueuingEngineControllerSlurm::updateRunningJob(NGSD& db, const AnalysisJob &job, int job_id) const
 {
-	QByteArrayList result;
-	QString command = "sacct";
-	QStringList sacct_args = QStringList() << "--parsable" << "--format=JobID,ExitCode" << "-j" << qe_job_id;
-	int exit_code = Helper::executeCommand(command, sacct_args, &result);
+	if (!job_states_valid_) return false;
 
-	Log::info(command + " " + sacct_args.join(" "));
+	if (!job_states_.contains(job.sge_id)) return true;
+
+	const JobState& state = job_states_[job.sge_id];
+	if (debug_) QTextStream(stdout) << "  Job queued/running (state: " << state.status << " queue: " << job.sge_queue << ")" << Qt::endl;
 
-	if (exit_code == 0)
+	if (state.status=="r" && job.sge_queue.isEmpty())
 	{
-		QString slurm_exit_code = "";
+		SqlQuery query = db.getQuery();
+		query.prepare("UPDATE analysis_job SET sge_queue=:0 WHERE id=:1");
+		query.bindValue(0, state.queue);
+		query.bindValue(1, job_id);
+		query.exec();
+	}
 
-		foreach(QByteArray line, result)
-		{
-			if (!line.startsWith(qe_job_id.toLatin1() + '|')) continue;
-			QByteArray exit_codes = line.split('|')[1];
-			slurm_exit_code = exit_codes.split(':')[0];
-		}
+	return false;
+}
 
-		if (slurm_exit_code == "0")
-		{
-			if (debug_) QTextStream(stdout) << "	Job finished successfully" << Qt::endl;
-			db.addAnalysisHistoryEntry(job_id, "finished", stdout_stderr);
-		}
-		else
-		{
-			if (debug_) QTextStream(stdout) << "	Job failed with exit code: " << slurm_exit_code << Qt::endl;
-			stdout_stderr.prepend(("job exit code: " + slurm_exit_code).toLatin1());
-			db.addAnalysisHistoryEntry(job_id, "error", stdout_stderr);
-		}
+void QueuingEngineControllerSlurm::checkCompletedJob(NGSD& db, QString qe_job_id, QByteArrayList stdout_stderr, int job_id) const
+{
+	if (!exit_codes_valid_) return;
+
+	QString slurm_exit_code = exit_codes_.value(qe_job_id, "");
+	if (slurm_exit_code == "0")
+	{
+		if (debug_) QTextStream(stdout) << "	Job finished successfully" << Qt::endl;
+		db.addAnalysisHistoryEntry(job_id, "finished", stdout_stderr);
 	}
 	else
 	{
-		Log::warn(command + " " + sacct_args.join(" ") + "' failed with exit code " + QString::number(exit_code));
+		if (debug_) QTextStream(stdout) << "	Job failed with exit code: " << slurm_exit_code << Qt::endl;
+		stdout_stderr.prepend(("job exit code: " + slurm_exit_code).toLatin1());
+		db.addAnalysisHistoryEntry(job_id, "error", stdout_stderr);
 	}
 }
 
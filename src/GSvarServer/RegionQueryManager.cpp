@@ -0,0 +1,198 @@
+#include "RegionQueryManager.h"
+#include "Exceptions.h"
+#include "Settings.h"
+#include "Log.h"
+#include <QFileInfo>
+
+RegionQueryManager::RegionQueryManager()
+	: mutex_()
+	, files_()
+{
+}
+
+RegionQueryManager& RegionQueryManager::instance()
+{
+	static RegionQueryManager region_query_manager;
+	return region_query_manager;
+}
+
+RegionFileType RegionQueryManager::fileType(const QString& filename)
+{
+	QString name = filename.toLower();
+	if (name.endsWith(".bam") || name.endsWith(".cram")) return RegionFileType::BAM;
+	if (name.endsWith(".bw") || name.endsWith(".bigwig")) return RegionFileType::BIGWIG;
+	if (name.endsWith(".gz")) return RegionFileType::TABIX;
+
+	THROW(ArgumentException, "Region queries are not supported for file " + QFileInfo(filename).fileName() + ". Supported are tabix-indexed files (*.gz), BAM/CRAM files and bigWig files!");
+}
+
+QByteArray RegionQueryManager::query(const QString& filename, const Chromosome& chr, int start, int end, int min_mapq)
+{
+	switch(fileType(filename))
+	{
+		case RegionFileType::TABIX:
+			return queryTabix(filename, chr, start, end);
+		case RegionFileType::BAM:
+			return queryBam(filename, chr, start, end, min_mapq);
+		case RegionFileType::BIGWIG:
+			return queryBigWig(filename, chr, start, end);
+	}
+
+	THROW(ProgrammingException, "Unhandled region file type!");
+}
+
+QByteArray RegionQueryManager::queryTabix(const QString& filename, const Chromosome& chr, int start, int end)
+{
+	QSharedPointer<OpenedFile> file = instance().openFile(filename, RegionFileType::TABIX);
+	QMutexLocker locker(&file->mutex);
+
+	QByteArray output;
+	foreach(const QByteArray& line, file->tabix->getMatchingLines(chr, start, end, true))
+	{
+		output.append(line);
+		output.append('\n');
+	}
+
+	return output;
+}
+
+QByteArray RegionQueryManager::queryBam(const QString& filename, const Chromosome& chr, int start, int end, int min_mapq)
+{
+	if (end-start+1 > MAX_PILEUP_REGION) THROW(ArgumentException, "Region is too large for a pileup query: " + QString::number(end-start+1) + " bases (maximum is " + QString::number(MAX_PILEUP_REGION) + ")");
+
+	QSharedPointer<OpenedFile> file = instance().openFile(filename, RegionFileType::BAM);
+	QMutexLocker locker(&file->mutex);
+
+	// the alignments of the region are read once and counted for all positions
+	QVector<Pileup> pileups = file->bam->getPileups(chr, start, end, min_mapq);
+	QByteArray output = "#chr\tpos\tdepth\tA\tC\tG\tT\tN\tdeletions\n";
+	for (int pos=start; pos<=end; ++pos)
+	{
+		const Pileup& pileup = pileups[pos-start];
+		output.append(chr.strNormalized(true) + "\t" + QByteArray::number(pos) + "\t" + QByteArray::number(pileup.depth(true)) + "\t" + QByteArray::number(pileup.a()) + "\t" + QByteArray::number(pileup.c()) + "\t" + QByteArray::number(pileup.g()) + "\t" + QByteArray::number(pileup.t()) + "\t" + QByteArray::number(pileup.n()) + "\t" + QByteArray::number(pileup.depth(true) - pileup.depth(false)) + "\n");
+	}
+
+	return output;
+}
+
+QByteArray RegionQueryManager::queryBigWig(const QString& filename, const Chromosome& chr, int start, int end)
+{
+	QSharedPointer<OpenedFile> file = instance().openFile(filename, RegionFileType::BIGWIG);
+	QMutexLocker locker(&file->mutex);
+
+	QByteArray output;
+	QByteArray chr_name = chr.strNormalized(true);
+	if (!file->bigwig->containsChromosome(chr_name)) return output;
+
+	// bigWig files use 0-based, half-open coordinates
+	foreach(const BigWigReader::OverlappingInterval& interval, file->bigwig->getOverlappingIntervals(chr_name, start-1, end, 0))
+	{
+		output.append(chr_name + "\t" + QByteArray::number(interval.start) + "\t" + QByteArray::number(interval.end) + "\t" + QByteArray::number(interval.value) + "\n");
+	}
+
+	return output;
+}
+
+int RegionQueryManager::cachedFileCount()
+{
+	RegionQueryManager& manager = instance();
+	QMutexLocker locker(&manager.mutex_);
+
+	return manager.files_.count();
+}
+
+void RegionQueryManager::removeExpiredFiles()
+{
+	RegionQueryManager& manager = instance();
+	QDateTime now = QDateTime::currentDateTime();
+
+	int removed_files = 0;
+	{
+		QMutexLocker locker(&manager.mutex_);
+		QStringList filenames = manager.files_.keys();
+		foreach(const QString& filename, filenames)
+		{
+			if (manager.files_[filename]->last_access.secsTo(now) < FILE_LIFETIME) continue;
+
+			// files that are queried at the moment are closed when the query has finished (shared pointer)
+			manager.files_.remove(filename);
+			++removed_files;
+		}
+	}
+
+	Log::info("Number of closed region query files: " + QString::number(removed_files));
+}
+
+QSharedPointer<RegionQueryManager::OpenedFile> RegionQueryManager::openFile(const QString& filename, RegionFileType type)
+{
+	QFileInfo info(filename);
+	if (!info.exists()) THROW(FileAccessException, "File does not exist: " + filename);
+	QString key = info.absoluteFilePath();
+	QDateTime now = QDateTime::currentDateTime();
+
+	QMutexLocker locker(&mutex_);
+
+	// cached file that has not changed since it was opened (it might still be opened by another thread)
+	if (files_.contains(key))
+	{
+		QSharedPointer<OpenedFile> file = files_[key];
+		if (file->size==info.size() && file->last_modified==info.lastModified())
+		{
+			file->last_access = now;
+			locker.unlock();
+
+			QMutexLocker open_locker(&file->open_mutex);
+			if (!file->open_error.isEmpty()) THROW(FileAccessException, "Could not open file " + filename + ": " + file->open_error);
+			return file;
+		}
+		files_.remove(key);
+	}
+
+	// close the least recently used file, if too many files are open
+	if (files_.count()>=MAX_OPEN_FILES)
+	{
+		QString oldest;
+		for (auto it=files_.cbegin(); it!=files_.cend(); ++it)
+		{
+			if (oldest.isEmpty() || it.value()->last_access<files_[oldest]->last_access) oldest = it.key();
+		}
+		files_.remove(oldest);
+	}
+
+	// insert a placeholder for the file, which is locked until the file is opened
+	QSharedPointer<OpenedFile> file(new OpenedFile());
+	file->size = info.size();
+	file->last_modified = info.lastModified();
+	file->last_access = now;
+	QMutexLocker open_locker(&file->open_mutex);
+	files_.insert(key, file);
+	locker.unlock();
+
+	// open file (the index is loaded when opening the file or with the first query)
+	try
+	{
+		if (type==RegionFileType::TABIX)
+		{
+			file->tabix.reset(new TabixIndexedFile());
+			file->tabix->load(key.toUtf8());
+		}
+		else if (type==RegionFileType::BAM)
+		{
+			file->bam.reset(new BamReader(key, Settings::string("reference_genome", true)));
+		}
+		else if (type==RegionFileType::BIGWIG)
+		{
+			file->bigwig.reset(new BigWigReader(key));
+		}
+	}
+	catch (Exception& e)
+	{
+		// remove the placeholder (unless it was already replaced) - threads waiting for it get the error
+		file->open_error = e.message();
+		locker.relock();
+		if (files_.value(key)==file) files_.remove(key);
+		throw;
+	}
+
+	return file;
+}
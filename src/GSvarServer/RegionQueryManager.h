@@ -0,0 +1,77 @@
+#ifndef REGIONQUERYMANAGER_H
+#define REGIONQUERYMANAGER_H
+
+#include <QMutex>
+#include <QHash>
+#include <QDateTime>
+#include <QSharedPointer>
+#include "Chromosome.h"
+#include "TabixIndexedFile.h"
+#include "BamReader.h"
+#include "BigWigReader.h"
+
+enum class RegionFileType
+{
+	TABIX, // tabix-indexed text file, e.g. VCF or BED (*.gz with TBI/CSI index)
+	BAM, // BAM/CRAM file
+	BIGWIG // bigWig file, e.g. expression or methylation tracks
+};
+
+// Queries for a small genomic region executed on the files of the server (e.g. variants, pileup or expression values
+// shown in GSvar). The client gets a compact result instead of downloading the complete file or emulating htslib via
+// many byte range requests. Opened files (incl. indices) are cached, so repeated queries on the same file do not re-open it.
+// Queries on the same file are serialized, because the readers are not thread-safe. Queries on different files run in parallel.
+class RegionQueryManager
+{
+public:
+	/// Returns the file type determined from the file name (throws an exception for unsupported types)
+	static RegionFileType fileType(const QString& filename);
+	/// Executes the query for the file type of the given file. The region is 1-based.
+	static QByteArray query(const QString& filename, const Chromosome& chr, int start, int end, int min_mapq = 1);
+
+	/// Returns all lines of a tabix-indexed file overlapping the region (1-based)
+	static QByteArray queryTabix(const QString& filename, const Chromosome& chr, int start, int end);
+	/// Returns the pileup of each position of the region (1-based) as TSV with the columns chr, pos, depth, A, C, G, T, N, deletions
+	static QByteArray queryBam(const QString& filename, const Chromosome& chr, int start, int end, int min_mapq = 1);
+	/// Returns the intervals of a bigWig file overlapping the region (1-based) in bedGraph format (0-based, half-open)
+	static QByteArray queryBigWig(const QString& filename, const Chromosome& chr, int start, int end);
+
+	/// Returns the number of cached file handles
+	static int cachedFileCount();
+	/// Closes cached files that have not been used for a while
+	static void removeExpiredFiles();
+
+	/// Maximum region size of a pileup query (the pileup is calculated for each position)
+	static const int MAX_PILEUP_REGION = 10000;
+
+protected:
+	RegionQueryManager();
+
+private:
+	static const int MAX_OPEN_FILES = 64;
+	static const qint64 FILE_LIFETIME = 10*60; // in seconds
+
+	// Opened file with the metadata needed to detect changes of the file
+	struct OpenedFile
+	{
+		QMutex mutex; // locked while the file is queried
+		QMutex open_mutex; // locked while the file is opened (other threads wait for it without blocking the whole cache)
+		QString open_error; // error message if opening the file failed
+		qint64 size = -1;
+		QDateTime last_modified;
+		QDateTime last_access;
+		QSharedPointer<TabixIndexedFile> tabix;
+		QSharedPointer<BamReader> bam;
+		QSharedPointer<BigWigReader> bigwig;
+	};
+
+	static RegionQueryManager& instance();
+	// Returns the cached file or opens it. The file is re-opened if it changed since it was opened.
+	// The file is opened outside the lock of the cache, so that slow opening (e.g. loading a large index) does not block queries on other files.
+	QSharedPointer<OpenedFile> openFile(const QString& filename, RegionFileType type);
+
+	QMutex mutex_;
+	QHash<QString, QSharedPointer<OpenedFile>> files_;
+};
+
+#endif // REGIONQUERYMANAGER_H
@@ -12,11 +12,14 @@
 #include "ClientHelper.h"
 #include "FileLocationList.h"
 #include "SessionManager.h"
+#include "EndpointMetrics.h"
 #include "UrlManager.h"
 #include "ServerDB.h"
 #include "Statistics.h"
 #include "ToolBase.h"
 #include "FileLocationProviderLocal.h"
+#include "RegionQueryManager.h"
+#include "NGSHelper.h"
 
 ServerController::ServerController()
 {
@@ -87,7 +90,7 @@ HttpResponse ServerController::createStaticFileRangeResponse(const QString& file
 	return HttpResponse(response_data);
 }
 
-HttpResponse ServerController::createStaticStreamResponse(const QString& filename, bool is_downloadable)
+HttpResponse ServerController::createStaticStreamResponse(const QString& filename, bool is_downloadable, bool allow_compression)
 {
 	QSharedPointer<FastFileInfo> info = QSharedPointer<FastFileInfo>(new FastFileInfo(filename));
 
@@ -98,6 +101,9 @@ HttpResponse ServerController::createStaticStreamResponse(const QString& filenam
 	response_data.is_stream = true;
 	response_data.content_type = HttpUtils::getContentTypeByFilename(filename);
 	response_data.is_downloadable = is_downloadable;
+	response_data.is_compressed = allow_compression && HttpUtils::isCompressible(response_data.content_type);
+	response_data.last_modified = info->lastModified();
+	response_data.etag = HttpUtils::createEtag(response_data.file_size, response_data.last_modified);
 
 	return HttpResponse(response_data);
 }
@@ -118,10 +124,27 @@ HttpResponse ServerController::createStaticFileResponse(const QString& filename,
 	}
 
     quint64 file_size = info->size();
+
+	// Conditional request: the client has a cached copy of the file, which is still valid
+	QDateTime last_modified = info->lastModified();
+	QByteArray etag = HttpUtils::createEtag(file_size, last_modified);
+	if (HttpUtils::isNotModified(request.getHeaderByName("If-None-Match"), request.getHeaderByName("If-Modified-Since"), etag, last_modified))
+	{
+		BasicResponseData response_data;
+		response_data.status = ResponseStatus::NOT_MODIFIED;
+		response_data.filename = filename;
+		response_data.etag = etag;
+		response_data.last_modified = last_modified;
+		return HttpResponse(response_data);
+	}
+
 	// Client wants to see only the size of the requested file (not its content)
 	if (request.getMethod() == RequestMethod::HEAD)
 	{
-		return HttpResponse(ResponseStatus::OK, HttpUtils::getContentTypeByFilename(filename), file_size);
+		HttpResponse response(ResponseStatus::OK, HttpUtils::getContentTypeByFilename(filename), file_size);
+		response.insertHeader("ETag", etag);
+		if (last_modified.isValid()) response.insertHeader("Last-Modified", HttpUtils::convertDateTimeToHttpDate(last_modified));
+		return response;
 	}
 
 	// Random read functionality based on byte-range headers
@@ -180,6 +203,16 @@ HttpResponse ServerController::createStaticFileResponse(const QString& filename,
 					current_range.end = file_size - 1;
 				}
 
+				// The range end is limited to the file size, otherwise the announced content length would not match the data
+				if (current_range.start >= file_size)
+				{
+					return HttpResponse(ResponseStatus::RANGE_NOT_SATISFIABLE, request.getContentType(), EndpointManager::formatResponseMessage(request, "Range is outside the file boundary"));
+				}
+				if (current_range.end > (file_size-1))
+				{
+					current_range.end = file_size - 1;
+				}
+
 				if ((!is_start_set) && (!is_end_set))
                 {
                     return HttpResponse(ResponseStatus::RANGE_NOT_SATISFIABLE, request.getContentType(), EndpointManager::formatResponseMessage(request, "Range limits have not been specified"));
@@ -199,13 +232,15 @@ HttpResponse ServerController::createStaticFileResponse(const QString& filename,
         {
             return HttpResponse(ResponseStatus::RANGE_NOT_SATISFIABLE, request.getContentType(), EndpointManager::formatResponseMessage(request, "Overlapping ranges have been detected"));
 		}
+		// Adjacent ranges and small gaps are sent as one part (cheaper than the part headers, fewer seeks)
+		byte_ranges = HttpUtils::coalesceByteRanges(byte_ranges, MAX_COALESCED_RANGE_GAP);
 
 		return createStaticFileRangeResponse(filename, byte_ranges, HttpUtils::getContentTypeByFilename(filename), false);
 	}
 
 
 	// Stream the content of the entire file
-	return createStaticStreamResponse(filename, false);
+	return createStaticStreamResponse(filename, false, HttpUtils::acceptsGzip(request.getHeaderByName("Accept-Encoding")));
 }
 
 HttpResponse ServerController::serveResourceAsset(const HttpRequest& request)
@@ -1082,6 +1117,32 @@ HttpResponse ServerController::annotateVariant(const HttpRequest& request)
 }
 
 HttpResponse ServerController::calculateLowCoverage(const HttpRequest& request)
+{
+	return createCoverageJobResponse(request, CoverageJobType::LOW_COVERAGE);
+}
+
+HttpResponse ServerController::calculateAvgCoverage(const HttpRequest& request)
+{
+	return createCoverageJobResponse(request, CoverageJobType::AVG_COVERAGE);
+}
+
+HttpResponse ServerController::calculateTargetRegionReadDepth(const HttpRequest& request)
+{
+	return createCoverageJobResponse(request, CoverageJobType::READ_DEPTH);
+}
+
+HttpResponse ServerController::getCoverageJob(const HttpRequest& request)
+{
+	CoverageJob job = CoverageJobManager::job(request.getUrlParams()["id"]);
+	if (job.status==CoverageJobStatus::UNKNOWN)
+	{
+		return HttpResponse(ResponseStatus::NOT_FOUND, HttpUtils::detectErrorContentType(request.getHeaderByName("User-Agent")), EndpointManager::formatResponseMessage(request, "Coverage job not found: " + request.getUrlParams()["id"]));
+	}
+
+	return createCoverageJobStatusResponse(job);
+}
+
+HttpResponse ServerController::createCoverageJobResponse(const HttpRequest& request, CoverageJobType type)
 {
 	BedFile roi;
 	QString bam_file_name;
@@ -1095,100 +1156,97 @@ HttpResponse ServerController::calculateLowCoverage(const HttpRequest& request)
 	{
 		bam_file_name = UrlManager::getURLById(request.getFormUrlEncoded()["bam_url_id"]).filename_with_path;
 	}
+	if (request.getFormUrlEncoded().contains("cutoff"))
+	{
+		cutoff = request.getFormUrlEncoded()["cutoff"].toInt();
+	}
 
 	QSharedPointer<FastFileInfo> info = QSharedPointer<FastFileInfo>(new FastFileInfo(bam_file_name));
-    if (!info->exists())
-    {
-        return HttpResponse(ResponseStatus::NOT_FOUND, request.getContentType(), EndpointManager::formatResponseMessage(request, "BAM file does not exist: " + bam_file_name));
-    }
+	if (!info->exists())
+	{
+		return HttpResponse(ResponseStatus::NOT_FOUND, request.getContentType(), EndpointManager::formatResponseMessage(request, "BAM file does not exist: " + bam_file_name));
+	}
 
-	if (request.getFormUrlEncoded().contains("cutoff"))
+	QString job_id = CoverageJobManager::submit(type, roi, bam_file_name, cutoff);
+
+	// asynchronous requests get the job status and poll for the result
+	if (request.getFormUrlEncoded()["async"].toLower()=="true")
 	{
-		cutoff = request.getFormUrlEncoded()["cutoff"].toInt();
+		return createCoverageJobStatusResponse(CoverageJobManager::job(job_id));
 	}
 
-	int threads = Settings::integer("threads");
-	BedFile low_cov = Statistics::lowCoverage(roi, bam_file_name, cutoff, 1, 0, threads);
+	CoverageJob job = CoverageJobManager::waitForJob(job_id);
+	if (job.status!=CoverageJobStatus::FINISHED)
+	{
+		return HttpResponse(ResponseStatus::INTERNAL_SERVER_ERROR, request.getContentType(), EndpointManager::formatResponseMessage(request, "Coverage calculation failed: " + job.error));
+	}
+
+	BasicResponseData response_data;
+	response_data.length = job.result.length();
+	response_data.content_type = request.getContentType();
+	response_data.is_downloadable = false;
+	return HttpResponse(response_data, job.result);
+}
 
-	QByteArray body = low_cov.toText().toUtf8();
+HttpResponse ServerController::createCoverageJobStatusResponse(const CoverageJob& job)
+{
+	QJsonObject json_object;
+	json_object.insert("id", job.id);
+	json_object.insert("status", CoverageJobManager::statusToString(job.status));
+	if (job.status==CoverageJobStatus::FINISHED) json_object.insert("result", QString(job.result));
+	if (job.status==CoverageJobStatus::FAILED) json_object.insert("error", job.error);
 
+	QByteArray body = QJsonDocument(json_object).toJson();
 	BasicResponseData response_data;
 	response_data.length = body.length();
-	response_data.content_type = request.getContentType();
+	response_data.content_type = ContentType::APPLICATION_JSON;
 	response_data.is_downloadable = false;
 	return HttpResponse(response_data, body);
 }
 
-HttpResponse ServerController::calculateAvgCoverage(const HttpRequest& request)
+HttpResponse ServerController::queryRegion(const HttpRequest& request)
 {
-	BedFile roi;
-	QString bam_file_name;
+	QString filename = UrlManager::getURLById(request.getUrlParams()["id"]).filename_with_path;
+	if (filename.isEmpty())
+	{
+		return HttpResponse(ResponseStatus::NOT_FOUND, request.getContentType(), EndpointManager::formatResponseMessage(request, "Unknown file id: " + request.getUrlParams()["id"]));
+	}
 
-    if (request.getFormUrlEncoded().contains("roi"))
+	Chromosome chr;
+	int start;
+	int end;
+	int min_mapq = 1;
+	try
 	{
-        roi = roi.fromText(request.getFormUrlEncoded()["roi"].toUtf8());
+		NGSHelper::parseRegion(request.getUrlParams()["locus"], chr, start, end);
+		if (request.getUrlParams().contains("min_mapq")) min_mapq = Helper::toInt(request.getUrlParams()["min_mapq"].toUtf8(), "min_mapq");
 	}
-	if (request.getFormUrlEncoded().contains("bam_url_id"))
+	catch (Exception& e)
 	{
-		bam_file_name = UrlManager::getURLById(request.getFormUrlEncoded()["bam_url_id"]).filename_with_path;
+		return HttpResponse(ResponseStatus::BAD_REQUEST, request.getContentType(), EndpointManager::formatResponseMessage(request, "Invalid region query: " + e.message()));
 	}
 
-	QSharedPointer<FastFileInfo> info = QSharedPointer<FastFileInfo>(new FastFileInfo(bam_file_name));
-    if (!info->exists())
-    {
-        return HttpResponse(ResponseStatus::NOT_FOUND, request.getContentType(), EndpointManager::formatResponseMessage(request, "BAM file does not exist: " + bam_file_name));
-    }
-
-	int threads = Settings::integer("threads");
-	Statistics::avgCoverage(roi, bam_file_name, 1, threads);
-
-    QByteArray body = roi.toText().toUtf8();
-    BasicResponseData response_data;
-    response_data.length = body.length();
-    response_data.content_type = request.getContentType();
-    response_data.is_stream = (!body.isEmpty() ? true : false);
-    response_data.is_downloadable = false;
-
-    return HttpResponse(response_data, body);
-}
-
-HttpResponse ServerController::calculateTargetRegionReadDepth(const HttpRequest& request)
-{
-    BedFile roi;
-	QString bam_file_name;
-
-    if (request.getFormUrlEncoded().contains("roi"))
+	QByteArray result;
+	try
 	{
-        roi = roi.fromText(request.getFormUrlEncoded()["roi"].toUtf8());
+		result = RegionQueryManager::query(filename, chr, start, end, min_mapq);
 	}
-	if (request.getFormUrlEncoded().contains("bam_url_id"))
+	catch (ArgumentException& e)
 	{
-		bam_file_name = UrlManager::getURLById(request.getFormUrlEncoded()["bam_url_id"]).filename_with_path;
+		return HttpResponse(ResponseStatus::BAD_REQUEST, request.getContentType(), EndpointManager::formatResponseMessage(request, e.message()));
 	}
-
-	QSharedPointer<FastFileInfo> info = QSharedPointer<FastFileInfo>(new FastFileInfo(bam_file_name));
-    if (!info->exists())
-    {
-        return HttpResponse(ResponseStatus::NOT_FOUND, request.getContentType(), EndpointManager::formatResponseMessage(request, "BAM file does not exist: " + bam_file_name));
-    }
-
-	QString ref_file = Settings::string("reference_genome");
-    QCCollection stats = Statistics::mapping(roi, bam_file_name, ref_file);
-
-	for (int i=0; i<stats.count(); ++i)
+	catch (Exception& e)
 	{
-		if (stats[i].accession()=="QC:2000025")
-		{
-			QByteArray body = stats[i].toString().toUtf8();
-			BasicResponseData response_data;
-			response_data.length = body.length();
-			response_data.content_type = request.getContentType();
-			response_data.is_downloadable = false;
-			return HttpResponse(response_data, body);
-		}
+		Log::error(EndpointManager::formatResponseMessage(request, "Region query failed: " + e.message()));
+		return HttpResponse(ResponseStatus::INTERNAL_SERVER_ERROR, request.getContentType(), EndpointManager::formatResponseMessage(request, "Region query failed: " + e.message()));
 	}
 
-    return HttpResponse(ResponseStatus::INTERNAL_SERVER_ERROR, request.getContentType(), EndpointManager::formatResponseMessage(request, "Could not calculate target region read depth"));
+	// text results are gzip-compressed if the client accepts it (see RequestWorker)
+	BasicResponseData response_data;
+	response_data.length = result.length();
+	response_data.content_type = ContentType::TEXT_PLAIN;
+	response_data.is_downloadable = false;
+	return HttpResponse(response_data, result);
 }
 
 HttpResponse ServerController::getMultiSampleAnalysisInfo(const HttpRequest& request)
@@ -1536,7 +1594,7 @@ HttpResponse ServerController::getProcessingSystemRegions(const HttpRequest& req
     {
         return HttpResponse(ResponseStatus::NOT_FOUND, HttpUtils::detectErrorContentType(request.getHeaderByName("User-Agent")), EndpointManager::formatResponseMessage(request, "Processing system regions file has not been found"));
 	}
-	return createStaticStreamResponse(filename, false);
+	return createStaticStreamResponse(filename, false, HttpUtils::acceptsGzip(request.getHeaderByName("Accept-Encoding")));
 }
 
 HttpResponse ServerController::getProcessingSystemGenes(const HttpRequest& request)
@@ -1563,7 +1621,7 @@ HttpResponse ServerController::getProcessingSystemGenes(const HttpRequest& reque
     {
         return HttpResponse(ResponseStatus::NOT_FOUND, HttpUtils::detectErrorContentType(request.getHeaderByName("User-Agent")), EndpointManager::formatResponseMessage(request, "Processing system genes file has not been found"));
 	}
-	return createStaticStreamResponse(filename, false);
+	return createStaticStreamResponse(filename, false, HttpUtils::acceptsGzip(request.getHeaderByName("Accept-Encoding")));
 }
 
 HttpResponse ServerController::getSecondaryAnalyses(const HttpRequest& request)
@@ -1985,3 +2043,39 @@ HttpResponse ServerController::clearPermissionsCache(const HttpRequest &/*reques
 	db.clearUserCaches();
 	return HttpResponse(ResponseStatus::OK, ContentType::TEXT_PLAIN, "User role/permission/action cache has been cleared");
 }
+
+HttpResponse ServerController::getEndpointStatistics(const HttpRequest& request)
+{
+	QJsonDocument json_doc_output;
+	try
+	{
+		Session current_session = SessionManager::getSessionBySecureToken(EndpointManager::getTokenIfAvailable(request));
+		if (current_session.isEmpty()) THROW_HTTP(HttpException, "You are not logged in", 401,  {}, {});
+
+		// access is restricted only for the user role 'admin'
+		NGSD db;
+		QByteArray role = db.getUserRole(current_session.user_id);
+		if (role!="admin")
+		{
+			THROW_HTTP(HttpException, "You do not have permissions to see the endpoint statistics!", 403,  {}, {});
+		}
+	}
+	catch (DatabaseException& e)
+	{
+		Log::error("Database error while checking the permissions for the endpoint statistics: " + e.message());
+		THROW_HTTP(HttpException, e.message(), 500,  {}, {});
+	}
+
+	json_doc_output = EndpointMetrics::statisticsAsJson();
+	if (request.getUrlParams().contains("reset") && (request.getUrlParams()["reset"].toLower()=="true" || request.getUrlParams()["reset"]=="1"))
+	{
+		EndpointMetrics::clear();
+	}
+
+	BasicResponseData response_data;
+	response_data.length = json_doc_output.toJson().length();
+	response_data.content_type = ContentType::APPLICATION_JSON;
+	response_data.is_downloadable = false;
+
+	return HttpResponse(response_data, json_doc_output.toJson());
+}
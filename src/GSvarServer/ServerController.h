@@ -8,6 +8,7 @@
 #include "HttpRequest.h"
 #include "EndpointManager.h"
 #include "FastFileInfo.h"
+#include "CoverageJobManager.h"
 
 
 struct SampleMetadata
@@ -65,6 +66,10 @@ public:
 	static HttpResponse calculateAvgCoverage(const HttpRequest& request);
 	/// Calculates target region read depth used in germline report
     static HttpResponse calculateTargetRegionReadDepth(const HttpRequest& request);
+	/// Returns the status (and the result, if available) of a coverage calculation that has been started asynchronously
+	static HttpResponse getCoverageJob(const HttpRequest& request);
+	/// Returns the data of a file for a genomic region (lines of tabix-indexed files, pileup of BAM/CRAM files, intervals of bigWig files)
+	static HttpResponse queryRegion(const HttpRequest& request);
 	/// Creates a list of analysis names for multi-samples
 	static HttpResponse getMultiSampleAnalysisInfo(const HttpRequest& request);
 	/// Requests a secure token that is needed for the communication with the server
@@ -107,8 +112,12 @@ public:
 
 	/// Removes the cache for user permissions
 	static HttpResponse clearPermissionsCache(const HttpRequest& request);
+	/// Returns request counts, transferred bytes and latencies of all endpoints (only for admins)
+	static HttpResponse getEndpointStatistics(const HttpRequest& request);
 
 private:
+	static const quint64 MAX_COALESCED_RANGE_GAP = 128; // byte ranges separated by smaller gaps are merged (size of the multipart part headers)
+
 	/// Find file/folder name corresponding to the id from a temporary URL
 	static QString findPathForTempUrl(QList<QString> path_parts);
 	/// Find file/folder name corresponding to the server root data
@@ -128,11 +137,14 @@ private:
 
 	/// Serves a file for a byte range request (i.e. specific fragment of a file)
 	static HttpResponse createStaticFileRangeResponse(const QString& filename, const QList<ByteRange>& byte_ranges, const ContentType& type, bool is_downloadable);
-	/// Serves a stream, used to transfer large files without opening multiple connections
-	static HttpResponse createStaticStreamResponse(const QString& filename, bool is_downloadable);
+	/// Serves a stream, used to transfer large files without opening multiple connections. Text files are gzip-compressed on the fly if compression is allowed (i.e. accepted by the client)
+	static HttpResponse createStaticStreamResponse(const QString& filename, bool is_downloadable, bool allow_compression = false);
     static HttpResponse createStaticFileResponse(const QString& filename, const HttpRequest& request);
 	static HttpResponse createStaticFolderResponse(const QString path, const HttpRequest& request);
 	static HttpResponse createStaticLocationResponse(const QString path, const HttpRequest& request);
+	/// Starts a coverage calculation (or reuses a running/cached one). Returns the result or the job status for asynchronous requests.
+	static HttpResponse createCoverageJobResponse(const HttpRequest& request, CoverageJobType type);
+	static HttpResponse createCoverageJobStatusResponse(const CoverageJob& job);
 };
 
 #endif // SERVERCONTROLLER_H
@@ -6,6 +6,8 @@
 #include "SessionManager.h"
 #include "UrlManager.h"
 #include "FileMetaCache.h"
+#include "CoverageJobManager.h"
+#include "RegionQueryManager.h"
 #include "PipelineSettings.h"
 
 ServerWrapper::ServerWrapper(const quint16& port)
@@ -277,6 +279,8 @@ void ServerWrapper::cleanupSessionsAndUrls()
 		SessionManager::removeExpiredSessions();
 		UrlManager::removeExpiredUrls();
 		FileMetaCache::removeExpiredMetadata();
+		CoverageJobManager::removeExpiredJobs();
+		RegionQueryManager::removeExpiredFiles();
 
 		SessionAndUrlBackupWorker *backup_worker = new SessionAndUrlBackupWorker(SessionManager::getAllSessions(), UrlManager::getAllUrls());
 		cleanup_pool_.start(backup_worker);
@@ -396,6 +396,7 @@ int main(int argc, char **argv)
 							{"roi", ParamProps{ParamProps::ParamCategory::POST_FORM_DATA, true, "Regions of interest"}},
 							{"bam_url_id", ParamProps{ParamProps::ParamCategory::POST_FORM_DATA, true, "An id of a temporary URL pointing to a BAM file"}},
 							{"cutoff", ParamProps{ParamProps::ParamCategory::POST_FORM_DATA, true, "Cutoff value"}},
+							{"async", ParamProps{ParamProps::ParamCategory::POST_FORM_DATA, true, "If 'true', the job status is returned immediately (see coverage_job)"}},
 							{"token", ParamProps{ParamProps::ParamCategory::ANY, false, "Secure token received after a successful login"}}
 						},
 						RequestMethod::POST,
@@ -409,6 +410,7 @@ int main(int argc, char **argv)
 						QMap<QString, ParamProps>{
                             {"roi", ParamProps{ParamProps::ParamCategory::POST_FORM_DATA, true, "Regions of interest"}},
 							{"bam_url_id", ParamProps{ParamProps::ParamCategory::POST_FORM_DATA, true, "An id of a temporary URL pointing to a BAM file"}},
+							{"async", ParamProps{ParamProps::ParamCategory::POST_FORM_DATA, true, "If 'true', the job status is returned immediately (see coverage_job)"}},
 							{"token", ParamProps{ParamProps::ParamCategory::ANY, false, "Secure token received after a successful login"}}
 						},
 						RequestMethod::POST,
@@ -422,6 +424,7 @@ int main(int argc, char **argv)
 						QMap<QString, ParamProps>{
                             {"roi", ParamProps{ParamProps::ParamCategory::POST_FORM_DATA, true, "Regions of interest"}},
 							{"bam_url_id", ParamProps{ParamProps::ParamCategory::POST_FORM_DATA, true, "An id of a temporary URL pointing to a BAM file"}},
+							{"async", ParamProps{ParamProps::ParamCategory::POST_FORM_DATA, true, "If 'true', the job status is returned immediately (see coverage_job)"}},
 							{"token", ParamProps{ParamProps::ParamCategory::ANY, false, "Secure token received after a successful login"}}
 						},
 						RequestMethod::POST,
@@ -430,6 +433,33 @@ int main(int argc, char **argv)
 						"Calculates target region read depth used in germline report",
 						&ServerController::calculateTargetRegionReadDepth
 					});
+	EndpointManager::appendEndpoint(Endpoint{
+						"coverage_job",
+						QMap<QString, ParamProps>{
+							{"id", ParamProps{ParamProps::ParamCategory::GET_URL_PARAM, false, "Id of the coverage calculation"}},
+							{"token", ParamProps{ParamProps::ParamCategory::ANY, false, "Secure token received after a successful login"}}
+						},
+						RequestMethod::GET,
+						ContentType::APPLICATION_JSON,
+						AuthType::USER_TOKEN,
+						"Status and result of a coverage calculation (low coverage regions, average coverage, target region read depth)",
+						&ServerController::getCoverageJob
+					});
+
+	EndpointManager::appendEndpoint(Endpoint{
+						"region_query",
+						QMap<QString, ParamProps>{
+							{"id", ParamProps{ParamProps::ParamCategory::GET_URL_PARAM, false, "An id of a temporary URL pointing to a tabix-indexed file (*.gz), a BAM/CRAM file or a bigWig file"}},
+							{"locus", ParamProps{ParamProps::ParamCategory::GET_URL_PARAM, false, "Genomic region, e.g. chr1:11013718-11013975 (1-based)"}},
+							{"min_mapq", ParamProps{ParamProps::ParamCategory::GET_URL_PARAM, true, "Minimum mapping quality of reads (BAM/CRAM files only, default is 1)"}},
+							{"token", ParamProps{ParamProps::ParamCategory::ANY, false, "Secure token received after a successful login"}}
+						},
+						RequestMethod::GET,
+						ContentType::TEXT_PLAIN,
+						AuthType::USER_TOKEN,
+						"Data of a file for a genomic region: overlapping lines of tabix-indexed files, pileup of BAM/CRAM files (max. 10kb), bedGraph intervals of bigWig files",
+						&ServerController::queryRegion
+					});
 
 	EndpointManager::appendEndpoint(Endpoint{
 						"multi_sample_analysis_info",
@@ -470,6 +500,19 @@ int main(int argc, char **argv)
 						&ServerController::clearPermissionsCache
 					});
 
+	EndpointManager::appendEndpoint(Endpoint{
+						"endpoint_statistics",
+						QMap<QString, ParamProps>{
+							{"token", ParamProps{ParamProps::ParamCategory::ANY, false, "Secure token received after a successful login"}},
+							{"reset", ParamProps{ParamProps::ParamCategory::GET_URL_PARAM, true, "If 'true', the statistics are reset after they have been returned"}}
+						},
+						RequestMethod::GET,
+						ContentType::APPLICATION_JSON,
+						AuthType::USER_TOKEN,
+						"Request counts, transferred bytes and latencies per endpoint (admin only)",
+						&ServerController::getEndpointStatistics
+					});
+
 	EndpointManager::appendEndpoint(Endpoint{
 						"variant_annotation",
 						QMap<QString, ParamProps>{							
@@ -1,5 +1,5 @@
 #include "ToolBase.h"
-#include "Graph.h"
+#include "CompactGraph.h"
 #include "Helper.h"
 #include <cmath>
 #include <QTextStream>
@@ -7,34 +7,8 @@
 #include <QString>
 #include <QStringList>
 #include <QList>
-#include <QListIterator>
 #include <QHash>
 #include <QSharedPointer>
-#include <random>
-
-struct NodeContent
-{
-    double score;
-    double score_change;
-    int visit_count;
-
-    NodeContent()
-        : score(0.0),
-          score_change(0.0),
-          visit_count(0)
-    {
-    }
-};
-
-struct EdgeContent
-{
-    double weight;
-
-    EdgeContent()
-        : weight(0.0)
-    {
-    }
-};
 
 class ConcreteTool
         : public ToolBase
@@ -43,32 +17,36 @@ class ConcreteTool
 
 private:
     QList<QString> starting_nodes_;
+    QVector<double> scores_;
 
-    void sortGenesByScore(QList<Graph<NodeContent, EdgeContent>::NodePointer>& node_list)
+    QList<int> sortGenesByScore(const CompactGraph& graph)
     {
         // round score for each node to 6 decimal places
-        Graph<NodeContent, EdgeContent>::NodePointer node;
-        foreach(node, node_list)
+        QList<int> node_list;
+        for(int node = 0; node < graph.nodeCount(); node++)
         {
-            node.data()->nodeContent().score = round(node.data()->nodeContent().score * 1e6) / 1e6;
+            scores_[node] = round(scores_[node] * 1e6) / 1e6;
+            node_list.append(node);
         }
 
         std::sort(node_list.begin(), node_list.end(),\
-                  [](const Graph<NodeContent, EdgeContent>::NodePointer& a, const Graph<NodeContent, EdgeContent>::NodePointer& b)\
+                  [&](int a, int b)\
                   {
-            if(a.data()->nodeContent().score == b.data()->nodeContent().score)
+            if(scores_[a] == scores_[b])
             {
-                return a.data()->nodeName() < b.data()->nodeName();
+                return graph.name(a) < graph.name(b);
             }
-            return a.data()->nodeContent().score > b.data()->nodeContent().score;});
+            return scores_[a] > scores_[b];});
+
+        return node_list;
     }
 
-    double getStartGenesAtTop(QList<Graph<NodeContent, EdgeContent>::NodePointer>& node_list)
+    double getStartGenesAtTop(const CompactGraph& graph, const QList<int>& node_list)
     {
         int counter{0};
         for(int i = 0; i < starting_nodes_.size(); i++)
         {
-            if(starting_nodes_.contains(node_list.at(i).data()->nodeName()))
+            if(starting_nodes_.contains(graph.name(node_list.at(i))))
             {
                 counter++;
             }
@@ -76,23 +54,24 @@ private:
         return (double) counter / starting_nodes_.size();
     }
 
-    double getAverageRankDifference(const QHash<QString, int>& previous_ranks, const QHash<QString, int>& current_ranks)
+    double getAverageRankDifference(const QVector<int>& previous_ranks, const QVector<int>& current_ranks)
     {
         double average_rank_diff{0.0};
-        QHashIterator<QString, int> it(current_ranks);
-        while(it.hasNext())
+        for(int node = 0; node < current_ranks.size(); node++)
         {
-            it.next();
-            average_rank_diff += abs((it.value() - previous_ranks[it.key()]));
+            average_rank_diff += abs(current_ranks[node] - previous_ranks[node]);
         }
         return average_rank_diff / current_ranks.size();
     }
 
-    Graph<NodeContent, EdgeContent>::NodePointer updateProbability(int steps, const Graph<NodeContent, EdgeContent>::NodePointer& node)
+    QVector<int> getRanks(const CompactGraph& graph, const QList<int>& node_list)
     {
-        node.data()->nodeContent().score = node.data()->nodeContent().score_change;
-        node.data()->nodeContent().score_change = (double) node.data()->nodeContent().visit_count / steps;
-        return node;
+        QVector<int> ranks(graph.nodeCount());
+        for(int i = 0; i < node_list.length(); i++)
+        {
+            ranks[node_list.at(i)] = i+1;
+        }
+        return ranks;
     }
 
 public:
@@ -105,41 +84,22 @@ public:
     {
 		setDescription("Performs gene prioritization based on list of known disease genes of a disease and a PPI graph.");
 		addInfile("in", "Input TSV file with one gene identifier per line (known disease genes of a disease).", false);
-		addInfile("graph", "Graph TSV file with two gene identifiers per line (PPI graph).", false);
+		addInfile("graph", "Graph TSV file with two gene identifiers per line (PPI graph), or binary graph file created by GraphStringDb.", false);
 		addOutfile("out", "Output TSV file containing prioritized genes for the disease.", false);
         //optional
 		addEnum("method", "Gene prioritization method to use.", true, QStringList() << "flooding" << "random_walk", "flooding");
 		addInt("n", "Number of network diffusion iterations (flooding).", true, 2);
 		addFloat("restart", "Restart probability (random_walk).", true, 0.4);
+		addInt("threads", "Number of threads used for network propagation.", true, 1);
 		addOutfile("debug", "Output TSV file for debugging", true);
-    }
-
-    Graph<NodeContent, EdgeContent> parseGraph(const QString& graph_file)
-    {
-
-        Graph<NodeContent, EdgeContent> graph;
 
-        QSharedPointer<QFile> reader = Helper::openFileForReading(graph_file);
-        QTextStream in(reader.data());
-
-        while(!in.atEnd())
-        {
-            QStringList line = in.readLine().split("\t", Qt::SkipEmptyParts);
-            if(line.size() == 2)
-            {
-                NodeContent node_content_1{};
-                NodeContent node_content_2{};
-                EdgeContent edge_content{};
-                edge_content.weight = 1.0;
-                graph.addEdge(line.at(0), node_content_1,\
-                              line.at(1), node_content_2, edge_content);
-            }
-        }
-        return graph;
+		changeLog(2026, 10, 19, "Graph is stored in compressed sparse row format and network propagation is performed as parallel sparse matrix-vector product. Random walk scores are calculated from the stationary distribution instead of a simulation.");
     }
 
-    void scoreDiseaseGenes(Graph<NodeContent, EdgeContent>& graph, QString disease_genes_file)
+    void scoreDiseaseGenes(const CompactGraph& graph, QString disease_genes_file)
     {
+        scores_.fill(0.0, graph.nodeCount());
+
         QFile file(disease_genes_file);
 
         if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
@@ -149,27 +109,28 @@ public:
 
         QTextStream in(&file);
 
-        // read file line by line, changing node content of the disease genes
+        // read file line by line, changing score of the disease genes
         while(!in.atEnd())
         {
             QStringList line = in.readLine().split("\t", Qt::SkipEmptyParts);
 
-            if(graph.hasNode(line.at(0)))
+            int node = graph.index(line.at(0));
+            if(node != -1)
             {
-                graph.getNode(line.at(0)).data()->nodeContent().score = 1.0;
+                scores_[node] = 1.0;
                 starting_nodes_.append(line.at(0));
             }
         }
     }
 
-    void performFlooding(Graph<NodeContent, EdgeContent>& graph, int n_iter, const QString& debug_file)
+    void performFlooding(const CompactGraph& graph, int n_iter, int threads, const QString& debug_file)
     {
         bool debug = (debug_file != "");
 
         QSharedPointer<QFile> writer;
         QTextStream stream;
 
-        QHash<QString, int> previous_ranks;
+        QVector<int> previous_ranks;
 
         // generate debug file with information about rank differences between iterations
         if(debug)
@@ -179,160 +140,107 @@ public:
 
             stream << "iteration\taverage_rank_change\tstart_at_top" << Qt::endl;
 
-            QList<Graph<NodeContent, EdgeContent>::NodePointer> node_list = graph.adjacencyList().keys();
-            sortGenesByScore(node_list);
-            for(int i = 0; i < node_list.length(); i++)
-            {
-                previous_ranks.insert(node_list.at(i).data()->nodeName(), i+1);
-            }
+            QList<int> node_list = sortGenesByScore(graph);
+            previous_ranks = getRanks(graph, node_list);
 
-            stream << 0 << "\tNaN\t" << getStartGenesAtTop(node_list) << Qt::endl;
+            stream << 0 << "\tNaN\t" << getStartGenesAtTop(graph, node_list) << Qt::endl;
         }
 
         // perform flooding algorithm
+        QVector<double> propagated(graph.nodeCount());
+        QVector<double> score_change;
         for(int i = 0; i < n_iter; i++)
         {
-            Graph<NodeContent, EdgeContent>::NodePointer node;
-            foreach(node, graph.adjacencyList().keys())
+            // propagate the score of each node to all adjacent nodes, relative to node degree
+            for(int node = 0; node < graph.nodeCount(); node++)
             {
-                double node_score = node.data()->nodeContent().score;
-
-                if(node_score != 0.0)
-                {
-                    QList<Graph<NodeContent, EdgeContent>::EdgePointer> adjacent_edges = graph.adjacencyList()[node];
-                    Graph<NodeContent, EdgeContent>::EdgePointer edge;
-
-                    int degree = graph.getDegree(node.data()->nodeName());
-
-                    // propagate the score to all adjacent nodes, relative to node degree
-                    foreach(edge, adjacent_edges)
-                    {
-                        double increment = node_score / degree;
-
-                        if(edge.data()->node1() == node)
-                        {
-                            edge.data()->node2().data()->nodeContent().score_change += increment;
-                        }
-                        else if(edge.data()->node2() == node)
-                        {
-                            edge.data()->node1().data()->nodeContent().score_change += increment;
-                        }
-                    }
-
-                    // add the value that was propagated to surrounding nodes to the node itself
-                    // node.data()->nodeContent().score_increment += node_score;
-                }
+                propagated[node] = scores_[node] / graph.degree(node);
             }
+            graph.multiply(propagated, score_change, threads);
 
-            // add the score increment to the node scores, relative to target node degree; reset increments
-            foreach (node, graph.adjacencyList().keys())
+            // add the score increment to the node scores, relative to target node degree
+            for(int node = 0; node < graph.nodeCount(); node++)
             {
-                node.data()->nodeContent().score += node.data()->nodeContent().score_change / sqrt(graph.getDegree(node.data()->nodeName()));
-                node.data()->nodeContent().score_change = 0.0;
+                scores_[node] += score_change[node] / sqrt(graph.degree(node));
             }
 
             // write average rank difference to debug file
             if(debug)
             {
-                QList<Graph<NodeContent, EdgeContent>::NodePointer> node_list = graph.adjacencyList().keys();
-                sortGenesByScore(node_list);
-                QHash<QString, int> current_ranks;
-                for(int j = 0; j < node_list.length(); j++)
-                {
-                    current_ranks.insert(node_list.at(j).data()->nodeName(), j+1);
-                }
+                QList<int> node_list = sortGenesByScore(graph);
+                QVector<int> current_ranks = getRanks(graph, node_list);
 
                 stream << i+1 << "\t" << getAverageRankDifference(current_ranks, previous_ranks) \
-                       << "\t" << getStartGenesAtTop(node_list) << Qt::endl;
+                       << "\t" << getStartGenesAtTop(graph, node_list) << Qt::endl;
                 previous_ranks = current_ranks;
             }
         }
     }
 
-	void randomWalk(Graph<NodeContent, EdgeContent>& graph, double restart_probability, const QString& debug_file, int max_steps = 1000000)
+	void randomWalk(const CompactGraph& graph, double restart_probability, int threads, const QString& debug_file, int max_iterations = 1000)
     {
-		std::default_random_engine generator;
-        std::uniform_real_distribution<double> restart_distrib(0.0,1.0);
-
-        std::uniform_int_distribution<int> start_nodes_distrib(0, starting_nodes_.size() - 1);
-
-        Graph<NodeContent, EdgeContent>::NodePointer current_node = graph.getNode(starting_nodes_.at(start_nodes_distrib(generator)));
-        current_node.data()->nodeContent().visit_count++;
-        current_node.data()->nodeContent().score_change = current_node.data()->nodeContent().visit_count;
+        if(starting_nodes_.isEmpty())
+        {
+            THROW(ArgumentException, "None of the disease genes is contained in the graph!");
+        }
 
-        int steps{1};
-        double vector_diff{1.0};
-        int update_frequency{50000};
+        // restart distribution: uniform over the disease genes
+        QVector<double> restart(graph.nodeCount(), 0.0);
+        foreach(const QString& name, starting_nodes_)
+        {
+            restart[graph.index(name)] += 1.0 / starting_nodes_.size();
+        }
 
         bool debug = (debug_file != "");
 
         QSharedPointer<QFile> writer;
         QTextStream stream;
 
-        // generate debug file with information about difference between probability vectors at each step
+        // generate debug file with information about difference between probability vectors at each iteration
         if(debug)
         {
             writer = Helper::openFileForWriting(debug_file);
             stream.setDevice(writer.data());
 
-            stream << "step\tprobability_diff_norm" << Qt::endl;
-            stream << steps << "\tNaN" << Qt::endl;
+            stream << "iteration\tprobability_diff_norm" << Qt::endl;
         }
 
-        QTextStream out(stdout);
-
-        do
+        // power iteration: visiting probability of the walk after each step, until the stationary distribution is reached
+        QVector<double> probability = restart;
+        QVector<double> propagated(graph.nodeCount());
+        QVector<double> next;
+        double vector_diff{1.0};
+        for(int i = 1; i <= max_iterations && vector_diff > 1.0e-12; i++)
         {
-            steps++;
-
-            if(restart_distrib(generator) < restart_probability)
+            for(int node = 0; node < graph.nodeCount(); node++)
             {
-                current_node = graph.getNode(starting_nodes_.at(start_nodes_distrib(generator)));
+                propagated[node] = probability[node] / graph.degree(node);
             }
-            else
-            {
-                QList<Graph<NodeContent, EdgeContent>::NodePointer> adjacent_nodes = graph.getAdjacentNodes(current_node.data()->nodeName());
-                std::uniform_int_distribution<int> adjacency_distrib(0, adjacent_nodes.size() - 1);
-                current_node = adjacent_nodes.at(adjacency_distrib(generator));
-            }
-            current_node.data()->nodeContent().visit_count++;
+            graph.multiply(propagated, next, threads);
 
             // update probabilities and calculate vector difference (L1 norm)
-
-            if(steps % update_frequency == 0)
+            vector_diff = 0.0;
+            for(int node = 0; node < graph.nodeCount(); node++)
             {
-                vector_diff = 0.0;
-
-                QListIterator<Graph<NodeContent, EdgeContent>::NodePointer> iter(graph.adjacencyList().keys());
-                while(iter.hasNext())
-                {
-                    Graph<NodeContent, EdgeContent>::NodePointer node = iter.next();
-                    node.data()->nodeContent().score = node.data()->nodeContent().score_change;
-                    node.data()->nodeContent().score_change = (double) node.data()->nodeContent().visit_count / steps;
-                    vector_diff += fabs(node.data()->nodeContent().score_change - node.data()->nodeContent().score);
-                }
-
-                vector_diff /= update_frequency;
-
-                if(debug)
-                {
-                    stream << steps << "\t" << vector_diff << Qt::endl;
-                    out << steps << "\t" << vector_diff << Qt::endl;
-                }
+                next[node] = (1.0 - restart_probability) * next[node] + restart_probability * restart[node];
+                vector_diff += fabs(next[node] - probability[node]);
             }
+            probability.swap(next);
 
-        } while((vector_diff > 1.0e-6) && (steps < max_steps));
+            if(debug)
+            {
+                stream << i << "\t" << vector_diff << Qt::endl;
+            }
+        }
 
-        // obtain final score with penalization of high degrees
-        QListIterator<Graph<NodeContent, EdgeContent>::NodePointer> iter(graph.adjacencyList().keys());
-        while(iter.hasNext())
+        // obtain final score (expected number of visits in 100,000 steps) with penalization of high degrees
+        for(int node = 0; node < graph.nodeCount(); node++)
         {
-            Graph<NodeContent, EdgeContent>::NodePointer node = iter.next();
-            node.data()->nodeContent().score = node.data()->nodeContent().visit_count / sqrt(graph.getDegree(node.data()->nodeName()));
+            scores_[node] = probability[node] * 1e5 / sqrt(graph.degree(node));
         }
     }
 
-    void writeOutputTsv(Graph<NodeContent, EdgeContent>& graph, QString out_file)
+    void writeOutputTsv(const CompactGraph& graph, QString out_file)
     {
         // output all nodes that have a score unequal zero to the output file
         QSharedPointer<QFile> writer = Helper::openFileForWriting(out_file);
@@ -340,15 +248,13 @@ public:
 
         stream << "node\tscore\tstarting_node\tdegree" << Qt::endl;
 
-        QList<Graph<NodeContent, EdgeContent>::NodePointer> node_list = graph.adjacencyList().keys();
-        sortGenesByScore(node_list);
+        QList<int> node_list = sortGenesByScore(graph);
 
-        Graph<NodeContent, EdgeContent>::NodePointer node;
-        foreach(node, node_list)
+        foreach(int node, node_list)
         {
-            stream << node.data()->nodeName() << "\t" << node.data()->nodeContent().score\
-                   << "\t" << starting_nodes_.contains(node.data()->nodeName()) \
-                   << "\t" << graph.getDegree(node.data()->nodeName()) << Qt::endl;
+            stream << graph.name(node) << "\t" << scores_[node]\
+                   << "\t" << starting_nodes_.contains(graph.name(node)) \
+                   << "\t" << graph.degree(node) << Qt::endl;
         }
     }
 
@@ -356,17 +262,18 @@ public:
     {
         // init
         QString method = getEnum("method");
-        Graph<NodeContent, EdgeContent> interaction_network = parseGraph(getInfile("graph"));
+        int threads = getInt("threads");
+        CompactGraph interaction_network = CompactGraph::load(getInfile("graph"));
 
         scoreDiseaseGenes(interaction_network, getInfile("in"));
 
 		if(method == "random_walk")
         {
-			randomWalk(interaction_network, getFloat("restart"), getOutfile("debug"));
+			randomWalk(interaction_network, getFloat("restart"), threads, getOutfile("debug"));
         }
         else if(method == "flooding")
         {
-            performFlooding(interaction_network, getInt("n"), getOutfile("debug"));
+            performFlooding(interaction_network, getInt("n"), threads, getOutfile("debug"));
         }
 
         writeOutputTsv(interaction_network, getOutfile("out"));
@@ -380,4 +287,3 @@ int main(int argc, char *argv[])
 	ConcreteTool tool(argc, argv);
     return tool.execute();
 }
-
@@ -1,6 +1,7 @@
 #include "ToolBase.h"
 #include "Graph.h"
 #include "StringDbParser.h"
+#include "CompactGraph.h"
 
 struct NodeContent
 {
@@ -43,6 +44,9 @@ public:
 		addOutfile("out", "Output TSV file with edges.", false);
         //optional
 		addFloat("min_score", "Minimum confidence score cutoff for String-DB interaction (0-1).", true, 0.4);
+		addOutfile("out_bin", "Output binary graph file (compressed sparse row format), which is loaded much faster than the TSV file by GenePrioritization.", true);
+
+		changeLog(2026, 10, 19, "Added parameter 'out_bin' for binary graph output.");
     }
 
     virtual void main()
@@ -52,6 +56,13 @@ public:
         Graph<NodeContent, EdgeContent> interaction_network = string_parser.interactionNetwork();
 
         interaction_network.store(getOutfile("out"));
+
+        // binary graph (created from the TSV file to make sure both contain the same graph)
+        QString out_bin = getOutfile("out_bin");
+        if(out_bin != "")
+        {
+            CompactGraph::load(getOutfile("out")).storeBinary(out_bin);
+        }
     }
 };
 
@@ -30,10 +30,12 @@ public:
 		addFlag("force", "Force import of small variants (they are skipped, if the same callset is already in NGSD).");
 		addOutfile("out", "Output file. If unset, writes to STDOUT.", true);
 		addFloat("max_af", "Maximum allele frequency of small variants to import (gnomAD).", true, 0.05);
+		addInt("batch_size", "Number of small variants per multi-row database statement. Use 0 to import variants one by one.", true, 500);
 		addFlag("test", "Uses the test database instead of on the production database.");
 		addFlag("debug", "Enable verbose debug output.");
 		addFlag("no_time", "Disable timing output.");
 
+		changeLog(2026, 10, 19, "Added batched import of small variants using multi-row statements (parameter 'batch_size').");
 		changeLog(2025, 11, 18, "No longer import entire variant consequence. Now imports only gene name, transcript ID, variant type and impact.");
 		changeLog(2025,  7, 14, "Changed behaviour of 'force' parameter (affects only small variants if callset was already imported now).");
 		changeLog(2024,  8, 28, "Merged all force parameters into one. Implmented skipping of small variants import if the same callset was already imported.");
@@ -81,9 +83,19 @@ public:
 		sub_timer.start();
 		int c_add, c_update;
 		double max_af = getFloat("max_af");
-		QList<int> variant_ids = db.addVariants(variants, max_af, c_add, c_update);
+		int batch_size = getInt("batch_size");
+		if (batch_size<0) THROW(ArgumentException, "Parameter 'batch_size' must not be negative!");
+		QStringList batch_times;
+		QList<int> variant_ids = batch_size>0 ? db.addVariantsBatched(variants, max_af, c_add, c_update, batch_size, &batch_times) : db.addVariants(variants, max_af, c_add, c_update);
         out << "Imported variants (added:" << c_add << " updated:" << c_update << ")" << Qt::endl;
 		sub_times << ("adding variants took: " + Helper::elapsedTime(sub_timer));
+		if (debug)
+		{
+			foreach(QString line, batch_times)
+			{
+				sub_times << ("  " + line);
+			}
+		}
 
 		//skip import of detected variants if same callset was already imported
 		QByteArray caller = variants.caller();
@@ -160,22 +172,58 @@ public:
 		//add detected variants
 		sub_timer.start();
 		int i_geno = variants.getSampleHeader().infoByID(ps_name).column_index;
-		SqlQuery q_insert = db.getQuery();
-		q_insert.prepare("INSERT INTO detected_variant (processed_sample_id, variant_id, genotype, mosaic) VALUES (" + ps_id + ", :0, :1, :2)");
 		db.transaction();
-		for (int i=0; i<variants.count(); ++i)
+		try
 		{
-			//skip high-AF variants or too long variants
-			int variant_id = variant_ids[i];
-			if (variant_id==-1) continue;
-
-			//bind
-			q_insert.bindValue(0, variant_id);
-			q_insert.bindValue(1, variants[i].annotations()[i_geno]);
-			q_insert.bindValue(2, variants[i].filters().contains("mosaic"));
-			q_insert.exec();
+			if (batch_size>0)
+			{
+				//multi-row inserts (genotype and mosaic flag are not user input, thus the values can be inlined)
+				QStringList values;
+				for (int i=0; i<variants.count(); ++i)
+				{
+					//skip high-AF variants or too long variants
+					int variant_id = variant_ids[i];
+					if (variant_id==-1) continue;
+
+					QByteArray genotype = variants[i].annotations()[i_geno];
+					if (genotype!="het" && genotype!="hom") THROW(FileParseException, "Invalid genotype '" + genotype + "' of variant " + variants[i].toString());
+					values << "(" + ps_id + "," + QString::number(variant_id) + ",'" + genotype + "'," + (variants[i].filters().contains("mosaic") ? "1" : "0") + ")";
+
+					if (values.count()>=batch_size)
+					{
+						db.getQuery().exec("INSERT INTO detected_variant (processed_sample_id, variant_id, genotype, mosaic) VALUES " + values.join(","));
+						values.clear();
+					}
+				}
+				if (!values.isEmpty())
+				{
+					db.getQuery().exec("INSERT INTO detected_variant (processed_sample_id, variant_id, genotype, mosaic) VALUES " + values.join(","));
+				}
+			}
+			else
+			{
+				SqlQuery q_insert = db.getQuery();
+				q_insert.prepare("INSERT INTO detected_variant (processed_sample_id, variant_id, genotype, mosaic) VALUES (" + ps_id + ", :0, :1, :2)");
+				for (int i=0; i<variants.count(); ++i)
+				{
+					//skip high-AF variants or too long variants
+					int variant_id = variant_ids[i];
+					if (variant_id==-1) continue;
+
+					//bind
+					q_insert.bindValue(0, variant_id);
+					q_insert.bindValue(1, variants[i].annotations()[i_geno]);
+					q_insert.bindValue(2, variants[i].filters().contains("mosaic"));
+					q_insert.exec();
+				}
+			}
+			db.commit();
+		}
+		catch(...)
+		{
+			db.rollback();
+			throw;
 		}
-		db.commit();
 		sub_times << ("adding detected variants took: " + Helper::elapsedTime(sub_timer));
 
 		//output
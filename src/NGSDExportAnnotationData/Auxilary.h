@@ -19,6 +19,9 @@ struct ExportParameters
 	//germline paramters
 	QString germline;
 	double max_af;
+	QString germline_previous; //previous germline export used as basis of a delta export
+	QString germline_state; //sample state file of the germline export
+	QString germline_previous_state; //sample state file of the previous germline export
 
 	//somatic parameters
 	QString somatic;
@@ -52,6 +55,14 @@ struct ClassificationData
 	QByteArray comment = "";
 };
 
+//Helper struct for the state of a processed sample at the time of a germline export (used to determine what changed since the export)
+struct SampleState
+{
+	QByteArray attributes; //tab-separated sample attributes relevant for the NGSD counts (sample ID, quality, affected status, disease group, same-patient samples)
+	long long variant_count = 0; //number of detected variants
+	long long variant_id_sum = 0; //sum of the detected variant IDs (used as checksum)
+};
+
 //Data cached from NGSD to speed up processing
 struct SharedData
 {
@@ -59,6 +70,15 @@ struct SharedData
 	QHash<int, ProcessedSampleInfo> ps_infos; //Sample data cached from NGSD to speed up processing
 	QHash<int, ClassificationData> class_infos; //Classification data cached from NGSD to speed up processing
 	QSet<int> somatic_variant_ids; //variant ids of somatic variants (looking them up once is faster then a join between 'variant' and 'detected_somatic_variant'
+
+	//germline export watermark
+	int max_variant_id = 0; //maximum variant ID exported (variants imported while this tool is running are ignored)
+	QHash<int, SampleState> sample_states; //processed sample states (only if a sample state file is written)
+
+	//germline delta export
+	bool germline_delta = false; //if the previous export is used as basis of the export
+	int previous_max_variant_id = 0; //maximum variant ID of the previous export
+	QSet<int> recount_variant_ids; //variants of the previous export for which the NGSD counts have to be re-calculated
 };
 
 //Returns a formatted time string from a given time in milliseconds
@@ -43,6 +43,11 @@ void ExportWorker::run()
 			double ngsd_count_update = 0;
 			long long vcf_lines_written = 0;
 
+			//delta export: open previous export of this chromosome (sorted like the variant query below)
+			QSharedPointer<QFile> previous_file;
+			if (shared_data_.germline_delta) previous_file = Helper::openFileForReading(params_.tempVcf(chr_, "germline_previous"));
+			long long vcf_lines_reused = 0;
+
 			//prepare queries
 			SqlQuery ngsd_count_query = db.getQuery();
 			ngsd_count_query.prepare("SELECT processed_sample_id, genotype, mosaic FROM detected_variant WHERE variant_id=:0");
@@ -54,7 +59,7 @@ void ExportWorker::run()
 			// get all ids of all variants on this chromosome
 			tmp_timer.restart();
 			SqlQuery variant_query = db.getQuery();
-			variant_query.exec("SELECT chr, start, end, ref, obs, gnomad, comment, germline_het, germline_hom, germline_mosaic, id FROM variant WHERE chr='" + chr_ + "' ORDER BY start ASC, end ASC");
+			variant_query.exec("SELECT chr, start, end, ref, obs, gnomad, comment, germline_het, germline_hom, germline_mosaic, id FROM variant WHERE chr='" + chr_ + "' AND id<=" + QString::number(shared_data_.max_variant_id) + " ORDER BY start ASC, end ASC, id ASC");
 			emit log(chr_, "Getting " + QString::number(variant_query.size()) + " variants for " + chr_ + " took " + getTimeString(tmp_timer.nsecsElapsed()/1000000.0));
 
 			// iterate over all variants
@@ -84,12 +89,36 @@ void ExportWorker::run()
 					continue;
 				}
 
-				//convert to VCF format (prepend ref base)
+				//delta export: get line of the variant from previous export (lines of variants deleted in the meantime are skipped)
+				QByteArrayList previous_parts;
+				if (!previous_file.isNull() && variant_id<=shared_data_.previous_max_variant_id)
+				{
+					while(previous_parts.isEmpty())
+					{
+						if (previous_file->atEnd()) THROW(Exception, "Previous germline export is out of sync with NGSD: variant with ID " + QString::number(variant_id) + " not found!");
+						QByteArray line = previous_file->readLine();
+						while (line.endsWith('\n') || line.endsWith('\r')) line.chop(1);
+						QByteArrayList parts = line.split('\t');
+						if (parts.count()<8) THROW(FileParseException, "Invalid line in previous germline export: " + line);
+						if (parts[2].toInt()==variant_id) previous_parts = parts;
+					}
+				}
+
+				//convert to VCF format (prepend ref base) - not necessary if the variant is contained in the previous export
 				tmp_timer.restart();
-				VcfLine vcf_line = variant.toVCF(reference_file);
-				variant.setStart(vcf_line.start());
-				variant.setRef(vcf_line.ref());
-				variant.setObs(vcf_line.altString());
+				if (!previous_parts.isEmpty())
+				{
+					variant.setStart(previous_parts[1].toInt());
+					variant.setRef(previous_parts[3]);
+					variant.setObs(previous_parts[4]);
+				}
+				else
+				{
+					VcfLine vcf_line = variant.toVCF(reference_file);
+					variant.setStart(vcf_line.start());
+					variant.setRef(vcf_line.ref());
+					variant.setObs(vcf_line.altString());
+				}
 				ref_lookup_sum += tmp_timer.nsecsElapsed()/1000000.0;
 
 				//output
@@ -105,7 +134,22 @@ void ExportWorker::run()
 
 				QByteArrayList info_column;
 
-				if(gnomad.toDouble() <= params_.max_af)
+				//delta export: re-use counts of previous export if the samples containing the variant did not change
+				QByteArrayList previous_counts;
+				if (!previous_parts.isEmpty() && !shared_data_.recount_variant_ids.contains(variant_id))
+				{
+					foreach(const QByteArray& entry, previous_parts[7].split(';'))
+					{
+						if (entry.startsWith("COUNTS=") || entry.startsWith("GSC")) previous_counts << entry;
+					}
+				}
+
+				if(gnomad.toDouble() <= params_.max_af && !previous_counts.isEmpty())
+				{
+					info_column << previous_counts;
+					++vcf_lines_reused;
+				}
+				else if(gnomad.toDouble() <= params_.max_af)
 				{
 					// calculate NGSD counts for each variant
 					int count_het = 0;
@@ -248,9 +292,11 @@ void ExportWorker::run()
 			// close vcf file
 			vcf_stream.flush();
 			vcf_file->close();
+			if (!previous_file.isNull()) previous_file->close();
 
 			emit log(chr_, "Finished germline export");
 			emit log(chr_, QString::number(vcf_lines_written) + " variants exported");
+			if (!previous_file.isNull()) emit log(chr_, QString::number(vcf_lines_reused) + " variant counts re-used from previous export");
 			emit log(chr_, "Time overall: " + getTimeString(chr_timer.elapsed()));
 			emit log(chr_, "Time for ref sequence lookup: " + getTimeString(ref_lookup_sum));
 			emit log(chr_, "Time for VCF writing: " + getTimeString(vcf_file_writing_sum));
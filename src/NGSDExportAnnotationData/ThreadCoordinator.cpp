@@ -1,7 +1,9 @@
 #include "ThreadCoordinator.h"
 #include "ExportWorker.h"
 #include "NGSD.h"
+#include "VersatileFile.h"
 #include <QElapsedTimer>
+#include <QCryptographicHash>
 
 ThreadCoordinator::ThreadCoordinator(QObject* parent, const ExportParameters& params)
 	: QObject(parent)
@@ -52,9 +54,36 @@ ThreadCoordinator::ThreadCoordinator(QObject* parent, const ExportParameters& pa
 		}
 	}
 
+	shared_data_.chrs = db.getEnum("variant", "chr");
+
+	//determine germline export watermark
+	if (!params_.germline.isEmpty())
+	{
+		query.exec("SELECT MAX(id) FROM variant");
+		query.next();
+		shared_data_.max_variant_id = query.value(0).toInt();
+		QByteArray disease_groups_hash = QCryptographicHash::hash(db.getEnum("sample", "disease_group").join("\t").toUtf8(), QCryptographicHash::Md5).toHex();
+		watermark_ = "max_variant_id=" + QByteArray::number(shared_data_.max_variant_id) + ";max_af=" + QByteArray::number(params_.max_af) + ";disease_groups=" + disease_groups_hash;
+
+		if (!params_.germline_state.isEmpty())
+		{
+			log("coordinator", "Determining sample states");
+			initSampleStates(db);
+		}
+
+		if (!params_.germline_previous.isEmpty())
+		{
+			log("coordinator", "Preparing delta export based on " + params_.germline_previous);
+			shared_data_.germline_delta = initGermlineDelta(db);
+			if (shared_data_.germline_delta)
+			{
+				log("coordinator", "Variants with re-calculated NGSD counts: " + QString::number(shared_data_.recount_variant_ids.count()) + " and all variants with ID above " + QString::number(shared_data_.previous_max_variant_id));
+			}
+		}
+	}
+
 	//start analysis
 	log("coordinator", "Starting export of variants");
-	shared_data_.chrs = db.getEnum("variant", "chr");
 	foreach (QString chr, shared_data_.chrs)
 	{
 		ExportWorker* worker = new ExportWorker(chr, params_, shared_data_);
@@ -80,6 +109,206 @@ void ThreadCoordinator::error(QString chr, QString message)
 	THROW(Exception, "Exception in worker for " + chr + ": " + message);
 }
 
+void ThreadCoordinator::initSampleStates(NGSD& db)
+{
+	//determine same-patient samples of all samples with relations at once (samples without relations are not looked up)
+	QHash<int, QByteArray> same_patient_samples;
+	SqlQuery query = db.getQuery();
+	query.exec("SELECT DISTINCT sample1_id, sample2_id FROM sample_relations WHERE relation='same sample' OR relation='same patient'");
+	while(query.next())
+	{
+		for (int i=0; i<2; ++i)
+		{
+			int s_id = query.value(i).toInt();
+			if (same_patient_samples.contains(s_id)) continue;
+
+			QList<int> same_patient_ids = db.sameSamples(s_id, SameSampleMode::SAME_PATIENT).values();
+			std::sort(same_patient_ids.begin(), same_patient_ids.end());
+			QByteArrayList same_patient;
+			foreach(int same_id, same_patient_ids)
+			{
+				same_patient << QByteArray::number(same_id);
+			}
+			same_patient_samples.insert(s_id, same_patient.join(','));
+		}
+	}
+
+	query.exec("SELECT processed_sample_id, COUNT(*), SUM(variant_id) FROM detected_variant GROUP BY processed_sample_id");
+	while(query.next())
+	{
+		//ignore processed samples imported while this tool is running
+		int ps_id = query.value(0).toInt();
+		if (!shared_data_.ps_infos.contains(ps_id)) continue;
+		const ProcessedSampleInfo& info = shared_data_.ps_infos[ps_id];
+
+		SampleState state;
+		state.attributes = QByteArrayList{QByteArray::number(info.s_id), info.bad_quality ? "bad" : "good", info.affected ? "affected" : "unaffected", info.disease_group.toUtf8(), same_patient_samples.value(info.s_id)}.join('\t');
+		state.variant_count = query.value(1).toLongLong();
+		state.variant_id_sum = query.value(2).toLongLong();
+		shared_data_.sample_states.insert(ps_id, state);
+	}
+}
+
+bool ThreadCoordinator::initGermlineDelta(NGSD& db)
+{
+	//parse header of previous export
+	VersatileFile file(params_.germline_previous);
+	file.open();
+	QByteArray line;
+	QByteArray previous_watermark;
+	while(!file.atEnd())
+	{
+		line = file.readLine(true);
+		if (!line.startsWith("#")) break;
+		if (line.startsWith("##NGSD_export_watermark=")) previous_watermark = line.mid(24);
+	}
+	if (line.startsWith("#")) line.clear();
+	if (previous_watermark.isEmpty()) THROW(ArgumentException, "Previous germline export '" + params_.germline_previous + "' contains no export watermark. It has to be created using the 'germline_state' parameter!");
+
+	//check that the previous export is compatible
+	QByteArray state_watermark;
+	QHash<int, SampleState> previous_states = loadSampleStates(params_.germline_previous_state, state_watermark);
+	if (state_watermark!=previous_watermark)
+	{
+		log("coordinator", "Sample state file does not match previous germline export - performing full export!");
+		return false;
+	}
+	QHash<QByteArray, QByteArray> previous_values;
+	foreach(const QByteArray& entry, previous_watermark.split(';'))
+	{
+		int sep = entry.indexOf('=');
+		previous_values[entry.left(sep)] = entry.mid(sep+1);
+	}
+	QHash<QByteArray, QByteArray> current_values;
+	foreach(const QByteArray& entry, watermark_.split(';'))
+	{
+		int sep = entry.indexOf('=');
+		current_values[entry.left(sep)] = entry.mid(sep+1);
+	}
+	foreach(QByteArray key, QByteArrayList{"max_af", "disease_groups"})
+	{
+		if (previous_values[key]!=current_values[key])
+		{
+			log("coordinator", "Watermark entry '" + key + "' changed since the previous germline export - performing full export!");
+			return false;
+		}
+	}
+	bool ok = false;
+	shared_data_.previous_max_variant_id = previous_values["max_variant_id"].toInt(&ok);
+	if (!ok) THROW(FileParseException, "Invalid max_variant_id in export watermark of '" + params_.germline_previous + "': " + previous_watermark);
+
+	//determine processed samples for which variant counts have to be re-calculated
+	QList<int> recount_ps_ids;
+	for (auto it=previous_states.cbegin(); it!=previous_states.cend(); ++it)
+	{
+		//variants of removed/re-imported samples cannot be determined > full export
+		if (!shared_data_.sample_states.contains(it.key()))
+		{
+			log("coordinator", "Variants of processed sample " + QString::number(it.key()) + " were removed since the previous germline export - performing full export!");
+			return false;
+		}
+		const SampleState& state = shared_data_.sample_states[it.key()];
+		if (state.variant_count!=it.value().variant_count || state.variant_id_sum!=it.value().variant_id_sum)
+		{
+			log("coordinator", "Variants of processed sample " + QString::number(it.key()) + " changed since the previous germline export - performing full export!");
+			return false;
+		}
+
+		//attribute changes
+		if (state.attributes!=it.value().attributes) recount_ps_ids << it.key();
+	}
+	for (auto it=shared_data_.sample_states.cbegin(); it!=shared_data_.sample_states.cend(); ++it)
+	{
+		if (!previous_states.contains(it.key())) recount_ps_ids << it.key();
+	}
+
+	//determine variants for which counts have to be re-calculated
+	SqlQuery query = db.getQuery();
+	for (int i=0; i<recount_ps_ids.count(); i+=1000)
+	{
+		QStringList ps_ids;
+		foreach(int ps_id, recount_ps_ids.mid(i, 1000))
+		{
+			ps_ids << QString::number(ps_id);
+		}
+		query.exec("SELECT DISTINCT variant_id FROM detected_variant WHERE processed_sample_id IN (" + ps_ids.join(",") + ")");
+		while(query.next())
+		{
+			shared_data_.recount_variant_ids << query.value(0).toInt();
+		}
+	}
+
+	//split variant lines of previous export by chromosome
+	QHash<QByteArray, QSharedPointer<QFile>> chr_files;
+	foreach(const QString& chr, shared_data_.chrs)
+	{
+		chr_files[Chromosome(chr).strNormalized(true)] = Helper::openFileForWriting(params_.tempVcf(chr, "germline_previous"));
+	}
+	while(!line.isEmpty() || !file.atEnd())
+	{
+		if (!line.isEmpty())
+		{
+			QByteArray chr = line.left(line.indexOf('\t'));
+			if (!chr_files.contains(chr)) THROW(FileParseException, "Invalid chromosome '" + chr + "' in previous germline export '" + params_.germline_previous + "'!");
+			chr_files[chr]->write(line + "\n");
+		}
+		line = file.atEnd() ? QByteArray() : file.readLine(true);
+	}
+	foreach(QSharedPointer<QFile> chr_file, chr_files)
+	{
+		chr_file->close();
+	}
+
+	return true;
+}
+
+QHash<int, SampleState> ThreadCoordinator::loadSampleStates(QString filename, QByteArray& watermark)
+{
+	QHash<int, SampleState> output;
+
+	QSharedPointer<QFile> file = Helper::openFileForReading(filename);
+	while(!file->atEnd())
+	{
+		QByteArray line = file->readLine();
+		while (line.endsWith('\n') || line.endsWith('\r')) line.chop(1);
+		if (line.isEmpty()) continue;
+
+		if (line.startsWith("##watermark="))
+		{
+			watermark = line.mid(12);
+			continue;
+		}
+		if (line.startsWith("#")) continue;
+
+		QByteArrayList parts = line.split('\t');
+		if (parts.count()!=8) THROW(FileParseException, "Invalid line in sample state file '" + filename + "': " + line);
+
+		SampleState state;
+		state.attributes = parts.mid(1, 5).join('\t');
+		state.variant_count = parts[6].toLongLong();
+		state.variant_id_sum = parts[7].toLongLong();
+		output.insert(parts[0].toInt(), state);
+	}
+
+	return output;
+}
+
+void ThreadCoordinator::writeSampleStates()
+{
+	QList<int> ps_ids = shared_data_.sample_states.keys();
+	std::sort(ps_ids.begin(), ps_ids.end());
+
+	QSharedPointer<QFile> file = Helper::openFileForWriting(params_.germline_state);
+	QTextStream stream(file.data());
+	stream << "##watermark=" << watermark_ << "\n";
+	stream << "#ps_id\ts_id\tquality\taffected\tdisease_group\tsame_patient_samples\tvariant_count\tvariant_id_sum\n";
+	foreach(int ps_id, ps_ids)
+	{
+		const SampleState& state = shared_data_.sample_states[ps_id];
+		stream << ps_id << "\t" << state.attributes << "\t" << state.variant_count << "\t" << state.variant_id_sum << "\n";
+	}
+}
+
 void ThreadCoordinator::writeGermlineVcf()
 {
 	QElapsedTimer timer;
@@ -96,6 +325,7 @@ void ThreadCoordinator::writeGermlineVcf()
 	vcf_stream << "##fileDate=" << QDate::currentDate().toString("yyyyMMdd") << "\n";
 	vcf_stream << "##source=NGSDExportAnnotationData " << params_.version << "\n";
 	vcf_stream << "##reference=" << params_.ref_file << "\n";
+	if (!params_.germline_state.isEmpty()) vcf_stream << "##NGSD_export_watermark=" << watermark_ << "\n";
 
 	foreach (const QString& chr_name, shared_data_.chrs)
 	{
@@ -133,7 +363,13 @@ void ThreadCoordinator::writeGermlineVcf()
 
 		//remove
 		QFile::remove(tmp_vcf);
+		if (shared_data_.germline_delta) QFile::remove(params_.tempVcf(chr, "germline_previous"));
 	}
+	vcf_stream.flush();
+	vcf_file->close();
+
+	//write sample states (after the export is complete - it is the basis for the next delta export)
+	if (!params_.germline_state.isEmpty()) writeSampleStates();
 
 	log("coordinator", "Runtime germline VCF merge: " + getTimeString(timer.elapsed()));
 }
@@ -6,6 +6,7 @@
 #include <QTextStream>
 #include <QSet>
 #include "Auxilary.h"
+#include "NGSD.h"
 
 //Coordinator class for chromosome-wise export of germline variats
 class ThreadCoordinator
@@ -29,6 +30,15 @@ private slots:
 	void error(QString chr, QString message);
 
 protected:
+	//Determines the state of all processed samples with detected variants
+	void initSampleStates(NGSD& db);
+	//Prepares the delta export based on the previous germline export. Returns 'false' if a full export is necessary.
+	bool initGermlineDelta(NGSD& db);
+	//Loads a sample state file. The watermark of the corresponding export is stored in 'watermark'.
+	static QHash<int, SampleState> loadSampleStates(QString filename, QByteArray& watermark);
+	//Writes the sample state file
+	void writeSampleStates();
+
 	void writeGermlineVcf();
 	void writeSomaticVcf();
 	void exportGeneInformation();
@@ -36,6 +46,7 @@ protected:
 private:
 	ExportParameters params_; //not const ref! We need to copy the parameters because the original instance is deleted when the main loop terminates
 	SharedData shared_data_;
+	QByteArray watermark_; //germline export watermark
 	QThreadPool thread_pool_;
 	QTextStream out_;
 	QSet<QString> chrs_done_;
@@ -23,6 +23,9 @@ public:
 		addOutfile("genes", "Exports BED file containing genes and gene information.", true);
 		addInfile("reference", "Reference genome FASTA file. If unset 'reference_genome' from the 'settings.ini' file is used.", true, false);
 		addFloat("max_af", "Maximum allel frequency of exported variants (germline).",  true, 0.05);
+		addOutfile("germline_state", "Sample state file of the germline export. If set, the export watermark is written to the germline VCF header and the state of all processed samples is written to this file (germline).", true);
+		addInfile("germline_previous", "Previous germline export created with 'germline_state'. If set, only NGSD counts of variants affected by sample changes since the previous export are re-calculated (germline).", true);
+		addInfile("germline_previous_state", "Sample state file of the previous germline export (mandatory if 'germline_previous' is used). It is read before 'germline_state' is written, i.e. both parameters can be the same file (germline).", true);
 		addInt("gene_offset", "Defines the number of bases by which the regions of genes are extended (genes).", true, 5000);
 		addFlag("vicc_config_details", "Includes details about VICC interpretation (somatic).");
 		addInt("threads", "Number of threads to use.", true, 5);
@@ -30,6 +33,7 @@ public:
 		addInt("max_vcf_lines", "Maximum number of VCF lines to write per chromosome - for debugging.", true, -1);
 		addFlag("test", "Uses the test database instead of on the production database.");
 
+		changeLog(2026, 10, 19, "Added delta export of germline variants (parameters 'germline_state', 'germline_previous' and 'germline_previous_state').");
 		changeLog(2026,  4, 17, "Gene info entries now contains only keys with a value.");
 		changeLog(2023,  6, 18, "Refactoring of command line parameters and parallelization of somatic export.");
 		changeLog(2023,  6, 16, "Added support for 'germline_mosaic' column in 'variant' table and added parallelization.");
@@ -56,6 +60,9 @@ public:
 		params.vicc_config_details = getFlag("vicc_config_details");
 		params.max_af = getFloat("max_af");
 		if (params.max_af < 0) THROW(CommandLineParsingException, "Maximum AF has to be a positive value!");
+		params.germline_state = getOutfile("germline_state");
+		params.germline_previous = getInfile("germline_previous");
+		params.germline_previous_state = getInfile("germline_previous_state");
 		params.max_vcf_lines = getInt("max_vcf_lines");
 		params.threads = getInt("threads");
 		if (params.threads < 0) THROW(CommandLineParsingException, "Number of threads has to be a positive value!");
@@ -69,6 +76,10 @@ public:
 		
 		//check parameters
 		if (params.germline.isEmpty() && params.somatic.isEmpty() && params.genes.isEmpty()) THROW(CommandLineParsingException, "At least one of the parameters 'germline', 'somatic' or 'genes' needs to be given!");
+		if (!params.germline_state.isEmpty() && params.germline.isEmpty()) THROW(CommandLineParsingException, "Parameter 'germline_state' requires parameter 'germline'!");
+		if (!params.germline_previous.isEmpty() && params.germline_state.isEmpty()) THROW(CommandLineParsingException, "Parameter 'germline_previous' requires parameter 'germline_state'!");
+		if (params.germline_previous.isEmpty()!=params.germline_previous_state.isEmpty()) THROW(CommandLineParsingException, "Parameters 'germline_previous' and 'germline_previous_state' have to be used together!");
+		if (!params.germline_state.isEmpty() && params.max_vcf_lines>0) THROW(CommandLineParsingException, "Parameter 'germline_state' cannot be combined with parameter 'max_vcf_lines'!");
 		
 		//annotate
 		ThreadCoordinator* coordinator = new ThreadCoordinator(this, params);
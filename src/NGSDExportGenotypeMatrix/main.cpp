@@ -0,0 +1,69 @@
+#include "ToolBase.h"
+#include "NGSD.h"
+#include "GenotypeMatrix.h"
+
+class ConcreteTool
+		: public ToolBase
+{
+	Q_OBJECT
+
+public:
+	ConcreteTool(int& argc, char *argv[])
+		: ToolBase(argc, argv)
+	{
+	}
+
+	virtual void setup()
+	{
+		setDescription("Exports a sparse sample-by-variant genotype matrix of rare germline variants from the NGSD.");
+		setExtendedDescription(QStringList() << "The matrix can be used by NGSDGeneBurdenTest and GSvar to perform gene burden tests without querying the NGSD for each gene."
+											 << "If an existing matrix is given, only samples that were imported into the NGSD after its creation are appended.");
+		addOutfile("out", "Output genotype matrix file.", false);
+		//optional
+		addInfile("update", "Existing genotype matrix to update. If unset, a new matrix is created.", true);
+		addInt("max_ngsd_count", "Maximum NGSD count of variants contained in the matrix (ignored if 'update' is given).", true, 50);
+		addFlag("test", "Uses the test database instead of on the production database.");
+		addFlag("debug", "Enable verbose debug output.");
+
+		changeLog(2026, 10, 19, "Initial version.");
+	}
+
+	virtual void main()
+	{
+		//init
+		NGSD db(getFlag("test"));
+		QTextStream out(stdout);
+		QTextStream* debug_out = getFlag("debug") ? &out : nullptr;
+
+		//create/update matrix
+		GenotypeMatrix matrix;
+		QString update = getInfile("update");
+		if (update.isEmpty())
+		{
+			matrix.createFromNGSD(db, getInt("max_ngsd_count"), debug_out);
+		}
+		else
+		{
+			matrix.load(update);
+			int c_added = matrix.appendNewSamples(db, debug_out);
+			out << "Appended samples: " << c_added << Qt::endl;
+		}
+
+		//store
+		matrix.store(getOutfile("out"));
+
+		//statistics
+		out << "Maximum NGSD count: " << matrix.maxNgsdCount() << Qt::endl;
+		out << "Samples: " << matrix.sampleCount() << Qt::endl;
+		out << "Variants: " << matrix.variantCount() << Qt::endl;
+		out << "Genotypes: " << matrix.entryCount() << Qt::endl;
+	}
+};
+
+#include "main.moc"
+
+int main(int argc, char *argv[])
+{
+	ConcreteTool tool(argc, argv);
+	return tool.execute();
+}
@@ -34,10 +34,12 @@ public:
 		addInt("splice_region_size", "Extend coding region by this amount of bases.", true, 20);
 		addInfile("excluded_regions", "BED file containing regions which should be excluded from the test.", true);
 		addInt("threads", "Number of threads used to perform the test.", true, 4);
+		addInfile("genotype_matrix", "Genotype matrix created with NGSDExportGenotypeMatrix. If given, small variants and genotypes are taken from the matrix instead of the NGSD.", true);
 		addFlag("test", "Uses the test database instead of on the production database.");
 		addFlag("debug", "Activate debug output.");
 		addFlag("skip_errors", "Only report errors, do not fail execution.");
 
+		changeLog(2026, 10, 19, "Added parameter 'genotype_matrix'.");
 		changeLog(2026, 6,  1, "Added live impact annotation.");
 		changeLog(2026, 5, 22, "Added multithreading.");
 		changeLog(2026, 5, 20, "Initial commit.");
@@ -96,6 +98,12 @@ public:
 
 		//perform burden test
 		GeneBurdenTest burden_test(ps_ids_cases, ps_ids_controls, genes, parameters, getInt("threads"), getFlag("test"), getFlag("debug"), getFlag("skip_errors"));
+		GenotypeMatrix genotype_matrix;
+		if (!getInfile("genotype_matrix").isEmpty())
+		{
+			genotype_matrix.load(getInfile("genotype_matrix"));
+			burden_test.setGenotypeMatrix(&genotype_matrix);
+		}
 		QList<BurdenTestResult> results = burden_test.run_burden_test();
 
 		//open output file
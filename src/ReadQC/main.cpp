@@ -1,6 +1,81 @@
 #include "ToolBase.h"
 #include "StatisticsReads.h"
 #include "Helper.h"
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QMutex>
+
+//Read statistics of a worker (merged after all reads are processed)
+struct PartialStatistics
+{
+	PartialStatistics(bool long_read)
+		: stats(long_read)
+	{
+	}
+
+	StatisticsReads stats;
+	QString error;
+};
+
+//Statistics of the workers - there is one per thread, so a free one is always available when a block is processed
+struct PartialStatisticsPool
+{
+	QList<QSharedPointer<PartialStatistics>> partials;
+	QList<PartialStatistics*> available;
+	QMutex mutex; //only locked to take/return statistics, not while a block is processed
+
+	PartialStatistics* take()
+	{
+		QMutexLocker locker(&mutex);
+		return available.takeLast();
+	}
+
+	void release(PartialStatistics* partial)
+	{
+		QMutexLocker locker(&mutex);
+		available << partial;
+	}
+};
+
+//Updates the statistics of a worker with a block of reads
+class StatisticsWorker
+	: public QRunnable
+{
+public:
+	StatisticsWorker(QVector<FastqEntry>&& reads, StatisticsReads::ReadDirection direction, PartialStatisticsPool& pool, QSemaphore& free_blocks)
+		: QRunnable()
+		, reads_(std::move(reads))
+		, direction_(direction)
+		, pool_(pool)
+		, free_blocks_(free_blocks)
+	{
+	}
+
+	void run() override
+	{
+		PartialStatistics* partial = pool_.take();
+		try
+		{
+			foreach(const FastqEntry& entry, reads_)
+			{
+				partial->stats.update(entry, direction_);
+			}
+		}
+		catch (Exception& e)
+		{
+			partial->error = e.message();
+		}
+		pool_.release(partial);
+
+		free_blocks_.release();
+	}
+
+private:
+	QVector<FastqEntry> reads_;
+	StatisticsReads::ReadDirection direction_;
+	PartialStatisticsPool& pool_;
+	QSemaphore& free_blocks_;
+};
 
 class ConcreteTool
 		: public ToolBase
@@ -25,7 +100,10 @@ public:
 		addOutfile("out2", "If set, writes merged reverse FASTQs to this file (gzipped)", true);
 		addInt("compression_level", "Output FASTQ compression level from 1 (fastest) to 9 (best compression).", true, Z_BEST_SPEED);
 		addFlag("long_read", "Support long reads (> 1kb).");
+		addInt("threads", "The number of threads used to calculate the statistics (reading and writing FASTQ files is done in the main thread).", true, 1);
+		addInt("block_size", "Number of reads processed in one block (only used if 'threads' is larger than 1).", true, 10000);
 
+		changeLog(2026, 10, 19, "Added 'threads' parameter.");
 		changeLog(2023,  4,  18, "Added support for LongRead");
 		changeLog(2021,  2,  3, "Added option to write out merged input FASTQs (out1/out2).");
 		changeLog(2016,  8, 19, "Added support for multiple input files.");
@@ -55,6 +133,43 @@ public:
 		bool long_read = getFlag("long_read");
 		StatisticsReads stats(long_read);
 
+		//init multi-threaded mode: blocks of reads are processed by the thread pool, each thread has its own statistics
+		int threads = getInt("threads");
+		if (threads<1) THROW(CommandLineParsingException, "Parameter 'threads' must be at least 1!");
+		int block_size = getInt("block_size");
+		if (block_size<1) THROW(CommandLineParsingException, "Parameter 'block_size' must be at least 1!");
+		QThreadPool thread_pool;
+		thread_pool.setMaxThreadCount(threads);
+		QSemaphore free_blocks(2*threads); //limits the number of blocks in memory
+		PartialStatisticsPool pool;
+		for (int t=0; t<threads; ++t)
+		{
+			pool.partials << QSharedPointer<PartialStatistics>(new PartialStatistics(long_read));
+			pool.available << pool.partials.last().data();
+		}
+		QVector<FastqEntry> block;
+		block.reserve(block_size);
+		auto submit_block = [&](StatisticsReads::ReadDirection direction)
+		{
+			if (block.isEmpty()) return;
+
+			free_blocks.acquire();
+			thread_pool.start(new StatisticsWorker(std::move(block), direction, pool, free_blocks));
+			block = QVector<FastqEntry>();
+			block.reserve(block_size);
+		};
+		auto add_read = [&](const FastqEntry& entry, StatisticsReads::ReadDirection direction)
+		{
+			if (threads==1)
+			{
+				stats.update(entry, direction);
+				return;
+			}
+
+			block << entry;
+			if (block.count()>=block_size) submit_block(direction);
+		};
+
 		//process
 		for (int i=0; i<in1.count(); ++i)
 		{
@@ -63,13 +178,14 @@ public:
 			while(!stream.atEnd())
 			{
 				stream.readEntry(entry);
-				stats.update(entry, StatisticsReads::FORWARD);
+				add_read(entry, StatisticsReads::FORWARD);
 
 				if (write1)
 				{
 					out1_stream->write(entry);
 				}
 			}
+			submit_block(StatisticsReads::FORWARD);
 			infiles << in1[i];
 
 			//reverse (optional)
@@ -79,13 +195,14 @@ public:
 				while(!stream2.atEnd())
 				{
 					 stream2.readEntry(entry);
-					 stats.update(entry, StatisticsReads::REVERSE);
+					 add_read(entry, StatisticsReads::REVERSE);
 
 					 if (write2)
 					 {
 						 out2_stream->write(entry);
 					 }
 				}
+				submit_block(StatisticsReads::REVERSE);
 
 				//check read counts matches
 				if (stream.index()!=stream2.index())
@@ -97,6 +214,14 @@ public:
 			}
 		}
 
+		//merge statistics of threads
+		thread_pool.waitForDone();
+		foreach(const QSharedPointer<PartialStatistics>& partial, pool.partials)
+		{
+			if (!partial->error.isEmpty()) THROW(Exception, partial->error);
+			stats.merge(partial->stats);
+		}
+
 		//store output
 		QCCollection metrics = stats.getResult();
 		if (getFlag("txt"))
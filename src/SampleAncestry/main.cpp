@@ -5,6 +5,8 @@
 
 #include <QTextStream>
 #include <QFileInfo>
+#include <QThreadPool>
+#include <QMutex>
 
 class ConcreteTool
         : public ToolBase
@@ -21,15 +23,17 @@ public:
     {
 		setDescription("Estimates the ancestry of a sample based on variants.");
 
-		addInfileList("in", "Input variant list(s) in VCF or VCF.GZ format.", false);
+		addInfileList("in", "Input variant list(s) in VCF or VCF.GZ format. For multi-sample VCFs, one line per sample is written (with the sample name instead of the file name).", false);
 		//optional
 		addOutfile("out", "Output TSV file. If unset, writes to STDOUT.", true);
 		addInt("min_snps", "Minimum number of informative SNPs for population determination. If less SNPs are found, 'NOT_ENOUGH_SNPS' is returned.", true, 1000);
 		addFloat("score_cutoff", "Absolute score cutoff above which a sample is assigned to a population.", true, 0.32);
 		addFloat("mad_dist", "Maximum number of median average diviations that are allowed from median population score.", true, 4.2);
 		addEnum("build", "Genome build used to generate the input.", true, QStringList() << "hg19" << "hg38", "hg38");
+		addInt("threads", "Number of threads used. Each thread processes one input file.", true, 1);
 
 		//changelog
+		changeLog(2026, 10, 19, "Added support for multi-sample VCFs and 'threads' parameter. The marker SNPs are loaded only once for all input files.");
 		changeLog(2021,  5, 17, "Population assignment is based on abolute score and on median/mad now. Should be much more accurate now especially for admixed samples.");
         changeLog(2020,  8, 07, "VCF files only as input format for variant list.");
 		changeLog(2018, 12, 10, "Fixed bug in handling of 'pop_dist' parameter.");
@@ -47,19 +51,51 @@ public:
 		double mad_dist = getFloat("mad_dist");
 		double score_cutoff = getFloat("score_cutoff");
 		GenomeBuild build = stringToBuild(getEnum("build"));
+		int threads = getInt("threads");
+		if (threads<1) THROW(CommandLineParsingException, "Invalid number of threads: " + QString::number(threads));
+
+		//load marker SNPs (shared by all input files)
+		AncestryMarkers markers(build);
 
 		//process
-        out << "#sample\tsnps\tAFR\tEUR\tSAS\tEAS\tpopulation" << Qt::endl;
-		foreach(QString filename, in)
+		QVector<QList<AncestryEstimates>> results(in.count());
+		QStringList errors;
+		QMutex errors_mutex;
+		QThreadPool thread_pool;
+		thread_pool.setMaxThreadCount(threads);
+		for (int i=0; i<in.count(); ++i)
+		{
+			thread_pool.start([&, i]()
+			{
+				try
+				{
+					results[i] = Statistics::ancestry(markers, in[i], min_snps, score_cutoff, mad_dist);
+					if (results[i].isEmpty()) THROW(ArgumentException, "VCF file does not contain samples!");
+				}
+				catch(Exception& e)
+				{
+					QMutexLocker locker(&errors_mutex);
+					errors << "Error while processing " + in[i] + ": " + e.message();
+				}
+			});
+		}
+		thread_pool.waitForDone();
+		if (!errors.isEmpty()) THROW(Exception, errors.join("\n"));
+
+		//write output
+		out << "#sample\tsnps\tAFR\tEUR\tSAS\tEAS\tpopulation" << Qt::endl;
+		for (int i=0; i<in.count(); ++i)
 		{
-			AncestryEstimates ancestry = Statistics::ancestry(build, filename, min_snps, score_cutoff, mad_dist);
-			out << QFileInfo(filename).fileName()
-				<< "\t" << ancestry.snps
-				<< "\t" << QString::number(ancestry.afr, 'f', 4)
-				<< "\t" << QString::number(ancestry.eur, 'f', 4)
-				<< "\t" << QString::number(ancestry.sas, 'f', 4)
-				<< "\t" << QString::number(ancestry.eas, 'f', 4)
-                << "\t" << ancestry.population << Qt::endl;
+			foreach(const AncestryEstimates& ancestry, results[i])
+			{
+				out << (results[i].count()==1 ? QFileInfo(in[i]).fileName() : QString(ancestry.sample))
+					<< "\t" << ancestry.snps
+					<< "\t" << QString::number(ancestry.afr, 'f', 4)
+					<< "\t" << QString::number(ancestry.eur, 'f', 4)
+					<< "\t" << QString::number(ancestry.sas, 'f', 4)
+					<< "\t" << QString::number(ancestry.eas, 'f', 4)
+					<< "\t" << ancestry.population << Qt::endl;
+			}
 		}
 	}
 };
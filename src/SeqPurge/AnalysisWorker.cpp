@@ -85,13 +85,11 @@ void AnalysisWorker::run()
 		//update raw data statistics (before trimming)
 		if (!params_.qc.isEmpty())
 		{
-			stats_.qc_mutex.lock();
 			for (int r=0; r<job_.read_count; ++r)
 			{
-				stats_.qc.update(job_.r1[r], StatisticsReads::FORWARD);
-				stats_.qc.update(job_.r2[r], StatisticsReads::REVERSE);
+				job_.qc.update(job_.r1[r], StatisticsReads::FORWARD);
+				job_.qc.update(job_.r2[r], StatisticsReads::REVERSE);
 			}
-			stats_.qc_mutex.unlock();
 		}
 
 		for (int r=0; r<job_.read_count; ++r)
@@ -51,10 +51,11 @@ struct AnalysisJob
 	int reads_trimmed_adapter;
 	int reads_trimmed_q;
 	int reads_trimmed_n;
+	StatisticsReads qc; //raw read QC of all blocks processed by this job (accumulated without locking and merged at the end)
 
 	void clear()
 	{
-		//note: index, r1, r2, length_r1_orig, length_r2_orig must not be cleared
+		//note: index, r1, r2, length_r1_orig, length_r2_orig, qc must not be cleared
 		read_count = -1;
 		status = DONE;
 
@@ -129,6 +130,8 @@ struct TrimmingParameters
 	bool ec;
 	bool debug;
 	int compression_level;
+	int compression_threads;
+	bool bgzf;
 	QString qc;
 };
 
@@ -161,7 +164,6 @@ struct TrimmingStatistics
 	double reads_removed;
 	double bases_perc_trim_sum;
 	StatisticsReads qc;
-	QMutex qc_mutex;
 
 	void writeStatistics(QTextStream& out, const TrimmingParameters& params_)
 	{
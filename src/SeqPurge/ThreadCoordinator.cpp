@@ -24,13 +24,13 @@ ThreadCoordinator::ThreadCoordinator(QObject* parent, TrimmingParameters params)
 	//open output streams
 	streams_out_.summary_file = Helper::openFileForWriting(params.summary, true);
 	streams_out_.summary_stream.reset(new QTextStream(streams_out_.summary_file.data()));
-	streams_out_.ostream1.reset(new FastqOutfileStream(params.out1, params.compression_level));
-	streams_out_.ostream2.reset(new FastqOutfileStream(params.out2, params.compression_level));
+	streams_out_.ostream1.reset(new FastqOutfileStream(params.out1, params.compression_level, Z_DEFAULT_STRATEGY, params.compression_threads, params.bgzf));
+	streams_out_.ostream2.reset(new FastqOutfileStream(params.out2, params.compression_level, Z_DEFAULT_STRATEGY, params.compression_threads, params.bgzf));
 	QString out3_base = params.out3;
 	if (!out3_base.isEmpty())
 	{
-		streams_out_.ostream3.reset(new FastqOutfileStream(out3_base + "_R1.fastq.gz", params.compression_level));
-		streams_out_.ostream4.reset(new FastqOutfileStream(out3_base + "_R2.fastq.gz", params.compression_level));
+		streams_out_.ostream3.reset(new FastqOutfileStream(out3_base + "_R1.fastq.gz", params.compression_level, Z_DEFAULT_STRATEGY, params.compression_threads, params.bgzf));
+		streams_out_.ostream4.reset(new FastqOutfileStream(out3_base + "_R2.fastq.gz", params.compression_level, Z_DEFAULT_STRATEGY, params.compression_threads, params.bgzf));
 	}
 
 	streams_out_.ostream1_thread.setMaxThreadCount(1);
@@ -137,6 +137,10 @@ void ThreadCoordinator::checkDone()
 	//write qc output file
 	if (!params_.qc.isEmpty())
 	{
+		for (int i=0; i<job_pool_.count(); ++i)
+		{
+			stats_.qc.merge(job_pool_[i].qc);
+		}
 		stats_.qc.getResult().storeToQCML(params_.qc, QStringList() << params_.files_in1 << params_.files_in2, "");
 	}
 
@@ -41,8 +41,11 @@ public:
 		addFlag("debug", "Enables debug output (use only with one thread).");
 		addInt("progress", "Enables progress output at the given interval in milliseconds (disabled by default).", true, -1);
 		addInt("compression_level", "Output FASTQ compression level from 1 (fastest) to 9 (best compression).", true, Z_BEST_SPEED);
+		addInt("compression_threads", "Number of threads used to compress each output FASTQ file. If larger than 1, the data is compressed in independent blocks.", true, 1);
+		addFlag("bgzf", "Writes output FASTQ files in BGZF format, which can be indexed and decompressed in parallel.");
 
 		//changelog
+		changeLog(2026, 10, 19, "Added 'compression_threads' and 'bgzf' parameters.");
 		changeLog(2022, 7, 15, "Improved scaling with more than 4 threads and CPU usage.");
 		changeLog(2019, 3, 26, "Added 'compression_level' parameter.");
 		changeLog(2019, 2, 11, "Added writer thread to make SeqPurge scale better when using many threads.");
@@ -87,6 +90,8 @@ public:
 		params.ec = getFlag("ec");
 		params.debug = getFlag("debug");
 		params.compression_level = getInt("compression_level");
+		params.compression_threads = getInt("compression_threads");
+		params.bgzf = getFlag("bgzf");
 
 		//init pre-calculation of factorials
 		BasicStatistics::precalculateFactorials();
@@ -2,24 +2,24 @@
 #include "VcfFile.h"
 #include "BamReader.h"
 #include "NGSHelper.h"
+#include <QThreadPool>
+#include <QMutex>
+#include <QDir>
 
-enum Member
+//SNPs of one sample
+struct VariantInfo
 {
-	FATHER,
-	MOTHER,
-	CHILD
+	QMap<QByteArray, double> variants; //non-homozygous variants with minimum alternate base count => allele frequency
+	QSet<QByteArray> homozygous; //homozygous variants
 };
 
-struct VariantInfo
+//Result of one trio
+struct TrioResult
 {
-	QString bam;
-	QMap<QByteArray, double> variants;
-
-	VariantInfo(){};
-	VariantInfo(QString in_file_name_)
-	{
-		bam = in_file_name_;
-	}
+	int mother_variants = 0;
+	double perc_mother = 0.0;
+	int father_variants = 0;
+	double perc_father = 0.0;
 };
 
 class ConcreteTool
@@ -37,132 +37,214 @@ public:
 	{
 		setDescription("Detects maternal contamination of a child using SNPs from parents.");
 		setExtendedDescription(QStringList() << "Determines the percentage of heterozygous SNPs passed on to the child from mother/father." << "This percentage should be similar for mother/father. If it is much higher for the mother, maternal contamination is likely.");
-		addInfile("bam_m", "Input BAM/CRAM file of mother.", false);
-		addInfile("bam_f", "Input BAM/CRAM file of father.", false);
-		addInfile("bam_c", "Input BAM/CRAM file of child.", false);
-
 		//optional
+		addInfile("bam_m", "Input BAM/CRAM file of mother.", true);
+		addInfile("bam_f", "Input BAM/CRAM file of father.", true);
+		addInfile("bam_c", "Input BAM/CRAM file of child.", true);
+		addInfile("trios", "TSV file with one trio per line (child, father and mother BAM/CRAM file). Relative paths are resolved relative to the TSV file. If given, a table with one line per trio is written. Alternative to 'bam_c', 'bam_f' and 'bam_m'.", true);
+		addInt("threads", "Number of threads used. Each thread processes one BAM/CRAM file.", true, 1);
 		addInt("min_depth", "Minimum depth for calling SNPs.", true, 3);
 		addInt("min_alt_count", "Minimum number of alternate observations for calling a SNP.", true, 1);
 		addEnum("build", "Genome build used to generate the input.", true, QStringList() << "hg19" << "hg38", "hg38");
 		addOutfile("out", "Output file. If unset, writes to STDOUT.", true);
 		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
 
+		changeLog(2026, 10, 19, "Added batch mode for many trios (parameters 'trios' and 'threads').");
 		changeLog(2025,   5, 30, "Code refactoring and speed-up.");
 		changeLog(2020,  11, 27, "Added CRAM support.");
 		changeLog(2020,   6,  18, "Initial version of the tool.");
 	}
 
-	virtual void main()
-    {
-		QTextStream out(stdout);
-
-        //init
-		QString bam_m = getInfile("bam_m");
-		QString bam_f = getInfile("bam_f");
-		QString bam_c = getInfile("bam_c");
-		const QString ref_file = getInfile("ref");
-		int min_depth = getInt("min_depth");
-		int min_alt_count = getInt("min_alt_count");
+	//determines the relevant SNPs allele frequencies from a BAM file
+	static VariantInfo getVariants(QString bam, QString ref_file, const VcfFile& snps, int min_depth, int min_alt_count)
+	{
+		VariantInfo output;
 
-		GenomeBuild build = stringToBuild(getEnum("build"));
-		VcfFile snps = NGSHelper::getKnownVariants(build, true);
-		QSet<QByteArray> homozygous_variants;
-
-		//get relevant SNPs allele frequencies from BAMs
-		QMap<Member, VariantInfo> trio;
-		trio.insert(Member::MOTHER, VariantInfo(bam_m));
-		trio.insert(Member::FATHER, VariantInfo(bam_f));
-		trio.insert(Member::CHILD, VariantInfo(bam_c));
-		for(auto it=trio.begin(); it!=trio.end(); ++it)
+		BamReader reader(bam, ref_file);
+		for (int i=0; i<snps.count(); ++i)
 		{
-			BamReader reader(it.value().bam, ref_file);
-			for (int i=0; i<snps.count(); ++i)
-			{
-				const  VcfLine& v = snps[i];
-				if (!v.isSNV(true)) continue;
-				if (!v.chr().isAutosome()) continue;
+			const  VcfLine& v = snps[i];
+			if (!v.isSNV(true)) continue;
+			if (!v.chr().isAutosome()) continue;
 
-				//keep only variants of minimum depth
-				Pileup pileup_tu = reader.getPileup(v.chr(), v.start());
-				if (pileup_tu.depth(true) < min_depth) continue;
+			//keep only variants of minimum depth
+			Pileup pileup_tu = reader.getPileup(v.chr(), v.start());
+			if (pileup_tu.depth(true) < min_depth) continue;
+
+			for(const Sequence& alt : v.alt())
+			{
+				long long count = pileup_tu.countOf(alt[0]);
+				double frequency = pileup_tu.frequency(v.ref()[0], alt[0]);
 
-				for(const Sequence& alt : v.alt())
+				//do not keep homozygous variants
+				QByteArray tag = v.toString();
+				if(frequency==1)
 				{
-					long long count = pileup_tu.countOf(alt[0]);
-					double frequency = pileup_tu.frequency(v.ref()[0], alt[0]);
-
-					//do not keep homozygous variants
-					QByteArray tag = v.toString();
-					if(frequency==1)
-					{
-						homozygous_variants.insert(tag);
-						continue;
-					}
-					if(homozygous_variants.contains(tag)) continue;
-
-					//only keep variants with a minimum base count
-					if(count < min_alt_count) continue;
-
-					it.value().variants[v.toString()] = frequency;
+					output.homozygous.insert(tag);
+					continue;
 				}
+				if(output.homozygous.contains(tag)) continue;
+
+				//only keep variants with a minimum base count
+				if(count < min_alt_count) continue;
+
+				output.variants[tag] = frequency;
 			}
 		}
 
-		//delete homozygous variants from all samples
-		for(auto it=trio.begin(); it!=trio.end(); ++it)
+		return output;
+	}
+
+	//removes homozygous variants of the trio
+	static QMap<QByteArray, double> removeHomozygous(const QMap<QByteArray, double>& variants, const QSet<QByteArray>& homozygous_variants)
+	{
+		QMap<QByteArray, double> output;
+		for(auto it=variants.begin(); it!=variants.end(); ++it)
 		{
-			for (auto variant_it = it.value().variants.begin(); variant_it != it.value().variants.end(); )
+			if(homozygous_variants.contains(it.key())) continue;
+			output.insert(it.key(), it.value());
+		}
+		return output;
+	}
+
+	//counts variants of a parent (not present in the other parent) and how many of them are passed to the child
+	static void countParentVariants(const QMap<QByteArray, double>& parent, const QMap<QByteArray, double>& other_parent, const QMap<QByteArray, double>& child, int& parent_variants, double& perc)
+	{
+		parent_variants = 0;
+		double variants_in_child = 0;
+		for(auto it=parent.begin(); it!=parent.end(); ++it)
+		{
+			if(other_parent.contains(it.key())) continue;
+			++parent_variants;
+
+			if(child.contains(it.key()))
 			{
-				if(homozygous_variants.contains(variant_it.key()))
-				{
-					variant_it = it.value().variants.erase(variant_it);
-				}
-				else
+				++variants_in_child;
+			}
+		}
+		perc = 100.0 * variants_in_child / parent_variants;
+	}
+
+	//evaluates a trio (homozygous variants of any trio member are ignored)
+	static TrioResult evaluate(const VariantInfo& c, const VariantInfo& f, const VariantInfo& m)
+	{
+		QSet<QByteArray> homozygous_variants = c.homozygous;
+		homozygous_variants.unite(f.homozygous);
+		homozygous_variants.unite(m.homozygous);
+
+		QMap<QByteArray, double> vars_c = removeHomozygous(c.variants, homozygous_variants);
+		QMap<QByteArray, double> vars_f = removeHomozygous(f.variants, homozygous_variants);
+		QMap<QByteArray, double> vars_m = removeHomozygous(m.variants, homozygous_variants);
+
+		TrioResult output;
+		countParentVariants(vars_m, vars_f, vars_c, output.mother_variants, output.perc_mother);
+		countParentVariants(vars_f, vars_m, vars_c, output.father_variants, output.perc_father);
+		return output;
+	}
+
+	virtual void main()
+	{
+		//init
+		const QString ref_file = getInfile("ref");
+		int min_depth = getInt("min_depth");
+		int min_alt_count = getInt("min_alt_count");
+		int threads = getInt("threads");
+		if (threads<1) THROW(CommandLineParsingException, "Invalid number of threads: " + QString::number(threads));
+
+		//trios (child, father, mother)
+		QList<QStringList> trios;
+		QString trios_file = getInfile("trios");
+		bool batch_mode = !trios_file.isEmpty();
+		if (batch_mode)
+		{
+			if (!getInfile("bam_c").isEmpty() || !getInfile("bam_f").isEmpty() || !getInfile("bam_m").isEmpty()) THROW(CommandLineParsingException, "Parameters 'bam_c', 'bam_f' and 'bam_m' cannot be used together with 'trios'!");
+			QDir trios_dir = QFileInfo(trios_file).absoluteDir();
+			foreach(const QString& line, Helper::loadTextFile(trios_file, true, '#', true))
+			{
+				QStringList parts = line.split('\t');
+				if (parts.count()<3) THROW(FileParseException, "Trios file line with less than three columns: " + line);
+
+				QStringList trio;
+				for (int i=0; i<3; ++i)
 				{
-					++variant_it;
+					trio << QDir::cleanPath(trios_dir.absoluteFilePath(parts[i].trimmed()));
 				}
+				trios << trio;
 			}
+			if (trios.isEmpty()) THROW(FileParseException, "Trios file does not contain trios: " + trios_file);
 		}
-
-		//count mother variants
-		double mother_variants = 0;
-		double variants_of_mother_in_child = 0;
-		for(auto it=trio[Member::MOTHER].variants.begin(); it!=trio[Member::MOTHER].variants.end(); ++it)
+		else
 		{
-			if(trio[Member::FATHER].variants.contains(it.key())) continue;
-			++mother_variants;
+			if (getInfile("bam_c").isEmpty() || getInfile("bam_f").isEmpty() || getInfile("bam_m").isEmpty()) THROW(CommandLineParsingException, "Parameters 'bam_c', 'bam_f' and 'bam_m' are required if 'trios' is not given!");
+			trios << (QStringList() << getInfile("bam_c") << getInfile("bam_f") << getInfile("bam_m"));
+		}
 
-			if(trio[Member::CHILD].variants.contains(it.key()))
+		//determine unique BAM files (parents can be part of several trios)
+		QStringList bams;
+		foreach(const QStringList& trio, trios)
+		{
+			foreach(const QString& bam, trio)
 			{
-				++variants_of_mother_in_child;
+				if (!bams.contains(bam)) bams << bam;
 			}
 		}
-		double perc_mother = 100.0 * variants_of_mother_in_child / mother_variants;
 
-		//count father variants
-		double father_variants = 0;
-		double variants_of_father_in_child = 0;
-		for(auto it=trio[Member::FATHER].variants.begin(); it!=trio[Member::FATHER].variants.end(); ++it)
+		//get relevant SNPs allele frequencies from BAMs (in parallel, the known SNPs are loaded once)
+		GenomeBuild build = stringToBuild(getEnum("build"));
+		VcfFile snps = NGSHelper::getKnownVariants(build, true);
+		QVector<VariantInfo> bam_variants(bams.count());
+		QStringList errors;
+		QMutex errors_mutex;
+		QThreadPool thread_pool;
+		thread_pool.setMaxThreadCount(threads);
+		for (int i=0; i<bams.count(); ++i)
 		{
-			if(trio[Member::MOTHER].variants.contains(it.key())) continue;
-			++father_variants;
-
-			if(trio[Member::CHILD].variants.contains(it.key()))
+			thread_pool.start([&, i]()
 			{
-				++variants_of_father_in_child;
-			}
+				try
+				{
+					bam_variants[i] = getVariants(bams[i], ref_file, snps, min_depth, min_alt_count);
+				}
+				catch(Exception& e)
+				{
+					QMutexLocker locker(&errors_mutex);
+					errors << bams[i] + ": " + e.message();
+				}
+			});
 		}
-		double perc_father = 100.0 * variants_of_father_in_child / father_variants;
+		thread_pool.waitForDone();
+		if (!errors.isEmpty()) THROW(Exception, "Processing BAM/CRAM files failed:\n" + errors.join("\n"));
 
 		//write output
 		QSharedPointer<QFile> file = Helper::openFileForWriting(getOutfile("out"), true);
 		QTextStream stream(file.data());
-		stream << "Variants in mother: " << mother_variants << "\n"
-			   << "Percentage of variants from mother passed to child: " << QString::number(perc_mother, 'f', 2) << "\n"
-			   << "Variants in father: " << father_variants << "\n"
-			   << "Percentage of variants from father passed to child: " << QString::number(perc_father, 'f', 2) << "\n"
-			   << "Ratio mother/father: " << QString::number(perc_mother/perc_father, 'f', 2) << "\n";
+		if (batch_mode)
+		{
+			stream << "#bam_c\tbam_f\tbam_m\tvariants_mother\tperc_passed_mother\tvariants_father\tperc_passed_father\tratio_mother_father\n";
+		}
+		foreach(const QStringList& trio, trios)
+		{
+			const VariantInfo& c = bam_variants[bams.indexOf(trio[0])];
+			const VariantInfo& f = bam_variants[bams.indexOf(trio[1])];
+			const VariantInfo& m = bam_variants[bams.indexOf(trio[2])];
+			TrioResult result = evaluate(c, f, m);
+
+			if (batch_mode)
+			{
+				stream << QFileInfo(trio[0]).fileName() << "\t" << QFileInfo(trio[1]).fileName() << "\t" << QFileInfo(trio[2]).fileName() << "\t"
+					   << result.mother_variants << "\t" << QString::number(result.perc_mother, 'f', 2) << "\t"
+					   << result.father_variants << "\t" << QString::number(result.perc_father, 'f', 2) << "\t"
+					   << QString::number(result.perc_mother/result.perc_father, 'f', 2) << "\n";
+			}
+			else
+			{
+				stream << "Variants in mother: " << result.mother_variants << "\n"
+					   << "Percentage of variants from mother passed to child: " << QString::number(result.perc_mother, 'f', 2) << "\n"
+					   << "Variants in father: " << result.father_variants << "\n"
+					   << "Percentage of variants from father passed to child: " << QString::number(result.perc_father, 'f', 2) << "\n"
+					   << "Ratio mother/father: " << QString::number(result.perc_mother/result.perc_father, 'f', 2) << "\n";
+			}
+		}
 	}
 };
 
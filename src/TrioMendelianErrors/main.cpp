@@ -1,6 +1,37 @@
 #include "ToolBase.h"
 #include "VcfFile.h"
 #include "VersatileFile.h"
+#include <QThreadPool>
+#include <QMutex>
+
+//Trio with column indices in the VCF and counts
+struct Trio
+{
+	QByteArray c;
+	QByteArray f;
+	QByteArray m;
+	int i_c = -1;
+	int i_f = -1;
+	int i_m = -1;
+
+	int vars_checked_snv = 0;
+	int vars_checked_indel = 0;
+	int vars_mer_snv = 0;
+	int vars_mer_indel = 0;
+	int skip_depth_low = 0;
+	int skip_depth_invalid = 0;
+	int skip_genotype_unknown = 0;
+	int skip_genotype_invalid = 0;
+};
+
+//VCF line that passed the trio-independent filters
+struct TrioVcfLine
+{
+	QByteArray line;
+	QByteArrayList parts;
+	int i_dp;
+	bool is_snv;
+};
 
 class ConcreteTool
 		: public ToolBase
@@ -17,11 +48,12 @@ public:
 	{
 		setDescription("Determines mendelian error rate from a trio VCF.");
 		addInfile("vcf", "Multi-sample VCF or VCF.GZ file.", false);
-		addString("c", "Sample name of child in VCF.", false);
-		addString("f", "Sample name of father in VCF.", false);
-		addString("m", "Sample name of mother in VCF.", false);
-
 		//optional
+		addString("c", "Sample name of child in VCF.", true);
+		addString("f", "Sample name of father in VCF.", true);
+		addString("m", "Sample name of mother in VCF.", true);
+		addInfile("trios", "TSV file with one trio per line (child, father and mother sample name). If given, all trios are evaluated in one pass over the VCF and a table with one line per trio is written. Alternative to 'c', 'f' and 'm'.", true);
+		addInt("threads", "Number of threads used to evaluate trios in batch mode.", true, 1);
 		addOutfile("out", "Output text file. If unset, writes to STDOUT.", true);
 		addInt("min_dp", "Minimum depth in each sample.", true, 0);
 		addFloat("min_qual", "Minimum QUAL of variants.", true, 0.0);
@@ -29,6 +61,7 @@ public:
 		addFlag("debug", "Enable debug output");
 
 		//changelog
+		changeLog(2026, 10, 19, "Added batch mode for many trios in a multi-sample VCF (parameters 'trios' and 'threads').");
 		changeLog(2026,  4, 21, "Added parameter 'dot_as_wt'.");
 		changeLog(2025,  2, 18, "Initial version of the tool.");
 	}
@@ -72,39 +105,165 @@ public:
 		return dp_val;
 	}
 
+	//checks depth/genotypes and counts mendelian errors of a trio
+	void evaluate(Trio& trio, const TrioVcfLine& vcf_line)
+	{
+		const QByteArrayList& parts = vcf_line.parts;
+
+		//filter for depth
+		if (min_dp_>0)
+		{
+			int dp_c = depth(parts, trio.i_c, vcf_line.i_dp);
+			int dp_f = depth(parts, trio.i_f, vcf_line.i_dp);
+			int dp_m = depth(parts, trio.i_m, vcf_line.i_dp);
+
+			//check if depth is valid
+			if (dp_c==-1 || dp_f==-1 || dp_m==-1)
+			{
+				if (debug_)
+				{
+					QMutexLocker locker(&out_mutex_);
+					out_->write("DEBUG - invalid DP: " + vcf_line.line + "\n");
+				}
+				++trio.skip_depth_invalid;
+				return;
+			}
+
+			//check depth if high enough
+			if (dp_c<min_dp_ || dp_f<min_dp_ || dp_m<min_dp_)
+			{
+				++trio.skip_depth_low;
+				return;
+			}
+		}
+
+		//determine genotypes
+		Genotype gt_c = genotype(parts, trio.i_c, dot_as_wt_);
+		Genotype gt_f = genotype(parts, trio.i_f, dot_as_wt_);
+		Genotype gt_m = genotype(parts, trio.i_m, dot_as_wt_);
+		if (gt_c==Genotype::UNKNOWN || gt_f==Genotype::UNKNOWN || gt_m==Genotype::UNKNOWN)
+		{
+			++trio.skip_genotype_unknown;
+			return;
+		}
+		if (gt_c==Genotype::INVALID || gt_f==Genotype::INVALID || gt_m==Genotype::INVALID)
+		{
+			++trio.skip_genotype_invalid;
+			return;
+		}
+
+		//perform mendelian error check
+		if (vcf_line.is_snv) ++trio.vars_checked_snv;
+		else ++trio.vars_checked_indel;
+
+		//hom, hom => het/wt
+		bool error = false;
+		if (gt_f==Genotype::HOM && gt_m==Genotype::HOM && gt_c!=Genotype::HOM) error = true;
+		//hom, x => wt
+		else if ((gt_f==Genotype::HOM || gt_m==Genotype::HOM) && gt_c==Genotype::WT) error = true;
+		//wt, x => hom
+		else if ((gt_f==Genotype::WT || gt_m==Genotype::WT) && gt_c==Genotype::HOM) error = true;
+		//wt, wt  => het/hom
+		else if (gt_f==Genotype::WT && gt_m==Genotype::WT && gt_c!=Genotype::WT) error = true;
+		if (error)
+		{
+			if (vcf_line.is_snv) ++trio.vars_mer_snv;
+			else ++trio.vars_mer_indel;
+		}
+	}
+
+	//evaluates a chunk of VCF lines for all trios (in parallel, one job per trio)
+	void evaluateChunk(QList<Trio>& trios, const QList<TrioVcfLine>& chunk)
+	{
+		if (chunk.isEmpty()) return;
+
+		if (threads_==1 || trios.count()==1)
+		{
+			for (int t=0; t<trios.count(); ++t)
+			{
+				foreach(const TrioVcfLine& vcf_line, chunk)
+				{
+					evaluate(trios[t], vcf_line);
+				}
+			}
+		}
+		else
+		{
+			QThreadPool thread_pool;
+			thread_pool.setMaxThreadCount(threads_);
+			for (int t=0; t<trios.count(); ++t)
+			{
+				thread_pool.start([&, t]()
+				{
+					foreach(const TrioVcfLine& vcf_line, chunk)
+					{
+						evaluate(trios[t], vcf_line);
+					}
+				});
+			}
+			thread_pool.waitForDone();
+		}
+	}
+
+	//returns the error rate in percent
+	static QByteArray errorRate(int errors, int checked)
+	{
+		return QByteArray::number(100.0*errors/checked, 'f', 2);
+	}
+
 	virtual void main()
-    {
+	{
 		//init
-		QSharedPointer<QFile> out = Helper::openFileForWriting(getOutfile("out"), true);
-		QByteArray c = getString("c").toUtf8();
-		QByteArray f = getString("f").toUtf8();
-		QByteArray m = getString("m").toUtf8();
-		int min_dp = getInt("min_dp");
+		out_ = Helper::openFileForWriting(getOutfile("out"), true);
+		min_dp_ = getInt("min_dp");
 		double min_qual = getFloat("min_qual");
-		bool debug = getFlag("debug");
-		bool dot_as_wt = getFlag("dot_as_wt");
+		debug_ = getFlag("debug");
+		dot_as_wt_ = getFlag("dot_as_wt");
+		threads_ = getInt("threads");
+		if (threads_<1) THROW(CommandLineParsingException, "Invalid number of threads: " + QString::number(threads_));
+
+		//trios
+		QList<Trio> trios;
+		QString trios_file = getInfile("trios");
+		bool batch_mode = !trios_file.isEmpty();
+		if (batch_mode)
+		{
+			if (!getString("c").isEmpty() || !getString("f").isEmpty() || !getString("m").isEmpty()) THROW(CommandLineParsingException, "Parameters 'c', 'f' and 'm' cannot be used together with 'trios'!");
+			foreach(const QString& line, Helper::loadTextFile(trios_file, true, '#', true))
+			{
+				QStringList parts = line.split('\t');
+				if (parts.count()<3) THROW(FileParseException, "Trios file line with less than three columns: " + line);
+
+				Trio trio;
+				trio.c = parts[0].toUtf8();
+				trio.f = parts[1].toUtf8();
+				trio.m = parts[2].toUtf8();
+				trios << trio;
+			}
+			if (trios.isEmpty()) THROW(FileParseException, "Trios file does not contain trios: " + trios_file);
+		}
+		else
+		{
+			if (getString("c").isEmpty() || getString("f").isEmpty() || getString("m").isEmpty()) THROW(CommandLineParsingException, "Parameters 'c', 'f' and 'm' are required if 'trios' is not given!");
+
+			Trio trio;
+			trio.c = getString("c").toUtf8();
+			trio.f = getString("f").toUtf8();
+			trio.m = getString("m").toUtf8();
+			trios << trio;
+		}
 
 		//column indices
 		int i_format = VcfFile::FORMAT;
-		int i_c = -1;
-		int i_f = -1;
-		int i_m = -1;
-
-		//output counts
-		int c_vars_checked_snv = 0;
-		int c_vars_checked_indel = 0;
-		int c_vars_mer_snv = 0;
-		int c_vars_mer_indel = 0;
+
+		//output counts (trio-independent)
 		int c_skip_not_autosome = 0;
 		int c_skip_multiallelic = 0;
-		int c_skip_depth_low = 0;
-		int c_skip_depth_invalid = 0;
 		int c_skip_qual_low = 0;
 		int c_skip_qual_invalid = 0;
-		int c_skip_genotype_unknown = 0;
-		int c_skip_genotype_invalid = 0;
 
 		//open stream
+		QList<TrioVcfLine> chunk;
 		VersatileFile file(getInfile("vcf"));
 		file.open();
 		while(!file.atEnd())
@@ -120,14 +279,18 @@ public:
 			//header line > determine column indices
 			if (line.startsWith('#'))
 			{
-				i_c = parts.indexOf(c);
-				if (i_c==-1) THROW(FileParseException, "Could not find FORMAT column for sample '" + c + "'!");
+				for (int t=0; t<trios.count(); ++t)
+				{
+					Trio& trio = trios[t];
+					trio.i_c = parts.indexOf(trio.c);
+					if (trio.i_c==-1) THROW(FileParseException, "Could not find FORMAT column for sample '" + trio.c + "'!");
 
-				i_f = parts.indexOf(f);
-				if (i_f==-1) THROW(FileParseException, "Could not find FORMAT column for sample '" + f + "'!");
+					trio.i_f = parts.indexOf(trio.f);
+					if (trio.i_f==-1) THROW(FileParseException, "Could not find FORMAT column for sample '" + trio.f + "'!");
 
-				i_m = parts.indexOf(m);
-				if (i_m==-1) THROW(FileParseException, "Could not find FORMAT column for sample '" + m + "'!");
+					trio.i_m = parts.indexOf(trio.m);
+					if (trio.i_m==-1) THROW(FileParseException, "Could not find FORMAT column for sample '" + trio.m + "'!");
+				}
 
 				continue;
 			}
@@ -168,88 +331,73 @@ public:
 				}
 			}
 
-			//filter for depth
-			if (min_dp>0)
-			{
-				int i_dp = parts[i_format].split(':').indexOf("DP");
-				int dp_c = depth(parts, i_c, i_dp);
-				int dp_f = depth(parts, i_f, i_dp);
-				int dp_m = depth(parts, i_m, i_dp);
-
-				//check if depth is valid
-				if (dp_c==-1 || dp_f==-1 || dp_m==-1)
-				{
-					if (debug) out->write("DEBUG - invalid DP: " + line + "\n");
-					++c_skip_depth_invalid;
-					continue;
-				}
-
-				//check depth if high enough
-				if (dp_c<min_dp || dp_f<min_dp || dp_m<min_dp)
-				{
-					++c_skip_depth_low;
-					continue;
-				}
-			}
-
-			//determine genotypes
-			Genotype gt_c = genotype(parts, i_c, dot_as_wt);
-			Genotype gt_f = genotype(parts, i_f, dot_as_wt);
-			Genotype gt_m = genotype(parts, i_m, dot_as_wt);
-			if (gt_c==Genotype::UNKNOWN || gt_f==Genotype::UNKNOWN || gt_m==Genotype::UNKNOWN)
-			{
-				++c_skip_genotype_unknown;
-				continue;
-			}
-			if (gt_c==Genotype::INVALID || gt_f==Genotype::INVALID || gt_m==Genotype::INVALID)
+			//evaluate trios (in chunks of lines, so that the trios can be evaluated in parallel)
+			int i_dp = min_dp_>0 ? parts[i_format].split(':').indexOf("DP") : -1;
+			bool is_snv = parts[VcfFile::REF].length()==1 && parts[VcfFile::ALT].length()==1;
+			chunk << TrioVcfLine{line, parts, i_dp, is_snv};
+			if (chunk.count()>=10000)
 			{
-				++c_skip_genotype_invalid;
-				continue;
+				evaluateChunk(trios, chunk);
+				chunk.clear();
 			}
+		}
+		evaluateChunk(trios, chunk);
 
-			//perform mendelian error check
-			bool is_snv = parts[VcfFile::REF].length()==1 && parts[VcfFile::ALT].length()==1;
-			if (is_snv) ++c_vars_checked_snv;
-			else ++c_vars_checked_indel;
-
-			//hom, hom => het/wt
-			bool error = false;
-			if (gt_f==Genotype::HOM && gt_m==Genotype::HOM && gt_c!=Genotype::HOM) error = true;
-			//hom, x => wt
-			else if ((gt_f==Genotype::HOM || gt_m==Genotype::HOM) && gt_c==Genotype::WT) error = true;
-			//wt, x => hom
-			else if ((gt_f==Genotype::WT || gt_m==Genotype::WT) && gt_c==Genotype::HOM) error = true;
-			//wt, wt  => het/hom
-			else if (gt_f==Genotype::WT && gt_m==Genotype::WT && gt_c!=Genotype::WT) error = true;
-			if (error)
+		//output (batch mode)
+		if (batch_mode)
+		{
+			QByteArrayList headers;
+			headers << "#child" << "father" << "mother" << "skipped_not_autosome" << "skipped_multiallelic";
+			if (min_dp_>0) headers << "skipped_depth_low" << "skipped_depth_invalid";
+			if (min_qual>0) headers << "skipped_quality_low" << "skipped_quality_invalid";
+			headers << "skipped_genotype_unknown" << "skipped_genotype_invalid" << "variants_checked" << "variants_checked_snvs" << "variants_checked_indels" << "mendelian_error_rate" << "mendelian_error_rate_snvs" << "mendelian_error_rate_indels";
+			out_->write(headers.join("\t") + "\n");
+
+			foreach(const Trio& trio, trios)
 			{
-				if (is_snv) ++c_vars_mer_snv;
-				else ++c_vars_mer_indel;
+				QByteArrayList cols;
+				cols << trio.c << trio.f << trio.m << QByteArray::number(c_skip_not_autosome) << QByteArray::number(c_skip_multiallelic);
+				if (min_dp_>0) cols << QByteArray::number(trio.skip_depth_low) << QByteArray::number(trio.skip_depth_invalid);
+				if (min_qual>0) cols << QByteArray::number(c_skip_qual_low) << QByteArray::number(c_skip_qual_invalid);
+				cols << QByteArray::number(trio.skip_genotype_unknown) << QByteArray::number(trio.skip_genotype_invalid);
+				cols << QByteArray::number(trio.vars_checked_snv+trio.vars_checked_indel) << QByteArray::number(trio.vars_checked_snv) << QByteArray::number(trio.vars_checked_indel);
+				cols << errorRate(trio.vars_mer_snv+trio.vars_mer_indel, trio.vars_checked_snv+trio.vars_checked_indel) << errorRate(trio.vars_mer_snv, trio.vars_checked_snv) << errorRate(trio.vars_mer_indel, trio.vars_checked_indel);
+				out_->write(cols.join("\t") + "\n");
 			}
+			return;
 		}
 
 		//output
-		out->write("Skipped variants not on autosomes: " + QByteArray::number(c_skip_not_autosome) + "\n");
-		out->write("Skipped variants with multi-allelic alt: " + QByteArray::number(c_skip_multiallelic) + "\n");
-		if (min_dp>0)
+		const Trio& trio = trios[0];
+		out_->write("Skipped variants not on autosomes: " + QByteArray::number(c_skip_not_autosome) + "\n");
+		out_->write("Skipped variants with multi-allelic alt: " + QByteArray::number(c_skip_multiallelic) + "\n");
+		if (min_dp_>0)
 		{
-			out->write("Skipped variants with low depth: " + QByteArray::number(c_skip_depth_low) + "\n");
-			out->write("Skipped variants for which no depth could be determined: " + QByteArray::number(c_skip_depth_invalid) + "\n");
+			out_->write("Skipped variants with low depth: " + QByteArray::number(trio.skip_depth_low) + "\n");
+			out_->write("Skipped variants for which no depth could be determined: " + QByteArray::number(trio.skip_depth_invalid) + "\n");
 		}
 		if (min_qual>0)
 		{
-			out->write("Skipped variants with low quality: " + QByteArray::number(c_skip_qual_low) + "\n");
-			out->write("Skipped variants for which no quality could be determined: " + QByteArray::number(c_skip_qual_invalid) + "\n");
+			out_->write("Skipped variants with low quality: " + QByteArray::number(c_skip_qual_low) + "\n");
+			out_->write("Skipped variants for which no quality could be determined: " + QByteArray::number(c_skip_qual_invalid) + "\n");
 		}
-		out->write("Skipped variants with (partially) unknown genotype: " + QByteArray::number(c_skip_genotype_unknown) + "\n");
-		out->write("Skipped variants with invalid genotype: " + QByteArray::number(c_skip_genotype_invalid) + "\n");
-		out->write("\n");
-
-		out->write("Variants checked: " + QByteArray::number(c_vars_checked_snv+c_vars_checked_indel) + " (SNVs: " + QByteArray::number(c_vars_checked_snv) +" InDels: " + QByteArray::number(c_vars_checked_indel) +")\n");
-		out->write("Mendelian error rate: " + QByteArray::number(100.0*(c_vars_mer_snv+c_vars_mer_indel)/(c_vars_checked_snv+c_vars_checked_indel), 'f', 2) + "%\n");
-		out->write("Mendelian error rate SNVs: " + QByteArray::number(100.0*c_vars_mer_snv/c_vars_checked_snv, 'f', 2) + "%\n");
-		out->write("Mendelian error rate InDels: " + QByteArray::number(100.0*c_vars_mer_indel/c_vars_checked_indel, 'f', 2) + "%\n");
+		out_->write("Skipped variants with (partially) unknown genotype: " + QByteArray::number(trio.skip_genotype_unknown) + "\n");
+		out_->write("Skipped variants with invalid genotype: " + QByteArray::number(trio.skip_genotype_invalid) + "\n");
+		out_->write("\n");
+
+		out_->write("Variants checked: " + QByteArray::number(trio.vars_checked_snv+trio.vars_checked_indel) + " (SNVs: " + QByteArray::number(trio.vars_checked_snv) +" InDels: " + QByteArray::number(trio.vars_checked_indel) +")\n");
+		out_->write("Mendelian error rate: " + errorRate(trio.vars_mer_snv+trio.vars_mer_indel, trio.vars_checked_snv+trio.vars_checked_indel) + "%\n");
+		out_->write("Mendelian error rate SNVs: " + errorRate(trio.vars_mer_snv, trio.vars_checked_snv) + "%\n");
+		out_->write("Mendelian error rate InDels: " + errorRate(trio.vars_mer_indel, trio.vars_checked_indel) + "%\n");
 	}
+
+private:
+	QSharedPointer<QFile> out_;
+	QMutex out_mutex_;
+	int min_dp_ = 0;
+	bool dot_as_wt_ = false;
+	bool debug_ = false;
+	int threads_ = 1;
 };
 
 
@@ -4,8 +4,22 @@
 #include "VcfFile.h"
 #include "BasicStatistics.h"
 #include <QTextStream>
+#include <QThreadPool>
+#include <QDir>
 #include <cmath>
 
+//Trio with output files and log
+struct Trio
+{
+	QByteArray c;
+	QByteArray f;
+	QByteArray m;
+	QString out;
+	QString out_informative;
+	QString log;
+	QString error;
+};
+
 class ConcreteTool
 	: public ToolBase
 {
@@ -20,13 +34,15 @@ public:
 	virtual void setup()
 	{
 		setDescription("UPD detection from trio variant data.");
-		addInfile("in", "Input VCF file of trio.", false, true);
-		addString("c", "Header name of child.", false);
-		addString("f", "Header name of father.", false);
-		addString("m", "Header name of mother.", false);
-		addOutfile("out", "Output TSV file containing the detected UPDs.", false, true);
+		addInfile("in", "Input VCF file of trio (or of several trios in batch mode).", false, true);
 		//optional
+		addString("c", "Header name of child.", true);
+		addString("f", "Header name of father.", true);
+		addString("m", "Header name of mother.", true);
+		addOutfile("out", "Output TSV file containing the detected UPDs. Required if 'trios' is not given.", true, true);
 		addOutfile("out_informative", "Output IGV file containing informative variants.", true, true);
+		addInfile("trios", "TSV file with one trio per line (child, father and mother header name, output TSV file and optionally output IGV file of informative variants). Relative paths are resolved relative to the TSV file. If given, the VCF is loaded once and the output files of each trio are the same as in a single run. Alternative to 'c', 'f', 'm', 'out' and 'out_informative'.", true);
+		addInt("threads", "Number of threads used to process trios in batch mode.", true, 1);
 		addInfileList("exclude", "BED file with regions to exclude, e.g. regions with N base or copy-number variant regions of the sample.", true);
 		addInt("var_min_dp", "Minimum depth (DP) of a variant (in all three samples).", true, 20);
 		addFloat("var_min_q", "Minimum quality (QUAL) of a variant.", true, 20);
@@ -39,6 +55,7 @@ public:
 		addFloat("reg_min_q", "Mimimum Q-score required for a UPD region.",  true, 20.0);
 		addFlag("debug", "Enable verbose debug output.");
 
+		changeLog(2026, 10, 19, "Added batch mode for many trios in a multi-sample VCF (parameters 'trios' and 'threads').");
 		changeLog(2026,  5,  5, "Added parameter 'var_use_special_calls' and fixed bug in handling of exclude regions.");
 		changeLog(2024,  6,  6, "Added optional output file containing informative variants.");
 		changeLog(2020,  8,  7, "VCF files only as input format for variant list.");
@@ -197,31 +214,14 @@ public:
 		THROW(ArgumentException, "Invalid string '" + str + "' for conversion to genotype!");
 	}
 
-	QList<VariantData> loadVariants(QTextStream& stream)
+	QList<VariantData> loadVariants(const VcfFile& variants, const BedFile& exclude_regions, const ChromosomalIndex<BedFile>& exclude_idx, const Trio& trio, QTextStream& stream)
 	{
 		QList<VariantData> output;
 
-		QByteArray c = getString("c").toUtf8();
-		QByteArray f = getString("f").toUtf8();
-		QByteArray m = getString("m").toUtf8();
-		int var_min_dp = getInt("var_min_dp");
-		double var_min_q = getFloat("var_min_q");
-		bool var_use_indels = getFlag("var_use_indels");
-		bool var_use_special_calls = getFlag("var_use_special_calls");
+		const QByteArray& c = trio.c;
+		const QByteArray& f = trio.f;
+		const QByteArray& m = trio.m;
 
-		//load exclude regions
-		BedFile exclude_regions;
-		foreach(QString filename, getInfileList("exclude"))
-		{
-			BedFile tmp;
-			tmp.load(filename);
-			exclude_regions.add(tmp);
-		}
-		exclude_regions.merge();
-		ChromosomalIndex<BedFile> exclude_idx(exclude_regions);
-
-		VcfFile variants;
-		variants.load(getInfile("in"));
 		int skip_chr = 0;
 		int skip_qual = 0;
 		int skip_dp = 0;
@@ -241,17 +241,17 @@ public:
 			}
 
 			//filter indels
-			if (!var_use_indels && !v.isSNV())
+			if (!var_use_indels_ && !v.isSNV())
 			{
 				++skip_indel;
 				continue;
 			}
 
 			//filter by quality
-			if (var_min_q>0)
+			if (var_min_q_>0)
 			{
 				if (v.qual() < 0) THROW(ArgumentException, "Quality not available for variant " + v.toString(true));
-				if (v.qual()<var_min_q)
+				if (v.qual()<var_min_q_)
 				{
 					++skip_qual;
 					continue;
@@ -259,7 +259,7 @@ public:
 			}
 
 			//filter by depth
-			if (var_min_dp>0)
+			if (var_min_dp_>0)
 			{
 				QByteArray tmp = v.formatValueFromSample("DP", c);
 				bool ok = true;
@@ -273,7 +273,7 @@ public:
 				tmp = v.formatValueFromSample("DP", m);
 				int dp3 = (tmp.isEmpty() || tmp==".") ? 0 : tmp.toInt(&ok);
 				if (!ok) THROW(ArgumentException, "Depth of mother  '" + tmp + "' is no integer - variant " + v.toString(true));
-				if (dp1<var_min_dp || dp2<var_min_dp || dp3<var_min_dp)
+				if (dp1<var_min_dp_ || dp2<var_min_dp_ || dp3<var_min_dp_)
 				{
 					++skip_dp;
 					continue;
@@ -281,7 +281,7 @@ public:
 			}
 
 			//filter special calls
-			if(!var_use_special_calls)
+			if(!var_use_special_calls_)
 			{
 				QByteArray ct_c = v.formatValueFromSample("CT", c);
 				if (ct_c==".") ct_c= "";
@@ -323,8 +323,8 @@ public:
 		stream << "Loaded " << output.count() << " of " << variants.count() << " variants" << Qt::endl;
 		stream << "  Skipped " << skip_chr << " variants not on autosomes" << Qt::endl;
 		stream << "  Skipped " << skip_indel << " indels" << Qt::endl;
-		stream << "  Skipped " << skip_qual << " variants because of low quality (<" << var_min_q << ")" << Qt::endl;
-		stream << "  Skipped " << skip_dp << " variants because of low depth (<" << var_min_dp << ")" << Qt::endl;
+		stream << "  Skipped " << skip_qual << " variants because of low quality (<" << var_min_q_ << ")" << Qt::endl;
+		stream << "  Skipped " << skip_dp << " variants because of low depth (<" << var_min_dp_ << ")" << Qt::endl;
 		stream << "  Skipped " << skip_ct << " variants because flagged as special call" << Qt::endl;
 		stream << "  Skipped " << skip_excluded << " variants in exclude region." << Qt::endl;
 
@@ -388,7 +388,6 @@ public:
 
 	QList<UpdRange> detectRanges(QList<VariantData>& data, QTextStream& stream)
 	{
-		double debug = getFlag("debug");
 
 		QList<UpdRange> output;
 
@@ -431,7 +430,7 @@ public:
 		}
 
 		stream << "Detected " << output.count() << " raw ranges" << Qt::endl;
-		if (debug)
+		if (debug_)
 		{
 			foreach(const UpdRange& range, output)
 			{
@@ -444,9 +443,6 @@ public:
 
 	void mergeRanges(QList<UpdRange>& ranges, QTextStream& stream)
 	{
-		double ext_marker_perc = getFloat("ext_marker_perc");
-		double ext_size_perc = getFloat("ext_size_perc");
-		double debug = getFlag("debug");
 
 		bool merged = true;
 		while(merged)
@@ -459,15 +455,15 @@ public:
 				if (ranges[i].start->source!=ranges[i+1].start->source) continue;
 
 				double marker_diff = ranges[i+1].start - ranges[i].end;
-				double marker_cutoff = ext_marker_perc / 100.0 * (ranges[i].sizeMarkers() + ranges[i+1].sizeMarkers());
+				double marker_cutoff = ext_marker_perc_ / 100.0 * (ranges[i].sizeMarkers() + ranges[i+1].sizeMarkers());
 
 				double base_diff = ranges[i+1].start->start - (ranges[i].end-1)->end;
-				double base_cutoff = ext_size_perc / 100.0 * (ranges[i].sizeBases() + ranges[i+1].sizeBases());
+				double base_cutoff = ext_size_perc_ / 100.0 * (ranges[i].sizeBases() + ranges[i+1].sizeBases());
 
 				//merge
 				if (marker_diff<marker_cutoff || base_diff<base_cutoff)
 				{
-					if (debug)
+					if (debug_)
 					{
 						stream << "Merging ranges:" << Qt::endl;
 						stream << "  " << ranges[i].toString() << Qt::endl;
@@ -486,14 +482,10 @@ public:
 		stream << "Merged adjacent raw regions resulting in " << ranges.count() << " region(s)" << Qt::endl;
 	}
 
-	void writeOutput(QList<UpdRange>& ranges, double p_biparental, double p_upd, QTextStream& stream)
+	void writeOutput(QList<UpdRange>& ranges, double p_biparental, double p_upd, QString out, QTextStream& stream)
 	{
-		QString out = getOutfile("out");
 		if (!out.endsWith(".tsv")) THROW(ArgumentException, "Output file name has to end with '.tsv'!");
-		int reg_min_markers = getInt("reg_min_markers");
-		double reg_min_bases = 1000.0 * getFloat("reg_min_kb");
-		double reg_min_q = getFloat("reg_min_q");
-		bool debug = getFlag("debug");
+		double reg_min_bases = 1000.0 * reg_min_kb_;
 
 		QSharedPointer<QFile> output = Helper::openFileForWriting(out);
 		output->write("#chr\tstart\tend\tsize_kb\tsize_markers\tupd_markers\tsource\thet_percentage\tq-score\n");
@@ -502,9 +494,9 @@ public:
 		{
 			if (range.sizeBases()<reg_min_bases) continue;
 			int upd_markers = range.countType(ISO)+range.countType(ISO_OR_HET);
-			if (upd_markers<reg_min_markers) continue;
+			if (upd_markers<reg_min_markers_) continue;
 			double q_score = range.qScore(p_biparental, p_upd);
-			if (q_score<reg_min_q) continue;
+			if (q_score<reg_min_q_) continue;
 
 			output->write(range.start->chr.str() + "\t" + QByteArray::number(range.start->start) + "\t" + QByteArray::number((range.end-1)->end)
 						  + "\t" + QByteArray::number(range.sizeBases()/1000.0, 'f', 3)
@@ -517,7 +509,7 @@ public:
 
 			++c_passing;
 
-			if (debug)
+			if (debug_)
 			{
 				stream << "  Range: " << range.toString() << Qt::endl;
 			}
@@ -525,9 +517,8 @@ public:
 		stream << "Written " << c_passing << " ranges that pass the filters" << Qt::endl;
 	}
 
-	void writeInformativeVariants(QList<VariantData>& data)
+	void writeInformativeVariants(QList<VariantData>& data, QString out)
 	{
-		QString out = getOutfile("out_informative");
 		if (out.isEmpty()) return;
 		if (!out.endsWith(".igv")) THROW(ArgumentException, "Output file name for informative variants has to end with '.igv'!");
 
@@ -568,15 +559,12 @@ public:
 		}
 	}
 
-	virtual void main()
+	//detects UPDs of a trio and writes the output files
+	void processTrio(const VcfFile& variants, const BedFile& exclude_regions, const ChromosomalIndex<BedFile>& exclude_idx, const Trio& trio, QTextStream& stream)
 	{
-		//init
-		BasicStatistics::precalculateFactorials();
-		QTextStream stream(stdout);
-
 		//load genotype data
 		stream << "### Loading variant/genotype data ###" << Qt::endl;
-		QList<VariantData> data = loadVariants(stream);
+		QList<VariantData> data = loadVariants(variants, exclude_regions, exclude_idx, trio, stream);
 		stream << Qt::endl;
 
 		//check medelian errors
@@ -637,11 +625,135 @@ public:
 		}
 
 		//write output
-		writeOutput(ranges, p_biparental, p_upd, stream);
+		writeOutput(ranges, p_biparental, p_upd, trio.out, stream);
 
 		//write informative variant output
-		writeInformativeVariants(data);
+		writeInformativeVariants(data, trio.out_informative);
 	}
+
+	virtual void main()
+	{
+		//init
+		BasicStatistics::precalculateFactorials();
+		QTextStream stream(stdout);
+		var_min_dp_ = getInt("var_min_dp");
+		var_min_q_ = getFloat("var_min_q");
+		var_use_indels_ = getFlag("var_use_indels");
+		var_use_special_calls_ = getFlag("var_use_special_calls");
+		ext_marker_perc_ = getFloat("ext_marker_perc");
+		ext_size_perc_ = getFloat("ext_size_perc");
+		reg_min_kb_ = getFloat("reg_min_kb");
+		reg_min_markers_ = getInt("reg_min_markers");
+		reg_min_q_ = getFloat("reg_min_q");
+		debug_ = getFlag("debug");
+		int threads = getInt("threads");
+		if (threads<1) THROW(CommandLineParsingException, "Invalid number of threads: " + QString::number(threads));
+
+		//trios
+		QList<Trio> trios;
+		QString trios_file = getInfile("trios");
+		bool batch_mode = !trios_file.isEmpty();
+		if (batch_mode)
+		{
+			if (!getString("c").isEmpty() || !getString("f").isEmpty() || !getString("m").isEmpty() || !getOutfile("out").isEmpty() || !getOutfile("out_informative").isEmpty()) THROW(CommandLineParsingException, "Parameters 'c', 'f', 'm', 'out' and 'out_informative' cannot be used together with 'trios'!");
+			QDir trios_dir = QFileInfo(trios_file).absoluteDir();
+			foreach(const QString& line, Helper::loadTextFile(trios_file, true, '#', true))
+			{
+				QStringList parts = line.split('\t');
+				if (parts.count()<4) THROW(FileParseException, "Trios file line with less than four columns: " + line);
+
+				Trio trio;
+				trio.c = parts[0].trimmed().toUtf8();
+				trio.f = parts[1].trimmed().toUtf8();
+				trio.m = parts[2].trimmed().toUtf8();
+				trio.out = QDir::cleanPath(trios_dir.absoluteFilePath(parts[3].trimmed()));
+				if (parts.count()>4 && !parts[4].trimmed().isEmpty()) trio.out_informative = QDir::cleanPath(trios_dir.absoluteFilePath(parts[4].trimmed()));
+				trios << trio;
+			}
+			if (trios.isEmpty()) THROW(FileParseException, "Trios file does not contain trios: " + trios_file);
+		}
+		else
+		{
+			if (getString("c").isEmpty() || getString("f").isEmpty() || getString("m").isEmpty() || getOutfile("out").isEmpty()) THROW(CommandLineParsingException, "Parameters 'c', 'f', 'm' and 'out' are required if 'trios' is not given!");
+
+			Trio trio;
+			trio.c = getString("c").toUtf8();
+			trio.f = getString("f").toUtf8();
+			trio.m = getString("m").toUtf8();
+			trio.out = getOutfile("out");
+			trio.out_informative = getOutfile("out_informative");
+			trios << trio;
+		}
+
+		//load exclude regions
+		BedFile exclude_regions;
+		foreach(QString filename, getInfileList("exclude"))
+		{
+			BedFile tmp;
+			tmp.load(filename);
+			exclude_regions.add(tmp);
+		}
+		exclude_regions.merge();
+		ChromosomalIndex<BedFile> exclude_idx(exclude_regions);
+
+		//load variants (once for all trios)
+		VcfFile variants;
+		variants.load(getInfile("in"));
+
+		//single trio
+		if (!batch_mode)
+		{
+			processTrio(variants, exclude_regions, exclude_idx, trios[0], stream);
+			return;
+		}
+
+		//batch mode: process trios in parallel (the log of each trio is buffered and written in the order of the trios file)
+		QThreadPool thread_pool;
+		thread_pool.setMaxThreadCount(threads);
+		for (int t=0; t<trios.count(); ++t)
+		{
+			thread_pool.start([&, t]()
+			{
+				Trio& trio = trios[t];
+				QTextStream trio_stream(&trio.log);
+				try
+				{
+					processTrio(variants, exclude_regions, exclude_idx, trio, trio_stream);
+				}
+				catch(Exception& e)
+				{
+					trio.error = e.message();
+				}
+			});
+		}
+		thread_pool.waitForDone();
+
+		QStringList failed;
+		foreach(const Trio& trio, trios)
+		{
+			stream << "##### Trio " << trio.c << " (father: " << trio.f << ", mother: " << trio.m << ") #####" << Qt::endl;
+			stream << trio.log;
+			if (!trio.error.isEmpty())
+			{
+				stream << "Error: " << trio.error << Qt::endl;
+				failed << trio.c;
+			}
+			stream << Qt::endl;
+		}
+		if (!failed.isEmpty()) THROW(ArgumentException, "UPD detection failed for " + QString::number(failed.count()) + " trio(s): " + failed.join(", "));
+	}
+
+private:
+	int var_min_dp_ = 20;
+	double var_min_q_ = 20.0;
+	bool var_use_indels_ = false;
+	bool var_use_special_calls_ = false;
+	double ext_marker_perc_ = 1.0;
+	double ext_size_perc_ = 20.0;
+	double reg_min_kb_ = 1000.0;
+	int reg_min_markers_ = 15;
+	double reg_min_q_ = 20.0;
+	bool debug_ = false;
 };
 
 #include "main.moc"
@@ -0,0 +1,192 @@
+#include "ToolBase.h"
+#include "VariantCountStore.h"
+#include "VariantList.h"
+#include "VcfFile.h"
+#include "VersatileFile.h"
+#include "Helper.h"
+#include <QThreadPool>
+#include <QMutex>
+#include <QFileInfo>
+
+class ConcreteTool
+		: public ToolBase
+{
+	Q_OBJECT
+
+public:
+	ConcreteTool(int& argc, char *argv[])
+		: ToolBase(argc, argv)
+	{
+	}
+
+	virtual void setup()
+	{
+		setDescription("Refreshes the NGSD columns of GSvar files using a variant count store.");
+		setExtendedDescription(QStringList() << "Updates the columns NGSD_hom, NGSD_het, NGSD_group and (if present) NGSD_mosaic, classification, classification_comment and comment."
+											 << "The disease group of the NGSD_group column is taken from the sample header of the GSvar file (first affected sample)."
+											 << "The store is created with VariantCountStoreCreate. All other columns are written unchanged.");
+		addInfileList("in", "Input GSvar file(s).", false);
+		addInfile("store", "Variant count store created with VariantCountStoreCreate.", false);
+		//optional
+		addOutfile("out", "Output GSvar file. If unset, the input files are updated in place. Can only be used with one input file.", true);
+		addInt("threads", "Number of threads used. Each thread processes one GSvar file.", true, 1);
+
+		changeLog(2026, 10, 19, "First version.");
+	}
+
+	//returns the value of the disease group counts in GSvar format
+	static QByteArray groupCounts(const VariantCountData& data, const QByteArray& group_key)
+	{
+		QByteArrayList counts = data.infoValue(group_key).split(',');
+		if (counts.count()!=2) return "0 / 0";
+		return counts[0] + " / " + counts[1];
+	}
+
+	//returns the plain text of an INFO value of the export, i.e. without surrounding quotes and URL encoding (tabs and line breaks are replaced by spaces because they would break the GSvar format)
+	static QByteArray plainText(QByteArray value)
+	{
+		if (value.size()>=2 && value.startsWith('"') && value.endsWith('"')) value = value.mid(1, value.size()-2);
+		value = VcfFile::decodeInfoValue(value).toUtf8();
+		value.replace('\t', ' ').replace('\n', ' ').replace('\r', ' ');
+		return value;
+	}
+
+	//updates the NGSD columns of one GSvar file
+	static void annotate(const VariantCountStore& store, QString in, QString out)
+	{
+		//determine disease group
+		VariantList header;
+		header.loadHeaderOnly(in);
+		QString disease_group = "n/a";
+		SampleHeaderInfo samples = header.getSampleHeader(false);
+		for (int i=0; i<samples.count(); ++i)
+		{
+			if (i==0 || samples[i].isAffected())
+			{
+				disease_group = samples[i].properties.value("DiseaseGroup", "n/a");
+				if (samples[i].isAffected()) break;
+			}
+		}
+		QByteArray group_key = store.diseaseGroupKey(disease_group);
+		if (group_key.isEmpty()) THROW(ArgumentException, "Disease group '" + disease_group + "' of GSvar file " + in + " is not contained in the variant count store!");
+		QByteArray high_af = "n/a (AF>" + QByteArray::number(100.0 * store.maxAf()) + "%)";
+
+		//write to temporary file in the output folder (in-place update)
+		QString tmp = out + ".tmp";
+		{
+			VersatileFile in_file(in, false);
+			in_file.open(QFile::ReadOnly | QIODevice::Text);
+			QSharedPointer<QFile> out_file = Helper::openFileForWriting(tmp);
+
+			int i_hom = -1;
+			int i_het = -1;
+			int i_mosaic = -1;
+			int i_group = -1;
+			int i_class = -1;
+			int i_class_comment = -1;
+			int i_comment = -1;
+			while(!in_file.atEnd())
+			{
+				QByteArray line = in_file.readLine(true);
+
+				//header
+				if (line.startsWith("##") || line.isEmpty())
+				{
+					out_file->write(line + "\n");
+					continue;
+				}
+				QByteArrayList parts = line.split('\t');
+				if (line.startsWith("#"))
+				{
+					i_hom = parts.indexOf("NGSD_hom");
+					i_het = parts.indexOf("NGSD_het");
+					i_mosaic = parts.indexOf("NGSD_mosaic");
+					i_group = parts.indexOf("NGSD_group");
+					i_class = parts.indexOf("classification");
+					i_class_comment = parts.indexOf("classification_comment");
+					i_comment = parts.indexOf("comment");
+					if (i_hom==-1 || i_het==-1 || i_group==-1) THROW(FileParseException, "GSvar file " + in + " does not contain the NGSD columns 'NGSD_hom', 'NGSD_het' and 'NGSD_group'!");
+
+					out_file->write(line + "\n");
+					continue;
+				}
+				if (i_hom==-1) THROW(FileParseException, "GSvar file " + in + " does not contain a header line!");
+				if (parts.count()<5) THROW(FileParseException, "GSvar line with less than 5 columns in " + in + ": " + line);
+
+				//lookup variant
+				Variant variant(parts[0], Helper::toInt(parts[1], "start", line), Helper::toInt(parts[2], "end", line), parts[3], parts[4]);
+				VariantCountData data = store.get(variant);
+
+				//update counts
+				if (data.high_af)
+				{
+					parts[i_hom] = high_af;
+					parts[i_het] = high_af;
+					parts[i_group] = high_af;
+					if (i_mosaic!=-1) parts[i_mosaic] = high_af;
+				}
+				else
+				{
+					parts[i_hom] = QByteArray::number(std::max(data.hom, 0));
+					parts[i_het] = QByteArray::number(std::max(data.het, 0));
+					parts[i_group] = groupCounts(data, group_key);
+					if (i_mosaic!=-1) parts[i_mosaic] = QByteArray::number(std::max(data.mosaic, 0));
+				}
+
+				//update classification and comment
+				if (i_class!=-1) parts[i_class] = plainText(data.infoValue("CLAS"));
+				if (i_class_comment!=-1) parts[i_class_comment] = plainText(data.infoValue("CLAS_COM"));
+				if (i_comment!=-1) parts[i_comment] = plainText(data.infoValue("COM"));
+
+				out_file->write(parts.join('\t') + "\n");
+			}
+			out_file->close();
+		}
+
+		//replace output file
+		if (QFile::exists(out) && !QFile::remove(out)) THROW(FileAccessException, "Could not remove file " + out);
+		if (!QFile::rename(tmp, out)) THROW(FileAccessException, "Could not rename " + tmp + " to " + out);
+	}
+
+	virtual void main()
+	{
+		//init
+		QStringList in = getInfileList("in");
+		QString out = getOutfile("out");
+		if (!out.isEmpty() && in.count()>1) THROW(CommandLineParsingException, "Parameter 'out' can only be used with one input file!");
+		int threads = getInt("threads");
+		if (threads<1) THROW(CommandLineParsingException, "Invalid number of threads: " + QString::number(threads));
+		VariantCountStore store(getInfile("store"));
+
+		//process GSvar files
+		QStringList errors;
+		QMutex errors_mutex;
+		QThreadPool thread_pool;
+		thread_pool.setMaxThreadCount(threads);
+		for (int i=0; i<in.count(); ++i)
+		{
+			thread_pool.start([&, i]()
+			{
+				try
+				{
+					annotate(store, in[i], out.isEmpty() ? in[i] : out);
+				}
+				catch(Exception& e)
+				{
+					QMutexLocker locker(&errors_mutex);
+					errors << QFileInfo(in[i]).fileName() + ": " + e.message();
+				}
+			});
+		}
+		thread_pool.waitForDone();
+		if (!errors.isEmpty()) THROW(Exception, "Processing GSvar files failed:\n" + errors.join("\n"));
+	}
+};
+
+#include "main.moc"
+
+int main(int argc, char *argv[])
+{
+	ConcreteTool tool(argc, argv);
+	return tool.execute();
+}
@@ -0,0 +1,39 @@
+#include "ToolBase.h"
+#include "VariantCountStore.h"
+
+class ConcreteTool
+		: public ToolBase
+{
+	Q_OBJECT
+
+public:
+	ConcreteTool(int& argc, char *argv[])
+		: ToolBase(argc, argv)
+	{
+	}
+
+	virtual void setup()
+	{
+		setDescription("Creates a variant count store from the germline NGSD export VCF.");
+		setExtendedDescription(QStringList() << "The store contains the NGSD counts, disease group counts, classification and comment of each variant exported by NGSDExportAnnotationData."
+											 << "Variants are stored as hashes of the GSvar representation, sorted by hash."
+											 << "It is used by VariantAnnotateCountStore to refresh the NGSD columns of GSvar files without re-running the annotation.");
+		addInfile("in", "Germline VCF file created by NGSDExportAnnotationData (plain or gzipped).", false);
+		addOutfile("out", "Output variant count store file.", false);
+
+		changeLog(2026, 10, 19, "First version.");
+	}
+
+	virtual void main()
+	{
+		VariantCountStore::create(getInfile("in"), getOutfile("out"));
+	}
+};
+
+#include "main.moc"
+
+int main(int argc, char *argv[])
+{
+	ConcreteTool tool(argc, argv);
+	return tool.execute();
+}
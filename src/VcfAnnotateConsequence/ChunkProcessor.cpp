@@ -3,6 +3,7 @@
 #include "Helper.h"
 #include "VcfFile.h"
 #include "VariantList.h"
+#include "RefGenomeService.h"
 
 
 ChunkProcessor::ChunkProcessor(AnalysisJob &job, const MetaData& settings, const Parameters& params)
@@ -11,7 +12,7 @@ ChunkProcessor::ChunkProcessor(AnalysisJob &job, const MetaData& settings, const
 	, job_(job)
 	, settings_(settings)
 	, params_(params)
-	, reference_(settings.reference)
+	, reference_(RefGenomeService::getReferenceGenomeIndex(settings.reference))
 	, hgvs_anno_(reference_, settings_.annotation_parameters)
 {
     if (params_.debug) QTextStream(stdout) << "ChunkProcessor(): " << job_.index << Qt::endl;
@@ -33,7 +33,7 @@ private:
 	AnalysisJob& job_;
 	const MetaData& settings_;
 	const Parameters& params_;
-	const FastaFileIndex reference_; // not thread-save -> each creates own copy
+	const FastaFileIndex& reference_; // memory-mapped, shared by all threads
 	VariantHgvsAnnotator hgvs_anno_;
 
 	int lines_annotated_ = 0;
@@ -3,6 +3,7 @@
 
 #include <QByteArray>
 #include <QString>
+#include "BedFile.h"
 
 //Analysis status
 enum AnalysisStatus
@@ -18,6 +19,7 @@ struct AnalysisJob
 {
 	QList<QByteArray> current_chunk;
 	QList<QByteArray> current_chunk_processed;
+	QList<BedFile> current_chunk_regions; //BED lines overlapping the variants of the chunk - one BedFile per annotation (streaming mode only)
 	QString error_message;
 
 	//id used to keep the vcf file in order
@@ -28,9 +30,18 @@ struct AnalysisJob
 	{
 		current_chunk.clear();
 		current_chunk_processed.clear();
+		current_chunk_regions.clear();
 		error_message.clear();
 		status = DONE;
 	}
 };
 
+//Annotation source
+struct BedAnnotation
+{
+	QByteArray file; //BED file path
+	QByteArray name; //INFO key
+	QByteArray desc; //custom INFO header description (optional)
+};
+
 #endif // AUXILARY_H
@@ -0,0 +1,79 @@
+#include "BedStreamWindow.h"
+#include "Exceptions.h"
+
+BedStreamWindow::BedStreamWindow(QString filename, QByteArray sep)
+	: stream_(filename, false, true)
+	, sep_(sep)
+	, chr_()
+	, active_()
+{
+}
+
+void BedStreamWindow::addOverlapping(const Chromosome& chr, int start, int end, BedFile& regions)
+{
+	//remove lines that cannot overlap this or following variants
+	if (chr!=chr_)
+	{
+		active_.clear();
+		chr_ = chr;
+	}
+	for (int i=active_.count()-1; i>=0; --i)
+	{
+		if (active_[i].line.end()<start) active_.removeAt(i);
+	}
+
+	//read lines that start before the variant end (lines of previous chromosomes are skipped)
+	while (!stream_.atEnd())
+	{
+		const BedLine& next = stream_.peek();
+		if (next.chr()==chr)
+		{
+			if (next.start()>end) break;
+		}
+		else if (next.chr()>chr)
+		{
+			break;
+		}
+
+		BedLine line = readLine();
+		if (line.chr()==chr && line.end()>=start)
+		{
+			active_.append(ActiveLine{line, false});
+		}
+	}
+
+	//add overlapping lines
+	for (int i=0; i<active_.count(); ++i)
+	{
+		ActiveLine& active = active_[i];
+		if (active.in_chunk || !active.line.overlapsWith(start, end)) continue;
+
+		regions.append(active.line);
+		active.in_chunk = true;
+	}
+}
+
+void BedStreamWindow::newChunk()
+{
+	for (int i=0; i<active_.count(); ++i)
+	{
+		active_[i].in_chunk = false;
+	}
+}
+
+BedLine BedStreamWindow::readLine()
+{
+	BedLine line;
+	stream_.next(line);
+
+	if (line.annotations().count()==0)
+	{
+		THROW(FileParseException, "BED line '" + line.toString(true) + "' has no name column: " + line.toString(true));
+	}
+	if (line.annotations()[0].contains(sep_))
+	{
+		THROW(FileParseException, "BED line '" + line.toString(true) + "' name column contains separator: " + line.annotations()[0]);
+	}
+
+	return line;
+}
@@ -0,0 +1,39 @@
+#ifndef BEDSTREAMWINDOW_H
+#define BEDSTREAMWINDOW_H
+
+#include "BedFileStream.h"
+
+//Active regions of a sorted BED file that is read in lockstep with a sorted VCF file.
+//Only the BED lines that can overlap the current or following variants are kept in memory.
+class BedStreamWindow
+{
+public:
+	BedStreamWindow(QString filename, QByteArray sep);
+
+	//Moves the window to the given variant and appends overlapping BED lines to @p regions (each line only once per chunk).
+	//The variants have to be passed in sorted order.
+	void addOverlapping(const Chromosome& chr, int start, int end, BedFile& regions);
+	//Starts a new chunk, i.e. active BED lines can be appended again.
+	void newChunk();
+
+private:
+	struct ActiveLine
+	{
+		BedLine line;
+		bool in_chunk;
+	};
+
+	BedFileStream stream_;
+	QByteArray sep_;
+	Chromosome chr_;
+	QList<ActiveLine> active_;
+
+	//reads the next BED line and checks the name column
+	BedLine readLine();
+
+	//declared away
+	BedStreamWindow(const BedStreamWindow&) = delete;
+	BedStreamWindow& operator=(const BedStreamWindow&) = delete;
+};
+
+#endif // BEDSTREAMWINDOW_H
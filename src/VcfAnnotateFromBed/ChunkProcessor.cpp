@@ -4,17 +4,16 @@
 #include "VcfFile.h"
 //#include "VariantList.h"
 
-ChunkProcessor::ChunkProcessor(AnalysisJob &job_, QByteArray name_, const BedFile& bed_file_, const ChromosomalIndex<BedFile>& bed_index_, QByteArray bed_file_path_, QByteArray sep_, QByteArray desc_)
+ChunkProcessor::ChunkProcessor(AnalysisJob &job_, const QList<BedAnnotation>& annotations_, const QList<BedFile>& bed_files_, const QList<QSharedPointer<ChromosomalIndex<BedFile>>>& bed_indices_, QByteArray sep_, bool stream_)
 
 	:QRunnable()
 	, terminate_(false)
 	, job(job_)
-	, name(name_)
-	, bed_file(bed_file_)
-	, bed_index(bed_index_)
-	, bed_file_path(bed_file_path_)
+	, annotations(annotations_)
+	, bed_files(bed_files_)
+	, bed_indices(bed_indices_)
 	, sep(sep_)
-	, desc(desc_)
+	, stream(stream_)
 {
 }
 
@@ -25,6 +24,21 @@ void ChunkProcessor::run()
 {
 	job.error_message.clear();
 	job.current_chunk_processed.clear();
+
+	//streaming mode: index the BED lines overlapping the variants of this chunk
+	QList<QSharedPointer<ChromosomalIndex<BedFile>>> chunk_indices;
+	if (stream)
+	{
+		for (int a=0; a<job.current_chunk_regions.count(); ++a)
+		{
+			BedFile& regions = job.current_chunk_regions[a];
+			if (!regions.isSorted()) regions.sort();
+			chunk_indices << QSharedPointer<ChromosomalIndex<BedFile>>(new ChromosomalIndex<BedFile>(regions));
+		}
+	}
+	const QList<BedFile>& beds = stream ? job.current_chunk_regions : bed_files;
+	const QList<QSharedPointer<ChromosomalIndex<BedFile>>>& indices = stream ? chunk_indices : bed_indices;
+
 	// read file
 	foreach(QByteArray line, job.current_chunk)
 	{
@@ -36,18 +50,20 @@ void ChunkProcessor::run()
 		//write out headers unchanged
 		if (line.startsWith('#'))
 		{
-			//append header line for new annotation
+			//append header lines for new annotations
 			if (line.startsWith("#CHROM"))
 			{
-				if (desc.trimmed().isEmpty())
+				foreach(const BedAnnotation& anno, annotations)
 				{
-					job.current_chunk_processed.append("##INFO=<ID=" + name + ",Number=.,Type=String,Description=\"Annotation from " + QFileInfo(bed_file_path).fileName().toLatin1() + " delimited by '" + sep + "'\">\n");
+					if (anno.desc.trimmed().isEmpty())
+					{
+						job.current_chunk_processed.append("##INFO=<ID=" + anno.name + ",Number=.,Type=String,Description=\"Annotation from " + QFileInfo(anno.file).fileName().toLatin1() + " delimited by '" + sep + "'\">\n");
+					}
+					else
+					{
+						job.current_chunk_processed.append("##INFO=<ID=" + anno.name + ",Number=.,Type=String,Description=\"" + QByteArray(anno.desc).replace("_", " ") + "\">\n");
+					}
 				}
-				else
-				{
-					job.current_chunk_processed.append("##INFO=<ID=" + name + ",Number=.,Type=String,Description=\"" + desc.replace("_", " ") + "\">\n");
-				}
-
 			}
 			job.current_chunk_processed.append(line + "\n");
 			continue;
@@ -73,27 +89,32 @@ void ChunkProcessor::run()
 		int end = start + parts[3].length() - 1; //length of ref
 
 		//get annotation data
-		QByteArrayList annos;
-		QVector<int> indices = bed_index.matchingIndices(chr, start, end);
-		foreach(int index, indices)
+		bool annotated = false;
+		for (int a=0; a<annotations.count(); ++a)
 		{
-			annos << bed_file[index].annotations()[0];
+			QByteArrayList annos;
+			QVector<int> matches = indices[a]->matchingIndices(chr, start, end);
+			foreach(int index, matches)
+			{
+				annos << beds[a][index].annotations()[0];
+			}
+			if (annos.isEmpty()) continue;
+
+			// add INFO column annotation
+			if(parts[7] == ".") parts[7].clear(); // remove '.' if column was empty before
+			if(!parts[7].isEmpty()) parts[7].append(';');
+			parts[7].append(annotations[a].name + "=" + VcfFile::encodeInfoValue(annos.join(sep)).toUtf8());
+			annotated = true;
 		}
 
 		//write output line
-		if (annos.isEmpty())
+		if (annotated)
 		{
-			job.current_chunk_processed.append(line + "\n");
+			job.current_chunk_processed.append(parts.join('\t') + "\n");
 		}
 		else
 		{
-			// add INFO column annotation
-			if(parts[7] == ".") parts[7].clear(); // remove '.' if column was empty before
-			if(!parts[7].isEmpty()) parts[7].append(';');
-			parts[7].append(name + "=" + VcfFile::encodeInfoValue(annos.join(sep)).toUtf8());
-
-			job.current_chunk_processed.append(parts.join('\t') + "\n");
-
+			job.current_chunk_processed.append(line + "\n");
 		}
 	}
 
@@ -3,6 +3,7 @@
 
 #include <QRunnable>
 #include <QByteArray>
+#include <QSharedPointer>
 //#include <iostream>
 #include "ChromosomalIndex.h"
 #include "Auxilary.h"
@@ -12,7 +13,8 @@ class ChunkProcessor
 		:public QRunnable
 {
 public:
-	ChunkProcessor(AnalysisJob &job_, QByteArray name_, const BedFile& bed_file_, const ChromosomalIndex<BedFile>& bed_index_, QByteArray bed_file_path_, QByteArray sep_, QByteArray desc_);
+	///Constructor. In streaming mode, the BED lines of the chunk are taken from the job and @p bed_files_/@p bed_indices_ are not used.
+	ChunkProcessor(AnalysisJob &job_, const QList<BedAnnotation>& annotations_, const QList<BedFile>& bed_files_, const QList<QSharedPointer<ChromosomalIndex<BedFile>>>& bed_indices_, QByteArray sep_, bool stream_);
 	void run();
 
 	void terminate()
@@ -23,12 +25,11 @@ public:
 private:
 	bool terminate_;
 	AnalysisJob& job;
-	QByteArray name;
-	const BedFile& bed_file;
-	const ChromosomalIndex<BedFile>& bed_index;
-	QByteArray bed_file_path;
+	const QList<BedAnnotation>& annotations;
+	const QList<BedFile>& bed_files;
+	const QList<QSharedPointer<ChromosomalIndex<BedFile>>>& bed_indices;
 	QByteArray sep;
-	QByteArray desc;
+	bool stream;
 };
 
 #endif // CHUNKPROCESSOR_H
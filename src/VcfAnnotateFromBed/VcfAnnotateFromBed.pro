@@ -2,9 +2,11 @@ include("../app_cli.pri")
 
 SOURCES += main.cpp \
     ChunkProcessor.cpp \
-    OutputWorker.cpp
+    OutputWorker.cpp \
+    BedStreamWindow.cpp
 
 HEADERS += \
     Auxilary.h \
     ChunkProcessor.h \
-    OutputWorker.h
+    OutputWorker.h \
+    BedStreamWindow.h
@@ -7,6 +7,7 @@
 #include "Auxilary.h"
 #include "ChunkProcessor.h"
 #include "OutputWorker.h"
+#include "BedStreamWindow.h"
 #include <QFile>
 #include <QSharedPointer>
 #include <QThreadPool>
@@ -32,8 +33,8 @@ public:
 		}
 		setExtendedDescription(QStringList()	<< "Characters which are not allowed in the INFO column based on the VCF 4.2 definition are URL encoded."
 												<< "The following characters are replaced:" << mapping_string);
-		addInfile("bed", "BED file used as source of annotations (name column).", false, true);
-		addString("name", "Annotation name in INFO column of output VCF file.", false);
+		addInfileList("bed", "BED file(s) used as source of annotations (name column).", false);
+		addString("name", "Annotation name in INFO column of output VCF file. If several BED files are given, a comma-separated list with one name per BED file.", false);
 		//optional
 		addInfile("in", "Input VCF file. If unset, reads from STDIN.", true, true);
 		addOutfile("out", "Output VCF list. If unset, writes to STDOUT.", true, true);
@@ -42,8 +43,10 @@ public:
 		addInt("block_size", "Number of lines processed in one chunk.", true, 5000);
 		addInt("prefetch", "Maximum number of chunks that may be pre-fetched into memory.", true, 64);
 		addInt("debug", "Enables debug output at the given interval in milliseconds (disabled by default, cannot be combined with writing to STDOUT).", true, -1);
-		addString("desc", "Custom INFO header description. If unset auto-generated string with file name and separator is used. (Use underscore instead of spaces.)", true, "");
+		addString("desc", "Custom INFO header description. If unset auto-generated string with file name and separator is used. (Use underscore instead of spaces.) Can only be used with one BED file.", true, "");
+		addFlag("stream", "Reads the BED files in lockstep with the input VCF instead of loading them into memory. Requires the VCF and the BED files (plain or gzipped) to be sorted by chromosome and position.");
 
+		changeLog(2026, 10, 19, "Added support for several BED files and streaming mode (parameter 'stream').");
 		changeLog(2026,  5, 13, "Added 'desc' parameter to set custom INFO header.");
 		changeLog(2021,  9, 18, "Prefetch only part of input file (to save memory).");
 		changeLog(2021,  8, 24, "Added multithread support.");
@@ -52,15 +55,56 @@ public:
 		changeLog(2017,  3, 14, "Initial implementation.");
 	}
 
+	//determines the BED lines overlapping the variants of a chunk (streaming mode)
+	void addChunkRegions(AnalysisJob& job, QList<QSharedPointer<BedStreamWindow>>& bed_windows)
+	{
+		for (int a=0; a<bed_windows.count(); ++a)
+		{
+			bed_windows[a]->newChunk();
+			job.current_chunk_regions << BedFile();
+		}
+
+		foreach(const QByteArray& line, job.current_chunk)
+		{
+			if (line.startsWith('#') || line.trimmed().isEmpty()) continue;
+
+			//parse position (invalid lines are reported by the chunk processor)
+			QByteArrayList parts = line.split('\t');
+			if (parts.count()<VcfFile::MIN_COLS) continue;
+			bool ok = false;
+			int start = parts[1].toInt(&ok);
+			if (!ok) continue;
+			int end = start + parts[3].length() - 1; //length of ref
+			if (parts[0]!=last_chr_str_)
+			{
+				last_chr_str_ = parts[0];
+				Chromosome chr(last_chr_str_);
+				if (chr<last_chr_) THROW(FileParseException, "Unsorted VCF file: chromosome '" + chr.str() + "' follows '" + last_chr_.str() + "'. Use VcfSort to sort the file!");
+				if (chr!=last_chr_) last_pos_ = 0;
+				last_chr_ = chr;
+			}
+
+			//check sorting
+			if (start<last_pos_) THROW(FileParseException, "Unsorted VCF file: position " + last_chr_.str() + ":" + QByteArray::number(start) + " follows position " + QByteArray::number(last_pos_) + ". Use VcfSort to sort the file!");
+			last_pos_ = start;
+
+			for (int a=0; a<bed_windows.count(); ++a)
+			{
+				bed_windows[a]->addOverlapping(last_chr_, start, end, job.current_chunk_regions[a]);
+			}
+		}
+	}
+
 	virtual void main()
 	{
 		//init
 		QString in = getInfile("in");
 		QString out = getOutfile("out");
-		QByteArray bed = getInfile("bed").toUtf8();
-		QByteArray name = getString("name").toUtf8().trimmed();
+		QStringList beds = getInfileList("bed");
+		QByteArrayList names = getString("name").toUtf8().split(',');
 		QByteArray sep = getString("sep").toUtf8().trimmed();
 		QByteArray desc = getString("desc").toUtf8().trimmed();
+		bool stream = getFlag("stream");
 		int block_size = getInt("block_size");
 		int threads = getInt("threads");
 		int prefetch = getInt("prefetch");
@@ -71,25 +115,56 @@ public:
 		if (threads < 1) THROW(ArgumentException, "Parameter 'threads' has to be greater than zero!");
 		if (prefetch < threads) THROW(ArgumentException, "Parameter 'prefetch' has to be at least number of used threads!");
 		if (out.isEmpty() && (debug > 0)) THROW(ArgumentException, "Parameter 'progress' cannot be combined with writing to STDOUT!");
+		if (names.count()!=beds.count()) THROW(ArgumentException, "Parameter 'name' has to contain one name per BED file!");
+		if (!desc.isEmpty() && beds.count()>1) THROW(ArgumentException, "Parameter 'desc' can only be used with one BED file!");
 
-		//load BED file
-		BedFile bed_data;
-		bed_data.load(bed);
-		if (!bed_data.isSorted()) bed_data.sort();
-		ChromosomalIndex<BedFile> bed_index(bed_data);
+		//annotations
+		QList<BedAnnotation> annotations;
+		for (int i=0; i<beds.count(); ++i)
+		{
+			BedAnnotation anno;
+			anno.file = beds[i].toUtf8();
+			anno.name = names[i].trimmed();
+			anno.desc = desc;
+			if (anno.name.isEmpty()) THROW(ArgumentException, "Parameter 'name' contains an empty name!");
+			annotations << anno;
+		}
 
-		//check BED file
-		for(int i=0; i<bed_data.count(); ++i)
+		//load BED files (streaming mode: open BED files)
+		QList<BedFile> bed_data;
+		QList<QSharedPointer<ChromosomalIndex<BedFile>>> bed_indices;
+		QList<QSharedPointer<BedStreamWindow>> bed_windows;
+		foreach(const BedAnnotation& anno, annotations)
 		{
-			BedLine& line = bed_data[i];
-			if (line.annotations().count()==0)
+			if (stream)
 			{
-				THROW(FileParseException, "BED line '" + line.toString(true) + "' has no name column: " + line.toString(true));
+				bed_windows << QSharedPointer<BedStreamWindow>(new BedStreamWindow(anno.file, sep));
+				continue;
 			}
-			if (line.annotations()[0].contains(sep))
+
+			BedFile file;
+			file.load(anno.file);
+			if (!file.isSorted()) file.sort();
+
+			//check BED file
+			for(int i=0; i<file.count(); ++i)
 			{
-				THROW(FileParseException, "BED line '" + line.toString(true) + "' name column contains separator: " + line.annotations()[0]);
+				BedLine& line = file[i];
+				if (line.annotations().count()==0)
+				{
+					THROW(FileParseException, "BED line '" + line.toString(true) + "' has no name column: " + line.toString(true));
+				}
+				if (line.annotations()[0].contains(sep))
+				{
+					THROW(FileParseException, "BED line '" + line.toString(true) + "' name column contains separator: " + line.annotations()[0]);
+				}
 			}
+
+			bed_data << file;
+		}
+		for (int i=0; i<bed_data.count(); ++i)
+		{
+			bed_indices << QSharedPointer<ChromosomalIndex<BedFile>>(new ChromosomalIndex<BedFile>(bed_data[i]));
 		}
 
 		//open input/output streams
@@ -149,7 +224,8 @@ public:
 								vcf_line_idx++;
 							}
 							vcf_line_idx = 0;
-							analysis_pool.start(new ChunkProcessor(job, name, bed_data, bed_index, bed, sep, desc));
+							if (stream) addChunkRegions(job, bed_windows);
+							analysis_pool.start(new ChunkProcessor(job, annotations, bed_data, bed_indices, sep, stream));
 							++current_chunk;
 							break;
 
@@ -274,6 +350,12 @@ public:
 			throw;
 		}
 	}
+
+private:
+	//last variant position in streaming mode (used to check sorting)
+	QByteArray last_chr_str_;
+	Chromosome last_chr_;
+	int last_pos_ = 0;
 };
 
 #include "main.moc"
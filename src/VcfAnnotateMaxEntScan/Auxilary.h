@@ -5,7 +5,38 @@
 #include <QString>
 
 #include "Transcript.h"
+#include "Exceptions.h"
 #include <QHash>
+#include <QVector>
+
+//Returns the 2-bit code of a base (A=0, C=1, G=2, T=3)
+inline int base_to_int(char base)
+{
+	switch(base)
+	{
+		case 'A':
+			return 0;
+		case 'C':
+			return 1;
+		case 'G':
+			return 2;
+		case 'T':
+			return 3;
+		default:
+			THROW(Exception, QString("Unknown base encountered: ") + base);
+	}
+}
+
+//Returns the hash of a sequence (2-bit codes of the bases, first base in the highest bits)
+inline int hashseq(const QByteArray& sequence)
+{
+	int result = 0;
+	for (int i=0; i<sequence.length(); ++i)
+	{
+		result = (result << 2) | base_to_int(sequence[i]);
+	}
+	return result;
+}
 
 //Tool parameters
 struct Parameters
@@ -42,17 +73,31 @@ struct MetaData
 {
 	const QString reference;
 	const TranscriptList transcripts;
-	const QHash<QByteArray,float> score5_rest_;
-	const QHash<int,QHash<int,float>> score3_rest_;
+	QVector<float> score5_rest_; //score of the 7 non-consensus bases of the 5' model, indexed by hash
+	QVector<QVector<float>> score3_rest_; //scores of the 9 sub-sequences of the 3' model, indexed by hash
 	const QByteArrayList annotation_header_lines;
 
-	MetaData(const QString reference, const TranscriptList transcripts, QHash<QByteArray,float> score5_rest_, QHash<int,QHash<int,float>> score3_rest_, QByteArrayList annotation_header_lines)
+	MetaData(const QString reference, const TranscriptList transcripts, QHash<QByteArray,float> score5_rest, QHash<int,QHash<int,float>> score3_rest, QByteArrayList annotation_header_lines)
 		: reference(reference)
 		, transcripts(transcripts)
-		, score5_rest_(score5_rest_)
-		, score3_rest_(score3_rest_)
+		, score5_rest_(1<<14, 0.0)
+		, score3_rest_(9, QVector<float>(1<<14, 0.0))
 		, annotation_header_lines(annotation_header_lines)
 	{
+		//convert matrices to lookup tables (missing entries have a score of 0 as before)
+		for (auto it=score5_rest.cbegin(); it!=score5_rest.cend(); ++it)
+		{
+			score5_rest_[hashseq(it.key())] = it.value();
+		}
+		for (auto it=score3_rest.cbegin(); it!=score3_rest.cend(); ++it)
+		{
+			if (it.key()<0 || it.key()>=score3_rest_.count()) continue;
+			for (auto it2=it.value().cbegin(); it2!=it.value().cend(); ++it2)
+			{
+				if (it2.key()<0 || it2.key()>=(1<<14)) THROW(FileParseException, "Invalid sequence hash in 3' score matrix: " + QString::number(it2.key()));
+				score3_rest_[it.key()][it2.key()] = it2.value();
+			}
+		}
 	}
 };
 
@@ -2,7 +2,10 @@
 
 #include "Exceptions.h"
 #include "Transcript.h"
+#include "RefGenomeService.h"
 #include <QDebug>
+#include <cmath>
+#include <limits>
 
 ChunkProcessor::ChunkProcessor(AnalysisJob& job, const MetaData& meta, const Parameters& params)
 	: QObject()
@@ -10,7 +13,7 @@ ChunkProcessor::ChunkProcessor(AnalysisJob& job, const MetaData& meta, const Par
 	, job_(job)
 	, meta_(meta)
 	, params_(params)
-	, reference_(meta.reference)
+	, reference_(RefGenomeService::getReferenceGenomeIndex(meta.reference))
 {
     if (params_.debug) QTextStream(stdout) << "ChunkProcessor(): " << job_.index << Qt::endl;
 }
@@ -20,41 +23,36 @@ ChunkProcessor::~ChunkProcessor()
     if (params_.debug) QTextStream(stdout) << "~ChunkProcessor(): " << job_.index << Qt::endl;
 }
 
-// utility functions
-int ChunkProcessor::hashseq(const QByteArray& sequence)
+void ChunkProcessor::EncodedSequence::encode(const Sequence& sequence)
 {
-	QList<int> pow_four{1,4,16,64,256,1024,4096,16384};
-    int result = 0;
-    int seqlength = sequence.length();
-	for (int i = 0; i<seqlength; i++)
+	const int n = sequence.length();
+	codes.resize(n);
+	for (int i=0; i<n; ++i)
 	{
-        result += base_to_int(sequence[i]) * pow_four[seqlength - i - 1];
-    }
-    return result;
-}
+		codes[i] = base_to_int(sequence[i]);
+	}
 
-int ChunkProcessor::base_to_int(char base)
-{
-	switch(base)
+	//rolling hashes of k-mers: the hash at index i is the hash of the k-mer starting at position i
+	auto rolling_hash = [this, n](QVector<int>& hashes, int k)
 	{
-		case 'A':
-			return 0;
-		case 'C':
-			return 1;
-		case 'G':
-			return 2;
-		case 'T':
-			return 3;
-		default:
-			THROW(Exception, QString("Unknown base encountered: ") + base);
-	}
+		hashes.resize(std::max(0, n - k + 1));
+		const int mask = (1 << (2*k)) - 1;
+		int hash = 0;
+		for (int i=0; i<n; ++i)
+		{
+			hash = ((hash << 2) | codes[i]) & mask;
+			if (i>=k-1) hashes[i-k+1] = hash;
+		}
+	};
+	rolling_hash(h3, 3);
+	rolling_hash(h4, 4);
+	rolling_hash(h7, 7);
 }
 
-
 bool ChunkProcessor::get_seqs(const Variant& variant, int slice_start, int length, bool is_minus_strand, Sequence& ref_seq, Sequence& alt_seq)
 {
 	//get ref sequence
-    ref_seq = reference_.seq(variant.chr(), slice_start, length + variant.ref().size() - 1);
+	reference_.seq(variant.chr(), slice_start, length + variant.ref().size() - 1, ref_seq);
 
 	//check that ref sequence contains only valid bases
 	if (!ref_seq.onlyACGT()) return false;
@@ -74,75 +72,75 @@ bool ChunkProcessor::get_seqs(const Variant& variant, int slice_start, int lengt
 	return true;
 }
 
-float ChunkProcessor::score5_consensus(const Sequence& sequence)
+float ChunkProcessor::score5(const EncodedSequence& sequence, int offset) const
 {
-    char seq_pos_3 = sequence[3];
-    char seq_pos_4 = sequence[4];
-    return cons15_.value(seq_pos_3)*cons25_.value(seq_pos_4)/(bgd_.value(seq_pos_3)*bgd_.value(seq_pos_4));
-}
+	//consensus bases 3 and 4
+	const quint8 seq_pos_3 = sequence.codes[offset+3];
+	const quint8 seq_pos_4 = sequence.codes[offset+4];
+	float consensus_score = cons15_[seq_pos_3]*cons25_[seq_pos_4]/(bgd_[seq_pos_3]*bgd_[seq_pos_4]);
 
-float ChunkProcessor::score5_rest(const Sequence& sequence)
-{
-    QByteArray rest_seq = sequence.mid(0,3) + sequence.mid(5);
-    return meta_.score5_rest_[rest_seq];
-}
+	//remaining bases 0-2 and 5-8
+	float rest_score = meta_.score5_rest_[(sequence.h3[offset] << 8) | sequence.h4[offset+5]];
 
-float ChunkProcessor::score5(const Sequence& sequence)
-{
-    float consensus_score = score5_consensus(sequence);
-    float rest_score = score5_rest(sequence);
-    return log2(consensus_score * rest_score);
+	return log2(consensus_score * rest_score);
 }
 
-float ChunkProcessor::score3(const Sequence& sequence)
+float ChunkProcessor::score3(const EncodedSequence& sequence, int offset) const
 {
-    float consensus_score = score3_consensus(sequence);
-    float rest_score = score3_rest(sequence);
-    return log2(consensus_score * rest_score);
+	//consensus bases 18 and 19
+	const quint8 seq_pos_18 = sequence.codes[offset+18];
+	const quint8 seq_pos_19 = sequence.codes[offset+19];
+	float consensus_score = cons13_[seq_pos_18]*cons23_[seq_pos_19]/(bgd_[seq_pos_18]*bgd_[seq_pos_19]);
+
+	//remaining bases 0-17 and 20-22 (rest sequence of 21 bases) - sub-sequences of the rest sequence are given in the comments
+	const QVector<QVector<float>>& rest = meta_.score3_rest_;
+	float rest_score = 1;
+	rest_score *= rest[0][sequence.h7[offset]]; //0-6
+	rest_score *= rest[1][sequence.h7[offset+7]]; //7-13
+	rest_score *= rest[2][(sequence.h4[offset+14] << 6) | sequence.h3[offset+20]]; //14-20
+	rest_score *= rest[3][sequence.h7[offset+4]]; //4-10
+	rest_score *= rest[4][sequence.h7[offset+11]]; //11-17
+	rest_score /= rest[5][sequence.h3[offset+4]]; //4-6
+	rest_score /= rest[6][sequence.h4[offset+7]]; //7-10
+	rest_score /= rest[7][sequence.h3[offset+11]]; //11-13
+	rest_score /= rest[8][sequence.h4[offset+14]]; //14-17
+
+	return log2(consensus_score * rest_score);
 }
 
-float ChunkProcessor::score3_consensus(const Sequence& sequence)
+float ChunkProcessor::score_ref(const Chromosome& chr, int window_start, bool is_minus_strand, Model model, const EncodedSequence& sequence, int offset)
 {
-    char seq_pos_18 = sequence[18];
-    char seq_pos_19 = sequence[19];
-    return cons13_.value(seq_pos_18)*cons23_.value(seq_pos_19)/(bgd_.value(seq_pos_18)*bgd_.value(seq_pos_19));
-}
+	//reference scores depend on the genomic window only, so they are cached for overlapping variants and transcripts
+	if (chr!=ref_cache_chr_ || ref_cache_.size()>1000000)
+	{
+		ref_cache_.clear();
+		ref_cache_chr_ = chr;
+	}
 
-float ChunkProcessor::score3_rest(const Sequence& sequence)
-{
-    QByteArray rest_seq = sequence.mid(0,18) + sequence.mid(20);
-    float rest_score = 1;
-    rest_score *= meta_.score3_rest_[0][hashseq(rest_seq.mid(0,7))];
-    rest_score *= meta_.score3_rest_[1][hashseq(rest_seq.mid(7,7))];
-    rest_score *= meta_.score3_rest_[2][hashseq(rest_seq.mid(14,7))];
-    rest_score *= meta_.score3_rest_[3][hashseq(rest_seq.mid(4,7))];
-    rest_score *= meta_.score3_rest_[4][hashseq(rest_seq.mid(11,7))];
-    rest_score /= meta_.score3_rest_[5][hashseq(rest_seq.mid(4,3))];
-    rest_score /= meta_.score3_rest_[6][hashseq(rest_seq.mid(7,4))];
-    rest_score /= meta_.score3_rest_[7][hashseq(rest_seq.mid(11,3))];
-    rest_score /= meta_.score3_rest_[8][hashseq(rest_seq.mid(14,4))];
-    return rest_score;
+	const qint64 key = (static_cast<qint64>(window_start) << 2) | (is_minus_strand ? 2 : 0) | (model==Model::FIVE_PRIME ? 1 : 0);
+	auto it = ref_cache_.constFind(key);
+	if (it!=ref_cache_.constEnd()) return it.value();
+
+	float output = score(sequence, offset, model);
+	ref_cache_.insert(key, output);
+	return output;
 }
 
-float ChunkProcessor::score_maxent(const Sequence& sequence, float (ChunkProcessor::*scorefunc)(const Sequence&))
+//Returns the genomic start of the reference window at @p offset in a sequence starting at @p slice_start (the sequence is reverse-complemented on the minus strand)
+static int ref_window_start(int slice_start, int length, int offset, int window_size, bool is_minus_strand)
 {
-	//calculate score if not in cache
-	if (!maxent_cache.contains(sequence))
-	{
-		maxent_cache[sequence] = (this->*scorefunc)(sequence);
-    }
-
-	return maxent_cache[sequence];
+	return is_minus_strand ? slice_start + length - offset - window_size : slice_start + offset;
 }
 
-
-QPair<float, int> ChunkProcessor::get_max_score(const Sequence& context, float window_size, float (ChunkProcessor::*scorefunc)(const Sequence&))
+//Returns the maximum score of all windows and the index of the first window with that score. The score of a window is calculated by @p score_func.
+template<typename T>
+static QPair<float, int> get_max_score(int window_count, T score_func)
 {
 	float maxscore = -1.0 *std::numeric_limits<int>::max();
 	int frame = -1;
-	for (int i = 0; i <= context.length() - window_size; i++)
+	for (int i=0; i<window_count; ++i)
 	{
-		float current_score = score_maxent(context.mid(i, window_size), scorefunc);
+		float current_score = score_func(i);
 		if (current_score > maxscore)
 		{
             maxscore = current_score;
@@ -212,8 +210,11 @@ QList<QByteArray> ChunkProcessor::runMES(const Variant& variant, const Chromosom
 				if (ok)
 				{
                     // get scores
-                    float maxentscan_ref = score_maxent(ref_seq, &ChunkProcessor::score3);
-                    float maxentscan_alt = score_maxent(alt_seq, &ChunkProcessor::score3);
+					ref_encoded_.encode(ref_seq);
+					alt_encoded_.encode(alt_seq);
+					int window_start = ref_window_start(slice_start_three, ref_seq.length(), 0, 23, current_transcript.isMinusStrand());
+					float maxentscan_ref = score_ref(variant.chr(), window_start, current_transcript.isMinusStrand(), Model::THREE_PRIME, ref_encoded_, 0);
+					float maxentscan_alt = score3(alt_encoded_, 0);
 					all_mes_strings.append(format_score(maxentscan_ref)+'&'+format_score(maxentscan_alt)+'&'+current_transcript.name());
                 }
             }
@@ -226,8 +227,13 @@ QList<QByteArray> ChunkProcessor::runMES(const Variant& variant, const Chromosom
 				bool ok = get_seqs(variant, slice_start_five, 9, current_transcript.isMinusStrand(),  ref_seq, alt_seq);
 				if (ok)
 				{
-                    float maxentscan_ref = score_maxent(ref_seq, &ChunkProcessor::score5);
-                    float maxentscan_alt = score_maxent(alt_seq, &ChunkProcessor::score5);
+					//sequences that do not have the length of the 5' model (indels) are not scored, i.e. they get the minimum score
+					const float not_scored = -std::numeric_limits<float>::infinity();
+					ref_encoded_.encode(ref_seq);
+					alt_encoded_.encode(alt_seq);
+					int window_start = ref_window_start(slice_start_five, ref_seq.length(), 0, 9, current_transcript.isMinusStrand());
+					float maxentscan_ref = ref_seq.length()!=9 ? not_scored : score_ref(variant.chr(), window_start, current_transcript.isMinusStrand(), Model::FIVE_PRIME, ref_encoded_, 0);
+					float maxentscan_alt = alt_seq.length()!=9 ? not_scored : score5(alt_encoded_, 0);
 					all_mes_strings.append(format_score(maxentscan_ref)+'&'+format_score(maxentscan_alt)+'&'+current_transcript.name());
                 }
             }
@@ -237,70 +243,60 @@ QList<QByteArray> ChunkProcessor::runMES(const Variant& variant, const Chromosom
     return all_mes_strings;
 }
 
-
-
 QList<QByteArray> ChunkProcessor::runSWA(const Variant& variant, const ChromosomalIndex<TranscriptList>& transcripts)
 {
     QList<QByteArray> all_mes_swa_strings;
 
+	//calculates the maximum reference/alternative score of all windows of the sequence context and the reference score of the best alternative window
+	auto score_context = [&](int slice_start, int length, int window_size, Model model, bool is_minus_strand, QByteArray& ref_str, QByteArray& alt_str, QByteArray& comp_str)
+	{
+		Sequence ref_context;
+		Sequence alt_context;
+		if (!get_seqs(variant, slice_start, length, is_minus_strand, ref_context, alt_context)) return;
+
+		ref_encoded_.encode(ref_context);
+		alt_encoded_.encode(alt_context);
+
+		//genomic start of reference windows (the context is reverse-complemented on the minus strand)
+		const int ref_length = ref_context.length();
+		auto ref_window = [&](int i)
+		{
+			return score_ref(variant.chr(), ref_window_start(slice_start, ref_length, i, window_size, is_minus_strand), is_minus_strand, model, ref_encoded_, i);
+		};
+
+		QPair<float, int> max_ref = get_max_score(ref_length - window_size + 1, ref_window);
+		QPair<float, int> max_alt = get_max_score(alt_context.length() - window_size + 1, [&](int i){ return score(alt_encoded_, i, model); });
+
+		float comp;
+		if (variant.ref().length() == variant.obs().length() && max_alt.second>=0)
+		{
+			comp = ref_window(max_alt.second);
+		}
+		else // take the max ref score
+		{
+			comp = max_ref.first;
+		}
+		ref_str = format_score(max_ref.first);
+		alt_str = format_score(max_alt.first);
+		comp_str = format_score(comp);
+	};
+
 	QVector<int> transcripts_oi = transcripts.matchingIndices(variant.chr(), variant.start(), variant.end());
 	foreach(int transcript_index, transcripts_oi)
 	{
 		const Transcript& current_transcript = transcripts.container()[transcript_index];
-        // 5 prime ss / donor ss
-		Sequence ref_context;
-		Sequence alt_context;
-		bool ok = get_seqs(variant, variant.start()-8, 17, current_transcript.isMinusStrand(), ref_context, alt_context);
 
-		//qDebug() << donor_seqs;
+        // 5 prime ss / donor ss
         QByteArray ref_donor = "";
         QByteArray alt_donor = "";
         QByteArray comp_donor = "";
-		if (ok)
-		{
-			QPair<float, int> max_ref_donor = get_max_score(ref_context, 9, &ChunkProcessor::score5);
-			QPair<float, int> max_alt_donor = get_max_score(alt_context, 9, &ChunkProcessor::score5);
+		score_context(variant.start()-8, 17, 9, Model::FIVE_PRIME, current_transcript.isMinusStrand(), ref_donor, alt_donor, comp_donor);
 
-            float donor_comp;
-			if (variant.ref().length() == variant.obs().length())
-			{
-				Sequence donor_comp_seq = ref_context.mid(max_alt_donor.second, 9);
-                donor_comp = score_maxent(donor_comp_seq, &ChunkProcessor::score5);
-			}
-			else // take the max ref score
-			{
-				donor_comp = max_ref_donor.first;
-            }
-			ref_donor = format_score(max_ref_donor.first);
-			alt_donor = format_score(max_alt_donor.first);
-			comp_donor = format_score(donor_comp);
-        }
-            
 		// 3 prime ss / acceptor ss
-		ok = get_seqs(variant, variant.start()-22, 45, current_transcript.isMinusStrand(), ref_context, alt_context);
-		//qDebug() << acceptor_seqs;
         QByteArray ref_acceptor = "";
         QByteArray alt_acceptor = "";
         QByteArray comp_acceptor = "";
-		if (ok)
-		{
-			QPair<float, int> max_ref_acceptor = get_max_score(ref_context, 23, &ChunkProcessor::score3);
-			QPair<float, int> max_alt_acceptor = get_max_score(alt_context, 23, &ChunkProcessor::score3);
-
-            float acceptor_comp;
-			if (variant.ref().length() == variant.obs().length())
-			{
-				Sequence acceptor_comp_seq = ref_context.mid(max_alt_acceptor.second, 23);
-                acceptor_comp = score_maxent(acceptor_comp_seq, &ChunkProcessor::score3);
-			}
-			else // take the max ref score
-			{
-				acceptor_comp = max_ref_acceptor.first;
-            }
-			ref_acceptor = format_score(max_ref_acceptor.first);
-			alt_acceptor = format_score(max_alt_acceptor.first);
-			comp_acceptor = format_score(acceptor_comp);
-		}
+		score_context(variant.start()-22, 45, 23, Model::THREE_PRIME, current_transcript.isMinusStrand(), ref_acceptor, alt_acceptor, comp_acceptor);
 
 		all_mes_swa_strings.append(ref_donor+'&'+alt_donor+'&'+comp_donor+'&'+ref_acceptor+'&'+alt_acceptor+'&'+comp_acceptor+'&'+current_transcript.name());
     }
@@ -5,7 +5,6 @@
 #include <QRunnable>
 #include "Auxilary.h"
 #include "ChromosomalIndex.h"
-#include <QRegularExpression>
 
 class ChunkProcessor
 	: public QObject
@@ -23,17 +22,31 @@ signals:
 	void error(int i, QString message); //signal emitted when job failed
 
 private:
-	int hashseq(const QByteArray& sequence);
-	int base_to_int(char base);
+	//2-bit encoded sequence with the hashes of all 3-, 4- and 7-mers (calculated with a rolling hash)
+	struct EncodedSequence
+	{
+		QVector<quint8> codes;
+		QVector<int> h3;
+		QVector<int> h4;
+		QVector<int> h7;
+
+		void encode(const Sequence& sequence);
+	};
+	//Splice site model
+	enum class Model
+	{
+		FIVE_PRIME, //donor, 9 bases
+		THREE_PRIME //acceptor, 23 bases
+	};
+
 	bool get_seqs(const Variant& variant, int slice_start, int length, bool is_minus_strand, Sequence& ref_seq, Sequence& alt_seq);
-	float score5_consensus(const Sequence& sequence);
-	float score5_rest(const Sequence& sequence);
-	float score5(const Sequence& sequence);
-	float score3(const Sequence& sequence);
-	float score3_consensus(const Sequence& sequence);
-	float score3_rest(const Sequence& sequence);
-	float score_maxent(const Sequence& sequence, float (ChunkProcessor::*scorefunc)(const Sequence&));
-	QPair<float, int> get_max_score(const Sequence& context, float window_size, float (ChunkProcessor::*scorefunc)(const Sequence&));
+	float score5(const EncodedSequence& sequence, int offset) const;
+	float score3(const EncodedSequence& sequence, int offset) const;
+	float score(const EncodedSequence& sequence, int offset, Model model) const
+	{
+		return model==Model::FIVE_PRIME ? score5(sequence, offset) : score3(sequence, offset);
+	}
+	float score_ref(const Chromosome& chr, int window_start, bool is_minus_strand, Model model, const EncodedSequence& sequence, int offset);
 	QList<QByteArray> runMES(const Variant& variant, const ChromosomalIndex<TranscriptList>& transcripts);
 	QList<QByteArray> runSWA(const Variant& variant, const ChromosomalIndex<TranscriptList>& transcripts);
 	QByteArray format_score(float score);
@@ -41,43 +54,24 @@ private:
 	AnalysisJob& job_;
 	const MetaData& meta_;
 	const Parameters& params_;
-	FastaFileIndex reference_;
-    QRegularExpression acgt_regexp_;
+	const FastaFileIndex& reference_; // memory-mapped, shared by all threads
 
-	//constants
-	QHash<char,float> bgd_ = {
-	    {'A',0.27},
-	    {'C',0.23},
-	    {'G',0.23},
-	    {'T',0.27}
-	};
+	//constants (index is the 2-bit code of the base: A, C, G, T)
+	static constexpr float bgd_[4] = {0.27, 0.23, 0.23, 0.27};
 	// constants for five prime
-	QHash<char,float> cons15_ ={
-	    {'A',0.004},
-	    {'C',0.0032},
-	    {'G',0.9896},
-	    {'T',0.0032}
-	};
-	QHash<char,float> cons25_ ={
-	    {'A',0.0034},
-	    {'C',0.0039},
-	    {'G',0.0042},
-	    {'T',0.9884}
-	};
+	static constexpr float cons15_[4] = {0.004, 0.0032, 0.9896, 0.0032};
+	static constexpr float cons25_[4] = {0.0034, 0.0039, 0.0042, 0.9884};
 	// constants for three prime
-	QHash<char,float> cons13_ ={
-	    {'A',0.9903},
-	    {'C',0.0032},
-	    {'G',0.0034},
-	    {'T',0.0030}
-	};
-	QHash<char,float> cons23_ ={
-	    {'A',0.0027},
-	    {'C',0.0037},
-	    {'G',0.9905},
-	    {'T',0.0030}
-	};
-	QHash<Sequence,float> maxent_cache;
+	static constexpr float cons13_[4] = {0.9903, 0.0032, 0.0034, 0.0030};
+	static constexpr float cons23_[4] = {0.0027, 0.0037, 0.9905, 0.0030};
+
+	//cache for reference scores: key is the genomic start of the window, strand and model (only for one chromosome)
+	QHash<qint64, float> ref_cache_;
+	Chromosome ref_cache_chr_;
+
+	//re-used buffers
+	EncodedSequence ref_encoded_;
+	EncodedSequence alt_encoded_;
 };
 
 #endif // CHUNKPROCESSOR_H
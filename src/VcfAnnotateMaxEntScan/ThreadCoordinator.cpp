@@ -11,6 +11,8 @@ ThreadCoordinator::ThreadCoordinator(QObject* parent, Parameters params, MetaDat
 	, params_(params)
 	, meta_(meta)
 {
+	timer_annotation_.start();
+
 	//set number of threads
 	thread_pool_read_.setMaxThreadCount(1);
 	thread_pool_annotate_.setMaxThreadCount(params_.threads);
@@ -107,6 +109,7 @@ void ThreadCoordinator::checkDone()
 	timer_done_.stop();
 
     QTextStream(stdout) << "Annotation jobs finished" << Qt::endl;
+	QTextStream(stdout) << "Annotation took: " << Helper::elapsedTime(timer_annotation_) << Qt::endl;
 
 	emit finished();
 }
@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QThreadPool>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QSharedPointer>
 #include "Auxilary.h"
@@ -44,6 +45,7 @@ private:
 
 	bool input_done_ = false;
 	QTimer timer_done_;
+	QElapsedTimer timer_annotation_; //time since the start of the annotation (printed when done to measure throughput)
 };
 
 #endif // THREADCOORDINATOR_H
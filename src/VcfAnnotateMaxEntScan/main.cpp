@@ -4,6 +4,7 @@
 #include "ThreadCoordinator.h"
 #include "Settings.h"
 #include "GffData.h"
+#include "RefGenomeService.h"
 
 class ConcreteTool
         : public ToolBase
@@ -45,6 +46,7 @@ public:
 		addInfile("ref", "Reference genome FASTA file. If unset 'reference_genome' from the 'settings.ini' file is used.", true);
 		addFlag("debug", "Enables debug output (use only with one thread).");
 
+		changeLog(2026, 10, 19, "Improved performance of the score calculation (rolling k-mer hashes and caching of reference scores).");
 		changeLog(2025,  3, 20, "Fixed bug in SWA alternative sequence generation and using 'min_score' for comp scores as well.");
 		changeLog(2023,  9, 26, "Added several parameters to make output more configurable.");
 		changeLog(2023,  9, 18, "first version");
@@ -79,7 +81,7 @@ public:
         QString ref_file = getInfile("ref");
         if (ref_file=="") ref_file = Settings::string("reference_genome", true);
         if (ref_file=="") THROW(CommandLineParsingException, "Reference genome FASTA unset in both command-line and settings.ini file!");
-        FastaFileIndex reference(ref_file);
+        RefGenomeService::getReferenceGenomeIndex(ref_file);
         out << "Reading reference took: " << Helper::elapsedTime(timer) << Qt::endl;
 
         // read in matrices
@@ -3,9 +3,56 @@
 #include "Helper.h"
 #include "VcfFile.h"
 #include "Settings.h"
+#include "VersatileFile.h"
+#include "RefGenomeService.h"
 #include <BamReader.h>
 #include <QFile>
+#include <QFileInfo>
 #include <QTextStream>
+#include <QThreadPool>
+#include <QSet>
+#include <functional>
+#include <algorithm>
+#include <limits>
+
+//PRS loaded from a PRS VCF file (shared by all samples)
+struct PrsScore
+{
+	VcfFile variants;
+	QHash<QByteArray,QByteArray> column_entries;
+	QVector<double> percentiles;
+};
+
+//PRS variant in the sorted list used for sweeping over the sample VCF
+struct SweepEntry
+{
+	int start;
+	int end;
+	int score;
+	int variant;
+
+	bool operator<(const SweepEntry& rhs) const
+	{
+		return start<rhs.start || (start==rhs.start && end<rhs.end);
+	}
+};
+
+//Sample VCF record buffered during the sweep
+struct SweepRecord
+{
+	int start;
+	int end;
+	QByteArray line;
+};
+
+//Output lines of a sample
+struct SampleResult
+{
+	QByteArray out;
+	QByteArray details;
+	QString messages;
+	QString error;
+};
 
 class ConcreteTool
 		: public ToolBase
@@ -21,18 +68,23 @@ public:
 	virtual void setup()
 	{
 		setDescription("Calculates the Polgenic Risk Score(s) for a sample.");
-		setExtendedDescription(QStringList() << "The PRS VCF files have to contain WEIGHT and POP_AF fields in the INFO column." << "Additionally some information about the PRS score is required in the VCF header." << "An example VCF file can be found at https://github.com/imgag/ngs-bits/blob/master/src/tools-TEST/data_in/VcfCalculatePRS_prs2.vcf");
-		addInfile("in", "Tabix indexed VCF.GZ file of a sample.", false);
+		setExtendedDescription(QStringList() << "The PRS VCF files have to contain WEIGHT and POP_AF fields in the INFO column." << "Additionally some information about the PRS score is required in the VCF header." << "An example VCF file can be found at https://github.com/imgag/ngs-bits/blob/master/src/tools-TEST/data_in/VcfCalculatePRS_prs2.vcf"
+							   << "If several samples are given, the output files contain an additional 'sample' column and the samples are processed in parallel.");
+		addInfileList("in", "Tabix indexed VCF.GZ file(s) of the sample(s). In sweep mode, the VCF files have to be sorted, but do not need to be indexed.", false);
 		addInfileList("prs", "List of PRS VCFs.", false);
-		addInfile("bam", "BAM file corresponding to the VCF.", false);
 		addOutfile("out", "Output TSV file containing Scores and PRS details", false);
-		addOutfile("details", "Output TSV containing each variant with weight, allele count and population AF.", true);
 
 		//optional
+		addInfileList("bam", "BAM file(s) corresponding to the VCF(s) - in the same order. Required unless 'gvcf' is set.", true);
+		addOutfile("details", "Output TSV containing each variant with weight, allele count and population AF.", true);
 		addInfile("ref", "Reference genome FASTA file. If unset, 'reference_genome' from the 'settings.ini' file is used.", true, false);
 		addInt("min_depth", "Depth cutoff below which uncalled SNPs are considered not callable and POP_AF is used instead of genotype.", true, 10);
 		addFlag("long_read", "Support long reads (> 1kb).");
+		addFlag("sweep", "Sweep mode: reads each sample VCF once and evaluates all PRS variants in position order instead of querying the tabix index for each PRS variant. Faster for large scores.");
+		addFlag("gvcf", "Input files are gVCFs: the depth of PRS variants is taken from the covering gVCF records (MIN_DP or DP) instead of the BAM file.");
+		addInt("threads", "Number of threads used. Each thread processes one sample.", true, 1);
 
+		changeLog(2026, 10, 19, "Added sweep mode, gVCF support and processing of several samples in parallel.");
 		changeLog(2025,  5, 21, "Added parameter 'long_read' for long-read support.");
 		changeLog(2024,  6,  5, "Added support for imputed variants.");
 		changeLog(2024,  4, 22, "Added output of factors and support for wt variants.");
@@ -44,110 +96,418 @@ public:
 	{
 		//init
 		QTextStream out(stdout);
-		int min_depth = getInt("min_depth");
-		bool long_read = getFlag("long_read");
-
-		//load sample VCF
-		TabixIndexedFile sample_vcf;
-		sample_vcf.load(getInfile("in").toUtf8());
-
-		//open refererence genome file
-		QString ref_file = getInfile("ref");
-		if (ref_file=="") ref_file = Settings::string("reference_genome", true);
-		if (ref_file=="") THROW(CommandLineParsingException, "Reference genome FASTA unset in both command-line and settings.ini file!");
-		FastaFileIndex reference(ref_file);
+		min_depth_ = getInt("min_depth");
+		long_read_ = getFlag("long_read");
+		sweep_ = getFlag("sweep");
+		gvcf_ = getFlag("gvcf");
+		int threads = getInt("threads");
+		if (threads<1) THROW(CommandLineParsingException, "Invalid number of threads: " + QString::number(threads));
+		QStringList vcfs = getInfileList("in");
+		QStringList bams = getInfileList("bam");
+		if (!gvcf_ && bams.count()!=vcfs.count()) THROW(CommandLineParsingException, "The number of BAM files (" + QString::number(bams.count()) + ") does not match the number of VCF files (" + QString::number(vcfs.count()) + ")!");
+		multi_sample_ = vcfs.count()>1;
+
+		//determine refererence genome file (not needed for gVCFs)
+		if (!gvcf_)
+		{
+			ref_file_ = getInfile("ref");
+			if (ref_file_=="") ref_file_ = Settings::string("reference_genome", true);
+			if (ref_file_=="") THROW(CommandLineParsingException, "Reference genome FASTA unset in both command-line and settings.ini file!");
+		}
 
-		//open BAM file
-		BamReader bam_file(getInfile("bam"), ref_file);
+		//load PRS files
+		foreach (const QString& prs_file_path, getInfileList("prs"))
+		{
+			loadScore(prs_file_path);
+		}
+		if (sweep_) initSweep();
 
 		//open output file and write header
 		QSharedPointer<QFile> output_tsv = Helper::openFileForWriting(getOutfile("out"), true);
 		QByteArrayList column_headers = QByteArrayList() << "pgs_id" << "trait" << "score" << "percentile" << "build" << "variants_in_prs" << "variants_low_depth" << "variants_imputed" << "pgp_id" << "citation";
+		if (multi_sample_) column_headers.prepend("sample");
 		output_tsv->write("#" + column_headers.join("\t") + "\n");
 
 		//create optional output file containing all the factors used to calculate the PRS
-		bool detail_output = !getOutfile("details").isEmpty();
+		detail_output_ = !getOutfile("details").isEmpty();
 		QSharedPointer<QFile> detail_tsv;
-		if (detail_output)
+		if (detail_output_)
 		{
 			detail_tsv = Helper::openFileForWriting(getOutfile("details"), false);
 			detail_tsv->write("## allele_count: A '.' in the count_effect_allele column means insufficient depth and the tool uses the population_af as fallback allele count\n");
 			QByteArrayList detail_tsv_headers = QByteArrayList() << "chr" << "start" << "end" << "ref_allele" << "effect_allele" << "other_allele" << "patient_allele1" << "patient_allele2"
 																 << "count_effect_allele" << "variant_depth" << "weight" << "population_af" << "pgs_id"  << "comment";
+			if (multi_sample_) detail_tsv_headers.prepend("sample");
 			detail_tsv->write("#" + detail_tsv_headers.join("\t") + "\n");
 		}
 
-		//iterate over all given PRS files
-		foreach (const QString& prs_file_path, getInfileList("prs"))
+		//process samples
+		QVector<SampleResult> results(vcfs.count());
+		if (multi_sample_)
 		{
-			//load PRS file
-			VcfFile prs_variant_list;
-			prs_variant_list.load(prs_file_path);
+			QThreadPool thread_pool;
+			thread_pool.setMaxThreadCount(threads);
+			for (int s=0; s<vcfs.count(); ++s)
+			{
+				thread_pool.start([&, s]()
+				{
+					try
+					{
+						processSample(vcfs[s], gvcf_ ? QString() : bams[s], results[s]);
+					}
+					catch(Exception& e)
+					{
+						results[s].error = e.message();
+					}
+				});
+			}
+			thread_pool.waitForDone();
 
-			//does not support multi sample
-			if(prs_variant_list.sampleIDs().count() > 1)
+			for (int s=0; s<vcfs.count(); ++s)
 			{
-				THROW(FileParseException, "PRS VCF file must not contain more than one sample: " + prs_file_path);
+				if (!results[s].error.isEmpty()) THROW(Exception, "Error while processing sample VCF " + vcfs[s] + ": " + results[s].error);
 			}
+		}
+		else
+		{
+			processSample(vcfs[0], gvcf_ ? QString() : bams[0], results[0]);
+		}
 
-			//define PRS
-			double prs = 0;
-			QVector<double> percentiles;
-			QHash<QByteArray,QByteArray> column_entries;
+		//write output in the order of the input files
+		foreach(const SampleResult& result, results)
+		{
+			output_tsv->write(result.out);
+			if (detail_output_) detail_tsv->write(result.details);
+			out << result.messages;
+		}
 
-			//parse comment lines
-			foreach(const VcfHeaderLine& comment_line, prs_variant_list.vcfHeader().comments())
-			{
+		output_tsv->flush();
+		output_tsv->close();
 
-				foreach(const QByteArray& column_name, column_headers)
+		if (detail_output_)
+		{
+			detail_tsv->flush();
+			detail_tsv->close();
+		}
+	}
+
+private:
+	int min_depth_;
+	bool long_read_;
+	bool sweep_;
+	bool gvcf_;
+	bool multi_sample_;
+	bool detail_output_;
+	QString ref_file_;
+	QList<PrsScore> scores_;
+	QHash<int, QVector<SweepEntry>> sweep_entries_; //PRS variants sorted by position (key is the numeric representation of the chromosome)
+
+	//Loads a PRS VCF file
+	void loadScore(const QString& prs_file_path)
+	{
+		scores_ << PrsScore();
+		PrsScore& score = scores_.last();
+
+		//load PRS file
+		VcfFile& prs_variant_list = score.variants;
+		prs_variant_list.load(prs_file_path);
+
+		//does not support multi sample
+		if(prs_variant_list.sampleIDs().count() > 1)
+		{
+			THROW(FileParseException, "PRS VCF file must not contain more than one sample: " + prs_file_path);
+		}
+
+		//parse comment lines
+		QByteArrayList column_headers = QByteArrayList() << "pgs_id" << "trait" << "score" << "percentile" << "build" << "variants_in_prs" << "variants_low_depth" << "variants_imputed" << "pgp_id" << "citation";
+		foreach(const VcfHeaderLine& comment_line, prs_variant_list.vcfHeader().comments())
+		{
+
+			foreach(const QByteArray& column_name, column_headers)
+			{
+				if(comment_line.key.startsWith(column_name))
 				{
-					if(comment_line.key.startsWith(column_name))
+					if(score.column_entries.contains(column_name))
 					{
-						if(column_entries.contains(column_name))
-						{
-							THROW(FileParseException, "Comment section of PRS VCF  file contains more than one entry for '" +column_name + "': " + prs_file_path);
-						}
-						column_entries[column_name] = comment_line.value.trimmed();
-						break;
+						THROW(FileParseException, "Comment section of PRS VCF  file contains more than one entry for '" +column_name + "': " + prs_file_path);
 					}
+					score.column_entries[column_name] = comment_line.value.trimmed();
+					break;
 				}
+			}
 
-				if(comment_line.key.startsWith("percentiles"))
+			if(comment_line.key.startsWith("percentiles"))
+			{
+				if (score.percentiles.size() != 0) THROW(FileParseException, "Percentiles in PRS VCF file given twice: " + prs_file_path);
+				QByteArrayList percentile_string = comment_line.value.trimmed().split(',');
+				if (percentile_string.size() != 100) THROW(FileParseException, "Invalid number of percentiles given (required: 100, given: "  + QByteArray::number(percentile_string.size()) + ": " + prs_file_path);
+				foreach (const QByteArray& value_string, percentile_string)
 				{
-					if (percentiles.size() != 0) THROW(FileParseException, "Percentiles in PRS VCF file given twice: " + prs_file_path);
-					QByteArrayList percentile_string = comment_line.value.trimmed().split(',');
-					if (percentile_string.size() != 100) THROW(FileParseException, "Invalid number of percentiles given (required: 100, given: "  + QByteArray::number(percentile_string.size()) + ": " + prs_file_path);
-					foreach (const QByteArray& value_string, percentile_string)
-					{
-						percentiles.append(Helper::toDouble(value_string, "Percentile"));
-					}
+					score.percentiles.append(Helper::toDouble(value_string, "Percentile"));
+				}
+			}
+		}
+
+		//check if all required comment lines are present
+		QByteArrayList col_entries_not_in_header = QByteArrayList() << "score" << "percentile" << "variants_in_prs" << "variants_low_depth"<< "variants_imputed";
+		foreach (const QByteArray& key, column_headers)
+		{
+			if(col_entries_not_in_header.contains(key)) continue;
+			if(!score.column_entries.contains(key))
+			{
+				THROW(FileParseException, "Comment section of PRS VCFs does not contain an entry for '" + key + "': " + prs_file_path);
+			}
+		}
+
+		for(int i = 0; i < prs_variant_list.count(); ++i)
+		{
+			VcfLine& prs_variant = prs_variant_list[i];
+
+			//does not support multi-allelic variants
+			if(prs_variant.isMultiAllelic())
+			{
+				THROW(FileParseException, "Multi-allelic variants in PRS VCF files are not supported: " + prs_variant.toString());
+			}
+
+			//replace '.' in wildtype var with ref
+			if (prs_variant.altString() == ".") prs_variant.setSingleAlt(prs_variant.ref());
+		}
+	}
+
+	//Creates the position-sorted list of all PRS variants that are not imputed
+	void initSweep()
+	{
+		for (int s=0; s<scores_.count(); ++s)
+		{
+			const VcfFile& prs_variant_list = scores_[s].variants;
+			for(int i = 0; i < prs_variant_list.count(); ++i)
+			{
+				const VcfLine& prs_variant = prs_variant_list[i];
+				if (prs_variant.infoKeys().contains("IMPUTE")) continue;
+
+				sweep_entries_[prs_variant.chr().num()] << SweepEntry{prs_variant.start(), prs_variant.end(), s, i};
+			}
+		}
+
+		for (auto it=sweep_entries_.begin(); it!=sweep_entries_.end(); ++it)
+		{
+			std::sort(it.value().begin(), it.value().end());
+		}
+	}
+
+	//Collects the sample VCF records overlapping the PRS variants with a single pass over the position-sorted sample VCF
+	void sweepSampleVcf(const QString& filename, QVector<QVector<QByteArrayList>>& matching_lines) const
+	{
+		VersatileFile file(filename);
+		file.open();
+
+		QSet<int> chrs_done;
+		QByteArray chr;
+		const QVector<SweepEntry>* entries = nullptr;
+		int next_entry = 0;
+		int last_pos = 0;
+		QList<SweepRecord> buffer;
+
+		//assigns the buffered records to the PRS variants ending before the given position and removes records that cannot overlap any remaining PRS variant
+		auto process_entries = [&](int pos)
+		{
+			if (entries==nullptr) return;
+
+			while (next_entry<entries->count() && (*entries)[next_entry].end<pos)
+			{
+				const SweepEntry& entry = (*entries)[next_entry];
+				QByteArrayList& lines = matching_lines[entry.score][entry.variant];
+				foreach(const SweepRecord& record, buffer)
+				{
+					if (record.start<=entry.end && record.end>=entry.start) lines << record.line;
 				}
+				++next_entry;
+			}
+
+			int min_start = next_entry<entries->count() ? (*entries)[next_entry].start : std::numeric_limits<int>::max();
+			buffer.erase(std::remove_if(buffer.begin(), buffer.end(), [min_start](const SweepRecord& record){ return record.end<min_start; }), buffer.end());
+		};
+
+		while (!file.atEnd())
+		{
+			QByteArray line = file.readLine(true);
+			if (line.isEmpty() || line.startsWith('#')) continue;
+
+			//new chromosome
+			int tab_pos = line.indexOf('\t');
+			if (tab_pos==-1) THROW(FileParseException, "Invalid line in sample VCF " + filename + ": " + line);
+			if (chr!=line.left(tab_pos))
+			{
+				process_entries(std::numeric_limits<int>::max());
+				buffer.clear();
+
+				chr = line.left(tab_pos);
+				int chr_num = Chromosome(chr).num();
+				if (chrs_done.contains(chr_num)) THROW(FileParseException, "Sample VCF is not sorted by chromosome: " + filename);
+				chrs_done << chr_num;
+
+				auto it = sweep_entries_.constFind(chr_num);
+				entries = (it==sweep_entries_.constEnd()) ? nullptr : &(it.value());
+				next_entry = 0;
+				last_pos = 0;
+			}
+			if (entries==nullptr || next_entry>=entries->count()) continue;
+
+			QByteArrayList parts = line.split('\t');
+			if (parts.count()<8) THROW(FileParseException, "Invalid line in sample VCF " + filename + ": " + line);
+			int pos = Helper::toInt(parts[1], "VCF position", line);
+			if (pos<last_pos) THROW(FileParseException, "Sample VCF is not sorted by position: " + filename);
+			last_pos = pos;
+
+			process_entries(pos);
+			if (next_entry>=entries->count()) continue;
+
+			//determine end of record (reference blocks and symbolic alleles have an END entry in the INFO column)
+			int end = pos + parts[3].length() - 1;
+			foreach(const QByteArray& info_entry, parts[7].split(';'))
+			{
+				if (info_entry.startsWith("END=")) end = std::max(end, Helper::toInt(info_entry.mid(4), "END", line));
+			}
+			if (end<(*entries)[next_entry].start) continue;
+
+			buffer << SweepRecord{pos, end, line};
+		}
+		process_entries(std::numeric_limits<int>::max());
+	}
+
+	//Returns the depth of a PRS variant from the overlapping gVCF records (minimum of MIN_DP/DP) and removes reference blocks and symbolic alleles from the records
+	static int processGvcfLines(QByteArrayList& lines)
+	{
+		int depth = -1;
+		QByteArrayList output;
+		foreach(const QByteArray& line, lines)
+		{
+			QByteArrayList parts = line.split('\t');
+			if (parts.count()<10) THROW(FileParseException, "gVCF record without sample column: " + line);
+
+			//depth
+			QByteArrayList format_header_items = parts[8].split(':');
+			QByteArrayList format_value_items = parts[9].split(':');
+			int depth_idx = format_header_items.indexOf("MIN_DP");
+			if (depth_idx<0) depth_idx = format_header_items.indexOf("DP");
+			if (depth_idx>=0 && depth_idx<format_value_items.count() && format_value_items[depth_idx]!=".")
+			{
+				int record_depth = Helper::toInt(format_value_items[depth_idx], "gVCF depth", line);
+				depth = depth<0 ? record_depth : std::min(depth, record_depth);
+			}
+
+			//remove symbolic alleles - reference blocks are skipped
+			QByteArrayList alts = parts[4].split(',');
+			alts.removeAll("<NON_REF>");
+			alts.removeAll("<*>");
+			if (alts.isEmpty() || alts[0]==".") continue;
+			parts[4] = alts.join(',');
+			output << parts.join('\t');
+		}
+		lines = output;
+
+		return std::max(depth, 0);
+	}
+
+	//Calculates the PRSs of a sample
+	void processSample(const QString& vcf, const QString& bam, SampleResult& result) const
+	{
+		QByteArray prefix;
+		if (multi_sample_) prefix = sampleName(vcf) + "\t";
+
+		//random access to sample data
+		QSharedPointer<TabixIndexedFile> sample_vcf;
+		QSharedPointer<BamReader> bam_file;
+		const FastaFileIndex* reference = nullptr;
+		if (!sweep_)
+		{
+			sample_vcf.reset(new TabixIndexedFile());
+			sample_vcf->load(vcf.toUtf8());
+		}
+		if (!gvcf_)
+		{
+			bam_file.reset(new BamReader(bam, ref_file_));
+			reference = &RefGenomeService::getReferenceGenomeIndex(ref_file_);
+		}
+
+		//sweep over sample VCF
+		QVector<QVector<QByteArrayList>> sweep_lines;
+		QVector<QVector<int>> sweep_depth;
+		if (sweep_)
+		{
+			sweep_lines.resize(scores_.count());
+			sweep_depth.resize(scores_.count());
+			for (int s=0; s<scores_.count(); ++s)
+			{
+				sweep_lines[s].resize(scores_[s].variants.count());
+				sweep_depth[s].fill(-1, scores_[s].variants.count());
 			}
+			sweepSampleVcf(vcf, sweep_lines);
 
-			//check if all required comment lines are present
-			QByteArrayList col_entries_not_in_header = QByteArrayList() << "score" << "percentile" << "variants_in_prs" << "variants_low_depth"<< "variants_imputed";
-			foreach (const QByteArray& key, column_headers)
+			//determine depth in position order (each variant is looked up once, even if it is contained in several PRSs)
+			for (auto it=sweep_entries_.cbegin(); it!=sweep_entries_.cend(); ++it)
 			{
-				if(col_entries_not_in_header.contains(key)) continue;
-				if(!column_entries.contains(key))
+				QHash<QByteArray, int> depth_cache;
+				foreach(const SweepEntry& entry, it.value())
 				{
-					THROW(FileParseException, "Comment section of PRS VCFs does not contain an entry for '" + key + "': " + prs_file_path);
+					if (gvcf_)
+					{
+						sweep_depth[entry.score][entry.variant] = processGvcfLines(sweep_lines[entry.score][entry.variant]);
+					}
+					else
+					{
+						const VcfLine& prs_variant = scores_[entry.score].variants[entry.variant];
+						QByteArray key = prs_variant.toString();
+						if (!depth_cache.contains(key))
+						{
+							depth_cache[key] = bam_file->getVariantDetails(*reference, prs_variant, long_read_).depth;
+						}
+						sweep_depth[entry.score][entry.variant] = depth_cache[key];
+					}
 				}
 			}
+		}
+
+		//functions to access depth and matching sample VCF lines of a PRS variant
+		QByteArrayList gvcf_lines;
+		std::function<int(int, int)> get_depth = [&](int s, int i) -> int
+		{
+			if (sweep_) return sweep_depth[s][i];
+
+			const VcfLine& prs_variant = scores_[s].variants[i];
+			if (gvcf_)
+			{
+				gvcf_lines = sample_vcf->getMatchingLines(prs_variant.chr(), prs_variant.start(), prs_variant.end(), true);
+				return processGvcfLines(gvcf_lines);
+			}
+			return bam_file->getVariantDetails(*reference, prs_variant, long_read_).depth;
+		};
+		std::function<QByteArrayList(int, int)> get_lines = [&](int s, int i) -> QByteArrayList
+		{
+			if (sweep_) return sweep_lines[s][i];
+			if (gvcf_) return gvcf_lines;
+
+			const VcfLine& prs_variant = scores_[s].variants[i];
+			return sample_vcf->getMatchingLines(prs_variant.chr(), prs_variant.start(), prs_variant.end(), true);
+		};
+
+		//calculate PRSs
+		QTextStream messages(&result.messages);
+		for (int s=0; s<scores_.count(); ++s)
+		{
+			const PrsScore& score = scores_[s];
+			const VcfFile& prs_variant_list = score.variants;
+			QHash<QByteArray,QByteArray> column_entries = score.column_entries;
+			const QVector<double>& percentiles = score.percentiles;
+			double prs = 0;
 
 			//iterate over all variants in PRS
 			int c_found = 0;
 			int c_low_depth = 0;
 			int c_imputed = 0;
 			for(int i = 0; i < prs_variant_list.count(); ++i)
-			{	
-				VcfLine& prs_variant = prs_variant_list[i];
-
-				//does not support multi-allelic variants
-				if(prs_variant.isMultiAllelic())
-				{
-					THROW(FileParseException, "Multi-allelic variants in PRS VCF files are not supported: " + prs_variant.toString());
-				}
+			{
+				const VcfLine& prs_variant = prs_variant_list[i];
 
 				// get weight/pop_af from PRS VCF
 				double weight = Helper::toDouble(prs_variant.info("WEIGHT"), "PRS weight");
@@ -158,9 +518,7 @@ public:
 				int allele_count = -1;
 				QByteArrayList patient_alleles;
 				QByteArrayList comment;
-				bool prs_var_is_wildtype = ((prs_variant.altString() == ".") || (prs_variant.altString() == prs_variant.ref()) || prs_variant.infoKeys().contains("REF_IS_EFFECT_ALLELE"));
-				//replace '.' in wildtype var with ref
-				if (prs_variant.altString() == ".") prs_variant.setSingleAlt(prs_variant.ref());
+				bool prs_var_is_wildtype = ((prs_variant.altString() == prs_variant.ref()) || prs_variant.infoKeys().contains("REF_IS_EFFECT_ALLELE"));
 
 				//extract other allele for ref-flagged vars
 				if (prs_variant.infoKeys().contains("REF_IS_EFFECT_ALLELE") && (prs_variant.altString() != ".") && (prs_variant.altString() != prs_variant.ref()))
@@ -178,8 +536,8 @@ public:
 				}
 				else
 				{
-					var_depth = bam_file.getVariantDetails(reference, prs_variant, long_read).depth;
-					if (var_depth < min_depth)
+					var_depth = get_depth(s, i);
+					if (var_depth < min_depth_)
 					{
 						//coverage too low --> use POP_AF
 						allele_count = -1;
@@ -192,7 +550,7 @@ public:
 						//QC is ok, check for called variants
 
 						//get all matching variants at this position
-						QByteArrayList matching_lines = sample_vcf.getMatchingLines(prs_variant.chr(), prs_variant.start(), prs_variant.end(), true);
+						QByteArrayList matching_lines = get_lines(s, i);
 						QByteArrayList matching_variants;
 
 						if (prs_var_is_wildtype)
@@ -219,7 +577,7 @@ public:
 									//prevent allele count to drop below 0
 									allele_count = std::max(allele_count, 0);
 
-									if (detail_output)
+									if (detail_output_)
 									{
 										//get patient allele
 										Sequence ref = split_line[3].trimmed();
@@ -238,7 +596,7 @@ public:
 
 									++c_found;
 
-									if (detail_output)
+									if (detail_output_)
 									{
 										//get patient allele
 										for (int j = 0; j < allele_count; j++)
@@ -263,7 +621,7 @@ public:
 								++c_found;
 
 								//both allele are ref
-								if (detail_output) patient_alleles << prs_variant.ref() + ">" + prs_variant.ref() << prs_variant.ref() + ">" + prs_variant.ref();
+								if (detail_output_) patient_alleles << prs_variant.ref() + ">" + prs_variant.ref() << prs_variant.ref() + ">" + prs_variant.ref();
 							}
 
 						}
@@ -277,7 +635,7 @@ public:
 								{
 									matching_variants.append(line);
 								}
-								else if(detail_output) //get alt allele of patient
+								else if(detail_output_) //get alt allele of patient
 								{
 									//get genotype
 									QByteArrayList split_line = line.split('\t');
@@ -323,7 +681,7 @@ public:
 
 								++c_found;
 
-								if (detail_output)
+								if (detail_output_)
 								{
 									for (int j = 0; j < allele_count; j++)
 									{
@@ -338,7 +696,7 @@ public:
 							{
 								//sufficient depth (checked previously) & no call => both alleles wildtype
 								allele_count = 0;
-								if (detail_output)
+								if (detail_output_)
 								{
 									//fill up with ref calls
 									if (patient_alleles.size() == 0) patient_alleles << prs_variant.ref() + ">" + prs_variant.ref() << prs_variant.ref() + ">" + prs_variant.ref();
@@ -357,14 +715,14 @@ public:
 					}
 				}
 
-				if (detail_output)
+				if (detail_output_)
 				{
 					QByteArrayList detail_tsv_line = QByteArrayList() << prs_variant.chr().strNormalized(true) << QByteArray::number(prs_variant.start()) << QByteArray::number(prs_variant.end())
 																	  << prs_variant.ref() << ((prs_var_is_wildtype)?prs_variant.ref():prs_variant.altString()) << other_allele
 																	  << ((patient_alleles.size() > 0)?patient_alleles[0]:".") << ((patient_alleles.size() > 1)?patient_alleles[1]:".")
 																	  << ((allele_count < 0)?".":QByteArray::number(allele_count)) << ((var_depth < 0)?".":QByteArray::number(var_depth))
 																	  << QByteArray::number(weight) << QByteArray::number(pop_af) <<  column_entries["pgs_id"] << comment.join(";");
-					detail_tsv->write(detail_tsv_line.join("\t") + "\n");
+					result.details.append(prefix + detail_tsv_line.join("\t") + "\n");
 				}
 			}
 
@@ -391,23 +749,32 @@ public:
 			QByteArrayList prs_line = QByteArrayList() << column_entries["pgs_id"] << column_entries["trait"] << QByteArray::number(prs)
 													   << percentile_string << column_entries["build"] << QByteArray::number(prs_variant_list.count()) << QByteArray::number(c_low_depth)
 													   << QByteArray::number(c_imputed) << column_entries["pgp_id"] << column_entries["citation"];
-			output_tsv->write(prs_line.join("\t") + "\n");
+			result.out.append(prefix + prs_line.join("\t") + "\n");
 
 
 			//print final PRS
-			out << column_entries["pgs_id"] << ": variants_found=" << c_found << " prs=" << prs << " percentile=" << percentile_string << " low_depth_variants=" << c_low_depth
-                << " variants_imputed=" << c_imputed << Qt::endl;
+			if (multi_sample_) messages << prefix.trimmed() << " ";
+			messages << column_entries["pgs_id"] << ": variants_found=" << c_found << " prs=" << prs << " percentile=" << percentile_string << " low_depth_variants=" << c_low_depth
+					 << " variants_imputed=" << c_imputed << Qt::endl;
 		}
+	}
 
-		output_tsv->flush();
-		output_tsv->close();
-
-		if (detail_output)
+	//Returns the sample name from the VCF header (or the file name if there is no sample column)
+	static QByteArray sampleName(const QString& vcf)
+	{
+		VersatileFile file(vcf);
+		file.open();
+		while (!file.atEnd())
 		{
-			detail_tsv->flush();
-			detail_tsv->close();
+			QByteArray line = file.readLine(true);
+			if (line.startsWith("##")) continue;
+
+			QByteArrayList parts = line.split('\t');
+			if (line.startsWith("#CHROM") && parts.count()>9) return parts[9];
+			break;
 		}
 
+		return QFileInfo(vcf).fileName().toUtf8();
 	}
 };
 
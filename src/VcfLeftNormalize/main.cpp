@@ -3,6 +3,7 @@
 #include "Exceptions.h"
 #include "VcfFile.h"
 #include "Settings.h"
+#include "RefGenomeService.h"
 #include <QFile>
 #include <QList>
 
@@ -35,7 +36,7 @@ public:
 
 	void streamVcf(const QString& in, const QString& out, const QString& ref_file, bool right)
 	{
-		FastaFileIndex reference(ref_file);
+		const FastaFileIndex& reference = RefGenomeService::getReferenceGenomeIndex(ref_file);
 		if(in!="" && in==out)
 		{
 			THROW(ArgumentException, "Input and output files must be different when streaming!");
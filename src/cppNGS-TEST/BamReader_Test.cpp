@@ -1,5 +1,6 @@
 #include "TestFrameworkNGS.h"
 #include "BamReader.h"
+#include "BedFile.h"
 #include "BasicStatistics.h"
 #include "Settings.h"
 
@@ -291,6 +292,41 @@ private:
 		F_EQUAL2(pileup.frequency('G', 'A'), 0.389, 0.001);
 	}
 
+	TEST_METHOD(BamReader_getPileups)
+	{
+		//compare with getPileup for each position (regions with SNP, insertion, deletion and RNA data containing the CIGAR operations S and N)
+		QList<QPair<QString, BedLine>> tests;
+		tests << qMakePair(TESTDATA("data_in/panel.bam"), BedLine("chr1", 12002100, 12002160));
+		tests << qMakePair(TESTDATA("data_in/panel.bam"), BedLine("chr6", 109732600, 109732640));
+		tests << qMakePair(TESTDATA("data_in/panel.bam"), BedLine("chr14", 53046740, 53046780));
+		tests << qMakePair(TESTDATA("data_in/BamReader_rna.bam"), BedLine("chr10", 92675260, 92675310));
+		tests << qMakePair(TESTDATA("data_in/BamReader_insert_only.bam"), BedLine("chr19", 5787200, 5787230));
+		foreach(auto test, tests)
+		{
+			BamReader reader(test.first);
+			const BedLine& region = test.second;
+			QVector<Pileup> pileups = reader.getPileups(region.chr(), region.start(), region.end());
+			I_EQUAL(pileups.count(), region.length());
+			for (int pos=region.start(); pos<=region.end(); ++pos)
+			{
+				Pileup expected = reader.getPileup(region.chr(), pos);
+				const Pileup& pileup = pileups[pos-region.start()];
+				I_EQUAL(pileup.a(), expected.a());
+				I_EQUAL(pileup.c(), expected.c());
+				I_EQUAL(pileup.g(), expected.g());
+				I_EQUAL(pileup.t(), expected.t());
+				I_EQUAL(pileup.n(), expected.n());
+				I_EQUAL(pileup.depth(true), expected.depth(true));
+			}
+		}
+
+		//no coverage
+		BamReader reader(TESTDATA("data_in/BamReader_rna.bam"));
+		QVector<Pileup> pileups = reader.getPileups("chr11", 92675290, 92675300);
+		I_EQUAL(pileups.count(), 11);
+		I_EQUAL(pileups[0].depth(true), 0);
+	}
+
 	TEST_METHOD(BamReader_getVariantDetails)
 	{
 		SKIP_IF_NO_HG38_GENOME();
@@ -0,0 +1,278 @@
+#include "TestFramework.h"
+#include "BedSweep.h"
+#include <random>
+
+TEST_CLASS(BedSweep_Test)
+{
+private:
+	//creates a random sorted BED file with overlapping and adjacent regions
+	BedFile randomBedFile(std::mt19937& generator, int count, int max_length)
+	{
+		QByteArrayList chrs = QByteArrayList() << "chr1" << "chr2" << "chr10" << "chrX";
+		std::uniform_int_distribution<int> chr_distrib(0, chrs.count()-1);
+		std::uniform_int_distribution<int> start_distrib(1, 20000);
+		std::uniform_int_distribution<int> length_distrib(1, max_length);
+
+		BedFile file;
+		file.appendHeader("#random regions");
+		for (int i=0; i<count; ++i)
+		{
+			int start = start_distrib(generator);
+			file.append(BedLine(chrs[chr_distrib(generator)], start, start + length_distrib(generator) - 1, QByteArrayList() << "name" + QByteArray::number(i%50) << "x"));
+		}
+		file.sort();
+
+		return file;
+	}
+
+	//returns the lines of the BED file sorted as text (the order of split regions is different in streaming mode)
+	QStringList sortedLines(const BedFile& file)
+	{
+		QStringList lines = file.toText().split('\n');
+		std::sort(lines.begin(), lines.end());
+		return lines;
+	}
+
+	//loads the BED file and returns the lines sorted as text
+	QStringList sortedLines(QString filename)
+	{
+		BedFile file;
+		file.load(filename);
+		return sortedLines(file);
+	}
+
+	//reads all lines of a stream
+	void readAll(BedFileStream& stream)
+	{
+		BedLine line;
+		while(stream.next(line)) {}
+	}
+
+	TEST_METHOD(merge)
+	{
+		std::mt19937 generator(4711);
+		BedFile file = randomBedFile(generator, 2000, 50);
+		file.store("out/BedSweep_merge_in.bed");
+
+		for (int b2b=0; b2b<2; ++b2b)
+		{
+			for (int names=0; names<2; ++names)
+			{
+				for (int unique=0; unique<2; ++unique)
+				{
+					{
+						BedFileStream in("out/BedSweep_merge_in.bed");
+						BedOutfileStream out("out/BedSweep_merge_out.bed");
+						BedSweep::merge(in, out, b2b, names, unique);
+					}
+					BedFile expected = file;
+					expected.merge(b2b, names, unique);
+					expected.store("out/BedSweep_merge_expected.bed");
+
+					COMPARE_FILES("out/BedSweep_merge_out.bed", "out/BedSweep_merge_expected.bed");
+				}
+			}
+		}
+	}
+
+	TEST_METHOD(intersect)
+	{
+		std::mt19937 generator(4712);
+		BedFile file = randomBedFile(generator, 2000, 200);
+		file.store("out/BedSweep_intersect_in.bed");
+		BedFile file2 = randomBedFile(generator, 1000, 100);
+		file2.store("out/BedSweep_intersect_in2.bed");
+		IS_FALSE(BedSweep::isMergedAndSorted("out/BedSweep_intersect_in2.bed"));
+		file2.merge();
+
+		for (int keep_anno=0; keep_anno<2; ++keep_anno)
+		{
+			{
+				BedFileStream in("out/BedSweep_intersect_in.bed");
+				BedFileStream in2("out/BedSweep_intersect_in2.bed");
+				BedOutfileStream out("out/BedSweep_intersect_out.bed");
+				BedSweep::intersect(in, in2, out, keep_anno, true);
+			}
+			BedFile expected = file;
+			expected.intersect(file2, keep_anno);
+
+			QStringList lines = sortedLines("out/BedSweep_intersect_out.bed");
+			IS_TRUE(lines.count()>100);
+			IS_TRUE(lines==sortedLines(expected));
+		}
+	}
+
+	TEST_METHOD(intersect_back_to_back_regions)
+	{
+		BedFile file;
+		file.append(BedLine("chr1", 5, 15));
+		file.append(BedLine("chr1", 25, 45));
+		file.append(BedLine("chr2", 1, 100));
+		file.store("out/BedSweep_b2b_in.bed");
+
+		//back-to-back regions without overlaps (e.g. per-base callable regions): not merged
+		BedFile file2;
+		file2.append(BedLine("chr1", 1, 10));
+		file2.append(BedLine("chr1", 11, 20));
+		file2.append(BedLine("chr1", 21, 30));
+		file2.append(BedLine("chr1", 40, 50));
+		file2.append(BedLine("chr2", 50, 60));
+		file2.append(BedLine("chr2", 61, 70));
+		file2.store("out/BedSweep_b2b_in2.bed");
+		IS_TRUE(file2.isMergedAndSorted());
+		IS_TRUE(BedSweep::isMergedAndSorted("out/BedSweep_b2b_in2.bed"));
+		{
+			BedFileStream in("out/BedSweep_b2b_in.bed");
+			BedFileStream in2("out/BedSweep_b2b_in2.bed");
+			BedOutfileStream out("out/BedSweep_b2b_out.bed");
+			BedSweep::intersect(in, in2, out, false, !BedSweep::isMergedAndSorted("out/BedSweep_b2b_in2.bed"));
+		}
+		BedFile expected = file;
+		expected.intersect(file2);
+		QStringList lines = sortedLines("out/BedSweep_b2b_out.bed");
+		I_EQUAL(lines.count(), 7); //6 regions and empty last line
+		IS_TRUE(lines==sortedLines(expected));
+
+		//back-to-back regions in a file with overlaps: merged (as BedFile::merge does)
+		file2.append(BedLine("chr2", 65, 80));
+		file2.store("out/BedSweep_b2b_in2.bed");
+		IS_FALSE(file2.isMergedAndSorted());
+		IS_FALSE(BedSweep::isMergedAndSorted("out/BedSweep_b2b_in2.bed"));
+		{
+			BedFileStream in("out/BedSweep_b2b_in.bed");
+			BedFileStream in2("out/BedSweep_b2b_in2.bed");
+			BedOutfileStream out("out/BedSweep_b2b_out.bed");
+			BedSweep::intersect(in, in2, out, false, !BedSweep::isMergedAndSorted("out/BedSweep_b2b_in2.bed"));
+		}
+		file2.merge();
+		expected = file;
+		expected.intersect(file2);
+		lines = sortedLines("out/BedSweep_b2b_out.bed");
+		I_EQUAL(lines.count(), 5); //4 regions and empty last line
+		IS_TRUE(lines==sortedLines(expected));
+	}
+
+	TEST_METHOD(overlapping)
+	{
+		std::mt19937 generator(4713);
+		BedFile file = randomBedFile(generator, 2000, 100);
+		file.store("out/BedSweep_overlapping_in.bed");
+		BedFile file2 = randomBedFile(generator, 500, 50);
+		file2.store("out/BedSweep_overlapping_in2.bed");
+		file2.merge();
+
+		{
+			BedFileStream in("out/BedSweep_overlapping_in.bed");
+			BedFileStream in2("out/BedSweep_overlapping_in2.bed");
+			BedOutfileStream out("out/BedSweep_overlapping_out.bed");
+			BedSweep::overlapping(in, in2, out);
+		}
+		BedFile expected = file;
+		expected.overlapping(file2);
+		expected.store("out/BedSweep_overlapping_expected.bed");
+
+		COMPARE_FILES("out/BedSweep_overlapping_out.bed", "out/BedSweep_overlapping_expected.bed");
+	}
+
+	TEST_METHOD(subtract)
+	{
+		std::mt19937 generator(4714);
+		BedFile file = randomBedFile(generator, 2000, 200);
+		file.store("out/BedSweep_subtract_in.bed");
+		BedFile file2 = randomBedFile(generator, 1000, 50);
+		file2.store("out/BedSweep_subtract_in2.bed");
+		file2.merge();
+
+		{
+			BedFileStream in("out/BedSweep_subtract_in.bed");
+			BedFileStream in2("out/BedSweep_subtract_in2.bed");
+			BedOutfileStream out("out/BedSweep_subtract_out.bed");
+			BedSweep::subtract(in, in2, out);
+		}
+		BedFile expected = file;
+		expected.subtract(file2);
+
+		QStringList lines = sortedLines("out/BedSweep_subtract_out.bed");
+		IS_TRUE(lines.count()>100);
+		IS_TRUE(lines==sortedLines(expected));
+	}
+
+	TEST_METHOD(panel_vs_low_coverage)
+	{
+		BedFile panel;
+		panel.load(TESTDATA("data_in/panel.bed"));
+		BedFile lowcov;
+		lowcov.load(TESTDATA("data_in/panel_lowcov.bed"));
+		lowcov.sort();
+		lowcov.store("out/BedSweep_lowcov.bed");
+		bool lowcov_merged = lowcov.isMergedAndSorted();
+		IS_TRUE(lowcov_merged==BedSweep::isMergedAndSorted("out/BedSweep_lowcov.bed"));
+		if (!lowcov_merged) lowcov.merge();
+
+		{
+			BedFileStream in(TESTDATA("data_in/panel.bed"));
+			BedFileStream in2("out/BedSweep_lowcov.bed");
+			BedOutfileStream out("out/BedSweep_panel_subtract_out.bed");
+			BedSweep::subtract(in, in2, out);
+		}
+		BedFile expected = panel;
+		expected.subtract(lowcov);
+		IS_TRUE(sortedLines("out/BedSweep_panel_subtract_out.bed")==sortedLines(expected));
+
+		{
+			BedFileStream in(TESTDATA("data_in/panel.bed"));
+			BedFileStream in2("out/BedSweep_lowcov.bed");
+			BedOutfileStream out("out/BedSweep_panel_intersect_out.bed");
+			BedSweep::intersect(in, in2, out, true, !lowcov_merged);
+		}
+		expected = panel;
+		expected.intersect(lowcov, true);
+		IS_TRUE(sortedLines("out/BedSweep_panel_intersect_out.bed")==sortedLines(expected));
+	}
+
+	TEST_METHOD(gzipped_input_and_output)
+	{
+		std::mt19937 generator(4715);
+		BedFile file = randomBedFile(generator, 1000, 50);
+		file.store("out/BedSweep_gz_in.bed");
+
+		//write bgzipped file
+		{
+			BedFileStream in("out/BedSweep_gz_in.bed");
+			BedOutfileStream out("out/BedSweep_gz_out.bed.gz");
+			BedSweep::merge(in, out);
+		}
+		BedFile expected = file;
+		expected.merge();
+		IS_TRUE(sortedLines("out/BedSweep_gz_out.bed.gz")==sortedLines(expected));
+
+		//read bgzipped file
+		BedFileStream in("out/BedSweep_gz_out.bed.gz");
+		S_EQUAL(in.headers().join(), "#random regions");
+		BedLine line;
+		int count = 0;
+		while(in.next(line))
+		{
+			IS_TRUE(line==expected[count]);
+			++count;
+		}
+		I_EQUAL(count, expected.count());
+	}
+
+	TEST_METHOD(unsorted_input)
+	{
+		BedFile file;
+		file.append(BedLine("chr1", 100, 200));
+		file.append(BedLine("chr2", 100, 200));
+		file.append(BedLine("chr1", 300, 400));
+		file.store("out/BedSweep_unsorted.bed");
+
+		BedFileStream stream("out/BedSweep_unsorted.bed");
+		IS_THROWN(FileParseException, readAll(stream));
+
+		//no exception if sorting is not required
+		BedFileStream stream2("out/BedSweep_unsorted.bed", false, false);
+		readAll(stream2);
+		IS_TRUE(stream2.atEnd());
+	}
+};
@@ -0,0 +1,305 @@
+#include "TestFramework.h"
+#include "CompactGraph.h"
+#include "Graph.h"
+#include "Helper.h"
+#include <QElapsedTimer>
+#include <random>
+#include <cmath>
+
+struct FloodingNode
+{
+	double score = 0.0;
+	double score_change = 0.0;
+};
+
+TEST_CLASS(CompactGraph_Test)
+{
+private:
+	//creates a ring of 20 nodes with additional edges between every second node
+	CompactGraph createGraph(bool directed, bool weighted)
+	{
+		QStringList names;
+		for (int i=1; i<=20; ++i)
+		{
+			names << QString::number(i);
+		}
+
+		QVector<CompactGraph::Edge> edges;
+		for (int i=0; i<20; ++i)
+		{
+			edges << CompactGraph::Edge{i, (i+1)%20, 1.0f};
+			if (i%2==0) edges << CompactGraph::Edge{i, (i+2)%20, 3.0f};
+		}
+		//duplicates
+		edges << CompactGraph::Edge{0, 1, 5.0f};
+		edges << CompactGraph::Edge{1, 0, 7.0f};
+
+		return CompactGraph(names, edges, directed, weighted);
+	}
+
+	TEST_METHOD(undirected)
+	{
+		CompactGraph graph = createGraph(false, false);
+		IS_FALSE(graph.directed());
+		IS_FALSE(graph.weighted());
+		I_EQUAL(graph.nodeCount(), 20);
+		I_EQUAL(graph.edgeCount(), 30);
+
+		I_EQUAL(graph.index("1"), 0);
+		I_EQUAL(graph.index("20"), 19);
+		I_EQUAL(graph.index("21"), -1);
+		S_EQUAL(graph.name(4), "5");
+
+		//node '1' is connected to '2', '3', '19' and '20'
+		I_EQUAL(graph.degree(0), 4);
+		I_EQUAL(graph.neighbors(0)[0], 1);
+		I_EQUAL(graph.neighbors(0)[1], 2);
+		I_EQUAL(graph.neighbors(0)[2], 18);
+		I_EQUAL(graph.neighbors(0)[3], 19);
+		I_EQUAL(graph.degree(1), 2);
+		IS_TRUE(graph.weights(0)==nullptr);
+	}
+
+	TEST_METHOD(directed)
+	{
+		CompactGraph graph = createGraph(true, true);
+		IS_TRUE(graph.directed());
+		IS_TRUE(graph.weighted());
+		I_EQUAL(graph.edgeCount(), 31);
+
+		//node '1' has edges to '2' and '3' (the duplicate edge with the first weight is skipped)
+		I_EQUAL(graph.degree(0), 2);
+		I_EQUAL(graph.neighbors(0)[0], 1);
+		I_EQUAL(graph.neighbors(0)[1], 2);
+		F_EQUAL(graph.weights(0)[0], 1.0);
+		F_EQUAL(graph.weights(0)[1], 3.0);
+		//node '2' has edges to '3' and '1'
+		I_EQUAL(graph.degree(1), 2);
+		I_EQUAL(graph.neighbors(1)[0], 0);
+		F_EQUAL(graph.weights(1)[0], 7.0);
+	}
+
+	TEST_METHOD(self_loop)
+	{
+		CompactGraph graph(QStringList() << "A" << "B", QVector<CompactGraph::Edge>() << CompactGraph::Edge{0, 0, 1.0f} << CompactGraph::Edge{0, 1, 1.0f});
+		I_EQUAL(graph.edgeCount(), 2);
+		I_EQUAL(graph.degree(0), 3);
+		I_EQUAL(graph.degree(1), 1);
+	}
+
+	TEST_METHOD(invalid_input)
+	{
+		IS_THROWN(ArgumentException, CompactGraph(QStringList() << "A" << "A", QVector<CompactGraph::Edge>()));
+		IS_THROWN(ArgumentException, CompactGraph(QStringList() << "A" << "B", QVector<CompactGraph::Edge>() << CompactGraph::Edge{0, 2, 1.0f}));
+	}
+
+	TEST_METHOD(multiply)
+	{
+		QVector<double> input;
+		for (int i=0; i<20; ++i)
+		{
+			input << i;
+		}
+		QVector<double> output;
+
+		CompactGraph graph = createGraph(false, false);
+		graph.multiply(input, output);
+		I_EQUAL(output.count(), 20);
+		F_EQUAL(output[0], 1.0 + 2.0 + 18.0 + 19.0);
+		F_EQUAL(output[1], 0.0 + 2.0);
+
+		CompactGraph weighted = createGraph(false, true);
+		weighted.multiply(input, output, 4);
+		F_EQUAL(output[0], 1.0 + 3.0*2.0 + 3.0*18.0 + 19.0);
+
+		IS_THROWN(ArgumentException, graph.multiply(QVector<double>(19), output));
+	}
+
+	TEST_METHOD(load_tsv_and_binary)
+	{
+		//TSV with duplicate edge, swapped duplicate edge and invalid line
+		Helper::storeTextFile("out/CompactGraph_in1.tsv", QStringList() << "A\tB" << "B\tC" << "A\tB" << "C\tB" << "C\tD" << "invalid" << "D\tA");
+		CompactGraph graph = CompactGraph::load("out/CompactGraph_in1.tsv");
+		IS_FALSE(CompactGraph::isBinaryFile("out/CompactGraph_in1.tsv"));
+		IS_FALSE(graph.directed());
+		I_EQUAL(graph.nodeCount(), 4);
+		I_EQUAL(graph.edgeCount(), 4);
+		S_EQUAL(graph.name(0), "A");
+		S_EQUAL(graph.name(3), "D");
+		I_EQUAL(graph.degree(0), 2);
+		I_EQUAL(graph.degree(1), 2);
+
+		graph.storeBinary("out/CompactGraph_out1.bin");
+		IS_TRUE(CompactGraph::isBinaryFile("out/CompactGraph_out1.bin"));
+		CompactGraph graph2 = CompactGraph::load("out/CompactGraph_out1.bin");
+		I_EQUAL(graph2.nodeCount(), graph.nodeCount());
+		I_EQUAL(graph2.edgeCount(), graph.edgeCount());
+		IS_FALSE(graph2.weighted());
+		for (int n=0; n<graph.nodeCount(); ++n)
+		{
+			S_EQUAL(graph2.name(n), graph.name(n));
+			I_EQUAL(graph2.index(graph.name(n)), n);
+			I_EQUAL(graph2.degree(n), graph.degree(n));
+			for (int i=0; i<graph.degree(n); ++i)
+			{
+				I_EQUAL(graph2.neighbors(n)[i], graph.neighbors(n)[i]);
+			}
+		}
+
+		//weighted graph
+		CompactGraph weighted = createGraph(true, true);
+		weighted.storeBinary("out/CompactGraph_out2.bin");
+		CompactGraph weighted2 = CompactGraph::load("out/CompactGraph_out2.bin");
+		IS_TRUE(weighted2.directed());
+		IS_TRUE(weighted2.weighted());
+		F_EQUAL(weighted2.weights(1)[0], 7.0);
+	}
+
+	//large enough to be processed in parallel
+	TEST_METHOD(multiply_threads)
+	{
+		const int node_count = 20000;
+		const int edge_count = 200000;
+
+		//create random graph
+		std::mt19937 generator(4711);
+		std::uniform_int_distribution<int> node_distrib(0, node_count-1);
+		std::uniform_real_distribution<float> weight_distrib(0.1f, 10.0f);
+		QStringList names;
+		for (int i=0; i<node_count; ++i)
+		{
+			names << "N" + QString::number(i);
+		}
+		QVector<CompactGraph::Edge> edges;
+		for (int i=0; i<edge_count; ++i)
+		{
+			edges << CompactGraph::Edge{node_distrib(generator), node_distrib(generator), weight_distrib(generator)};
+		}
+		QVector<double> input(node_count);
+		for (int n=0; n<node_count; ++n)
+		{
+			input[n] = (n%7) * 0.25;
+		}
+
+		foreach(bool weighted, QList<bool>() << false << true)
+		{
+			CompactGraph graph(names, edges, false, weighted);
+			IS_TRUE(graph.edgeCount()>50000);
+
+			QVector<double> expected;
+			graph.multiply(input, expected);
+			for (int n=0; n<node_count; n+=997)
+			{
+				double sum = 0.0;
+				for (int i=0; i<graph.degree(n); ++i)
+				{
+					sum += (weighted ? graph.weights(n)[i] : 1.0) * input[graph.neighbors(n)[i]];
+				}
+				F_EQUAL2(expected[n], sum, 1e-9);
+			}
+
+			foreach(int threads, QList<int>() << 2 << 3 << 8)
+			{
+				QVector<double> output;
+				graph.multiply(input, output, threads);
+				I_EQUAL(output.count(), node_count);
+				for (int n=0; n<node_count; ++n)
+				{
+					F_EQUAL2(output[n], expected[n], 1e-12);
+				}
+			}
+		}
+	}
+
+	//compares flooding (see GenePrioritization) with the pointer-based graph and the compact graph - opt-in because of the runtime (set the environment variable NGSBITS_BENCHMARK to run it)
+	TEST_METHOD(benchmark_flooding)
+	{
+		if (qgetenv("NGSBITS_BENCHMARK").isEmpty()) SKIP("Benchmark is only executed if the environment variable NGSBITS_BENCHMARK is set!");
+
+		const int node_count = 20000;
+		const int edge_count = 200000;
+		const int iterations = 10;
+
+		//create random graph
+		std::mt19937 generator(4711);
+		std::uniform_int_distribution<int> node_distrib(0, node_count-1);
+		QStringList names;
+		for (int i=0; i<node_count; ++i)
+		{
+			names << "N" + QString::number(i);
+		}
+		QVector<CompactGraph::Edge> edges;
+		for (int i=0; i<edge_count; ++i)
+		{
+			edges << CompactGraph::Edge{node_distrib(generator), node_distrib(generator), 1.0f};
+		}
+
+		//pointer-based graph
+		QElapsedTimer timer;
+		timer.start();
+		Graph<FloodingNode, double> graph;
+		foreach(const CompactGraph::Edge& edge, edges)
+		{
+			graph.addEdge(names[edge.node1], FloodingNode(), names[edge.node2], FloodingNode(), 1.0);
+		}
+		qint64 ms_create = timer.restart();
+		for (int i=0; i<node_count; i+=100)
+		{
+			if (graph.hasNode(names[i])) graph.getNode(names[i])->nodeContent().score = 1.0;
+		}
+		for (int iter=0; iter<iterations; ++iter)
+		{
+			foreach(auto node, graph.adjacencyList().keys())
+			{
+				double node_score = node->nodeContent().score;
+				if (node_score==0.0) continue;
+				int degree = graph.getDegree(node->nodeName());
+				foreach(auto edge, graph.adjacencyList()[node])
+				{
+					auto target = (edge->node1()==node) ? edge->node2() : edge->node1();
+					target->nodeContent().score_change += node_score / degree;
+				}
+			}
+			foreach(auto node, graph.adjacencyList().keys())
+			{
+				node->nodeContent().score += node->nodeContent().score_change / sqrt(graph.getDegree(node->nodeName()));
+				node->nodeContent().score_change = 0.0;
+			}
+		}
+		qint64 ms_flooding = timer.restart();
+
+		//compact graph
+		CompactGraph compact(names, edges);
+		qint64 ms_create_compact = timer.restart();
+		QVector<double> scores(node_count, 0.0);
+		for (int i=0; i<node_count; i+=100)
+		{
+			scores[i] = 1.0;
+		}
+		QVector<double> propagated(node_count);
+		QVector<double> score_change;
+		for (int iter=0; iter<iterations; ++iter)
+		{
+			for (int n=0; n<node_count; ++n)
+			{
+				propagated[n] = compact.degree(n)==0 ? 0.0 : scores[n] / compact.degree(n);
+			}
+			compact.multiply(propagated, score_change, 4);
+			for (int n=0; n<node_count; ++n)
+			{
+				if (compact.degree(n)>0) scores[n] += score_change[n] / sqrt(compact.degree(n));
+			}
+		}
+		qint64 ms_flooding_compact = timer.restart();
+
+		//compare
+		for (int n=0; n<node_count; ++n)
+		{
+			if (!graph.hasNode(names[n])) continue;
+			double expected = graph.getNode(names[n])->nodeContent().score;
+			F_EQUAL2(scores[n], expected, 1e-9 * std::max(1.0, std::fabs(expected)));
+		}
+		qDebug() << "Graph creation:" << ms_create << "ms (pointer-based)" << ms_create_compact << "ms (compact)";
+		qDebug() << "Flooding:" << ms_flooding << "ms (pointer-based)" << ms_flooding_compact << "ms (compact)";
+	}
+};
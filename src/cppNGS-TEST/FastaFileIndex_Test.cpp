@@ -67,6 +67,31 @@ private:
 		S_EQUAL(seq, Sequence("GAATT"));
 	}
 
+	TEST_METHOD(seq_substr_buffer)
+	{
+		FastaFileIndex index(TESTDATA("data_in/example.fa"));
+		Sequence seq;
+		index.seq("chr14", 75, 10, seq, false);
+		S_EQUAL(seq, Sequence("tttttgagac"));
+
+		index.seq("chr15", 2, 2, seq, false);
+		S_EQUAL(seq, Sequence("ga"));
+
+		index.seq("chr17", 1, 4, seq);
+		S_EQUAL(seq, Sequence("ACGT"));
+	}
+
+	TEST_METHOD(base)
+	{
+		FastaFileIndex index(TESTDATA("data_in/example.fa"));
+		I_EQUAL(index.base("chr14", 1, false), 'a');
+		I_EQUAL(index.base("chr14", 80), 'G');
+		I_EQUAL(index.base("chr14", 1509), 'A');
+		I_EQUAL(index.base("chr16", 7, false), 'a');
+		IS_THROWN(ProgrammingException, index.base("chr16", 8));
+		IS_THROWN(ProgrammingException, index.base("chr16", 0));
+	}
+
 	TEST_METHOD(lengthOf)
 	{
 		FastaFileIndex index(TESTDATA("data_in/example.fa"));
@@ -451,4 +451,84 @@ private:
 		QFile::remove(tmp_file);
 	}
 
+	TEST_METHOD(write_gzipped_parallel)
+	{
+		//load reference data
+		QList<FastqEntry> entries;
+		FastqFileStream in_stream(TESTDATA("data_in/example6.fastq.gz"));
+		while(!in_stream.atEnd())
+		{
+			FastqEntry entry;
+			in_stream.readEntry(entry);
+			entries << entry;
+		}
+
+		//write as concatenated gzip members and as BGZF blocks (several blocks per file)
+		QList<bool> bgzf_modes = QList<bool>() << false << true;
+		foreach(bool bgzf, bgzf_modes)
+		{
+			QString tmp_file = Helper::tempFileName(".fastq.gz");
+			FastqOutfileStream out(tmp_file, Z_BEST_SPEED, Z_DEFAULT_STRATEGY, 4, bgzf);
+			foreach(const FastqEntry& entry, entries)
+			{
+				out.write(entry);
+			}
+			out.close();
+
+			//check data
+			FastqFileStream stream(tmp_file);
+			FastqEntry entry;
+			for (int i=0; i<entries.count(); ++i)
+			{
+				IS_FALSE(stream.atEnd());
+				stream.readEntry(entry);
+				S_EQUAL(entry.header, entries[i].header);
+				S_EQUAL(entry.bases, entries[i].bases);
+				S_EQUAL(entry.qualities, entries[i].qualities);
+			}
+			IS_TRUE(stream.atEnd());
+
+			//check BGZF block header and end-of-file marker
+			if (bgzf)
+			{
+				QFile file(tmp_file);
+				IS_TRUE(file.open(QIODevice::ReadOnly));
+				QByteArray data = file.readAll();
+				S_EQUAL(data.mid(12, 2), QByteArray("BC"));
+				S_EQUAL(data.right(28).toHex(), QByteArray("1f8b08040000000000ff0600424302001b0003000000000000000000"));
+			}
+
+			QFile::remove(tmp_file);
+		}
+	}
+
+	TEST_METHOD(compressBlock)
+	{
+		QByteArray data = "@read1\nACGT\n+\nIIII\n";
+
+		//gzip member can be decompressed by zlib
+		QByteArray compressed = FastqOutfileStream::compressBlock(data, Z_BEST_SPEED, Z_DEFAULT_STRATEGY, false);
+		I_EQUAL((uchar)compressed[0], 0x1f);
+		I_EQUAL((uchar)compressed[1], 0x8b);
+		QByteArray uncompressed(data.size(), 0);
+		z_stream stream;
+		stream.zalloc = Z_NULL;
+		stream.zfree = Z_NULL;
+		stream.opaque = Z_NULL;
+		stream.next_in = reinterpret_cast<Bytef*>(compressed.data());
+		stream.avail_in = compressed.size();
+		stream.next_out = reinterpret_cast<Bytef*>(uncompressed.data());
+		stream.avail_out = uncompressed.size();
+		I_EQUAL(inflateInit2(&stream, 31), Z_OK);
+		I_EQUAL(inflate(&stream, Z_FINISH), Z_STREAM_END);
+		inflateEnd(&stream);
+		S_EQUAL(uncompressed, data);
+
+		//BGZF block contains its size
+		compressed = FastqOutfileStream::compressBlock(data, Z_BEST_SPEED, Z_DEFAULT_STRATEGY, true);
+		I_EQUAL((uchar)compressed[16] + 256*(uchar)compressed[17], compressed.size()-1);
+
+		//BGZF block size is limited
+		IS_THROWN(ArgumentException, FastqOutfileStream::compressBlock(QByteArray(FastqOutfileStream::BGZF_MAX_BLOCK_SIZE+1, 'A'), Z_BEST_SPEED, Z_DEFAULT_STRATEGY, true));
+	}
 };
@@ -0,0 +1,79 @@
+#include "TestFrameworkNGS.h"
+#include "MatePairBuffer.h"
+
+TEST_CLASS(MatePairBuffer_Test)
+{
+private:
+
+	static bool isValidPair(const BamAlignment& a, const BamAlignment& b)
+	{
+		return a.name()==b.name() && a.isRead1()!=b.isRead1();
+	}
+
+	//Pairs the mates of a BAM file and returns the sorted names of pairs (prefixed with 'P') and single reads (prefixed with 'S')
+	QStringList pairMates(QString bam_file, int max_cached)
+	{
+		QStringList output;
+
+		BamReader reader(bam_file);
+		MatePairBuffer buffer(reader, max_cached, 4);
+		QSharedPointer<BamAlignment> al(new BamAlignment());
+		while (reader.getNextAlignment(*al))
+		{
+			if (!al->isPaired() || al->isSecondaryAlignment() || al->isSupplementaryAlignment()) continue;
+
+			QSharedPointer<BamAlignment> mate = buffer.add(al);
+			if (mate.isNull())
+			{
+				al = QSharedPointer<BamAlignment>(new BamAlignment());
+			}
+			else
+			{
+				output << (isValidPair(*mate, *al) ? "P " : "invalid pair ") + QString(al->name());
+			}
+		}
+
+		long long spilled = buffer.spilledCount();
+		buffer.resolve([&](BamAlignment& first, BamAlignment& second)
+		{
+			bool sorted = first.chromosomeID()<second.chromosomeID() || (first.chromosomeID()==second.chromosomeID() && first.start()<=second.start());
+			output << (isValidPair(first, second) && sorted ? "P " : "invalid pair ") + QString(first.name());
+		},
+		[&](BamAlignment& single)
+		{
+			output << "S " + QString(single.name());
+		});
+		if (buffer.size()!=0) output << "buffer not empty";
+		if (max_cached>0 && buffer.maxSize()>max_cached) output << "maximum size exceeded"; //also checks the pairing of spilled alignments
+
+		output << "spilled: " + QString(spilled>0 ? "yes" : "no");
+		output.sort();
+		return output;
+	}
+
+	TEST_METHOD(pairing_in_memory)
+	{
+		QStringList result = pairMates(TESTDATA("data_in/sry.bam"), 0);
+		IS_TRUE(result.contains("spilled: no"));
+		IS_TRUE(result.filter(QRegularExpression("^P ")).count()>0);
+		I_EQUAL(result.filter(QRegularExpression("^S ")).count(), 1);
+	}
+
+	TEST_METHOD(pairing_with_spill)
+	{
+		QStringList expected = pairMates(TESTDATA("data_in/sry.bam"), 0);
+		expected.replaceInStrings("spilled: no", "spilled: yes");
+
+		QStringList result = pairMates(TESTDATA("data_in/sry.bam"), 20);
+		I_EQUAL(result.count(), expected.count());
+		S_EQUAL(result.join("\n"), expected.join("\n"));
+
+		//limit of 1 alignment
+		result = pairMates(TESTDATA("data_in/sry.bam"), 1);
+		S_EQUAL(result.join("\n"), expected.join("\n"));
+
+		//limit of 3 alignments (partitions are split while pairing)
+		result = pairMates(TESTDATA("data_in/sry.bam"), 3);
+		S_EQUAL(result.join("\n"), expected.join("\n"));
+	}
+};
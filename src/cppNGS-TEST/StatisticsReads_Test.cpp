@@ -54,4 +54,50 @@ private:
 			IS_TRUE(result[i].description()!="");
 		}
 	}
+
+	TEST_METHOD(merge)
+	{
+		//distribute reads to several instances (forward reads to three, reverse reads to two)
+		QList<StatisticsReads> parts;
+		for (int i=0; i<3; ++i) parts << StatisticsReads();
+
+		FastqEntry e;
+		int index = 0;
+		FastqFileStream stream(TESTDATA("data_in/example6.fastq.gz"), false);
+		while(!stream.atEnd())
+		{
+			stream.readEntry(e);
+			parts[index % 3].update(e, StatisticsReads::FORWARD);
+			++index;
+		}
+		FastqFileStream stream2(TESTDATA("data_in/example7.fastq.gz"), false);
+		while(!stream2.atEnd())
+		{
+			stream2.readEntry(e);
+			parts[index % 2].update(e, StatisticsReads::REVERSE);
+			++index;
+		}
+
+		//merge in different orders
+		StatisticsReads stats;
+		for (int i=0; i<parts.count(); ++i) stats.merge(parts[i]);
+		StatisticsReads stats_reverse;
+		for (int i=parts.count()-1; i>=0; --i) stats_reverse.merge(parts[i]);
+
+		//results are the same as for a single instance
+		QList<QCCollection> results;
+		results << stats.getResult() << stats_reverse.getResult();
+		foreach(const QCCollection& result, results)
+		{
+			S_EQUAL(result[0].toString(), QString("5000"));
+			S_EQUAL(result[1].toString(), QString("151"));
+			S_EQUAL(result[2].toString(), QString("0.76"));
+			S_EQUAL(result[3].toString(), QString("99.40"));
+			S_EQUAL(result[4].toString(), QString("96.77"));
+			S_EQUAL(result[5].toString(), QString("96.30"));
+			S_EQUAL(result[6].toString(), QString("0.00"));
+			S_EQUAL(result[7].toString(), QString("46.26"));
+			I_EQUAL(result.count(), 11);
+		}
+	}
 };
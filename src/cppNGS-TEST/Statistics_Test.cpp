@@ -4,6 +4,8 @@
 #include "Statistics.h"
 #include "Settings.h"
 #include "ScatterPlot.h"
+#include "VersatileFile.h"
+#include "Helper.h"
 
 TEST_CLASS(Statistics_Test)
 {
@@ -890,5 +892,98 @@ TEST_CLASS(Statistics_Test)
 		F_EQUAL2(ancestry.eas, 0.0742, 0.001);
 		S_EQUAL(ancestry.population, "AFR");
 	}
+
+	TEST_METHOD(ancestry_preloaded_markers)
+	{
+		AncestryMarkers markers(GenomeBuild::HG19);
+		IS_TRUE(markers.variants().count()>0);
+
+		QList<AncestryEstimates> estimates = Statistics::ancestry(markers, TESTDATA("data_in/ancestry.vcf.gz"));
+		I_EQUAL(estimates.count(), 1);
+		S_EQUAL(estimates[0].sample, "NA12878");
+		I_EQUAL(estimates[0].snps, 3096);
+		F_EQUAL2(estimates[0].eur, 0.3088, 0.001);
+		S_EQUAL(estimates[0].population, "EUR");
+
+		//multi-sample VCF (two copies of the sample above)
+		estimates = Statistics::ancestry(markers, TESTDATA("../tools-TEST/data_in/SampleAncestry_in_multi.vcf.gz"));
+		I_EQUAL(estimates.count(), 2);
+		for (int i=0; i<2; ++i)
+		{
+			I_EQUAL(estimates[i].snps, 3096);
+			F_EQUAL2(estimates[i].afr, 0.0114, 0.001);
+			F_EQUAL2(estimates[i].eur, 0.3088, 0.001);
+			S_EQUAL(estimates[i].population, "EUR");
+		}
+		S_EQUAL(estimates[1].sample, "S2");
+		IS_THROWN(ArgumentException, Statistics::ancestry(GenomeBuild::HG19, TESTDATA("../tools-TEST/data_in/SampleAncestry_in_multi.vcf.gz")));
+	}
+
+	TEST_METHOD(ancestry_multi_sample_same_as_single_sample)
+	{
+		//create a multi-sample VCF with two different samples (with missing and homozygous reference genotypes) and single-sample VCFs that contain only the variants of each sample
+		QStringList multi;
+		QStringList single1;
+		QStringList single2;
+		VersatileFile file(TESTDATA("data_in/ancestry.vcf.gz"));
+		file.open();
+		int i = 0;
+		while(!file.atEnd())
+		{
+			QByteArray line = file.readLine(true);
+			if (line.isEmpty()) continue;
+			if (line.startsWith("##"))
+			{
+				multi << line;
+				single1 << line;
+				single2 << line;
+				continue;
+			}
+			if (line.startsWith("#"))
+			{
+				multi << line + "\tS2";
+				single1 << line;
+				single2 << line.left(line.lastIndexOf('\t')) + "\tS2";
+				continue;
+			}
+
+			//sample 1: genotype of NA12878, missing for every 7th variant
+			QByteArrayList parts = line.split('\t');
+			QByteArray gt1 = parts[9].left(3);
+			if (i%7==0) gt1 = "./.";
+
+			//sample 2: heterozygous and homozygous genotypes of NA12878 swapped, homozygous reference for every 3rd variant, missing for every 5th variant
+			QByteArray gt2 = gt1=="1/1" ? "0/1" : "1/1";
+			if (i%3==0) gt2 = "0/0";
+			if (i%5==0) gt2 = "./.";
+			++i;
+
+			QByteArray fixed = parts.mid(0, 8).join('\t') + "\tGT";
+			multi << fixed + "\t" + gt1 + "\t" + gt2;
+			if (gt1!="./.") single1 << fixed + "\t" + gt1;
+			if (gt2!="./." && gt2!="0/0") single2 << fixed + "\t" + gt2;
+		}
+		Helper::storeTextFile("out/Statistics_ancestry_multi.vcf", multi);
+		Helper::storeTextFile("out/Statistics_ancestry_single1.vcf", single1);
+		Helper::storeTextFile("out/Statistics_ancestry_single2.vcf", single2);
+
+		//compare
+		AncestryMarkers markers(GenomeBuild::HG19);
+		QList<AncestryEstimates> estimates = Statistics::ancestry(markers, "out/Statistics_ancestry_multi.vcf", 100);
+		I_EQUAL(estimates.count(), 2);
+		for (int s=0; s<2; ++s)
+		{
+			QList<AncestryEstimates> expected = Statistics::ancestry(markers, "out/Statistics_ancestry_single" + QString::number(s+1) + ".vcf", 100);
+			I_EQUAL(expected.count(), 1);
+			I_EQUAL(estimates[s].snps, expected[0].snps);
+			F_EQUAL(estimates[s].afr, expected[0].afr);
+			F_EQUAL(estimates[s].eur, expected[0].eur);
+			F_EQUAL(estimates[s].sas, expected[0].sas);
+			F_EQUAL(estimates[s].eas, expected[0].eas);
+			S_EQUAL(estimates[s].population, expected[0].population);
+		}
+		IS_TRUE(estimates[0].snps<3096);
+		IS_TRUE(estimates[1].snps<estimates[0].snps);
+	}
 };
 
@@ -0,0 +1,89 @@
+#include "TestFramework.h"
+#include "VariantCountStore.h"
+#include "Helper.h"
+
+TEST_CLASS(VariantCountStore_Test)
+{
+private:
+
+	TEST_METHOD(create_and_get)
+	{
+		VariantCountStore::create(TESTDATA("../tools-TEST/data_in/VariantCountStoreCreate_in1.vcf"), "out/VariantCountStore_out1.vcs");
+
+		VariantCountStore store("out/VariantCountStore_out1.vcs");
+		I_EQUAL(store.count(), 22);
+		F_EQUAL(store.maxAf(), 0.05);
+		S_EQUAL(store.diseaseGroupKey("Neoplasms"), "GSC02");
+		S_EQUAL(store.diseaseGroupKey("n/a"), "GSC01");
+		S_EQUAL(store.diseaseGroupKey("Endocrine, nutritional or metabolic diseases"), "GSC05");
+		S_EQUAL(store.diseaseGroupKey("invalid"), "");
+
+		//SNV with disease group counts and comment
+		VariantCountData data = store.get(Variant("chr1", 826893, 826893, "G", "A"));
+		IS_TRUE(data.found);
+		IS_FALSE(data.high_af);
+		I_EQUAL(data.hom, 8);
+		I_EQUAL(data.het, 0);
+		I_EQUAL(data.mosaic, 0);
+		I_EQUAL(data.info.count(), 6);
+		S_EQUAL(data.infoValue("GSC02"), "4,0");
+		S_EQUAL(data.infoValue("GSC03"), "");
+		S_EQUAL(data.infoValue("COM"), "\"NA12878_38_Dragen_abra\"");
+
+		//deletion (VCF format converted to GSvar format)
+		data = store.get(Variant("chr1", 13657, 13658, "AG", "-"));
+		IS_TRUE(data.found);
+		I_EQUAL(data.hom, 1);
+		I_EQUAL(data.het, 1);
+		I_EQUAL(data.mosaic, 2);
+
+		//insertion with high AF and classification
+		data = store.get(Variant("chr1", 120069426, 120069426, "-", "CCTCCTCCG"));
+		IS_TRUE(data.found);
+		IS_TRUE(data.high_af);
+		I_EQUAL(data.hom, -1);
+		S_EQUAL(data.infoValue("CLAS"), "1");
+
+		//classification without disease group counts
+		data = store.get(Variant("chr1", 62247574, 62247574, "G", "A"));
+		IS_TRUE(data.found);
+		I_EQUAL(data.hom, 0);
+		S_EQUAL(data.infoValue("CLAS"), "5");
+		S_EQUAL(data.infoValue("CLAS_COM"), "\"pathogenic\"");
+
+		//not contained
+		data = store.get(Variant("chr1", 62247574, 62247574, "G", "C"));
+		IS_FALSE(data.found);
+		I_EQUAL(data.info.count(), 0);
+	}
+
+	TEST_METHOD(duplicate_variant)
+	{
+		QStringList lines;
+		lines << "##fileformat=VCFv4.2";
+		lines << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO";
+		lines << "chr1\t826893\t.\tG\tA\t.\t.\tCOUNTS=8,0,0";
+		lines << "chr1\t826893\t.\tG\tC\t.\t.\tCOUNTS=1,0,0";
+		lines << "chr1\t826893\t.\tG\tA\t.\t.\tCOUNTS=2,0,0";
+		Helper::storeTextFile("out/VariantCountStore_duplicate.vcf", lines);
+
+		IS_THROWN(FileParseException, VariantCountStore::create("out/VariantCountStore_duplicate.vcf", "out/VariantCountStore_out2.vcs"));
+	}
+
+	TEST_METHOD(hash_and_check_hash)
+	{
+		//hashes are part of the file format, i.e. they must not change
+		Variant v1("chr1", 826893, 826893, "G", "A");
+		IS_TRUE(VariantCountStore::hash(v1)==8952635757016352002ULL);
+		IS_TRUE(VariantCountStore::checkHash(v1)==5454178U);
+
+		Variant v2("chr1", 826893, 826893, "G", "C");
+		IS_TRUE(VariantCountStore::hash(v2)==8952633557993095580ULL);
+		IS_TRUE(VariantCountStore::checkHash(v2)==4266866236U);
+	}
+
+	TEST_METHOD(invalid_file)
+	{
+		IS_THROWN(FileParseException, VariantCountStore store(TESTDATA("../tools-TEST/data_in/VariantCountStoreCreate_in1.vcf")));
+	}
+};
@@ -24,6 +24,8 @@ SOURCES += \
         Chromosome_Test.cpp \
         BedLine_Test.cpp \
         BedFile_Test.cpp \
+        BedSweep_Test.cpp \
+        VariantCountStore_Test.cpp \
         QcRuleMatcher_Test.cpp \
         VariantList_Test.cpp \
         FilterCascade_Test.cpp \
@@ -48,8 +50,10 @@ SOURCES += \
         VcfFile_Test.cpp \
         VariantScores_Test.cpp \
         BamWriter_Test.cpp \
+        MatePairBuffer_Test.cpp \
         SomaticVariantInterpreter_Test.cpp \
         Graph_Test.cpp \
+        CompactGraph_Test.cpp \
         ChainFileReader_Test.cpp \
         BigWigReader_Test.cpp \
         VariantHgvsAnnotator_Test.cpp \
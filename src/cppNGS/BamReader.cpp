@@ -3,6 +3,7 @@
 #include "Helper.h"
 #include "VersatileFile.h"
 #include "RefGenomeService.h"
+#include "htslib/bgzf.h"
 /*
 External documentation used for the implementation:
 - reading BAM file: https://gist.github.com/PoisonAlien/350677acc03b2fbf98aa
@@ -735,16 +736,7 @@ void BamReader::setRegion(const Chromosome& chr, int start, int end)
 {
 	//clear data from previous calls
 	clearIterator();
-
-	//load index if not done already
-	if (index_==nullptr)
-	{
-		index_ = sam_index_load(fp_, bam_file_.toUtf8().data());
-		if (index_==nullptr)
-		{
-			THROW(FileAccessException, "Could not load index of BAM/CRAM file " + bam_file_);
-		}
-	}
+	loadIndex();
 
 	//find chromosome string used in BAM header ('chr1' does not equal '1' for htslib)
 	int chr_index = chrs_.indexOf(chr);
@@ -767,6 +759,49 @@ void BamReader::setRegion(const Chromosome& chr, int start, int end)
 	}
 }
 
+void BamReader::setRegionUnplaced()
+{
+	//clear data from previous calls
+	clearIterator();
+	loadIndex();
+
+	//create iterator for unmapped reads without coordinates
+	iter_ = sam_itr_queryi(index_, HTS_IDX_NOCOOR, 0, 0);
+	if (iter_==nullptr)
+	{
+		THROW(FileAccessException, "Could not create iterator for unplaced reads in BAM/CRAM file " + bam_file_);
+	}
+}
+
+qint64 BamReader::tell() const
+{
+	if (fp_->is_cram) THROW(NotImplementedException, "Virtual file offsets are not supported for CRAM file " + bam_file_);
+
+	return bgzf_tell(fp_->fp.bgzf);
+}
+
+void BamReader::seek(qint64 offset)
+{
+	if (fp_->is_cram) THROW(NotImplementedException, "Virtual file offsets are not supported for CRAM file " + bam_file_);
+
+	clearIterator();
+	if (bgzf_seek(fp_->fp.bgzf, offset, SEEK_SET)<0)
+	{
+		THROW(FileAccessException, "Could not seek to virtual file offset " + QString::number(offset) + " in BAM file " + bam_file_);
+	}
+}
+
+void BamReader::loadIndex()
+{
+	if (index_!=nullptr) return;
+
+	index_ = sam_index_load(fp_, bam_file_.toUtf8().data());
+	if (index_==nullptr)
+	{
+		THROW(FileAccessException, "Could not load index of BAM/CRAM file " + bam_file_);
+	}
+}
+
 const QList<Chromosome>& BamReader::chromosomes() const
 {
 	return chrs_;
@@ -884,6 +919,75 @@ Pileup BamReader::getPileup(const Chromosome& chr, int pos, int indel_window, in
 	return output;
 }
 
+QVector<Pileup> BamReader::getPileups(const Chromosome& chr, int start, int end, int min_mapq, bool include_not_properly_paired, int min_baseq)
+{
+	//init
+	QVector<Pileup> output(end-start+1);
+
+	//we don't need qualities for this method - they are re-enabled at the end
+	int requested_fields_before = requested_fields_;
+	if (min_baseq<=0) skipQualities();
+	skipTags();
+
+	//restrict to region
+	setRegion(chr, start, end);
+
+	//iterate through all alignments and add the bases of the region to the counts
+	BamAlignment al;
+	while (getNextAlignment(al))
+	{
+		if (al.isSecondaryAlignment() || al.isSupplementaryAlignment() || al.isDuplicate() || al.isUnmapped()) continue;
+		if (!al.isProperPair() && !include_not_properly_paired) continue;
+		if (al.mappingQuality()<min_mapq) continue;
+		if (al.cigarIsOnlyInsertion()) continue;
+
+		int read_pos = 0;
+		int genome_pos = al.start();
+		CigarData cigar = al.cigarData();
+		for(uint32_t i=0; i<cigar.size() && genome_pos<=end; ++i)
+		{
+			uint32_t op = cigar.opType(i);
+			int len = cigar.opLength(i);
+
+			if (op==BAM_CMATCH || op==BAM_CEQUAL || op==BAM_CDIFF)
+			{
+				for (int j=std::max(0, start-genome_pos); j<len && genome_pos+j<=end; ++j)
+				{
+					int quality = al.containsQualities() ? al.quality(read_pos+j) : -1;
+					if (quality>=min_baseq) output[genome_pos+j-start].inc(al.base(read_pos+j));
+				}
+				genome_pos += len;
+				read_pos += len;
+			}
+			else if(op==BAM_CDEL)
+			{
+				//deleted bases are counted independent of the base quality (like in getPileup)
+				for (int j=std::max(0, start-genome_pos); j<len && genome_pos+j<=end; ++j)
+				{
+					output[genome_pos+j-start].inc('-');
+				}
+				genome_pos += len;
+			}
+			else if(op==BAM_CREF_SKIP) //skipped reference bases (for RNA)
+			{
+				genome_pos += len;
+			}
+			else if(op==BAM_CINS || op==BAM_CSOFT_CLIP)
+			{
+				read_pos += len;
+			}
+			else if(op!=BAM_CHARD_CLIP)
+			{
+				THROW(Exception, "Unknown CIGAR operation " + QString::number(cigar.opTypeAsChar(i)) + "!");
+			}
+		}
+	}
+
+	requested_fields_ = requested_fields_before;
+
+	return output;
+}
+
 
 VariantDetails BamReader::getVariantDetails(const FastaFileIndex& reference, const Variant& variant, bool include_not_properly_paired, bool count_fragments)
 {
@@ -381,6 +381,13 @@ class CPPNGSSHARED_EXPORT BamReader
 
 		//Set region for alignment retrieval (1-based coordinates).
 		void setRegion(const Chromosome& chr, int start, int end);
+		//Set region to the unmapped alignments without coordinates (stored at the end of coordinate-sorted files).
+		void setRegionUnplaced();
+
+		//Returns the virtual file offset of the next alignment. Throws an exception for CRAM files.
+		qint64 tell() const;
+		//Moves to the given virtual file offset returned by tell(). A region set before is cleared. Throws an exception for CRAM files.
+		void seek(qint64 offset);
 
 		//Get next alignment and stores it in @p al.
 		bool getNextAlignment(BamAlignment& al)
@@ -416,6 +423,12 @@ class CPPNGSSHARED_EXPORT BamReader
 		*/
         Pileup getPileup(const Chromosome& chr, int pos, int indel_window = -1, int min_mapq = 1, bool include_not_properly_paired = false, int min_baseq = 13, bool count_fragments=false);
 
+		/**
+		  @brief Returns the pileups of all positions of a chromosomal range (1-based). The alignments of the range are read only once, which is much faster than calling getPileup for each position.
+		  @note The base counts are the same as those of getPileup (without indel window and fragment counting). Indels and the fraction of MAPQ0 reads are not determined.
+		*/
+		QVector<Pileup> getPileups(const Chromosome& chr, int start, int end, int min_mapq = 1, bool include_not_properly_paired = false, int min_baseq = 13);
+
 		/**
 			@bried Returns the depth/frequency for a variant (start, ref, obs in TSV style). If the depth is 0, quiet_NaN is returned as frequency.
 			@param include_not_properly_paired also uses reads which are not properly paired. This flag has to be set when used on long-read data.
@@ -442,6 +455,8 @@ class CPPNGSSHARED_EXPORT BamReader
 
 		//Releases resources held by the iterator (index is not cleared)
 		void clearIterator();
+		//Loads the index (if not done already)
+		void loadIndex();
 		void checkChromosomeLengths(const QString& ref_genome);
         void init(const QString& bam_file, QString ref_genome = QString());
 
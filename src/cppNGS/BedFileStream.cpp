@@ -0,0 +1,177 @@
+#include "BedFileStream.h"
+#include "Exceptions.h"
+#include "Helper.h"
+
+BedFileStream::BedFileStream(QString filename, bool stdin_if_empty, bool require_sorted)
+	: filename_(filename)
+	, file_(new VersatileFile(filename, stdin_if_empty))
+	, require_sorted_(require_sorted)
+	, headers_()
+	, has_next_(false)
+	, next_()
+{
+	file_->open(QFile::ReadOnly | QIODevice::Text);
+
+	//read headers and first line
+	readNext();
+}
+
+bool BedFileStream::next(BedLine& line)
+{
+	if (!has_next_) return false;
+
+	line = next_;
+	readNext();
+
+	return true;
+}
+
+void BedFileStream::readNext()
+{
+	bool has_previous = has_next_;
+	has_next_ = false;
+
+	while(!file_->atEnd())
+	{
+		QByteArray line = file_->readLine(true);
+
+		//skip empty lines
+		if(line.isEmpty()) continue;
+
+		//store headers
+		if (line.startsWith("#") || line.startsWith("track ") || line.startsWith("browser ") || line.startsWith("Chromosome\tStart\tEnd"))
+		{
+			headers_.append(line);
+			continue;
+		}
+
+		//error when less than 3 fields
+		QByteArrayList fields = line.split('\t');
+		if (fields.count()<3)
+		{
+			THROW(FileParseException, "BED file line with less than three fields found: '" + line.trimmed() + "'");
+		}
+
+		//chr (re-use chromosome of previous line)
+		if (fields[0]!=last_chr_str_)
+		{
+			last_chr_str_ = fields[0];
+			last_chr_ = Chromosome(last_chr_str_);
+		}
+
+		//check that start/end is number
+		bool ok = true;
+		int start = fields[1].toInt(&ok) + 1;
+		if (!ok) THROW(FileParseException, "BED file line with invalid starts position found: '" + line.trimmed() + "'");
+		int end = fields[2].toInt(&ok);
+		if (!ok) THROW(FileParseException, "BED file line with invalid end position found: '" + line.trimmed() + "'");
+
+		//annotations
+		QByteArrayList annos = fields.mid(3);
+
+		//check sorting
+		BedLine bed_line(last_chr_, start, end, annos);
+		if (require_sorted_ && has_previous && bed_line<next_)
+		{
+			THROW(FileParseException, "Unsorted BED file line found in '" + filename_ + "': '" + line.trimmed() + "' follows '" + next_.toString(false) + "'. Use BedSort to sort the file!");
+		}
+
+		next_ = bed_line;
+		has_next_ = true;
+		return;
+	}
+}
+
+BedOutfileStream::BedOutfileStream(QString filename, bool stdout_if_empty, int compression_level)
+	: filename_(filename)
+	, file_()
+	, bgzf_(nullptr)
+	, buffer_()
+	, is_closed_(false)
+{
+	if (filename.endsWith(".gz"))
+	{
+		QByteArray open_flags = "wb"+QByteArray::number(compression_level);
+		bgzf_ = bgzf_open(filename.toUtf8().data(), open_flags.data());
+		if (bgzf_==nullptr) THROW(FileAccessException, "Could not open file '" + filename + "' for writing!");
+	}
+	else
+	{
+		file_ = Helper::openFileForWriting(filename, stdout_if_empty);
+	}
+}
+
+BedOutfileStream::~BedOutfileStream()
+{
+	//no exceptions in the destructor
+	try
+	{
+		close();
+	}
+	catch(...)
+	{
+	}
+}
+
+void BedOutfileStream::writeHeaders(const QByteArrayList& headers)
+{
+	foreach(const QByteArray& header, headers)
+	{
+		buffer_.append(header.trimmed());
+		buffer_.append('\n');
+	}
+}
+
+void BedOutfileStream::write(const BedLine& line)
+{
+	buffer_.append(line.chr().str());
+	buffer_.append('\t');
+	buffer_.append(QByteArray::number(line.start()-1));
+	buffer_.append('\t');
+	buffer_.append(QByteArray::number(line.end()));
+	foreach(const QByteArray& anno, line.annotations())
+	{
+		buffer_.append('\t');
+		buffer_.append(anno);
+	}
+	buffer_.append('\n');
+
+	if (buffer_.size()>=1048576) flush();
+}
+
+void BedOutfileStream::close()
+{
+	if (is_closed_) return;
+	is_closed_ = true;
+
+	flush();
+
+	if (bgzf_!=nullptr)
+	{
+		int closed = bgzf_close(bgzf_);
+		bgzf_ = nullptr;
+		if (closed!=0) THROW(FileAccessException, "Writing bgzipped BED file '" + filename_ + "' failed: could not close file.");
+	}
+	else
+	{
+		file_->close();
+	}
+}
+
+void BedOutfileStream::flush()
+{
+	if (buffer_.isEmpty()) return;
+
+	if (bgzf_!=nullptr)
+	{
+		ssize_t written_bytes = bgzf_write(bgzf_, buffer_.constData(), buffer_.size());
+		if (written_bytes!=buffer_.size()) THROW(FileAccessException, "Writing bgzipped BED file '" + filename_ + "' failed: not all bytes were written.");
+	}
+	else
+	{
+		qint64 written_bytes = file_->write(buffer_);
+		if (written_bytes!=buffer_.size()) THROW(FileAccessException, "Writing BED file '" + filename_ + "' failed: not all bytes were written.");
+	}
+
+	buffer_.clear();
+}
@@ -0,0 +1,90 @@
+#ifndef BEDFILESTREAM_H
+#define BEDFILESTREAM_H
+
+#include "cppNGS_global.h"
+#include "BedFile.h"
+#include "VersatileFile.h"
+#include "htslib/bgzf.h"
+#include <QSharedPointer>
+
+///BED file reader that returns one line after the other, i.e. the memory usage does not depend on the file size.
+///Supports gzipped/bgzipped files and STDIN. Headers are available directly after construction.
+class CPPNGSSHARED_EXPORT BedFileStream
+{
+public:
+	///Constructor. If @p require_sorted is set, a FileParseException is thrown when a line is smaller than the previous line (see BedLine::operator<).
+	BedFileStream(QString filename, bool stdin_if_empty = true, bool require_sorted = true);
+
+	///Reads the next line into @p line. Returns false if the end of the file is reached.
+	bool next(BedLine& line);
+	///Returns the next line without consuming it. The stream must not be at the end.
+	const BedLine& peek() const
+	{
+		return next_;
+	}
+	///Returns if the end of the file is reached.
+	bool atEnd() const
+	{
+		return !has_next_;
+	}
+
+	///Returns the header lines.
+	const QByteArrayList& headers() const
+	{
+		return headers_;
+	}
+	///Returns the file name.
+	const QString& filename() const
+	{
+		return filename_;
+	}
+
+private:
+	QString filename_;
+	QSharedPointer<VersatileFile> file_;
+	bool require_sorted_;
+	QByteArrayList headers_;
+	bool has_next_;
+	BedLine next_;
+	QByteArray last_chr_str_; //last chromosome, used to avoid creating a new chromosome for each line
+	Chromosome last_chr_;
+
+	void readNext();
+
+	//declared away
+	BedFileStream(const BedFileStream&) = delete;
+	BedFileStream& operator=(const BedFileStream&) = delete;
+};
+
+///BED file writer that writes one line after the other. Files ending with '.gz' are bgzip-compressed, i.e. they can be indexed with tabix.
+///The output format is the same as the format of BedFile::store.
+class CPPNGSSHARED_EXPORT BedOutfileStream
+{
+public:
+	///Constructor. If @p filename is empty and @p stdout_if_empty is set, writes to STDOUT.
+	BedOutfileStream(QString filename, bool stdout_if_empty = true, int compression_level = 6);
+	///Destructor - closes the file if not done yet.
+	~BedOutfileStream();
+
+	///Writes header lines.
+	void writeHeaders(const QByteArrayList& headers);
+	///Writes a BED line.
+	void write(const BedLine& line);
+	///Flushes the buffer and closes the file.
+	void close();
+
+private:
+	QString filename_;
+	QSharedPointer<QFile> file_;
+	BGZF* bgzf_;
+	QByteArray buffer_;
+	bool is_closed_;
+
+	void flush();
+
+	//declared away
+	BedOutfileStream(const BedOutfileStream&) = delete;
+	BedOutfileStream& operator=(const BedOutfileStream&) = delete;
+};
+
+#endif // BEDFILESTREAM_H
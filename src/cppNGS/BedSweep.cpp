@@ -0,0 +1,176 @@
+#include "BedSweep.h"
+
+//Window of merged regions of a sorted BED stream. The window is moved along the regions of another sorted BED stream and contains only the regions needed for the current and later regions.
+class MergedRegionWindow
+{
+public:
+	MergedRegionWindow(BedFileStream& stream, bool merge_back_to_back = true)
+		: stream_(stream)
+		, merge_back_to_back_(merge_back_to_back)
+		, regions_()
+	{
+	}
+
+	//Moves the window to the given line and returns the merged regions of the window (sorted, on the chromosome of the line, ending at or after the start of the line).
+	//The first regions overlap the line - iteration can be stopped at the first region starting after the line end.
+	const QList<BedLine>& moveTo(const BedLine& line)
+	{
+		//remove regions before the line
+		while (!regions_.isEmpty() && (regions_.first().chr()<line.chr() || regions_.first().end()<line.start()))
+		{
+			regions_.removeFirst();
+		}
+
+		//add regions that start before the line end
+		BedLine region;
+		while (!stream_.atEnd())
+		{
+			const BedLine& next = stream_.peek();
+			if (line.chr()<next.chr() || (next.chr()==line.chr() && next.start()>line.end())) break;
+
+			stream_.next(region);
+			if (region.chr()<line.chr() || region.end()<line.start()) continue;
+
+			if (!regions_.isEmpty() && (regions_.last().overlapsWith(region.chr(), region.start(), region.end()) || (merge_back_to_back_ && regions_.last().adjacentTo(region.chr(), region.start(), region.end()))))
+			{
+				if (region.end()>regions_.last().end()) regions_.last().setEnd(region.end());
+			}
+			else
+			{
+				region.annotations().clear();
+				regions_.append(region);
+			}
+		}
+
+		return regions_;
+	}
+
+private:
+	BedFileStream& stream_;
+	bool merge_back_to_back_;
+	QList<BedLine> regions_;
+};
+
+void BedSweep::merge(BedFileStream& in, BedOutfileStream& out, bool merge_back_to_back, bool merge_names, bool merged_names_unique)
+{
+	out.writeHeaders(in.headers());
+
+	BedLine next_output_line;
+	bool has_output_line = false;
+	BedLine line;
+	while(in.next(line))
+	{
+		//keep name only
+		QByteArray name;
+		if (merge_names && !line.annotations().isEmpty()) name = line.annotations()[0];
+		line.annotations().clear();
+		if (merge_names) line.annotations().append(name);
+
+		if (!has_output_line)
+		{
+			next_output_line = line;
+			has_output_line = true;
+		}
+		else if (next_output_line.overlapsWith(line.chr(), line.start(), line.end()) || (merge_back_to_back && next_output_line.adjacentTo(line.chr(), line.start(), line.end())))
+		{
+			if (line.end()>next_output_line.end())
+			{
+				next_output_line.setEnd(line.end());
+			}
+			if (merge_names && (!merged_names_unique || !next_output_line.annotations().contains(name)))
+			{
+				next_output_line.annotations() << name;
+			}
+		}
+		else
+		{
+			if (merge_names) next_output_line.annotations() = QByteArrayList() << next_output_line.annotations().join(",");
+			out.write(next_output_line);
+
+			next_output_line = line;
+		}
+	}
+
+	//write last line
+	if (has_output_line)
+	{
+		if (merge_names) next_output_line.annotations() = QByteArrayList() << next_output_line.annotations().join(",");
+		out.write(next_output_line);
+	}
+}
+
+void BedSweep::intersect(BedFileStream& in, BedFileStream& in2, BedOutfileStream& out, bool keep_anno, bool merge_back_to_back)
+{
+	out.writeHeaders(in.headers());
+
+	MergedRegionWindow window(in2, merge_back_to_back);
+	BedLine line;
+	while(in.next(line))
+	{
+		if (!keep_anno) line.annotations().clear();
+
+		foreach(const BedLine& region, window.moveTo(line))
+		{
+			if (region.start()>line.end()) break;
+
+			out.write(BedLine(line.chr(), std::max(line.start(), region.start()), std::min(line.end(), region.end()), line.annotations()));
+		}
+	}
+}
+
+void BedSweep::overlapping(BedFileStream& in, BedFileStream& in2, BedOutfileStream& out)
+{
+	out.writeHeaders(in.headers());
+
+	MergedRegionWindow window(in2);
+	BedLine line;
+	while(in.next(line))
+	{
+		const QList<BedLine>& regions = window.moveTo(line);
+		if (!regions.isEmpty() && regions.first().start()<=line.end())
+		{
+			out.write(line);
+		}
+	}
+}
+
+void BedSweep::subtract(BedFileStream& in, BedFileStream& in2, BedOutfileStream& out)
+{
+	out.writeHeaders(in.headers());
+
+	MergedRegionWindow window(in2);
+	BedLine line;
+	while(in.next(line))
+	{
+		int start = line.start();
+		foreach(const BedLine& region, window.moveTo(line))
+		{
+			if (region.start()>line.end()) break;
+
+			//part left of the region
+			if (region.start()>start) out.write(BedLine(line.chr(), start, region.start()-1));
+			start = std::max(start, region.end()+1);
+		}
+
+		//part right of the last region
+		if (start<=line.end()) out.write(BedLine(line.chr(), start, line.end()));
+	}
+}
+
+bool BedSweep::isMergedAndSorted(QString filename)
+{
+	BedFileStream stream(filename, false, false);
+
+	BedLine previous;
+	BedLine line;
+	bool first = true;
+	while(stream.next(line))
+	{
+		if (!first && (line<previous || previous.overlapsWith(line.chr(), line.start(), line.end()))) return false;
+
+		previous = line;
+		first = false;
+	}
+
+	return true;
+}
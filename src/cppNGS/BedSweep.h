@@ -0,0 +1,31 @@
+#ifndef BEDSWEEP_H
+#define BEDSWEEP_H
+
+#include "cppNGS_global.h"
+#include "BedFileStream.h"
+
+///Sweep-line algorithms on sorted BED streams. In contrast to the BedFile methods, the memory usage does not depend on the file size, i.e. they can be used for genome-wide BED files with millions of lines (e.g. per-base callable regions).
+///The second input stream is merged on the fly (overlapping regions and optionally back-to-back regions, as BedFile::merge does).
+///The output contains the same lines as the output of the respective BedFile methods. However, lines that are split are written directly after each other instead of being appended at the end, i.e. the output stays sorted.
+///If an input stream is not sorted, a FileParseException is thrown.
+class CPPNGSSHARED_EXPORT BedSweep
+{
+public:
+	///Merges overlapping (and back-to-back) regions, see BedFile::merge.
+	static void merge(BedFileStream& in, BedOutfileStream& out, bool merge_back_to_back = true, bool merge_names = false, bool merged_names_unique = false);
+	///Writes the intersect of each region of @p in with the regions of @p in2, see BedFile::intersect.
+	///Back-to-back regions of @p in2 are only merged if @p merge_back_to_back is set. To get the same output as BedFile::intersect after merging the second file only if it is not merged (see BedFile::isMergedAndSorted), use isMergedAndSorted(QString) to set it.
+	static void intersect(BedFileStream& in, BedFileStream& in2, BedOutfileStream& out, bool keep_anno = false, bool merge_back_to_back = true);
+	///Writes the regions of @p in that overlap a region of @p in2, see BedFile::overlapping.
+	static void overlapping(BedFileStream& in, BedFileStream& in2, BedOutfileStream& out);
+	///Writes the regions of @p in with the regions of @p in2 removed, see BedFile::subtract.
+	static void subtract(BedFileStream& in, BedFileStream& in2, BedOutfileStream& out);
+
+	///Returns if the regions of a BED file are sorted and do not overlap, see BedFile::isMergedAndSorted. The file is read line by line.
+	static bool isMergedAndSorted(QString filename);
+
+protected:
+	BedSweep() = delete;
+};
+
+#endif // BEDSWEEP_H
@@ -0,0 +1,273 @@
+#include "CompactGraph.h"
+#include "Exceptions.h"
+#include "VersatileFile.h"
+#include <QDataStream>
+#include <QFile>
+#include <QSet>
+#include <QThreadPool>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+//file format: magic (8 bytes), version, flags, node names, edge count, offsets and targets/weights as raw arrays
+static const char CSR_MAGIC[] = "NGSCSR01";
+static const qint32 CSR_VERSION = 1;
+
+CompactGraph::CompactGraph()
+	: directed_(false)
+	, edge_count_(0)
+	, offsets_(1, 0)
+{
+}
+
+CompactGraph::CompactGraph(const QStringList& names, const QVector<Edge>& edges, bool directed, bool weighted)
+	: names_(names)
+	, directed_(directed)
+	, edge_count_(0)
+{
+	createIndex();
+	const int node_count = names_.count();
+
+	//skip duplicate edges
+	QVector<Edge> unique_edges;
+	unique_edges.reserve(edges.count());
+	QSet<quint64> keys;
+	keys.reserve(edges.count());
+	for (const Edge& edge : edges)
+	{
+		if (edge.node1<0 || edge.node1>=node_count || edge.node2<0 || edge.node2>=node_count) THROW(ArgumentException, "Invalid node index in edge " + QString::number(edge.node1) + "-" + QString::number(edge.node2) + " of graph with " + QString::number(node_count) + " nodes!");
+
+		quint32 first = edge.node1;
+		quint32 second = edge.node2;
+		if (!directed && first>second) std::swap(first, second);
+		quint64 key = (static_cast<quint64>(first)<<32) | second;
+		if (keys.contains(key)) continue;
+		keys << key;
+
+		unique_edges << edge;
+	}
+	edge_count_ = unique_edges.count();
+
+	//count neighbors (undirected edges are stored for both nodes)
+	QVector<qint64> counts(node_count + 1, 0);
+	for (const Edge& edge : unique_edges)
+	{
+		++counts[edge.node1 + 1];
+		if (!directed) ++counts[edge.node2 + 1];
+	}
+	for (int i=1; i<=node_count; ++i)
+	{
+		counts[i] += counts[i-1];
+	}
+	if (counts[node_count]>std::numeric_limits<int>::max()) THROW(ArgumentException, "Graph contains too many edges: " + QString::number(counts[node_count]));
+	offsets_.resize(node_count + 1);
+	for (int i=0; i<=node_count; ++i)
+	{
+		offsets_[i] = static_cast<int>(counts[i]);
+	}
+
+	//fill neighbors
+	targets_.resize(offsets_[node_count]);
+	QVector<float> edge_weights(offsets_[node_count]);
+	QVector<int> next = offsets_;
+	for (const Edge& edge : unique_edges)
+	{
+		int pos = next[edge.node1]++;
+		targets_[pos] = edge.node2;
+		edge_weights[pos] = edge.weight;
+		if (!directed)
+		{
+			pos = next[edge.node2]++;
+			targets_[pos] = edge.node1;
+			edge_weights[pos] = edge.weight;
+		}
+	}
+
+	//sort neighbors of each node
+	QVector<QPair<int, float>> row;
+	for (int n=0; n<node_count; ++n)
+	{
+		row.clear();
+		for (int i=offsets_[n]; i<offsets_[n+1]; ++i)
+		{
+			row << qMakePair(targets_[i], edge_weights[i]);
+		}
+		std::stable_sort(row.begin(), row.end(), [](const QPair<int, float>& a, const QPair<int, float>& b){ return a.first<b.first; });
+		for (int i=0; i<row.count(); ++i)
+		{
+			targets_[offsets_[n] + i] = row[i].first;
+			edge_weights[offsets_[n] + i] = row[i].second;
+		}
+	}
+	if (weighted) weights_ = edge_weights;
+}
+
+void CompactGraph::createIndex()
+{
+	indices_.clear();
+	indices_.reserve(names_.count());
+	for (int i=0; i<names_.count(); ++i)
+	{
+		if (indices_.contains(names_[i])) THROW(ArgumentException, "Duplicate node name in graph: " + names_[i]);
+		indices_.insert(names_[i], i);
+	}
+}
+
+CompactGraph CompactGraph::load(const QString& filename)
+{
+	if (isBinaryFile(filename))
+	{
+		QFile file(filename);
+		if (!file.open(QIODevice::ReadOnly)) THROW(FileAccessException, "Could not open graph file for reading: " + filename);
+		QDataStream stream(&file);
+
+		char magic[8];
+		qint32 version;
+		bool directed;
+		bool weighted;
+		qint32 edge_count;
+		qint32 target_count;
+		CompactGraph graph;
+		stream.readRawData(magic, 8);
+		stream >> version;
+		if (version!=CSR_VERSION) THROW(FileParseException, "Unsupported version " + QString::number(version) + " of binary graph file " + filename);
+		stream >> directed >> weighted >> graph.names_ >> edge_count >> target_count;
+		if (stream.status()!=QDataStream::Ok || target_count<0) THROW(FileParseException, "Could not read header of binary graph file " + filename);
+
+		graph.directed_ = directed;
+		graph.edge_count_ = edge_count;
+		graph.offsets_.resize(graph.names_.count() + 1);
+		graph.targets_.resize(target_count);
+		auto read_array = [&](char* data, qint64 bytes)
+		{
+			if (stream.readRawData(data, bytes)!=bytes) THROW(FileParseException, "Truncated binary graph file " + filename);
+		};
+		read_array(reinterpret_cast<char*>(graph.offsets_.data()), graph.offsets_.count() * sizeof(int));
+		read_array(reinterpret_cast<char*>(graph.targets_.data()), graph.targets_.count() * sizeof(int));
+		if (weighted)
+		{
+			graph.weights_.resize(target_count);
+			read_array(reinterpret_cast<char*>(graph.weights_.data()), graph.weights_.count() * sizeof(float));
+		}
+		if (graph.offsets_.first()!=0 || graph.offsets_.last()!=target_count) THROW(FileParseException, "Invalid offsets in binary graph file " + filename);
+
+		graph.createIndex();
+		return graph;
+	}
+
+	//TSV file
+	QStringList names;
+	QHash<QString, int> indices;
+	QVector<Edge> edges;
+	auto node_index = [&](const QString& name)
+	{
+		int index = indices.value(name, -1);
+		if (index==-1)
+		{
+			index = names.count();
+			indices.insert(name, index);
+			names << name;
+		}
+		return index;
+	};
+
+	VersatileFile file(filename);
+	file.open();
+	while (!file.atEnd())
+	{
+		QStringList parts = QString::fromUtf8(file.readLine(true)).split('\t', Qt::SkipEmptyParts);
+		if (parts.count()!=2) continue;
+
+		int node1 = node_index(parts[0]);
+		int node2 = node_index(parts[1]);
+		edges << Edge{node1, node2, 1.0f};
+	}
+
+	return CompactGraph(names, edges);
+}
+
+void CompactGraph::storeBinary(const QString& filename) const
+{
+	QFile file(filename);
+	if (!file.open(QIODevice::WriteOnly)) THROW(FileAccessException, "Could not open graph file for writing: " + filename);
+	QDataStream stream(&file);
+
+	stream.writeRawData(CSR_MAGIC, 8);
+	stream << CSR_VERSION << directed_ << weighted() << names_ << static_cast<qint32>(edge_count_) << static_cast<qint32>(targets_.count());
+	stream.writeRawData(reinterpret_cast<const char*>(offsets_.constData()), offsets_.count() * sizeof(int));
+	stream.writeRawData(reinterpret_cast<const char*>(targets_.constData()), targets_.count() * sizeof(int));
+	if (weighted())
+	{
+		stream.writeRawData(reinterpret_cast<const char*>(weights_.constData()), weights_.count() * sizeof(float));
+	}
+
+	if (stream.status()!=QDataStream::Ok) THROW(FileAccessException, "Could not write to graph file " + filename);
+}
+
+bool CompactGraph::isBinaryFile(const QString& filename)
+{
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly)) THROW(FileAccessException, "Could not open graph file for reading: " + filename);
+
+	char magic[8];
+	return file.read(magic, 8)==8 && memcmp(magic, CSR_MAGIC, 8)==0;
+}
+
+void CompactGraph::multiply(const QVector<double>& input, QVector<double>& output, int threads) const
+{
+	const int node_count = nodeCount();
+	if (input.count()!=node_count) THROW(ArgumentException, "Input vector size " + QString::number(input.count()) + " does not match node count " + QString::number(node_count) + "!");
+	output.resize(node_count);
+	const double* in = input.constData();
+	double* out = output.data();
+
+	auto process_nodes = [&](int start, int end)
+	{
+		const int* targets = targets_.constData();
+		const float* weights = weights_.constData();
+		for (int n=start; n<end; ++n)
+		{
+			double sum = 0.0;
+			if (weights_.isEmpty())
+			{
+				for (int i=offsets_[n]; i<offsets_[n+1]; ++i)
+				{
+					sum += in[targets[i]];
+				}
+			}
+			else
+			{
+				for (int i=offsets_[n]; i<offsets_[n+1]; ++i)
+				{
+					sum += weights[i] * in[targets[i]];
+				}
+			}
+			out[n] = sum;
+		}
+	};
+
+	//small graphs are not worth the thread overhead
+	if (threads<=1 || targets_.count()<100000)
+	{
+		process_nodes(0, node_count);
+		return;
+	}
+
+	//split nodes into chunks with about the same number of neighbors
+	const int chunk_count = threads * 4;
+	const qint64 chunk_size = targets_.count() / chunk_count + 1;
+	QThreadPool thread_pool;
+	thread_pool.setMaxThreadCount(threads);
+	int start = 0;
+	while (start<node_count)
+	{
+		int end = std::upper_bound(offsets_.constBegin() + start + 1, offsets_.constEnd(), offsets_[start] + chunk_size) - offsets_.constBegin() - 1;
+		end = std::min(std::max(end, start + 1), node_count);
+		thread_pool.start([&process_nodes, start, end]()
+		{
+			process_nodes(start, end);
+		});
+		start = end;
+	}
+	thread_pool.waitForDone();
+}
@@ -0,0 +1,99 @@
+#ifndef COMPACTGRAPH_H
+#define COMPACTGRAPH_H
+
+#include "cppNGS_global.h"
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QVector>
+
+///Immutable graph in compressed sparse row (CSR) format: nodes are identified by index, neighbors and weights of all nodes are stored in contiguous arrays.
+///Intended for large networks (e.g. protein-protein interaction graphs) that are loaded once and used for network propagation.
+class CPPNGSSHARED_EXPORT CompactGraph
+{
+public:
+	///Edge between two nodes (node indices).
+	struct Edge
+	{
+		int node1;
+		int node2;
+		float weight;
+	};
+
+	///Default constructor (empty graph).
+	CompactGraph();
+	///Constructor. Duplicate edges are skipped, i.e. the first occurrence is used. In undirected graphs, an edge and the edge with swapped nodes are duplicates. Weights are stored only if @p weighted is set.
+	CompactGraph(const QStringList& names, const QVector<Edge>& edges, bool directed = false, bool weighted = false);
+
+	///Loads an undirected graph from a TSV file with two node names per line, or a graph from a binary file created with storeBinary() (the format is detected automatically).
+	static CompactGraph load(const QString& filename);
+	///Stores the graph in binary format.
+	void storeBinary(const QString& filename) const;
+	///Returns if the file is a binary graph file.
+	static bool isBinaryFile(const QString& filename);
+
+	///Returns the number of nodes.
+	int nodeCount() const
+	{
+		return names_.count();
+	}
+	///Returns the number of edges.
+	int edgeCount() const
+	{
+		return edge_count_;
+	}
+	///Returns if the graph is directed.
+	bool directed() const
+	{
+		return directed_;
+	}
+	///Returns if edge weights are stored.
+	bool weighted() const
+	{
+		return !weights_.isEmpty();
+	}
+
+	///Returns the name of a node.
+	const QString& name(int node) const
+	{
+		return names_[node];
+	}
+	///Returns the index of a node, or -1 if the graph does not contain a node with the given name.
+	int index(const QString& name) const
+	{
+		return indices_.value(name, -1);
+	}
+
+	///Returns the number of neighbors of a node (outgoing edges for directed graphs). In undirected graphs, self-loops count twice.
+	int degree(int node) const
+	{
+		return offsets_[node+1] - offsets_[node];
+	}
+	///Returns the neighbors of a node (sorted by index). The array contains degree() elements.
+	const int* neighbors(int node) const
+	{
+		return targets_.constData() + offsets_[node];
+	}
+	///Returns the weights of the edges to the neighbors of a node, or nullptr if the graph is not weighted.
+	const float* weights(int node) const
+	{
+		return weighted() ? weights_.constData() + offsets_[node] : nullptr;
+	}
+
+	///Sparse matrix-vector product: output[i] is the sum of the weighted input values of all neighbors of node i (weight 1 for unweighted graphs). Nodes are processed in parallel.
+	void multiply(const QVector<double>& input, QVector<double>& output, int threads = 1) const;
+
+protected:
+	QStringList names_;
+	QHash<QString, int> indices_;
+	bool directed_;
+	int edge_count_;
+	QVector<int> offsets_; //node count + 1 elements
+	QVector<int> targets_;
+	QVector<float> weights_; //empty if the graph is not weighted
+
+	//Creates the name index
+	void createIndex();
+};
+
+#endif // COMPACTGRAPH_H
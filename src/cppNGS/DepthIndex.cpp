@@ -0,0 +1,402 @@
+#include "DepthIndex.h"
+#include "BamReader.h"
+#include "Exceptions.h"
+#include <QDataStream>
+#include <QFileInfo>
+#include <QThreadPool>
+#include <QBitArray>
+#include <cstring>
+#include <algorithm>
+
+//file format constants
+static const char DEPTH_MAGIC[] = "NGSDEPTH";
+static const quint32 DEPTH_VERSION = 1;
+
+//variable-length encoding of non-negative integers (7 bits per byte)
+static void appendVarint(QByteArray& data, quint32 value)
+{
+	while (value>=0x80)
+	{
+		data.append(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	data.append(static_cast<char>(value));
+}
+
+static quint32 readVarint(const QByteArray& data, int& pos)
+{
+	quint32 value = 0;
+	int shift = 0;
+	while (pos<data.size())
+	{
+		quint8 byte = static_cast<quint8>(data[pos++]);
+		value |= static_cast<quint32>(byte & 0x7F) << shift;
+		if ((byte & 0x80)==0) return value;
+		shift += 7;
+		if (shift>28) break;
+	}
+	THROW(FileParseException, "Invalid block data in depth index file");
+}
+
+void DepthIndex::create(const QString& bam_file, const QString& index_file, const Parameters& params, int threads, const QString& ref_file)
+{
+	QList<Chromosome> chrs;
+	QVector<ChromosomeInfo> chr_infos;
+	{
+		BamReader reader(bam_file, ref_file);
+		chrs = reader.chromosomes();
+		foreach(const Chromosome& chr, chrs)
+		{
+			ChromosomeInfo info;
+			info.id = chr_infos.count();
+			info.length = reader.chromosomeSize(chr);
+			info.blocks.resize((info.length + BLOCK_SIZE - 1) / BLOCK_SIZE);
+			chr_infos << info;
+		}
+	}
+
+	QFile file(index_file);
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		THROW(FileAccessException, "Could not open depth index file for writing: " + index_file);
+	}
+
+	//header
+	QDataStream stream(&file);
+	stream.writeRawData(DEPTH_MAGIC, 8);
+	stream << DEPTH_VERSION << static_cast<qint32>(params.min_mapq) << static_cast<qint32>(params.min_baseq) << params.skip_mismapped << static_cast<qint64>(QFileInfo(bam_file).size()) << static_cast<qint32>(BLOCK_SIZE);
+
+	//blocks (written by the workers in the order they are finished)
+	QMutex file_mutex;
+	QString error;
+	auto store_block = [&](int chr_id, int block_index, const QByteArray& data)
+	{
+		BlockInfo& block = chr_infos[chr_id].blocks[block_index];
+		block.size = data.size();
+		block.offset = 0;
+		if (data.isEmpty()) return;
+
+		QMutexLocker locker(&file_mutex);
+		block.offset = file.pos();
+		if (file.write(data)!=data.size()) THROW(FileAccessException, "Could not write to depth index file " + index_file);
+	};
+
+	QAtomicInt next_chr;
+	QThreadPool thread_pool;
+	thread_pool.setMaxThreadCount(threads);
+	for (int t=0; t<std::max(1, threads); ++t)
+	{
+		thread_pool.start([&]()
+		{
+			try
+			{
+				BamReader reader(bam_file, ref_file);
+				reader.skipBases();
+				reader.skipTags();
+				if (params.min_baseq<=0) reader.skipQualities();
+
+				while(true)
+				{
+					int chr_id = next_chr.fetchAndAddOrdered(1);
+					if (chr_id>=chrs.count()) break;
+					const Chromosome& chr = chrs[chr_id];
+					const int chr_length = chr_infos[chr_id].length;
+
+					//depth of the bases starting at the current block (blocks before the start of the current read are final)
+					QVector<int> depth;
+					int block_index = 0;
+					int block_start = 1;
+					auto store_next_block = [&]()
+					{
+						int length = std::min(BLOCK_SIZE, chr_length - block_start + 1);
+						store_block(chr_id, block_index, encodeBlock(depth, length));
+						depth.remove(0, std::min(length, static_cast<int>(depth.size())));
+						block_start += BLOCK_SIZE;
+						++block_index;
+					};
+
+					if (chr_length>0)
+					{
+						reader.setRegion(chr, 1, chr_length);
+					}
+					BamAlignment al;
+					QBitArray base_qualities;
+					while (chr_length>0 && reader.getNextAlignment(al))
+					{
+						if (al.isDuplicate() || al.isSecondaryAlignment() || al.isSupplementaryAlignment()) continue;
+						if (al.isUnmapped() || al.mappingQuality()<params.min_mapq) continue;
+						if (params.skip_mismapped && !al.isProperPair() && al.mappingQuality()<20) continue;
+
+						while (block_start + BLOCK_SIZE <= al.start())
+						{
+							store_next_block();
+						}
+
+						const int al_end = std::min(al.end(), chr_length);
+						const int ol_start = al.start() - block_start;
+						const int ol_end = al_end - block_start;
+						if (ol_end<ol_start) continue;
+						if (depth.size()<=ol_end) depth.resize(ol_end + 1);
+						if (params.min_baseq>0)
+						{
+							al.qualities(base_qualities, params.min_baseq, al.end() - al.start() + 1);
+							for (int p=ol_start; p<=ol_end; ++p)
+							{
+								if (base_qualities.testBit(p - ol_start)) ++depth[p];
+							}
+						}
+						else
+						{
+							for (int p=ol_start; p<=ol_end; ++p)
+							{
+								++depth[p];
+							}
+						}
+					}
+
+					while (block_index<chr_infos[chr_id].blocks.count())
+					{
+						store_next_block();
+					}
+				}
+			}
+			catch(Exception& e)
+			{
+				QMutexLocker locker(&file_mutex);
+				error = e.message();
+			}
+		});
+	}
+	thread_pool.waitForDone();
+
+	if (!error.isEmpty())
+	{
+		file.close();
+		file.remove();
+		THROW(Exception, "Creating depth index for " + bam_file + " failed: " + error);
+	}
+
+	//index
+	qint64 index_offset = file.pos();
+	stream << static_cast<qint32>(chrs.count());
+	for (int i=0; i<chrs.count(); ++i)
+	{
+		const ChromosomeInfo& info = chr_infos[i];
+		stream << chrs[i].str() << static_cast<qint32>(info.length) << static_cast<qint32>(info.blocks.count());
+		foreach(const BlockInfo& block, info.blocks)
+		{
+			stream << block.offset << static_cast<qint32>(block.size);
+		}
+	}
+
+	//footer
+	stream << index_offset;
+	stream.writeRawData(DEPTH_MAGIC, 8);
+	if (stream.status()!=QDataStream::Ok) THROW(FileAccessException, "Could not write to depth index file " + index_file);
+}
+
+DepthIndex::DepthIndex(const QString& index_file)
+	: index_file_(index_file)
+	, file_(index_file)
+{
+	block_cache_.setMaxCost(2000000);
+
+	if (!file_.open(QIODevice::ReadOnly))
+	{
+		THROW(FileAccessException, "Could not open depth index file " + index_file);
+	}
+
+	//header
+	QDataStream stream(&file_);
+	char magic[8];
+	quint32 version;
+	qint32 min_mapq;
+	qint32 min_baseq;
+	qint32 block_size;
+	if (stream.readRawData(magic, 8)!=8 || memcmp(magic, DEPTH_MAGIC, 8)!=0) THROW(FileParseException, "File is not a depth index file: " + index_file);
+	stream >> version;
+	if (version!=DEPTH_VERSION) THROW(FileParseException, "Unsupported depth index version " + QString::number(version) + " in file " + index_file);
+	stream >> min_mapq >> min_baseq >> params_.skip_mismapped >> bam_size_ >> block_size;
+	params_.min_mapq = min_mapq;
+	params_.min_baseq = min_baseq;
+	if (block_size!=BLOCK_SIZE) THROW(FileParseException, "Unsupported block size " + QString::number(block_size) + " in depth index file " + index_file);
+
+	//footer
+	qint64 index_offset = -1;
+	if (!file_.seek(file_.size() - 16)) THROW(FileParseException, "Truncated depth index file " + index_file);
+	stream >> index_offset;
+	if (stream.readRawData(magic, 8)!=8 || memcmp(magic, DEPTH_MAGIC, 8)!=0) THROW(FileParseException, "Truncated depth index file " + index_file);
+
+	//index
+	file_.seek(index_offset);
+	qint32 chr_count;
+	stream >> chr_count;
+	for (int i=0; i<chr_count; ++i)
+	{
+		QByteArray name;
+		qint32 length;
+		qint32 block_count;
+		stream >> name >> length >> block_count;
+
+		ChromosomeInfo info;
+		info.id = i;
+		info.length = length;
+		info.blocks.resize(block_count);
+		for (int b=0; b<block_count; ++b)
+		{
+			qint32 size;
+			stream >> info.blocks[b].offset >> size;
+			info.blocks[b].size = size;
+		}
+		chrs_.insert(Chromosome(name), info);
+	}
+	if (stream.status()!=QDataStream::Ok) THROW(FileParseException, "Could not read index of depth index file " + index_file);
+}
+
+void DepthIndex::checkParameters(int min_mapq, int min_baseq, bool skip_mismapped) const
+{
+	if (params_.min_mapq!=min_mapq || params_.min_baseq!=min_baseq || params_.skip_mismapped!=skip_mismapped)
+	{
+		THROW(ArgumentException, "Depth index " + index_file_ + " was created with different parameters (min_mapq=" + QString::number(params_.min_mapq) + ", min_baseq=" + QString::number(params_.min_baseq) + ", skip_mismapped=" + (params_.skip_mismapped ? "yes" : "no") + ") than requested (min_mapq=" + QString::number(min_mapq) + ", min_baseq=" + QString::number(min_baseq) + ", skip_mismapped=" + (skip_mismapped ? "yes" : "no") + ")!");
+	}
+}
+
+bool DepthIndex::isIndexOf(const QString& bam_file) const
+{
+	return QFileInfo(bam_file).size()==bam_size_;
+}
+
+void DepthIndex::runs(const Chromosome& chr, int start, int end, std::function<void(int, int, int)> func) const
+{
+	if (start>end) return;
+
+	auto it = chrs_.constFind(chr);
+	if (it==chrs_.constEnd()) THROW(ArgumentException, "Chromosome '" + chr.str() + "' not contained in depth index " + index_file_);
+	const ChromosomeInfo& info = it.value();
+
+	//neighboring runs of different blocks with the same depth are reported as one run
+	int run_start = -1;
+	int run_end = -1;
+	int run_depth = -1;
+	auto add_run = [&](int s, int e, int d)
+	{
+		if (run_start!=-1 && run_depth==d && run_end+1==s)
+		{
+			run_end = e;
+			return;
+		}
+		if (run_start!=-1) func(run_start, run_end, run_depth);
+		run_start = s;
+		run_end = e;
+		run_depth = d;
+	};
+
+	int pos = std::max(1, start);
+	const int chr_end = std::min(end, info.length);
+	while (pos<=chr_end)
+	{
+		const int block_index = (pos-1) / BLOCK_SIZE;
+		const int block_start = block_index * BLOCK_SIZE + 1;
+		QVector<Run> block_runs = block(info, block_index);
+
+		//first run that contains the position
+		auto run_it = std::lower_bound(block_runs.cbegin(), block_runs.cend(), pos - block_start, [](const Run& run, int offset){ return run.end<offset; });
+		for (; run_it!=block_runs.cend() && pos<=chr_end; ++run_it)
+		{
+			const int e = std::min(chr_end, block_start + run_it->end);
+			add_run(pos, e, run_it->depth);
+			pos = e + 1;
+		}
+	}
+	if (end>chr_end) add_run(std::max(chr_end + 1, start), end, 0);
+
+	if (run_start!=-1) func(run_start, run_end, run_depth);
+}
+
+double DepthIndex::averageDepth(const Chromosome& chr, int start, int end) const
+{
+	if (start>end) THROW(ArgumentException, "Invalid region " + chr.str() + ":" + QString::number(start) + "-" + QString::number(end) + " for depth calculation!");
+
+	double sum = 0.0;
+	runs(chr, start, end, [&sum](int s, int e, int depth)
+	{
+		sum += static_cast<double>(e - s + 1) * depth;
+	});
+
+	return sum / (end - start + 1);
+}
+
+QVector<DepthIndex::Run> DepthIndex::block(const ChromosomeInfo& chr_info, int block_index) const
+{
+	const int length = std::min(BLOCK_SIZE, chr_info.length - block_index * BLOCK_SIZE);
+	const BlockInfo& block_info = chr_info.blocks[block_index];
+	if (block_info.size==0) return QVector<Run>() << Run{length-1, 0};
+
+	QMutexLocker locker(&mutex_);
+
+	const qint64 key = (static_cast<qint64>(chr_info.id) << 32) | block_index;
+	QVector<Run>* cached = block_cache_.object(key);
+	if (cached!=nullptr) return *cached;
+
+	if (!file_.seek(block_info.offset)) THROW(FileAccessException, "Could not seek in depth index file " + index_file_);
+	QByteArray data = file_.read(block_info.size);
+	if (data.size()!=block_info.size) THROW(FileAccessException, "Could not read block from depth index file " + index_file_);
+
+	QVector<Run>* block_runs = new QVector<Run>(decodeBlock(data, length));
+	QVector<Run> output = *block_runs;
+	block_cache_.insert(key, block_runs, std::max(1, static_cast<int>(block_runs->size())));
+
+	return output;
+}
+
+QByteArray DepthIndex::encodeBlock(const QVector<int>& depth, int length)
+{
+	//blocks without coverage are not stored
+	bool covered = false;
+	for (int p=0; p<std::min(length, static_cast<int>(depth.size())); ++p)
+	{
+		if (depth[p]!=0)
+		{
+			covered = true;
+			break;
+		}
+	}
+	if (!covered) return QByteArray();
+
+	//run-length encoding: length and depth of each run
+	QByteArray data;
+	int run_start = 0;
+	int run_depth = depth.isEmpty() ? 0 : depth[0];
+	for (int p=1; p<=length; ++p)
+	{
+		int current = (p<length && p<depth.size()) ? depth[p] : 0;
+		if (p==length || current!=run_depth)
+		{
+			appendVarint(data, p - run_start);
+			appendVarint(data, run_depth);
+			run_start = p;
+			run_depth = current;
+		}
+	}
+
+	return qCompress(data);
+}
+
+QVector<DepthIndex::Run> DepthIndex::decodeBlock(const QByteArray& data, int length)
+{
+	QByteArray raw = qUncompress(data);
+
+	QVector<Run> output;
+	int pos = 0;
+	int bases = 0;
+	while (pos<raw.size())
+	{
+		int run_length = readVarint(raw, pos);
+		int depth = readVarint(raw, pos);
+		bases += run_length;
+		output << Run{bases-1, depth};
+	}
+	if (bases!=length) THROW(FileParseException, "Invalid block length " + QString::number(bases) + " in depth index file (expected " + QString::number(length) + ")");
+
+	return output;
+}
@@ -0,0 +1,97 @@
+#ifndef DEPTHINDEX_H
+#define DEPTHINDEX_H
+
+#include "cppNGS_global.h"
+#include "Chromosome.h"
+#include <QFile>
+#include <QHash>
+#include <QVector>
+#include <QCache>
+#include <QMutex>
+#include <functional>
+
+///Per-base read depth of a BAM/CRAM file, stored as run-length encoded, compressed blocks with an index.
+///The track is created once per sample and answers coverage queries for any region without reading the BAM/CRAM file again.
+///Reads are counted with the same rules as the coverage workers (no duplicates, secondary/supplementary or unmapped reads) using the minimum mapping/base quality stored in the file.
+class CPPNGSSHARED_EXPORT DepthIndex
+{
+public:
+	///Read filter parameters the depth was calculated with.
+	struct Parameters
+	{
+		int min_mapq = 1;
+		int min_baseq = 0; ///< 0 means that all bases of the read span are counted (incl. deletions)
+		bool skip_mismapped = false; ///< skip reads with mapping quality less than 20 that are not properly paired
+	};
+
+	///Creates a depth index file for the given BAM/CRAM file. Chromosomes are processed in parallel.
+	static void create(const QString& bam_file, const QString& index_file, const Parameters& params, int threads = 1, const QString& ref_file = QString());
+	///Returns the default name of the depth index of a BAM/CRAM file.
+	static QString defaultFileName(const QString& bam_file)
+	{
+		return bam_file + ".depth";
+	}
+
+	///Constructor, loads the index of the given depth index file.
+	explicit DepthIndex(const QString& index_file);
+
+	///Returns the read filter parameters the depth was calculated with.
+	const Parameters& parameters() const
+	{
+		return params_;
+	}
+	///Throws an ArgumentException if the depth was calculated with different read filter parameters.
+	void checkParameters(int min_mapq, int min_baseq, bool skip_mismapped) const;
+	///Returns if the index was created from the given BAM/CRAM file (compares the file size).
+	bool isIndexOf(const QString& bam_file) const;
+
+	///Calls @p func for each run of bases with the same depth in the given region (1-based, inclusive). Bases outside of the chromosome have a depth of 0.
+	void runs(const Chromosome& chr, int start, int end, std::function<void(int start, int end, int depth)> func) const;
+	///Returns the average depth of the given region (1-based, inclusive).
+	double averageDepth(const Chromosome& chr, int start, int end) const;
+
+	///Number of bases per block.
+	static const int BLOCK_SIZE = 16384;
+
+protected:
+	//Index entry of a block
+	struct BlockInfo
+	{
+		qint64 offset;
+		int size; //0 if the depth of all bases is 0
+	};
+	//Index entry of a chromosome
+	struct ChromosomeInfo
+	{
+		int id; //index of the chromosome in the file
+		int length;
+		QVector<BlockInfo> blocks;
+	};
+	//Run of bases with the same depth (end is the offset of the last base in the block)
+	struct Run
+	{
+		int end;
+		int depth;
+	};
+
+	QString index_file_;
+	Parameters params_;
+	qint64 bam_size_;
+	QHash<Chromosome, ChromosomeInfo> chrs_;
+	mutable QFile file_;
+	mutable QMutex mutex_;
+	mutable QCache<qint64, QVector<Run>> block_cache_;
+
+	//Returns the runs of a block (decoded blocks are cached)
+	QVector<Run> block(const ChromosomeInfo& chr_info, int block_index) const;
+	//Encodes the depth of the bases of a block (depth may be shorter than the block, missing bases have a depth of 0)
+	static QByteArray encodeBlock(const QVector<int>& depth, int length);
+	//Decodes the runs of a block
+	static QVector<Run> decodeBlock(const QByteArray& data, int length);
+
+	//"declared away" methods
+	DepthIndex(const DepthIndex&) = delete;
+	DepthIndex& operator=(const DepthIndex&) = delete;
+};
+
+#endif // DEPTHINDEX_H
@@ -4,6 +4,7 @@
 #include "Log.h"
 #include <QNetworkProxy>
 #include "HttpRequestHandler.h"
+#include <cstring>
 
 using namespace std;
 
@@ -11,15 +12,23 @@ FastaFileIndex::FastaFileIndex(QString fasta_file)
 	: fasta_name_(fasta_file)
 	, index_name_(fasta_file + ".fai")
 	, file_(fasta_file)
+	, data_(nullptr)
 {
     if (Helper::isHttpUrl(fasta_name_)) THROW(NotImplementedException, "FastaFileIndex does not support HTTP/HTTPS!");
 
     //open FASTA file handle
-    if (!file_.open(QIODevice::ReadOnly | QIODevice::Text))
+    if (!file_.open(QIODevice::ReadOnly))
     {
         THROW(FileAccessException, "Could not open FASTA file '" + fasta_name_ + "' for reading!");
     }
 
+	//map FASTA file into memory (pages are shared between all instances and processes)
+	if (file_.size()>0)
+	{
+		data_ = reinterpret_cast<const char*>(file_.map(0, file_.size()));
+		if (data_==nullptr) Log::warn("Could not map FASTA file '" + fasta_name_ + "' into memory - using seek/read: " + file_.errorString());
+	}
+
     //load index file
     int linenum = 0;
     QSharedPointer<QFile> file = Helper::openFileForReading(index_name_);
@@ -43,6 +52,7 @@ FastaFileIndex::FastaFileIndex(QString fasta_file)
 
 FastaFileIndex::~FastaFileIndex()
 {
+	if (data_!=nullptr) file_.unmap(reinterpret_cast<uchar*>(const_cast<char*>(data_)));
     file_.close();
 }
 
@@ -50,25 +60,19 @@ Sequence FastaFileIndex::seq(const Chromosome& chr, bool to_upper) const
 {
 	const FastaIndexEntry& entry = index(chr);
 
-    //jump to postion
-    if (!file_.seek(entry.offset))
-    {
-        THROW(FileAccessException, "QFile::seek did not work on " + fasta_name_ + "'!");
-    }
-
-	//read data
-	int newlines_in_sequence = entry.length / entry.line_blen;
-	int seqlen = newlines_in_sequence  + entry.length;
 	Sequence output;
-
-    output = file_.read(seqlen).replace('\n', "");
-
-	//output
-	if (to_upper) output = output.toUpper();
+	extract(entry, 0, entry.length, output, to_upper);
 	return output;
 }
 
 Sequence FastaFileIndex::seq(const Chromosome& chr, int start, int length, bool to_upper) const
+{
+	Sequence output;
+	seq(chr, start, length, output, to_upper);
+	return output;
+}
+
+void FastaFileIndex::seq(const Chromosome& chr, int start, int length, Sequence& output, bool to_upper) const
 {
 	//subtract 1 to make the coordinates 0-based
 	start -= 1;
@@ -93,41 +97,110 @@ Sequence FastaFileIndex::seq(const Chromosome& chr, int start, int length, bool
 		length = min(length, entry.length - start);
 	}
 
-	//jump to postion
-	int newlines_before = start > 0 ? (start - 1) / entry.line_blen : 0;
-	qint64 read_start_pos = entry.offset + newlines_before + start;
-    if (!file_.seek(read_start_pos))
-    {
-        THROW(FileAccessException, "QFile::seek did not work on " + fasta_name_ + "'!");
-    }
+	extract(entry, start, length, output, to_upper);
+}
 
-	//read data
-	int newlines_by_end = (start + length - 1) / entry.line_blen;
-	int newlines_inside = newlines_by_end - newlines_before;
-	int seqlen = length + newlines_inside;
-	Sequence output {};
+char FastaFileIndex::base(const Chromosome& chr, int pos, bool to_upper) const
+{
+	const FastaIndexEntry& entry = index(chr);
+	if (pos<1 || pos>entry.length)
+	{
+		THROW(ProgrammingException, "FastaFileIndex::base: Invalid position " + chr.strNormalized(true) + ":" + QString::number(pos) + " (chromosome length is " + QString::number(entry.length) + ")");
+	}
 
-    output = file_.read(seqlen).replace('\n', "");
+	char output;
+	const int offset = pos - 1;
+	const qint64 file_pos = entry.offset + static_cast<qint64>(offset / entry.line_blen) * entry.line_len + offset % entry.line_blen;
+	if (data_!=nullptr)
+	{
+		output = data_[file_pos];
+	}
+	else
+	{
+		QMutexLocker locker(&mutex_);
+		if (!file_.seek(file_pos) || !file_.getChar(&output))
+		{
+			THROW(FileAccessException, "Could not read from FASTA file '" + fasta_name_ + "'!");
+		}
+	}
 
-	//output
-	if (to_upper) output = output.toUpper();
+	if (to_upper && output>='a' && output<='z') output -= 'a' - 'A';
 	return output;
 }
 
-int FastaFileIndex::n(const Chromosome& chr) const
+void FastaFileIndex::extract(const FastaIndexEntry& entry, int start, int length, Sequence& output, bool to_upper) const
 {
-	if (!n_.contains(chr))
+	output.resize(length);
+	if (length==0) return;
+
+	//determine raw data (incl. line breaks)
+	const qint64 first_byte = entry.offset + static_cast<qint64>(start / entry.line_blen) * entry.line_len + start % entry.line_blen;
+	const int last = start + length - 1;
+	const qint64 last_byte = entry.offset + static_cast<qint64>(last / entry.line_blen) * entry.line_len + last % entry.line_blen;
+	const char* raw = nullptr;
+	QByteArray buffer;
+	if (data_!=nullptr)
+	{
+		raw = data_ + first_byte;
+	}
+	else
+	{
+		QMutexLocker locker(&mutex_);
+		if (!file_.seek(first_byte))
+		{
+			THROW(FileAccessException, "QFile::seek did not work on " + fasta_name_ + "'!");
+		}
+		buffer = file_.read(last_byte - first_byte + 1);
+		if (buffer.size()!=last_byte - first_byte + 1)
+		{
+			THROW(FileAccessException, "Could not read from FASTA file '" + fasta_name_ + "'!");
+		}
+		raw = buffer.constData();
+	}
+
+	//copy bases line by line (skipping line breaks)
+	char* out = output.data();
+	int col = start % entry.line_blen;
+	int remaining = length;
+	while (remaining>0)
+	{
+		const int count = min(entry.line_blen - col, remaining);
+		memcpy(out, raw, count);
+		out += count;
+		remaining -= count;
+		raw += count + (entry.line_len - entry.line_blen);
+		col = 0;
+	}
+
+	//convert to upper case
+	if (to_upper)
 	{
-		int output = 0;
-		Sequence sequence = seq(chr, false);
-		for (int i=0; i<sequence.length(); ++i)
+		char* data = output.data();
+		for (int i=0; i<length; ++i)
 		{
-			if (sequence[i]=='N' || sequence[i]=='n') ++output;
+			if (data[i]>='a' && data[i]<='z') data[i] -= 'a' - 'A';
 		}
-		n_[chr] = output;
+	}
+}
+
+int FastaFileIndex::n(const Chromosome& chr) const
+{
+	{
+		QMutexLocker locker(&mutex_);
+		auto it = n_.constFind(chr);
+		if (it!=n_.constEnd()) return it.value();
+	}
+
+	int output = 0;
+	Sequence sequence = seq(chr, false);
+	for (int i=0; i<sequence.length(); ++i)
+	{
+		if (sequence[i]=='N' || sequence[i]=='n') ++output;
 	}
 
-	return n_[chr];
+	QMutexLocker locker(&mutex_);
+	n_[chr] = output;
+	return output;
 }
 
 const FastaFileIndex::FastaIndexEntry& FastaFileIndex::index(const Chromosome& chr) const
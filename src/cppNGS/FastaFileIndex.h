@@ -6,8 +6,10 @@
 #include "Sequence.h"
 #include <QFile>
 #include <QHash>
+#include <QMutex>
 
 ///Fasta file index for fast access to seqences in a FASTA file.
+///The FASTA file is memory-mapped, so sequences can be read from several threads concurrently without locking. If mapping fails, reads fall back to seek/read guarded by a mutex.
 class CPPNGSSHARED_EXPORT FastaFileIndex
 {
 public:
@@ -20,6 +22,10 @@ public:
 	Sequence seq(const Chromosome& chr, bool to_upper = true) const;
 	///Returns the sequence corresponding to the given chromosome and range (start is 1-based). If the coordinates are invalid, an empty string is returned.
 	Sequence seq(const Chromosome& chr, int start, int length, bool to_upper = true) const;
+	///Stores the sequence corresponding to the given chromosome and range (start is 1-based) in @p output. Re-using @p output avoids a memory allocation per call.
+	void seq(const Chromosome& chr, int start, int length, Sequence& output, bool to_upper = true) const;
+	///Returns the base at the given position (1-based).
+	char base(const Chromosome& chr, int pos, bool to_upper = true) const;
 
 	///Returns the chromosomes in the order of the input FASTA file.
 	const QList<Chromosome>& chromosomes() const
@@ -51,8 +57,16 @@ protected:
 	QList<Chromosome> chrs_;
 	mutable QHash<Chromosome, int> n_; //cache for N bases (slow, so it should not be calcualted more than once)
 	mutable QFile file_;
+	const char* data_; //memory-mapped FASTA file (nullptr if mapping failed)
+	mutable QMutex mutex_; //guards file_ (only used if mapping failed) and n_
 	const FastaIndexEntry& index(const Chromosome& chr) const;
 	void saveEntryToIndex(const QList<QByteArray>& fields);
+	//Copies 'length' bases starting at the 0-based position 'start' to 'output' (without line breaks).
+	void extract(const FastaIndexEntry& entry, int start, int length, Sequence& output, bool to_upper) const;
+
+	//"declared away" methods
+	FastaFileIndex(const FastaFileIndex&) = delete;
+	FastaFileIndex& operator=(const FastaFileIndex&) = delete;
 };
 
 #endif
@@ -1,4 +1,5 @@
 #include "FastqFileStream.h"
+#include "Helper.h"
 
 void FastqEntry::validate(bool long_read) const
 {
@@ -157,27 +158,106 @@ void FastqFileStream::readEntry(FastqEntry& entry)
 	if (auto_validate_) entry.validate(long_read_);
 }
 
-FastqOutfileStream::FastqOutfileStream(QString filename, int compression_level, int compression_strategy)
+//Compresses a block of the parallel mode in the thread pool
+class FastqBlockCompressor
+	: public QRunnable
+{
+public:
+	FastqBlockCompressor(QSharedPointer<FastqOutfileStream::CompressionBlock> block, int compression_level, int compression_strategy, bool bgzf)
+		: QRunnable()
+		, block_(block)
+		, compression_level_(compression_level)
+		, compression_strategy_(compression_strategy)
+		, bgzf_(bgzf)
+	{
+	}
+
+	void run() override
+	{
+		try
+		{
+			block_->compressed = FastqOutfileStream::compressBlock(block_->data, compression_level_, compression_strategy_, bgzf_);
+		}
+		catch (Exception& e)
+		{
+			block_->error = e.message();
+		}
+		block_->data.clear();
+		block_->done.release();
+	}
+
+private:
+	QSharedPointer<FastqOutfileStream::CompressionBlock> block_;
+	int compression_level_;
+	int compression_strategy_;
+	bool bgzf_;
+};
+
+FastqOutfileStream::FastqOutfileStream(QString filename, int compression_level, int compression_strategy, int threads, bool bgzf)
 	: filename_(filename)
+	, gzfile_(nullptr)
 	, is_closed_(false)
+	, parallel_(threads>1 || bgzf)
+	, bgzf_(bgzf)
+	, compression_level_(compression_level)
+	, compression_strategy_(compression_strategy)
+	, block_size_(bgzf ? BGZF_MAX_BLOCK_SIZE : 262144)
+	, max_pending_blocks_(4*threads)
 {
+	if (compression_level<0 || compression_level>9) THROW(ArgumentException, "Invalid gzip compression level '" + QString::number(compression_level) +"' given for FASTQ file '" + filename + "'!");
+	if (compression_strategy<0 || compression_strategy>4) THROW(ArgumentException, "Invalid gzip compression strategy '" + QString::number(compression_strategy) +"' given for FASTQ file '" + filename + "'!");
+	if (threads<1) THROW(ArgumentException, "Invalid number of compression threads '" + QString::number(threads) +"' given for FASTQ file '" + filename + "'!");
+
+	if (parallel_)
+	{
+		file_ = Helper::openFileForWriting(filename);
+		thread_pool_.setMaxThreadCount(threads);
+		buffer_.reserve(block_size_ + 4096);
+		return;
+	}
+
 	gzfile_ = gzopen(filename.toUtf8().data(), "wb");
 	if (gzfile_==nullptr) THROW(FileAccessException, "Could not open file '" + filename + "' for writing!");
 
 	gzbuffer(gzfile_, 131072);
-
-	if (compression_level<0 || compression_level>9) THROW(ArgumentException, "Invalid gzip compression level '" + QString::number(compression_level) +"' given for FASTQ file '" + filename + "'!");
-	if (compression_strategy<0 || compression_strategy>4) THROW(ArgumentException, "Invalid gzip compression strategy '" + QString::number(compression_strategy) +"' given for FASTQ file '" + filename + "'!");
 	gzsetparams(gzfile_, compression_level, compression_strategy);
 }
 
 FastqOutfileStream::~FastqOutfileStream()
 {
-    close();
+	//no exceptions in the destructor
+	try
+	{
+		close();
+	}
+	catch(...)
+	{
+	}
 }
 
 void FastqOutfileStream::write(const FastqEntry& entry)
 {
+	if (parallel_)
+	{
+		buffer_.append(entry.header).append('\n');
+		buffer_.append(entry.bases).append('\n');
+		buffer_.append(entry.header2).append('\n');
+		buffer_.append(entry.qualities).append('\n');
+
+		//blocks have a fixed size, i.e. records can span two blocks (long reads can span several blocks)
+		if (buffer_.size()>=block_size_)
+		{
+			int start = 0;
+			while (buffer_.size()-start >= block_size_)
+			{
+				submitBlock(buffer_.mid(start, block_size_));
+				start += block_size_;
+			}
+			buffer_.remove(0, start);
+		}
+		return;
+	}
+
 	static QByteArray newline = "\n";
 	if (gzputs(gzfile_, entry.header.constData())==-1
 		|| gzputs(gzfile_, newline)==-1
@@ -195,7 +275,127 @@ void FastqOutfileStream::write(const FastqEntry& entry)
 void FastqOutfileStream::close()
 {
     if (is_closed_) return;
-
-	gzclose(gzfile_);
 	is_closed_ = true;
+
+	if (parallel_)
+	{
+		if (!buffer_.isEmpty()) submitBlock(buffer_);
+		buffer_.clear();
+		writeBlocks(true);
+
+		//BGZF end-of-file marker (fixed empty block, see SAM specification)
+		if (bgzf_)
+		{
+			QByteArray eof_block = QByteArray::fromHex("1f8b08040000000000ff0600424302001b0003000000000000000000");
+			if (file_->write(eof_block)!=eof_block.size()) THROW(FileAccessException, "Could not write to file '" + filename_ + "'!");
+		}
+		if (!file_->flush()) THROW(FileAccessException, "Could not write to file '" + filename_ + "'!");
+		file_->close();
+		return;
+	}
+
+	if (gzclose(gzfile_)!=Z_OK) THROW(FileAccessException, "Could not close file '" + filename_ + "'!");
+}
+
+void FastqOutfileStream::submitBlock(const QByteArray& data)
+{
+	//limit the number of blocks in memory
+	while (pending_.count()>=max_pending_blocks_)
+	{
+		pending_.head()->done.acquire();
+		pending_.head()->done.release();
+		writeBlocks(false);
+	}
+
+	QSharedPointer<CompressionBlock> block(new CompressionBlock());
+	block->data = data;
+	pending_.enqueue(block);
+	thread_pool_.start(new FastqBlockCompressor(block, compression_level_, compression_strategy_, bgzf_));
+
+	writeBlocks(false);
+}
+
+void FastqOutfileStream::writeBlocks(bool wait)
+{
+	//blocks are written in the order they were submitted
+	while (!pending_.isEmpty())
+	{
+		QSharedPointer<CompressionBlock> block = pending_.head();
+		if (wait)
+		{
+			block->done.acquire();
+		}
+		else if (!block->done.tryAcquire())
+		{
+			return;
+		}
+		pending_.dequeue();
+
+		if (!block->error.isEmpty()) THROW(FileAccessException, "Could not compress data for file '" + filename_ + "': " + block->error);
+		if (file_->write(block->compressed)!=block->compressed.size())
+		{
+			THROW(FileAccessException, "Could not write to file '" + filename_ + "'!");
+		}
+	}
+}
+
+QByteArray FastqOutfileStream::compressBlock(const QByteArray& data, int compression_level, int compression_strategy, bool bgzf)
+{
+	if (bgzf && data.size()>BGZF_MAX_BLOCK_SIZE) THROW(ArgumentException, "BGZF block data size " + QString::number(data.size()) + " exceeds maximum of " + QString::number(BGZF_MAX_BLOCK_SIZE) + "!");
+
+	//raw deflate data
+	z_stream stream;
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	if (deflateInit2(&stream, compression_level, Z_DEFLATED, -15, 8, compression_strategy)!=Z_OK)
+	{
+		THROW(Exception, "Could not initialize zlib compression!");
+	}
+	const int header_size = bgzf ? 18 : 10;
+	QByteArray output(header_size + deflateBound(&stream, data.size()) + 8, Qt::Uninitialized);
+	stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.constData()));
+	stream.avail_in = data.size();
+	stream.next_out = reinterpret_cast<Bytef*>(output.data() + header_size);
+	stream.avail_out = output.size() - header_size - 8;
+	int status = deflate(&stream, Z_FINISH);
+	int compressed_size = (int)stream.total_out;
+	deflateEnd(&stream);
+	if (status!=Z_STREAM_END) THROW(Exception, "Could not compress data block (zlib status " + QString::number(status) + ")!");
+	output.resize(header_size + compressed_size + 8);
+
+	//gzip header (BGZF blocks contain the block size in the extra field)
+	uchar* out = reinterpret_cast<uchar*>(output.data());
+	out[0] = 0x1f;
+	out[1] = 0x8b;
+	out[2] = 8; //deflate
+	out[3] = bgzf ? 4 : 0; //FEXTRA
+	out[4] = out[5] = out[6] = out[7] = 0; //modification time
+	out[8] = 0;
+	out[9] = 0xff; //unknown OS
+	if (bgzf)
+	{
+		int block_size = output.size() - 1;
+		if (block_size>0xffff) THROW(ProgrammingException, "BGZF block size exceeds 64KB!");
+		out[10] = 6; //XLEN
+		out[11] = 0;
+		out[12] = 'B';
+		out[13] = 'C';
+		out[14] = 2; //SLEN
+		out[15] = 0;
+		out[16] = block_size & 0xff;
+		out[17] = (block_size >> 8) & 0xff;
+	}
+
+	//gzip footer: CRC32 and size of uncompressed data (little-endian)
+	quint32 crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(data.constData()), data.size());
+	quint32 size = data.size();
+	uchar* footer = out + header_size + compressed_size;
+	for (int i=0; i<4; ++i)
+	{
+		footer[i] = (crc >> (8*i)) & 0xff;
+		footer[4+i] = (size >> (8*i)) & 0xff;
+	}
+
+	return output;
 }
@@ -5,6 +5,11 @@
 #include "Exceptions.h"
 #include "Sequence.h"
 #include <QString>
+#include <QFile>
+#include <QQueue>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QThreadPool>
 #include "VersatileFile.h"
 
 ///Representation of a FASTQ entry.
@@ -86,18 +91,21 @@ protected:
 
 /**
   @brief FASTQ file output stream (gzipped).
+  @note By default, the data is compressed by zlib in the calling thread.
+		In parallel mode, the records are buffered into independent blocks that are compressed by a thread pool and written in order - as concatenated gzip members or as BGZF blocks.
+		BGZF output is valid gzip, but can also be indexed and decompressed in parallel.
 */
 class CPPNGSSHARED_EXPORT FastqOutfileStream
 {
 public:
-    ///Constructor.
-	FastqOutfileStream(QString filename, int compression_level = Z_BEST_SPEED, int compression_strategy = Z_DEFAULT_STRATEGY);
-    ///Destructor - closes the stream if not already done.
+    ///Constructor. If more than one thread or BGZF output is requested, the parallel mode is used.
+	FastqOutfileStream(QString filename, int compression_level = Z_BEST_SPEED, int compression_strategy = Z_DEFAULT_STRATEGY, int threads = 1, bool bgzf = false);
+    ///Destructor - closes the stream if not already done. Errors are ignored, call close() to detect them.
     ~FastqOutfileStream();
 
     ///Writes an entry to the stream.
 	void write(const FastqEntry& entry);
-    ///Closes the stream.
+    ///Closes the stream. Throws an exception if the remaining data could not be written.
     void close();
 
 	///Returns the filename the stream writes to.
@@ -106,11 +114,42 @@ public:
 		return filename_;
 	}
 
+	///Compresses a block of data to a single gzip member. If 'bgzf' is set, a BGZF block is created (at most BGZF_MAX_BLOCK_SIZE bytes of data).
+	static QByteArray compressBlock(const QByteArray& data, int compression_level, int compression_strategy, bool bgzf);
+	///Maximum size of uncompressed data in a BGZF block.
+	static const int BGZF_MAX_BLOCK_SIZE = 0xff00;
+
 protected:
+	//Block of data that is compressed in the thread pool (parallel mode only)
+	struct CompressionBlock
+	{
+		QByteArray data;
+		QByteArray compressed;
+		QString error;
+		QSemaphore done;
+	};
+
+	void submitBlock(const QByteArray& data);
+	void writeBlocks(bool wait);
+
     QString filename_;
 	gzFile gzfile_;
 	bool is_closed_;
 
+	//parallel mode
+	bool parallel_;
+	bool bgzf_;
+	int compression_level_;
+	int compression_strategy_;
+	int block_size_;
+	int max_pending_blocks_;
+	QByteArray buffer_;
+	QSharedPointer<QFile> file_;
+	QThreadPool thread_pool_;
+	QQueue<QSharedPointer<CompressionBlock>> pending_;
+
+	friend class FastqBlockCompressor;
+
     //declared away methods
 	FastqOutfileStream(const FastqOutfileStream& ) = delete;
 	FastqOutfileStream& operator=(const FastqOutfileStream&) = delete;
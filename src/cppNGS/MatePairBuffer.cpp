@@ -0,0 +1,191 @@
+#include "MatePairBuffer.h"
+#include "Helper.h"
+#include <QFile>
+#include <algorithm>
+#include <limits>
+
+MatePairBuffer::MatePairBuffer(const BamReader& reader, int max_cached, int partitions)
+	: reader_(reader)
+	, max_cached_(max_cached)
+	, max_size_(0)
+	, spilled_(0)
+	, partitions_(partitions)
+	, last_pos_(0)
+{
+	if (max_cached<0) THROW(ArgumentException, "Invalid maximum number of cached alignments: " + QString::number(max_cached));
+	if (partitions<1) THROW(ArgumentException, "Invalid number of partitions: " + QString::number(partitions));
+}
+
+MatePairBuffer::~MatePairBuffer()
+{
+	for (Partition& part : partitions_)
+	{
+		if (part.filename.isEmpty()) continue;
+
+		part.writer.clear();
+		QFile::remove(part.filename);
+	}
+}
+
+QSharedPointer<BamAlignment> MatePairBuffer::add(const QSharedPointer<BamAlignment>& al)
+{
+	QByteArray name = al->name();
+	auto it = cache_.find(name);
+	if (it!=cache_.end())
+	{
+		QSharedPointer<BamAlignment> mate = it.value();
+		cache_.erase(it);
+		return mate;
+	}
+
+	cache_.insert(name, al);
+	last_pos_ = position(al->chromosomeID(), al->start());
+	if (max_cached_>0 && cache_.size()>max_cached_)
+	{
+		spill();
+	}
+	max_size_ = std::max(max_size_, static_cast<int>(cache_.size()));
+
+	return QSharedPointer<BamAlignment>();
+}
+
+void MatePairBuffer::spill()
+{
+	//determine where the mate of each alignment is expected (mates that should have been seen already are expected last)
+	QVector<QPair<quint64, QByteArray>> expected;
+	expected.reserve(cache_.size());
+	for (auto it=cache_.cbegin(); it!=cache_.cend(); ++it)
+	{
+		quint64 mate_pos = position(it.value()->mateChrosomeID(), it.value()->mateStart());
+		if (mate_pos<last_pos_) mate_pos = std::numeric_limits<quint64>::max();
+		expected << qMakePair(mate_pos, it.key());
+	}
+
+	//write half of the alignments to the temporary files
+	int count = std::max(1, static_cast<int>(cache_.size()/2));
+	std::nth_element(expected.begin(), expected.begin() + (count-1), expected.end(), [](const QPair<quint64, QByteArray>& a, const QPair<quint64, QByteArray>& b){ return a.first>b.first; });
+	for (int i=0; i<count; ++i)
+	{
+		const QByteArray& name = expected[i].second;
+		write(partitions_, partition(name), *cache_.take(name));
+		++spilled_;
+	}
+}
+
+void MatePairBuffer::write(QVector<Partition>& partitions, int index, const BamAlignment& al)
+{
+	Partition& part = partitions[index];
+	if (part.writer.isNull())
+	{
+		part.filename = Helper::tempFileName(".bam");
+		part.writer.reset(new BamWriter(part.filename));
+		part.writer->writeHeader(reader_);
+	}
+	part.writer->writeAlignment(al);
+	++part.count;
+}
+
+int MatePairBuffer::partition(const QByteArray& name, int level) const
+{
+	return qHash(name, level) % partitions_.count();
+}
+
+void MatePairBuffer::resolve(std::function<void(BamAlignment&, BamAlignment&)> pair_func, std::function<void(BamAlignment&)> single_func)
+{
+	//nothing spilled: the mates of the alignments left in memory are missing
+	if (spilled_==0)
+	{
+		for (auto it=cache_.begin(); it!=cache_.end(); ++it)
+		{
+			single_func(*it.value());
+		}
+		cache_.clear();
+		return;
+	}
+
+	//spill the alignments left in memory as well, so that only one partition is kept in memory at a time
+	for (auto it=cache_.cbegin(); it!=cache_.cend(); ++it)
+	{
+		write(partitions_, partition(it.key()), *it.value());
+	}
+	cache_.clear();
+
+	//pair alignments of each partition
+	for (Partition& part : partitions_)
+	{
+		if (part.writer.isNull()) continue;
+
+		part.writer->close();
+		part.writer.clear();
+		resolveFile(part.filename, part.count, 0, true, pair_func, single_func);
+		part.filename.clear();
+		part.count = 0;
+	}
+}
+
+void MatePairBuffer::resolveFile(const QString& filename, long long count, int level, bool split, std::function<void(BamAlignment&, BamAlignment&)>& pair_func, std::function<void(BamAlignment&)>& single_func)
+{
+	//too many alignments: split into partitions with a different hash seed and pair them one after the other
+	if (split && max_cached_>0 && count>max_cached_)
+	{
+		QVector<Partition> sub_partitions(partitions_.count());
+		QByteArray first_name;
+		bool same_name = true;
+		{
+			BamReader reader(filename);
+			BamAlignment al;
+			while (reader.getNextAlignment(al))
+			{
+				QByteArray name = al.name();
+				if (first_name.isEmpty()) first_name = name;
+				else if (name!=first_name) same_name = false;
+				write(sub_partitions, partition(name, level+1), al);
+			}
+		}
+		QFile::remove(filename);
+
+		for (Partition& part : sub_partitions)
+		{
+			if (part.writer.isNull()) continue;
+
+			part.writer->close();
+			part.writer.clear();
+
+			//splitting again does not help if all alignments have the same name (e.g. only one pair) - they are paired in memory
+			resolveFile(part.filename, part.count, level+1, !same_name, pair_func, single_func);
+		}
+		return;
+	}
+
+	//pair alignments in memory
+	QHash<QByteArray, QSharedPointer<BamAlignment>> part_cache;
+	{
+		BamReader reader(filename);
+		QSharedPointer<BamAlignment> al(new BamAlignment());
+		while (reader.getNextAlignment(*al))
+		{
+			QByteArray name = al->name();
+			QSharedPointer<BamAlignment> mate = part_cache.take(name);
+			if (mate.isNull())
+			{
+				part_cache.insert(name, al);
+				max_size_ = std::max(max_size_, static_cast<int>(part_cache.size()));
+				al = QSharedPointer<BamAlignment>(new BamAlignment());
+			}
+			else if (position(mate->chromosomeID(), mate->start())<=position(al->chromosomeID(), al->start()))
+			{
+				pair_func(*mate, *al);
+			}
+			else
+			{
+				pair_func(*al, *mate);
+			}
+		}
+	}
+	QFile::remove(filename);
+
+	for (auto it=part_cache.begin(); it!=part_cache.end(); ++it)
+	{
+		single_func(*it.value());
+	}
+}
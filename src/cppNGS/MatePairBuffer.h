@@ -0,0 +1,80 @@
+#ifndef MATEPAIRBUFFER_H
+#define MATEPAIRBUFFER_H
+
+#include "cppNGS_global.h"
+#include "BamReader.h"
+#include "BamWriter.h"
+#include <QHash>
+#include <QSharedPointer>
+#include <functional>
+
+///Buffer for pairing the mates of paired-end alignments.
+///Alignments are kept in memory until their mate is added. If the number of buffered alignments exceeds the given maximum, the half of the alignments whose mates are expected last is spilled to temporary BAM files (partitioned by read name).
+///Spilled alignments are paired partition by partition when resolve() is called after all alignments have been added. Partitions with more alignments than the maximum are split into smaller partitions before pairing.
+class CPPNGSSHARED_EXPORT MatePairBuffer
+{
+public:
+	///Constructor. The header of @p reader is used for the temporary files. If @p max_cached is 0, all alignments are kept in memory.
+	MatePairBuffer(const BamReader& reader, int max_cached, int partitions = 16);
+	///Destructor - removes the temporary files.
+	~MatePairBuffer();
+
+	///Adds an alignment. If its mate is buffered in memory, the mate is removed from the buffer and returned. Otherwise the alignment is buffered and a null pointer is returned.
+	QSharedPointer<BamAlignment> add(const QSharedPointer<BamAlignment>& al);
+
+	///Pairs all alignments left in memory or spilled to disk. @p pair_func is called for each pair (the alignment with the lower position first), @p single_func for each alignment without mate. The buffer is empty afterwards.
+	void resolve(std::function<void(BamAlignment&, BamAlignment&)> pair_func, std::function<void(BamAlignment&)> single_func);
+
+	///Returns the number of alignments buffered in memory.
+	int size() const
+	{
+		return cache_.size();
+	}
+	///Returns the maximum number of alignments that were buffered in memory at the same time (including the pairing of spilled alignments in resolve()).
+	int maxSize() const
+	{
+		return max_size_;
+	}
+	///Returns the number of alignments spilled to disk.
+	long long spilledCount() const
+	{
+		return spilled_;
+	}
+
+protected:
+	//Temporary BAM file of a read name partition
+	struct Partition
+	{
+		QString filename;
+		QSharedPointer<BamWriter> writer;
+		long long count = 0;
+	};
+
+	const BamReader& reader_;
+	int max_cached_;
+	int max_size_;
+	long long spilled_;
+	QHash<QByteArray, QSharedPointer<BamAlignment>> cache_;
+	QVector<Partition> partitions_;
+	quint64 last_pos_; //position of the last added alignment
+
+	//Writes the alignments whose mates are expected last to the temporary files.
+	void spill();
+	//Writes an alignment to the temporary file of a partition.
+	void write(QVector<Partition>& partitions, int index, const BamAlignment& al);
+	//Pairs the alignments of a temporary file. If it contains more alignments than the maximum and @p split is set, it is split into smaller partitions using a different hash seed for each level.
+	void resolveFile(const QString& filename, long long count, int level, bool split, std::function<void(BamAlignment&, BamAlignment&)>& pair_func, std::function<void(BamAlignment&)>& single_func);
+	//Returns the partition index of a read name (the level is used as hash seed when splitting partitions).
+	int partition(const QByteArray& name, int level = 0) const;
+	//Returns a sortable position (unmapped alignments without coordinates are sorted last).
+	static quint64 position(int chr_id, int pos)
+	{
+		return (static_cast<quint64>(static_cast<quint32>(chr_id)) << 32) | static_cast<quint32>(pos);
+	}
+
+	//"declared away" methods
+	MatePairBuffer(const MatePairBuffer&) = delete;
+	MatePairBuffer& operator=(const MatePairBuffer&) = delete;
+};
+
+#endif // MATEPAIRBUFFER_H
@@ -48,6 +48,17 @@ void Pileup::dec(char base)
     else THROW(ArgumentException, "Unknown base '" + QString(QChar(base)) + "' in pileup!");
 }
 
+void Pileup::add(const Pileup& other)
+{
+	a_ += other.a_;
+	c_ += other.c_;
+	g_ += other.g_;
+	t_ += other.t_;
+	n_ += other.n_;
+	del_ += other.del_;
+	indels_ << other.indels_;
+}
+
 void Pileup::clear()
 {
 	a_ = 0;
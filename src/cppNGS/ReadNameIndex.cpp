@@ -0,0 +1,205 @@
+#include "ReadNameIndex.h"
+#include "BamReader.h"
+#include "Exceptions.h"
+#include "Helper.h"
+#include <QFileInfo>
+#include <QSharedPointer>
+#include <algorithm>
+#include <cstring>
+#include <queue>
+
+//file format: magic (8 bytes), BAM file size (8 bytes), entry count (8 bytes), reserved (8 bytes), entries (16 bytes each)
+static const char RNI_MAGIC[] = "NGSRNI01";
+static const qint64 RNI_HEADER_SIZE = 32;
+
+void ReadNameIndex::create(const QString& bam_file, const QString& index_file, int max_entries)
+{
+	if (max_entries<1) THROW(ArgumentException, "Invalid maximum number of entries in memory: " + QString::number(max_entries));
+
+	BamReader reader(bam_file);
+	reader.skipBases();
+	reader.skipQualities();
+	reader.skipTags();
+
+	//collect entries - sorted chunks are written to temporary files if there are too many
+	QStringList tmp_files;
+	QVector<Entry> entries;
+	qint64 count = 0;
+	BamAlignment al;
+	qint64 offset = reader.tell();
+	while (reader.getNextAlignment(al))
+	{
+		entries << Entry{hash(al.name()), offset};
+		offset = reader.tell();
+		++count;
+
+		if (entries.count()>=max_entries)
+		{
+			std::sort(entries.begin(), entries.end());
+			QString tmp_file = Helper::tempFileName(".rni");
+			QFile file(tmp_file);
+			if (!file.open(QIODevice::WriteOnly)) THROW(FileAccessException, "Could not open temporary file for writing: " + tmp_file);
+			writeEntries(file, entries, tmp_file);
+			tmp_files << tmp_file;
+			entries.clear();
+		}
+	}
+	std::sort(entries.begin(), entries.end());
+
+	//write header
+	QFile file(index_file);
+	if (!file.open(QIODevice::WriteOnly)) THROW(FileAccessException, "Could not open read name index file for writing: " + index_file);
+	qint64 header[3] = {QFileInfo(bam_file).size(), count, 0};
+	file.write(RNI_MAGIC, 8);
+	file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+	//write entries
+	if (tmp_files.isEmpty())
+	{
+		writeEntries(file, entries, index_file);
+	}
+	else
+	{
+		//k-way merge of the sorted chunks (the entries left in memory are the last chunk)
+		struct Chunk
+		{
+			QSharedPointer<QFile> file;
+			QVector<Entry> buffer;
+			int pos;
+		};
+		const int buffer_size = 65536;
+		QVector<Chunk> chunks;
+		foreach(const QString& tmp_file, tmp_files)
+		{
+			Chunk chunk{QSharedPointer<QFile>(new QFile(tmp_file)), QVector<Entry>(), 0};
+			if (!chunk.file->open(QIODevice::ReadOnly)) THROW(FileAccessException, "Could not open temporary file for reading: " + tmp_file);
+			chunks << chunk;
+		}
+		chunks << Chunk{QSharedPointer<QFile>(), entries, 0};
+
+		auto next = [&](Chunk& chunk) -> bool
+		{
+			if (chunk.pos<chunk.buffer.count()) return true;
+			if (chunk.file.isNull()) return false;
+
+			chunk.buffer.resize(buffer_size);
+			qint64 bytes = chunk.file->read(reinterpret_cast<char*>(chunk.buffer.data()), buffer_size * sizeof(Entry));
+			if (bytes<0) THROW(FileAccessException, "Could not read temporary file " + chunk.file->fileName());
+			chunk.buffer.resize(bytes / sizeof(Entry));
+			chunk.pos = 0;
+			return !chunk.buffer.isEmpty();
+		};
+
+		auto greater = [&](int a, int b)
+		{
+			return chunks[b].buffer[chunks[b].pos] < chunks[a].buffer[chunks[a].pos];
+		};
+		std::priority_queue<int, std::vector<int>, decltype(greater)> queue(greater);
+		for (int i=0; i<chunks.count(); ++i)
+		{
+			if (next(chunks[i])) queue.push(i);
+		}
+
+		QVector<Entry> output;
+		output.reserve(buffer_size);
+		while (!queue.empty())
+		{
+			int i = queue.top();
+			queue.pop();
+			output << chunks[i].buffer[chunks[i].pos];
+			++chunks[i].pos;
+			if (next(chunks[i])) queue.push(i);
+
+			if (output.count()==buffer_size)
+			{
+				writeEntries(file, output, index_file);
+				output.clear();
+			}
+		}
+		writeEntries(file, output, index_file);
+
+		//remove temporary files
+		foreach(const Chunk& chunk, chunks)
+		{
+			if (chunk.file.isNull()) continue;
+			chunk.file->close();
+			chunk.file->remove();
+		}
+	}
+}
+
+void ReadNameIndex::writeEntries(QFile& file, const QVector<Entry>& entries, const QString& filename)
+{
+	qint64 bytes = entries.count() * sizeof(Entry);
+	if (file.write(reinterpret_cast<const char*>(entries.constData()), bytes)!=bytes)
+	{
+		THROW(FileAccessException, "Could not write to file " + filename);
+	}
+}
+
+ReadNameIndex::ReadNameIndex(const QString& index_file)
+	: index_file_(index_file)
+	, file_(index_file)
+	, bam_size_(0)
+	, count_(0)
+	, entries_(nullptr)
+{
+	if (!file_.open(QIODevice::ReadOnly)) THROW(FileAccessException, "Could not open read name index file " + index_file);
+
+	//header
+	char magic[8];
+	qint64 header[3];
+	if (file_.read(magic, 8)!=8 || memcmp(magic, RNI_MAGIC, 8)!=0) THROW(FileParseException, "File is not a read name index file: " + index_file);
+	if (file_.read(reinterpret_cast<char*>(header), sizeof(header))!=sizeof(header)) THROW(FileParseException, "Truncated read name index file " + index_file);
+	bam_size_ = header[0];
+	count_ = header[1];
+	if (file_.size()!=RNI_HEADER_SIZE + count_ * static_cast<qint64>(sizeof(Entry))) THROW(FileParseException, "Invalid size of read name index file " + index_file);
+
+	//map entries
+	if (count_>0)
+	{
+		uchar* data = file_.map(RNI_HEADER_SIZE, count_ * sizeof(Entry));
+		if (data==nullptr) THROW(FileAccessException, "Could not map read name index file " + index_file + ": " + file_.errorString());
+		entries_ = reinterpret_cast<const Entry*>(data);
+	}
+}
+
+ReadNameIndex::~ReadNameIndex()
+{
+	if (entries_!=nullptr)
+	{
+		file_.unmap(reinterpret_cast<uchar*>(const_cast<Entry*>(entries_)));
+	}
+}
+
+bool ReadNameIndex::isIndexOf(const QString& bam_file) const
+{
+	return QFileInfo(bam_file).size()==bam_size_;
+}
+
+QList<qint64> ReadNameIndex::offsets(const QByteArray& name) const
+{
+	QList<qint64> output;
+
+	const quint64 name_hash = hash(name);
+	const Entry* end = entries_ + count_;
+	const Entry* it = std::lower_bound(entries_, end, name_hash, [](const Entry& entry, quint64 value){ return entry.hash<value; });
+	while (it!=end && it->hash==name_hash)
+	{
+		output << it->offset;
+		++it;
+	}
+
+	return output;
+}
+
+quint64 ReadNameIndex::hash(const QByteArray& name)
+{
+	quint64 output = 14695981039346656037ULL;
+	for (char c : name)
+	{
+		output ^= static_cast<quint8>(c);
+		output *= 1099511628211ULL;
+	}
+	return output;
+}
@@ -0,0 +1,67 @@
+#ifndef READNAMEINDEX_H
+#define READNAMEINDEX_H
+
+#include "cppNGS_global.h"
+#include <QFile>
+#include <QList>
+#include <QVector>
+
+///Read name index of a BAM file: a sorted list of read name hashes and the virtual file offsets of the alignments.
+///The index allows extracting alignments by name without reading the complete BAM file. CRAM files are not supported.
+class CPPNGSSHARED_EXPORT ReadNameIndex
+{
+public:
+	///Creates a read name index file for the given BAM file. If more than @p max_entries alignments are contained, sorted chunks are written to temporary files and merged.
+	static void create(const QString& bam_file, const QString& index_file, int max_entries = 50000000);
+	///Returns the default name of the read name index of a BAM file.
+	static QString defaultFileName(const QString& bam_file)
+	{
+		return bam_file + ".rni";
+	}
+
+	///Constructor, maps the given read name index file into memory.
+	explicit ReadNameIndex(const QString& index_file);
+	///Destructor.
+	~ReadNameIndex();
+
+	///Returns if the index was created from the given BAM file (compares the file size).
+	bool isIndexOf(const QString& bam_file) const;
+	///Returns the number of indexed alignments.
+	qint64 count() const
+	{
+		return count_;
+	}
+	///Returns the virtual file offsets of alignments with the given name (sorted). Because only hashes are stored, alignments with a different name can be contained and have to be checked after reading.
+	QList<qint64> offsets(const QByteArray& name) const;
+
+	///Returns the 64-bit hash of a read name (FNV-1a, independent of platform and Qt version).
+	static quint64 hash(const QByteArray& name);
+
+protected:
+	//Index entry
+	struct Entry
+	{
+		quint64 hash;
+		qint64 offset;
+
+		bool operator<(const Entry& rhs) const
+		{
+			return hash<rhs.hash || (hash==rhs.hash && offset<rhs.offset);
+		}
+	};
+
+	QString index_file_;
+	QFile file_;
+	qint64 bam_size_;
+	qint64 count_;
+	const Entry* entries_;
+
+	//Writes sorted entries to a file
+	static void writeEntries(QFile& file, const QVector<Entry>& entries, const QString& filename);
+
+	//"declared away" methods
+	ReadNameIndex(const ReadNameIndex&) = delete;
+	ReadNameIndex& operator=(const ReadNameIndex&) = delete;
+};
+
+#endif // READNAMEINDEX_H
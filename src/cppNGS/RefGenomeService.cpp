@@ -36,6 +36,21 @@ const QString& RefGenomeService::getReferenceGenome()
     return instance().ref_genome_file_;
 }
 
+const FastaFileIndex& RefGenomeService::getReferenceGenomeIndex(QString filename)
+{
+	if (filename.isEmpty()) filename = getReferenceGenome();
+
+	RefGenomeService& service = instance();
+	QMutexLocker locker(&service.indices_mutex_);
+	QSharedPointer<FastaFileIndex>& index = service.indices_[filename];
+	if (index.isNull())
+	{
+		index.reset(new FastaFileIndex(filename));
+	}
+
+	return *index;
+}
+
 RefGenomeService& RefGenomeService::instance()
 {
     static RefGenomeService instance;
@@ -2,7 +2,11 @@
 #define REFGENOMESERVICE_H
 
 #include "cppNGS_global.h"
+#include "FastaFileIndex.h"
 #include <QString>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
 
 //Singleton that defines the reference genome used in the application (e.g. for reading CRAM files)
 class CPPNGSSHARED_EXPORT RefGenomeService
@@ -12,6 +16,8 @@ public:
 	static const QString& getReferenceGenome();
 	//sets the reference genome FASTA file. Setting the reference genome manually should be necessary only in special cases.
 	static void setReferenceGenome(QString filename);
+	//returns the FASTA index of the given reference genome file (default is getReferenceGenome()). The index is created on first use and shared by all threads of the application.
+	static const FastaFileIndex& getReferenceGenomeIndex(QString filename = QString());
 
 protected:
     RefGenomeService();
@@ -20,6 +26,8 @@ protected:
 
 private:
     QString ref_genome_file_;
+	QMutex indices_mutex_;
+	QHash<QString, QSharedPointer<FastaFileIndex>> indices_;
 };
 
 
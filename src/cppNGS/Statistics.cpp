@@ -2385,35 +2385,11 @@ QCCollection Statistics::contamination(GenomeBuild build, QString bam, QString r
 	return output;
 }
 
-AncestryEstimates Statistics::ancestry(GenomeBuild build, QString filename, int min_snp, double abs_score_cutoff, double max_mad_dist)
+AncestryMarkers::AncestryMarkers(GenomeBuild build)
+	: variants_()
+	, variants_idx_(variants_)
+	, roi_()
 {
-	//init score statistics
-	struct PopScore
-	{
-		double median;
-		double mad;
-	};
-	static QMap<QString, QMap<QString, PopScore>> scores;
-	if (scores.isEmpty())
-	{
-		scores["AFR"]["AFR"] = {0.5002, 0.0291};
-		scores["AFR"]["EUR"] = {0.0553, 0.0280};
-		scores["AFR"]["SAS"] = {0.1061, 0.0267};
-		scores["AFR"]["EAS"] = {0.0895, 0.0274};
-		scores["EUR"]["AFR"] = {0.0727, 0.0271};
-		scores["EUR"]["EUR"] = {0.3251, 0.0252};
-		scores["EUR"]["SAS"] = {0.1922, 0.0249};
-		scores["EUR"]["EAS"] = {0.0603, 0.0264};
-		scores["SAS"]["AFR"] = {0.0698, 0.0264};
-		scores["SAS"]["EUR"] = {0.1574, 0.0295};
-		scores["SAS"]["SAS"] = {0.3395, 0.0291};
-		scores["SAS"]["EAS"] = {0.1693, 0.0288};
-		scores["EAS"]["AFR"] = {0.08415, 0.0275};
-		scores["EAS"]["EUR"] = {0.06725, 0.0269};
-		scores["EAS"]["SAS"] = {0.21495, 0.0228};
-		scores["EAS"]["EAS"] = {0.47035, 0.0242};
-	}
-
 	//copy ancestry SNP file from resources (gzopen cannot access Qt resources)
 	QString snp_file = ":/Resources/" + buildToString(build) + "_ancestry.vcf";
 	if (!QFile::exists(snp_file)) THROW(ProgrammingException, "Unsupported genome build '" + buildToString(build) + "' for ancestry estimation!");
@@ -2421,66 +2397,150 @@ AncestryEstimates Statistics::ancestry(GenomeBuild build, QString filename, int
 	QFile::copy(snp_file, tmp);
 
 	//load ancestry SNP file
-	VcfFile vars_ancestry;
-	vars_ancestry.load(tmp);
-	ChromosomalIndex<VcfFile> vars_ancestry_idx(vars_ancestry);
+	variants_.load(tmp);
+	variants_idx_.createIndex();
 
 	//remove temporary file
 	QFile::remove(tmp);
 
 	//create ROI to speed up loading the sample file, e.g. for genomes.
-	BedFile roi;
-	for(int i=0; i<vars_ancestry.count(); ++i)
+	for(int i=0; i<variants_.count(); ++i)
 	{
-		const VcfLine& var = vars_ancestry[i];
-		roi.append(BedLine(var.chr(), var.start(), var.end()));
+		const VcfLine& var = variants_[i];
+		roi_.append(BedLine(var.chr(), var.start(), var.end()));
 	}
-	roi.merge(true);
+	roi_.merge(true);
+}
 
-	//load relevant variants from VCF
-	VcfFile vl;
-	vl.setRegion(roi);
-	vl.load(filename);
+int AncestryMarkers::markerIndex(const VcfLine& v) const
+{
+	int index = variants_idx_.matchingIndex(v.chr(), v.start(), v.end());
+	if (index==-1) return -1;
+
+	const VcfLine& v2 = variants_[index];
+	if (v.ref()!=v2.ref() || v.alt()!=v2.alt()) return -1;
+
+	return index;
+}
+
+AncestryEstimates Statistics::ancestry(GenomeBuild build, QString filename, int min_snp, double abs_score_cutoff, double max_mad_dist)
+{
+	AncestryMarkers markers(build);
+	QList<AncestryEstimates> output = ancestry(markers, filename, min_snp, abs_score_cutoff, max_mad_dist);
 
 	//multi-sample VCF is not supported
-	if(vl.sampleIDs().count()!=1)
+	if(output.count()!=1)
 	{
 		THROW(ArgumentException, "Only single-sample VCFs are supported for ancestry estimation!");
 	}
 
+	return output[0];
+}
+
+QList<AncestryEstimates> Statistics::ancestry(const AncestryMarkers& markers, QString filename, int min_snp, double abs_score_cutoff, double max_mad_dist)
+{
+	//load relevant variants from VCF
+	VcfFile vl;
+	vl.setRegion(markers.roi());
+	vl.load(filename);
+
 	//determine required annotation indices
 	if(!vl.vcfHeader().formatIdDefined("GT"))
 	{
 		THROW(ArgumentException, "VCF file does not contain FORMAT entry 'GT', which is required for ancestry estimation!")
 	}
 
-	//process variants
-	QVector<double> geno_sample;
-	QVector<double> af_afr;
-	QVector<double> af_eur;
-	QVector<double> af_sas;
-	QVector<double> af_eas;
+	//process variants - for each sample, only variants with an alternative allele are used, i.e. the same variants as in a single-sample VCF of the sample (missing and homozygous reference genotypes are skipped)
+	struct SampleData
+	{
+		QVector<double> geno;
+		QVector<double> af_afr;
+		QVector<double> af_eur;
+		QVector<double> af_sas;
+		QVector<double> af_eas;
+	};
+	auto has_alt_allele = [](const QByteArray& gt)
+	{
+		foreach(const QByteArray& allele, gt.split(gt.contains('|') ? '|' : '/'))
+		{
+			if (!allele.isEmpty() && allele!="0" && allele!=".") return true;
+		}
+		return false;
+	};
+	const QByteArrayList& samples = vl.sampleIDs();
+	QVector<SampleData> sample_data(samples.count());
 	for(int i=0; i<vl.count(); ++i)
 	{
 		const VcfLine& v = vl[i];
 
 		//skip non-informative SNPs
-		int index = vars_ancestry_idx.matchingIndex(v.chr(), v.start(), v.end());
+		int index = markers.markerIndex(v);
 		if (index==-1) continue;
 
-		const VcfLine& v2 = vars_ancestry[index];
-		if (v.ref()!=v2.ref() || v.alt()!=v2.alt()) continue;
+		//population AFs
+		const VcfLine& v2 = markers.variants()[index];
+		double afr = v2.info("AF_AFR").toDouble();
+		double eur = v2.info("AF_EUR").toDouble();
+		double sas = v2.info("AF_SAS").toDouble();
+		double eas = v2.info("AF_EAS").toDouble();
 
-		//genotype sample
-		geno_sample << vl[i].formatValueFromSample("GT").count('1');
+		//genotype samples
+		for (int s=0; s<samples.count(); ++s)
+		{
+			QByteArray gt = v.formatValueFromSample("GT", s);
+			if (!has_alt_allele(gt)) continue;
 
-		//population AFs
-		af_afr << v2.info("AF_AFR").toDouble();
-		af_eur << v2.info("AF_EUR").toDouble();
-		af_sas << v2.info("AF_SAS").toDouble();
-		af_eas << v2.info("AF_EAS").toDouble();
+			SampleData& data = sample_data[s];
+			data.geno << gt.count('1');
+			data.af_afr << afr;
+			data.af_eur << eur;
+			data.af_sas << sas;
+			data.af_eas << eas;
+		}
+	}
+
+	//estimate ancestry of each sample
+	QList<AncestryEstimates> output;
+	for (int s=0; s<samples.count(); ++s)
+	{
+		const SampleData& data = sample_data[s];
+		output << ancestry(data.geno, data.af_afr, data.af_eur, data.af_sas, data.af_eas, min_snp, abs_score_cutoff, max_mad_dist);
+		output.last().sample = samples[s];
 	}
 
+	return output;
+}
+
+AncestryEstimates Statistics::ancestry(const QVector<double>& geno_sample, const QVector<double>& af_afr, const QVector<double>& af_eur, const QVector<double>& af_sas, const QVector<double>& af_eas, int min_snp, double abs_score_cutoff, double max_mad_dist)
+{
+	//init score statistics (thread-safe, because samples can be processed in parallel)
+	struct PopScore
+	{
+		double median;
+		double mad;
+	};
+	static const QMap<QString, QMap<QString, PopScore>> scores = []()
+	{
+		QMap<QString, QMap<QString, PopScore>> scores;
+		scores["AFR"]["AFR"] = {0.5002, 0.0291};
+		scores["AFR"]["EUR"] = {0.0553, 0.0280};
+		scores["AFR"]["SAS"] = {0.1061, 0.0267};
+		scores["AFR"]["EAS"] = {0.0895, 0.0274};
+		scores["EUR"]["AFR"] = {0.0727, 0.0271};
+		scores["EUR"]["EUR"] = {0.3251, 0.0252};
+		scores["EUR"]["SAS"] = {0.1922, 0.0249};
+		scores["EUR"]["EAS"] = {0.0603, 0.0264};
+		scores["SAS"]["AFR"] = {0.0698, 0.0264};
+		scores["SAS"]["EUR"] = {0.1574, 0.0295};
+		scores["SAS"]["SAS"] = {0.3395, 0.0291};
+		scores["SAS"]["EAS"] = {0.1693, 0.0288};
+		scores["EAS"]["AFR"] = {0.08415, 0.0275};
+		scores["EAS"]["EUR"] = {0.06725, 0.0269};
+		scores["EAS"]["SAS"] = {0.21495, 0.0228};
+		scores["EAS"]["EAS"] = {0.47035, 0.0242};
+		return scores;
+	}();
+
 	//not enough informative SNPs
 	AncestryEstimates output;
 	output.snps = geno_sample.count();
@@ -2808,6 +2868,50 @@ BedFile Statistics::highCoverage(const BedFile& bed_file, const QString& bam_fil
 	return lowOrHighCoverage(bed_file, bam_file, cutoff, min_mapq, min_baseq, threads, ref_file, true, random_access, debug);
 }
 
+BedFile Statistics::lowOrHighCoverage(const BedFile& bed_file, const DepthIndex& depth_index, int cutoff, int min_mapq, int min_baseq, bool is_high)
+{
+	depth_index.checkParameters(min_mapq, min_baseq, false);
+
+	BedFile output;
+	for (int i=0; i<bed_file.count(); ++i)
+	{
+		const BedLine& bed_line = bed_file[i];
+		depth_index.runs(bed_line.chr(), bed_line.start(), bed_line.end(), [&](int start, int end, int depth)
+		{
+			bool filter = is_high ? (depth>=cutoff) : (depth<cutoff);
+			if (filter)
+			{
+				output.append(BedLine(bed_line.chr(), start, end, bed_line.annotations()));
+			}
+		});
+	}
+
+	output.merge(true, true, true);
+	return output;
+}
+
+BedFile Statistics::lowCoverage(const BedFile& bed_file, const DepthIndex& depth_index, int cutoff, int min_mapq, int min_baseq)
+{
+	return lowOrHighCoverage(bed_file, depth_index, cutoff, min_mapq, min_baseq, false);
+}
+
+void Statistics::avgCoverage(BedFile& bed_file, const DepthIndex& depth_index, int min_mapq, int decimals, bool skip_mismapped)
+{
+	depth_index.checkParameters(min_mapq, 0, skip_mismapped);
+
+	for (int i=0; i<bed_file.count(); ++i)
+	{
+		BedLine& bed_line = bed_file[i];
+		double avg = depth_index.averageDepth(bed_line.chr(), bed_line.start(), bed_line.end());
+		bed_line.annotations().append(QByteArray::number(avg, 'f', decimals));
+	}
+}
+
+BedFile Statistics::highCoverage(const BedFile& bed_file, const DepthIndex& depth_index, int cutoff, int min_mapq, int min_baseq)
+{
+	return lowOrHighCoverage(bed_file, depth_index, cutoff, min_mapq, min_baseq, true);
+}
+
 GenderEstimate Statistics::genderXY(QString bam_file, double max_female, double min_male, const QString& ref_file)
 {
 	//open BAM file
@@ -8,6 +8,8 @@
 #include "KeyValuePair.h"
 #include "GenomeBuild.h"
 #include "BamReader.h"
+#include "DepthIndex.h"
+#include "ChromosomalIndex.h"
 
 ///Helper class for gender estimates
 struct CPPNGSSHARED_EXPORT GenderEstimate
@@ -20,6 +22,7 @@ struct CPPNGSSHARED_EXPORT GenderEstimate
 ///Helper class for ancestry estimates
 struct CPPNGSSHARED_EXPORT AncestryEstimates
 {
+	QByteArray sample;
 	int snps;
 	double afr;
 	double eur;
@@ -28,6 +31,36 @@ struct CPPNGSSHARED_EXPORT AncestryEstimates
 	QString population;
 };
 
+///Marker SNPs with population allele frequencies used for ancestry estimation. Load them once when estimating the ancestry of many samples.
+class CPPNGSSHARED_EXPORT AncestryMarkers
+{
+public:
+	///Constructor - loads the marker SNPs of the given genome build.
+	explicit AncestryMarkers(GenomeBuild build);
+
+	///Returns the marker SNPs (allele frequencies in the INFO entries AF_AFR, AF_EUR, AF_SAS and AF_EAS).
+	const VcfFile& variants() const
+	{
+		return variants_;
+	}
+	///Returns the merged marker regions, e.g. to load only relevant variants of a sample VCF.
+	const BedFile& roi() const
+	{
+		return roi_;
+	}
+	///Returns the index of the marker with the same position and alleles as the given variant, or -1 if the variant is not a marker.
+	int markerIndex(const VcfLine& v) const;
+
+private:
+	VcfFile variants_;
+	ChromosomalIndex<VcfFile> variants_idx_;
+	BedFile roi_;
+
+	//declared away
+	AncestryMarkers(const AncestryMarkers&) = delete;
+	AncestryMarkers& operator=(const AncestryMarkers&) = delete;
+};
+
 ///NGS statistics and some BAM file operations.
 class CPPNGSSHARED_EXPORT Statistics
 {
@@ -61,6 +94,8 @@ public:
 	static QCCollection contamination(GenomeBuild build, QString bam, QString ref_file = "", QString roi = "", bool debug = false, int min_cov = 20, int min_snps = 50, bool include_not_properly_paired = false);
 	///Returns ancestry estimates for a variant list in VCF format.
 	static AncestryEstimates ancestry(GenomeBuild build, QString filename, int min_snp=1000, double abs_score_cutoff = 0.32, double max_mad_dist = 4.2);
+	///Returns ancestry estimates for each sample of a single-sample or multi-sample VCF file. For each sample, only variants with an alternative allele are used (missing and homozygous reference genotypes are skipped). Use this method when processing many samples, so that the markers are loaded only once.
+	static QList<AncestryEstimates> ancestry(const AncestryMarkers& markers, QString filename, int min_snp=1000, double abs_score_cutoff = 0.32, double max_mad_dist = 4.2);
 
 	///Calculates the part of the target region that has a lower coverage than the given cutoff. The input BED file must be merged and sorted!
 	static BedFile lowCoverage(const BedFile& bed_file, const QString& bam_file, int cutoff, int min_mapq=1, int min_baseq=0, int threads=1, const QString& ref_file = QString(), bool random_access=true, bool debug=false);
@@ -68,6 +103,12 @@ public:
 	static void avgCoverage(BedFile& bed_file, const QString& bam_file, int min_mapq=1, int threads=1, int decimals=2, const QString& ref_file = QString(), bool random_access=true, bool skip_mismapped = false, bool debug=false);
 	///Calculates the part of the genome that has a higher coverage than the given cutoff.
 	static BedFile highCoverage(const BedFile& bed_file, const QString& bam_file, int cutoff, int min_mapq=1, int min_baseq=0, int threads=1, const QString& ref_file = QString(), bool random_access=true, bool debug=false);
+	///Calculates the part of the target region that has a lower coverage than the given cutoff using a depth index. Throws an exception if the index was created with different parameters.
+	static BedFile lowCoverage(const BedFile& bed_file, const DepthIndex& depth_index, int cutoff, int min_mapq=1, int min_baseq=0);
+	///Calculates and annotates the average coverage of the regions in the bed file using a depth index. Throws an exception if the index was created with different parameters.
+	static void avgCoverage(BedFile& bed_file, const DepthIndex& depth_index, int min_mapq=1, int decimals=2, bool skip_mismapped = false);
+	///Calculates the part of the target region that has a higher coverage than the given cutoff using a depth index. Throws an exception if the index was created with different parameters.
+	static BedFile highCoverage(const BedFile& bed_file, const DepthIndex& depth_index, int cutoff, int min_mapq=1, int min_baseq=0);
 
 	///Determines the gender based on the read ratio between X and Y chromosome.
 	static GenderEstimate genderXY(QString bam_file, double max_female=0.06, double min_male=0.09, const QString& ref_file = QString());
@@ -82,6 +123,9 @@ protected:
 
 private:
 	static BedFile lowOrHighCoverage(const BedFile& bed_file, const QString& bam_file, int cutoff, int min_mapq, int min_baseq, int threads, const QString& ref_file, bool is_high, bool random_access, bool debug);
+	static BedFile lowOrHighCoverage(const BedFile& bed_file, const DepthIndex& depth_index, int cutoff, int min_mapq, int min_baseq, bool is_high);
+	//Returns ancestry estimates from the genotypes of a sample and the population allele frequencies of the marker SNPs.
+	static AncestryEstimates ancestry(const QVector<double>& geno_sample, const QVector<double>& af_afr, const QVector<double>& af_eur, const QVector<double>& af_sas, const QVector<double>& af_eas, int min_snp, double abs_score_cutoff, double max_mad_dist);
 	//Returns the ratio of chrY and chrX reads (for gender check and determining XXY karyotype). If no reads are found on chrX, nan is returned.
 	static double yxRatio(BamReader& reader, double* count_x=nullptr, double* count_y=nullptr);
 
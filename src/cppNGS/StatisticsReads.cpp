@@ -47,27 +47,11 @@ void StatisticsReads::update(const FastqEntry& entry, ReadDirection direction)
 	}
 
 	//create pileups
-	for (int i=0; i<cycles; ++i) pileups_[i].inc(entry.bases[i]);
+	const char* bases = entry.bases.constData();
+	for (int i=0; i<cycles; ++i) pileups_[i].inc(bases[i]);
 
 	//handle qualities
-	double q_sum = 0.0;
-	for (int i=0; i<cycles; ++i)
-	{
-		int q = entry.quality(i);
-		q_sum += q;
-		if (q>=20.0) ++c_base_q20_;
-		if (q>=30.0) ++c_base_q30_;
-		if (q >= base_qualities_.size()) THROW(ArgumentException, "Base quality > " + QByteArray::number(base_qualities_.size()) + " (" + QByteArray::number(q) + "). This should not happen!");
-		base_qualities_[q]++;
-		if (direction==FORWARD)
-		{
-			qualities1_[i] += q;
-		}
-		else
-		{
-			qualities2_[i] += q;
-		}
-	}
+	double q_sum = updateQualities(entry.qualities.constData(), cycles, direction);
 	double mean_qscore = q_sum/cycles;
 	if (BasicStatistics::isValidFloat(mean_qscore))
 	{
@@ -80,6 +64,40 @@ void StatisticsReads::update(const FastqEntry& entry, ReadDirection direction)
 	}
 }
 
+long long StatisticsReads::updateQualities(const char* qualities, int cycles, ReadDirection direction)
+{
+	//per-cycle sums and Q20/Q30 counts (no branches in the loop, so that the compiler can vectorize it)
+	double* cycle_sums = (direction==FORWARD ? qualities1_ : qualities2_).data();
+	long long q_sum = 0;
+	long long c_q20 = 0;
+	long long c_q30 = 0;
+	int q_min = 0;
+	int q_max = 0;
+	for (int i=0; i<cycles; ++i)
+	{
+		int q = qualities[i] - 33;
+		q_sum += q;
+		c_q20 += (q>=20);
+		c_q30 += (q>=30);
+		q_min = std::min(q_min, q);
+		q_max = std::max(q_max, q);
+		cycle_sums[i] += q;
+	}
+	if (q_min < 0) THROW(ArgumentException, "Base quality < 0 (" + QByteArray::number(q_min) + "). This should not happen!");
+	if (q_max >= base_qualities_.size()) THROW(ArgumentException, "Base quality > " + QByteArray::number(base_qualities_.size()) + " (" + QByteArray::number(q_max) + "). This should not happen!");
+	c_base_q20_ += c_q20;
+	c_base_q30_ += c_q30;
+
+	//base quality histogram
+	long long* base_qualities = base_qualities_.data();
+	for (int i=0; i<cycles; ++i)
+	{
+		++base_qualities[qualities[i] - 33];
+	}
+
+	return q_sum;
+}
+
 void StatisticsReads::update(const BamAlignment& al)
 {
 	// ignore supplement and secondary reads
@@ -157,6 +175,58 @@ void StatisticsReads::update(const BamAlignment& al)
 	if (mean_qscore>=20.0) ++c_read_q20_;
 }
 
+void StatisticsReads::merge(const StatisticsReads& other)
+{
+	//counts
+	c_forward_ += other.c_forward_;
+	c_reverse_ += other.c_reverse_;
+	for (auto it=other.read_lengths_.cbegin(); it!=other.read_lengths_.cend(); ++it)
+	{
+		read_lengths_[it.key()] += it.value();
+	}
+	bases_sequenced_ += other.bases_sequenced_;
+	c_read_q20_ += other.c_read_q20_;
+	c_base_q20_ += other.c_base_q20_;
+	c_base_q30_ += other.c_base_q30_;
+
+	//per-cycle data (quality sums are integers, so the result is exact in any order)
+	if (other.pileups_.size()>pileups_.size())
+	{
+		pileups_.resize(other.pileups_.size());
+		qualities1_.resize(other.pileups_.size());
+		qualities2_.resize(other.pileups_.size());
+	}
+	for (int i=0; i<other.pileups_.size(); ++i)
+	{
+		pileups_[i].add(other.pileups_[i]);
+		qualities1_[i] += other.qualities1_[i];
+		qualities2_[i] += other.qualities2_[i];
+	}
+
+	//histograms
+	addHistogram(qscore_dist_r1, other.qscore_dist_r1);
+	addHistogram(qscore_dist_r2, other.qscore_dist_r2);
+	for (int i=0; i<base_qualities_.size(); ++i)
+	{
+		base_qualities_[i] += other.base_qualities_[i];
+	}
+	for (int i=0; i<read_qualities_.size(); ++i)
+	{
+		read_qualities_[i] += other.read_qualities_[i];
+	}
+}
+
+void StatisticsReads::addHistogram(Histogram& hist, Histogram other)
+{
+	QVector<double> bins = hist.yCoords();
+	for (int i=0; i<bins.count(); ++i)
+	{
+		bins[i] += other.binValue(i);
+	}
+	hist.setBins(bins);
+	hist.setBinSum(hist.binSum() + other.binSum());
+}
+
 QCCollection StatisticsReads::getResult()
 {
 	//create output values
@@ -27,11 +27,18 @@ public:
 	void update(const FastqEntry& entry, ReadDirection direction);
 	///Updates the statistics based on the given alignment
 	void update(const BamAlignment& al);
+	///Adds the statistics of another instance, e.g. of another thread. The result does not depend on the order in which the instances are merged.
+	void merge(const StatisticsReads& other);
 
 	///Returns the statistics result.
 	QCCollection getResult();
 
 private:
+	//Adds the qualities of a read to the per-cycle and per-base counts. Returns the sum of qualities.
+	long long updateQualities(const char* qualities, int cycles, ReadDirection direction);
+	//Adds the bin counts of 'other' to 'hist' (both have the same range and bin size).
+	static void addHistogram(Histogram& hist, Histogram other);
+
 	bool single_end_;
 	long long c_forward_;
 	long long c_reverse_;
@@ -0,0 +1,312 @@
+#include "VariantCountStore.h"
+#include "VersatileFile.h"
+#include "Exceptions.h"
+#include "Helper.h"
+#include <QRegularExpression>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+//file format: magic (8 bytes), entry count (8 bytes), meta data size (8 bytes), info block size (8 bytes), meta data (text lines, padded to a multiple of 8 bytes), entries (40 bytes each), info block
+//all numbers are written explicitly as little-endian integers of fixed width, i.e. the format does not depend on the platform
+//entry: hash (8 bytes), start (4 bytes), check hash (4 bytes), homozygous count (4 bytes), heterozygous count (4 bytes), mosaic count (4 bytes), flags (4 bytes), info offset (8 bytes)
+//entries are sorted by hash, start and check hash, i.e. variants with the same hash are stored next to each other
+static const char VCS_MAGIC[] = "NGSVCS02";
+static const qint64 VCS_HEADER_SIZE = 32;
+static const qint64 VCS_ENTRY_SIZE = 40;
+
+//GSvar representation of a variant used for hashing
+static QByteArray hashString(const Variant& variant)
+{
+	return variant.toString(QChar(), -1, true).toUtf8();
+}
+
+//64-bit FNV-1a hash
+static quint64 fnv1a64(const QByteArray& data)
+{
+	quint64 output = 14695981039346656037ULL;
+	for (char c : data)
+	{
+		output ^= static_cast<quint8>(c);
+		output *= 1099511628211ULL;
+	}
+	return output;
+}
+
+//32-bit FNV-1a hash
+static quint32 fnv1a32(const QByteArray& data)
+{
+	quint32 output = 2166136261U;
+	for (char c : data)
+	{
+		output ^= static_cast<quint8>(c);
+		output *= 16777619U;
+	}
+	return output;
+}
+
+QByteArray VariantCountData::infoValue(const QByteArray& key) const
+{
+	foreach(const QByteArray& entry, info)
+	{
+		if (entry.size()>key.size() && entry.startsWith(key) && entry[key.size()]=='=') return entry.mid(key.size()+1);
+	}
+
+	return "";
+}
+
+void VariantCountStore::create(const QString& vcf_file, const QString& store_file)
+{
+	//temporary file for info entries (written in VCF order, appended after the sorted entries)
+	QString tmp_file = Helper::tempFileName(".vcs");
+	QFile info_file(tmp_file);
+	if (!info_file.open(QIODevice::ReadWrite)) THROW(FileAccessException, "Could not open temporary file for writing: " + tmp_file);
+	qint64 info_size = 0;
+
+	//parse VCF
+	QByteArray meta;
+	QRegularExpression group_regexp("^##INFO=<ID=(GSC[0-9]+),.*Description=\".* for (.*)\\.\">$");
+	QRegularExpression haf_regexp("^##INFO=<ID=HAF,.*threshold of ([0-9.]+)");
+	QVector<Entry> entries;
+	VersatileFile file(vcf_file, false);
+	file.open(QFile::ReadOnly | QIODevice::Text);
+	while(!file.atEnd())
+	{
+		QByteArray line = file.readLine(true);
+		if (line.isEmpty()) continue;
+
+		//header
+		if (line.startsWith("#"))
+		{
+			QRegularExpressionMatch match = group_regexp.match(line);
+			if (match.hasMatch())
+			{
+				meta += "group\t" + match.captured(1).toUtf8() + "\t" + match.captured(2).toLower().toUtf8() + "\n";
+			}
+			match = haf_regexp.match(line);
+			if (match.hasMatch())
+			{
+				meta += "max_af\t" + match.captured(1).toUtf8() + "\n";
+			}
+			continue;
+		}
+
+		QByteArrayList parts = line.split('\t');
+		if (parts.count()<8) THROW(FileParseException, "VCF line with less than 8 columns: " + line);
+		if (parts[4].contains(',')) THROW(FileParseException, "Multi-allelic VCF lines are not supported: " + line);
+		bool ok = false;
+		int pos = parts[1].toInt(&ok);
+		if (!ok) THROW(FileParseException, "Invalid VCF variant position: " + line);
+
+		//convert to GSvar format
+		Variant variant(parts[0], pos, pos + parts[3].length() - 1, parts[3], parts[4]);
+		variant.normalize("-", true);
+
+		//parse INFO column
+		QByteArray variant_string = hashString(variant);
+		Entry entry{fnv1a64(variant_string), variant.start(), fnv1a32(variant_string), -1, -1, -1, 0, -1};
+		QByteArrayList info;
+		if (parts[7]!=".")
+		{
+			foreach(const QByteArray& info_entry, parts[7].split(';'))
+			{
+				if (info_entry.startsWith("COUNTS="))
+				{
+					QByteArrayList counts = info_entry.mid(7).split(',');
+					if (counts.count()<2) THROW(FileParseException, "Invalid COUNTS entry in VCF line: " + line);
+					entry.hom = Helper::toInt(counts[0], "homozygous count", line);
+					entry.het = Helper::toInt(counts[1], "heterozygous count", line);
+					if (counts.count()>2) entry.mosaic = Helper::toInt(counts[2], "mosaic count", line);
+				}
+				else if (info_entry=="HAF")
+				{
+					entry.flags |= 1;
+				}
+				else if (!info_entry.isEmpty())
+				{
+					info << info_entry;
+				}
+			}
+		}
+
+		//store further INFO entries
+		if (!info.isEmpty())
+		{
+			QByteArray data = info.join(';') + '\0';
+			if (info_file.write(data)!=data.size()) THROW(FileAccessException, "Could not write to temporary file " + tmp_file);
+			entry.info_offset = info_size;
+			info_size += data.size();
+		}
+
+		entries << entry;
+	}
+
+	//sort entries (variants with the same hash are kept - they are distinguished by start and check hash)
+	std::sort(entries.begin(), entries.end());
+	for (int i=1; i<entries.count(); ++i)
+	{
+		if (entries[i].sameVariant(entries[i-1])) THROW(FileParseException, "VCF file " + vcf_file + " contains a variant twice!");
+	}
+
+	//write header
+	while (meta.size()%8!=0) meta.append('\n');
+	QFile out(store_file);
+	if (!out.open(QIODevice::WriteOnly)) THROW(FileAccessException, "Could not open variant count store file for writing: " + store_file);
+	QByteArray header(VCS_HEADER_SIZE, '\0');
+	memcpy(header.data(), VCS_MAGIC, 8);
+	qToLittleEndian<qint64>(entries.count(), header.data() + 8);
+	qToLittleEndian<qint64>(meta.size(), header.data() + 16);
+	qToLittleEndian<qint64>(info_size, header.data() + 24);
+	out.write(header);
+	out.write(meta);
+
+	//write entries
+	QByteArray buffer(VCS_ENTRY_SIZE, '\0');
+	foreach(const Entry& entry, entries)
+	{
+		char* data = buffer.data();
+		qToLittleEndian<quint64>(entry.hash, data);
+		qToLittleEndian<qint32>(entry.start, data + 8);
+		qToLittleEndian<quint32>(entry.check, data + 12);
+		qToLittleEndian<qint32>(entry.hom, data + 16);
+		qToLittleEndian<qint32>(entry.het, data + 20);
+		qToLittleEndian<qint32>(entry.mosaic, data + 24);
+		qToLittleEndian<qint32>(entry.flags, data + 28);
+		qToLittleEndian<qint64>(entry.info_offset, data + 32);
+		if (out.write(buffer)!=VCS_ENTRY_SIZE) THROW(FileAccessException, "Could not write to file " + store_file);
+	}
+
+	//append info block
+	info_file.seek(0);
+	while (!info_file.atEnd())
+	{
+		QByteArray data = info_file.read(1048576);
+		if (out.write(data)!=data.size()) THROW(FileAccessException, "Could not write to file " + store_file);
+	}
+	out.close();
+
+	//remove temporary file
+	info_file.close();
+	info_file.remove();
+}
+
+VariantCountStore::VariantCountStore(const QString& store_file)
+	: store_file_(store_file)
+	, file_(store_file)
+	, data_(nullptr)
+	, count_(0)
+	, entries_(nullptr)
+	, info_(nullptr)
+	, max_af_(0.0)
+	, disease_groups_()
+{
+	if (!file_.open(QIODevice::ReadOnly)) THROW(FileAccessException, "Could not open variant count store file " + store_file);
+
+	//header
+	QByteArray header = file_.read(VCS_HEADER_SIZE);
+	if (header.size()<8 || memcmp(header.constData(), VCS_MAGIC, 8)!=0) THROW(FileParseException, "File is not a variant count store file: " + store_file);
+	if (header.size()!=VCS_HEADER_SIZE) THROW(FileParseException, "Truncated variant count store file " + store_file);
+	count_ = qFromLittleEndian<qint64>(header.constData() + 8);
+	qint64 meta_size = qFromLittleEndian<qint64>(header.constData() + 16);
+	qint64 info_size = qFromLittleEndian<qint64>(header.constData() + 24);
+	if (count_<0 || meta_size<0 || info_size<0 || meta_size%8!=0 || file_.size()!=VCS_HEADER_SIZE + meta_size + count_ * VCS_ENTRY_SIZE + info_size) THROW(FileParseException, "Invalid size of variant count store file " + store_file);
+
+	//meta data
+	foreach(const QByteArray& line, file_.read(meta_size).split('\n'))
+	{
+		QByteArrayList parts = line.split('\t');
+		if (parts[0]=="max_af" && parts.count()==2)
+		{
+			max_af_ = Helper::toDouble(parts[1], "maximum allele frequency");
+		}
+		else if (parts[0]=="group" && parts.count()==3)
+		{
+			disease_groups_[parts[2]] = parts[1];
+		}
+	}
+
+	//map entries and info block
+	if (count_>0)
+	{
+		data_ = file_.map(0, file_.size());
+		if (data_==nullptr) THROW(FileAccessException, "Could not map variant count store file " + store_file + ": " + file_.errorString());
+		entries_ = data_ + VCS_HEADER_SIZE + meta_size;
+		info_ = reinterpret_cast<const char*>(entries_ + count_ * VCS_ENTRY_SIZE);
+	}
+}
+
+VariantCountStore::~VariantCountStore()
+{
+	if (data_!=nullptr)
+	{
+		file_.unmap(data_);
+	}
+}
+
+QByteArray VariantCountStore::diseaseGroupKey(const QString& disease_group) const
+{
+	return disease_groups_.value(disease_group.toLower().toUtf8());
+}
+
+VariantCountData VariantCountStore::get(const Variant& variant) const
+{
+	VariantCountData output;
+
+	//binary search for the first entry with a hash that is not smaller
+	const QByteArray variant_string = hashString(variant);
+	const quint64 variant_hash = fnv1a64(variant_string);
+	qint64 first = 0;
+	qint64 count = count_;
+	while (count>0)
+	{
+		qint64 step = count / 2;
+		if (qFromLittleEndian<quint64>(entries_ + (first + step) * VCS_ENTRY_SIZE) < variant_hash)
+		{
+			first += step + 1;
+			count -= step + 1;
+		}
+		else
+		{
+			count = step;
+		}
+	}
+
+	//check all entries with the same hash for matching start and check hash
+	const qint32 variant_start = variant.start();
+	const quint32 variant_check = fnv1a32(variant_string);
+	const uchar* entry = nullptr;
+	for (qint64 i=first; i<count_; ++i)
+	{
+		const uchar* current = entries_ + i * VCS_ENTRY_SIZE;
+		if (qFromLittleEndian<quint64>(current)!=variant_hash) break;
+		if (qFromLittleEndian<qint32>(current + 8)==variant_start && qFromLittleEndian<quint32>(current + 12)==variant_check)
+		{
+			entry = current;
+			break;
+		}
+	}
+	if (entry==nullptr) return output;
+
+	output.found = true;
+	output.high_af = qFromLittleEndian<qint32>(entry + 28) & 1;
+	output.hom = qFromLittleEndian<qint32>(entry + 16);
+	output.het = qFromLittleEndian<qint32>(entry + 20);
+	output.mosaic = qFromLittleEndian<qint32>(entry + 24);
+	qint64 info_offset = qFromLittleEndian<qint64>(entry + 32);
+	if (info_offset>=0)
+	{
+		output.info = QByteArray(info_ + info_offset).split(';');
+	}
+
+	return output;
+}
+
+quint64 VariantCountStore::hash(const Variant& variant)
+{
+	return fnv1a64(hashString(variant));
+}
+
+quint32 VariantCountStore::checkHash(const Variant& variant)
+{
+	return fnv1a32(hashString(variant));
+}
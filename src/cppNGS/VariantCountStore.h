@@ -0,0 +1,102 @@
+#ifndef VARIANTCOUNTSTORE_H
+#define VARIANTCOUNTSTORE_H
+
+#include "cppNGS_global.h"
+#include "VariantList.h"
+#include <QFile>
+#include <QHash>
+
+///Germline NGSD data of a variant stored in a VariantCountStore.
+struct CPPNGSSHARED_EXPORT VariantCountData
+{
+	///If the variant is contained in the store.
+	bool found = false;
+	///If the variant has an allele frequency above the maximum allele frequency of the export (counts are not available).
+	bool high_af = false;
+	///Homozygous/heterozygous/mosaic count (-1 if not available).
+	int hom = -1;
+	int het = -1;
+	int mosaic = -1;
+	///Further INFO entries of the export, i.e. disease group counts (GSC01, GSC02, ...), classification (CLAS, CLAS_COM) and comment (COM).
+	QByteArrayList info;
+
+	///Returns the value of an INFO entry, or an empty string if it is not contained.
+	QByteArray infoValue(const QByteArray& key) const;
+};
+
+///Compact store of the germline NGSD counts, classifications and comments for fast re-annotation of GSvar files.
+///It is created from the germline VCF of NGSDExportAnnotationData. Variants are stored as 64-bit hashes of the GSvar representation (sorted by hash).
+///Each entry additionally contains the variant start and a 32-bit check hash of the GSvar representation, which are used to distinguish variants with the same 64-bit hash.
+///The file is memory-mapped, i.e. a lookup is a binary search and the store is not loaded into memory. All numbers are stored as little-endian integers of fixed width, i.e. the file can be used on all platforms.
+class CPPNGSSHARED_EXPORT VariantCountStore
+{
+public:
+	///Creates a store from the germline export VCF of NGSDExportAnnotationData (plain or gzipped).
+	static void create(const QString& vcf_file, const QString& store_file);
+
+	///Constructor, maps the given store file into memory.
+	explicit VariantCountStore(const QString& store_file);
+	///Destructor.
+	~VariantCountStore();
+
+	///Returns the number of variants.
+	qint64 count() const
+	{
+		return count_;
+	}
+	///Returns the maximum allele frequency of the export (variants above are flagged as high AF).
+	double maxAf() const
+	{
+		return max_af_;
+	}
+	///Returns the INFO key of the counts of the given disease group (e.g. 'GSC01'), or an empty string if the disease group is unknown. Matching is case-insensitive.
+	QByteArray diseaseGroupKey(const QString& disease_group) const;
+
+	///Returns the data of a variant in GSvar format.
+	VariantCountData get(const Variant& variant) const;
+
+	///Returns the 64-bit hash of a variant in GSvar format (FNV-1a, independent of platform and Qt version).
+	static quint64 hash(const Variant& variant);
+	///Returns the 32-bit check hash of a variant in GSvar format (FNV-1a, independent of platform and Qt version).
+	static quint32 checkHash(const Variant& variant);
+
+protected:
+	//Store entry (only used during creation - entries are written field by field)
+	struct Entry
+	{
+		quint64 hash;
+		qint32 start;
+		quint32 check;
+		qint32 hom;
+		qint32 het;
+		qint32 mosaic;
+		qint32 flags; //1: high AF
+		qint64 info_offset; //offset of the '\0'-terminated INFO entries in the info block (-1 if there are none)
+
+		bool operator<(const Entry& rhs) const
+		{
+			if (hash!=rhs.hash) return hash<rhs.hash;
+			if (start!=rhs.start) return start<rhs.start;
+			return check<rhs.check;
+		}
+		bool sameVariant(const Entry& rhs) const
+		{
+			return hash==rhs.hash && start==rhs.start && check==rhs.check;
+		}
+	};
+
+	QString store_file_;
+	QFile file_;
+	uchar* data_;
+	qint64 count_;
+	const uchar* entries_;
+	const char* info_;
+	double max_af_;
+	QHash<QByteArray, QByteArray> disease_groups_; //lower-case disease group name => INFO key
+
+	//"declared away" methods
+	VariantCountStore(const VariantCountStore&) = delete;
+	VariantCountStore& operator=(const VariantCountStore&) = delete;
+};
+
+#endif // VARIANTCOUNTSTORE_H
@@ -440,12 +440,12 @@ public:
 	enum ShiftResult {SKIPPED, PROCESSED};
 	ShiftResult normalize(ShiftDirection shift_dir, const FastaFileIndex& reference, bool add_prefix_base_to_mnps=false);
 	// Left-normalize all variants.
-	ShiftResult leftNormalize(FastaFileIndex& reference)
+	ShiftResult leftNormalize(const FastaFileIndex& reference)
 	{
 		return normalize(ShiftDirection::LEFT, reference);
 	}
 	//Right-normalize all variants
-	ShiftResult rightNormalize(FastaFileIndex& reference)
+	ShiftResult rightNormalize(const FastaFileIndex& reference)
 	{
 		return normalize(ShiftDirection::RIGHT, reference);
 	}
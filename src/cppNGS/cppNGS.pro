@@ -25,6 +25,8 @@ unix: QMAKE_CXXFLAGS += $$system(pkg-config --cflags libxml-2.0)
 unix: LIBS += -lxml2
 
 SOURCES += BedFile.cpp \
+    BedFileStream.cpp \
+    BedSweep.cpp \
     Chromosome.cpp \
     ClientHelper.cpp \
     RefGenomeService.cpp \
@@ -42,6 +44,11 @@ SOURCES += BedFile.cpp \
     Sequence.cpp \
     BamReader.cpp \
     BamWriter.cpp \
+    MatePairBuffer.cpp \
+    DepthIndex.cpp \
+    ReadNameIndex.cpp \
+    VariantCountStore.cpp \
+    CompactGraph.cpp \
     SampleSimilarity.cpp \
     CnvList.cpp \
     Phenotype.cpp \
@@ -73,6 +80,8 @@ SOURCES += BedFile.cpp \
     GffData.cpp
 
 HEADERS += BedFile.h \
+    BedFileStream.h \
+    BedSweep.h \
     Chromosome.h \
     ClientHelper.h \
     FileInfo.h \
@@ -92,6 +101,10 @@ HEADERS += BedFile.h \
     Sequence.h \
     BamReader.h \
     BamWriter.h \
+    MatePairBuffer.h \
+    DepthIndex.h \
+    ReadNameIndex.h \
+    VariantCountStore.h \
     SampleSimilarity.h \
     CnvList.h \
     Phenotype.h \
@@ -118,6 +131,7 @@ HEADERS += BedFile.h \
     Graph.h \
     GraphNode.h \
     GraphEdge.h \
+    CompactGraph.h \
     GenomeBuild.h \
     ChainFileReader.h \
     BigWigReader.h \
@@ -17,7 +17,25 @@ QByteArray ApiCaller::get(QString api_path, RequestUrlParams url_params, HttpHea
 		if (needs_user_token) addUserTokenIfExists(url_params);
 		if (needs_db_token) addDbTokenIfExists(url_params);
 
-        return HttpRequestHandler().get(ClientHelper::serverApiUrl() + api_path + QUrl(url_params.asString()).toEncoded(), headers).body;
+		QString url = ClientHelper::serverApiUrl() + api_path + QUrl(url_params.asString()).toEncoded();
+		CachedReply cached_reply;
+		bool is_cached = getCachedReply(url, cached_reply);
+		if (is_cached) headers.insert("If-None-Match", cached_reply.etag);
+
+		try
+		{
+			ServerReply reply = HttpRequestHandler().get(url, headers);
+			if (is_cached && reply.status_code==304) return cached_reply.body;
+
+			updateCache(url, reply.headers, reply.body);
+			return reply.body;
+		}
+		catch (HttpException& e)
+		{
+			//depending on the network backend 'not modified' might be reported as an error
+			if (is_cached && e.status_code()==304) return cached_reply.body;
+			throw;
+		}
 	}
     catch (HttpException& e)
 	{
@@ -72,3 +90,54 @@ void ApiCaller::addDbTokenIfExists(RequestUrlParams& params)
 		Log::error("Could not add database token: " + e.message());
 	}
 }
+
+void ApiCaller::clearCache()
+{
+	Cache& cache = getCache();
+	QMutexLocker locker(&cache.mutex);
+	cache.replies.clear();
+	cache.size = 0;
+}
+
+ApiCaller::Cache& ApiCaller::getCache()
+{
+	static Cache cache;
+	return cache;
+}
+
+bool ApiCaller::getCachedReply(const QString& url, CachedReply& output)
+{
+	Cache& cache = getCache();
+	QMutexLocker locker(&cache.mutex);
+	if (!cache.replies.contains(url)) return false;
+
+	output = cache.replies[url];
+	return true;
+}
+
+void ApiCaller::updateCache(const QString& url, const HttpHeaders& headers, const QByteArray& body)
+{
+	QByteArray etag;
+	for (auto it=headers.cbegin(); it!=headers.cend(); ++it)
+	{
+		if (it.key().toLower()=="etag") etag = it.value();
+	}
+
+	Cache& cache = getCache();
+	QMutexLocker locker(&cache.mutex);
+	if (cache.replies.contains(url))
+	{
+		cache.size -= cache.replies[url].body.size();
+		cache.replies.remove(url);
+	}
+	if (etag.isEmpty() || body.size()>MAX_CACHE_SIZE) return;
+
+	//the cache is small - we simply start over when it is full
+	if (cache.size+body.size()>MAX_CACHE_SIZE)
+	{
+		cache.replies.clear();
+		cache.size = 0;
+	}
+	cache.replies.insert(url, CachedReply{etag, body});
+	cache.size += body.size();
+}
@@ -3,17 +3,41 @@
 
 #include "cppNGSD_global.h"
 #include "HttpRequestHandler.h"
+#include <QMutex>
 
 class CPPNGSDSHARED_EXPORT ApiCaller
 {
 public:
 	ApiCaller();
+	///Performs a GET request. Replies with an entity tag are cached locally and revalidated by the server on subsequent requests of the same URL (conditional request).
 	QByteArray get(QString api_path, RequestUrlParams url_params, HttpHeaders headers, bool needs_user_token = false, bool needs_db_token = false, bool rethrow_excpetion = false);
 	QByteArray post(QString api_path, RequestUrlParams url_params, HttpHeaders headers, const QByteArray& data, bool needs_user_token = false, bool needs_db_token = false, bool rethrow_excpetion = false);
 
+	///Removes all locally cached replies.
+	static void clearCache();
+
 protected:
 	void addUserTokenIfExists(RequestUrlParams& params);
 	void addDbTokenIfExists(RequestUrlParams& params);
+
+	///Cached reply of a GET request
+	struct CachedReply
+	{
+		QByteArray etag;
+		QByteArray body;
+	};
+	///Local cache of GET replies (URL as key)
+	struct Cache
+	{
+		QMutex mutex;
+		QHash<QString, CachedReply> replies;
+		qint64 size = 0;
+	};
+	static Cache& getCache();
+	static const qint64 MAX_CACHE_SIZE = 50*1024*1024; // in bytes
+
+	static bool getCachedReply(const QString& url, CachedReply& output);
+	static void updateCache(const QString& url, const HttpHeaders& headers, const QByteArray& body);
 };
 
 #endif // APICALLER_H
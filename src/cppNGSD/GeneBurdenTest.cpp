@@ -6,7 +6,7 @@
 
 
 WorkerGeneBurdenTest::WorkerGeneBurdenTest(const QByteArray &gene, const BurdenTestParameters& parameters, const QMap<QByteArray,BedFile>& ccr80_region, const QSet<int>& ps_ids_cases, const QSet<int>& ps_ids_controls,
-										   const QByteArrayList& ps_ids, const QSet<int>& callset_ids_cases, const QSet<int>& callset_ids_controls, const BedFile &cnv_polymorphism_region, bool test,  bool debug)
+										   const QByteArrayList& ps_ids, const QSet<int>& callset_ids_cases, const QSet<int>& callset_ids_controls, const BedFile &cnv_polymorphism_region, const GenotypeMatrix* genotype_matrix, bool test,  bool debug)
 	: QRunnable()
 	, parameters_(parameters)
 	, ccr80_region_(ccr80_region)
@@ -16,6 +16,7 @@ WorkerGeneBurdenTest::WorkerGeneBurdenTest(const QByteArray &gene, const BurdenT
 	, callset_ids_cases_(callset_ids_cases)
 	, callset_ids_controls_(callset_ids_controls)
 	, cnv_polymorphism_region_(cnv_polymorphism_region)
+	, genotype_matrix_(genotype_matrix)
 	, test_(test)
 	, debug_(debug)
 {
@@ -145,7 +146,11 @@ void WorkerGeneBurdenTest::run()
 
 		// for all matching variants: get counts of case and control cohort
 		QMap<int,QSet<int>> detected_variants;
-		if(variant_ids.size() != 0)
+		if (genotype_matrix_!=nullptr)
+		{
+			detected_variants = genotype_matrix_->detectedVariants(variant_ids, ps_ids_cases_ + ps_ids_controls_, parameters_.include_mosaic);
+		}
+		else if(variant_ids.size() != 0)
 		{
 			QStringList var_ids_str;
 			foreach (int id, variant_ids)
@@ -210,15 +215,23 @@ void WorkerGeneBurdenTest::run()
 
 QMap<int, Variant> WorkerGeneBurdenTest::getVariantsForRegion(const BedFile &regions)
 {
-	NGSD db(test_);
-	db.enableDebugging(debug_);
-	QMap<int, Variant> variants;
-
 	if(regions.count() < 1)
 	{
 		THROW(ArgumentException, "BED file doesn't contain any regions!");
 	}
 
+	//use genotype matrix if available
+	if (genotype_matrix_!=nullptr)
+	{
+		QMap<int, Variant> variants = genotype_matrix_->variants(regions, parameters_.max_ngsd_count, parameters_.max_gnomad_af);
+		if (debug_) QTextStream(stdout) << "\t initial variants (genotype matrix): " << variants.size() << Qt::endl;
+		return variants;
+	}
+
+	NGSD db(test_);
+	db.enableDebugging(debug_);
+	QMap<int, Variant> variants;
+
 	//execute query
 	QString query_text = createGeneQuery(regions);
 	SqlQuery query = db.getQuery();
@@ -316,8 +329,16 @@ QMap<QByteArray, QByteArray> WorkerGeneBurdenTest::getOccurences(const QSet<int>
 		{
 			int variant_id = intersection.values().at(0);
 			// check for hom var
-			QString genotype = db.getValue("SELECT genotype FROM detected_variant WHERE processed_sample_id=" + QString::number(ps_id) + " AND variant_id="
-											+ QString::number(variant_id)).toString();
+			QString genotype;
+			if (genotype_matrix_!=nullptr)
+			{
+				genotype = genotype_matrix_->genotype(variant_id, ps_id);
+			}
+			else
+			{
+				genotype = db.getValue("SELECT genotype FROM detected_variant WHERE processed_sample_id=" + QString::number(ps_id) + " AND variant_id="
+									   + QString::number(variant_id)).toString();
+			}
 
 			// skip het vars (except het on chr X in male samples)
 			if (genotype == "het")
@@ -449,6 +470,7 @@ GeneBurdenTest::GeneBurdenTest(const QSet<int> &ps_ids_cases, const QSet<int> &p
 	, threads_(threads)
 	, debug_(debug)
 	, skip_errors_(skip_errors)
+	, genotype_matrix_(nullptr)
 {
 	//init CCR region
 	if (parameters_.ccr_only) initCCR();
@@ -457,6 +479,23 @@ GeneBurdenTest::GeneBurdenTest(const QSet<int> &ps_ids_cases, const QSet<int> &p
 	genes_ = db_.genesToApproved(genes_);
 }
 
+void GeneBurdenTest::setGenotypeMatrix(const GenotypeMatrix* genotype_matrix)
+{
+	if (genotype_matrix!=nullptr)
+	{
+		//check that all samples are contained
+		for (int ps_id : ps_ids_cases_ + ps_ids_controls_)
+		{
+			if (!genotype_matrix->containsSample(ps_id)) THROW(ArgumentException, "Processed sample with ID " + QString::number(ps_id) + " is not contained in the genotype matrix. Please update the genotype matrix!");
+		}
+
+		//check NGSD count cutoff
+		if (parameters_.max_ngsd_count>genotype_matrix->maxNgsdCount()) THROW(ArgumentException, "Maximum NGSD count " + QString::number(parameters_.max_ngsd_count) + " is larger than the maximum NGSD count of the genotype matrix (" + QString::number(genotype_matrix->maxNgsdCount()) + ")!");
+	}
+
+	genotype_matrix_ = genotype_matrix;
+}
+
 QList<BurdenTestResult> GeneBurdenTest::run_burden_test()
 {
 	//clear previous results
@@ -560,7 +599,7 @@ QList<BurdenTestResult> GeneBurdenTest::run_burden_test()
 	QList<WorkerGeneBurdenTest*> workers;
 	for (const QByteArray& gene : std::as_const(genes_))
 	{
-		WorkerGeneBurdenTest* worker = new WorkerGeneBurdenTest(gene, parameters_, ccr80_region_, ps_ids_cases_, ps_ids_controls_, ps_ids_, callset_ids_cases_, callset_ids_controls_, cnv_polymorphism_region_, test_, debug_);
+		WorkerGeneBurdenTest* worker = new WorkerGeneBurdenTest(gene, parameters_, ccr80_region_, ps_ids_cases_, ps_ids_controls_, ps_ids_, callset_ids_cases_, callset_ids_controls_, cnv_polymorphism_region_, genotype_matrix_, test_, debug_);
 		worker->setAutoDelete(false);
 		workers << worker;
 		thread_pool.start(worker);
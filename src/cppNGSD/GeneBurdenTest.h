@@ -3,6 +3,7 @@
 
 #include "cppNGSD_global.h"
 #include "NGSD.h"
+#include "GenotypeMatrix.h"
 #include <QObject>
 
 enum class Inheritance
@@ -81,7 +82,7 @@ class WorkerGeneBurdenTest
 
 public:
 	WorkerGeneBurdenTest(const QByteArray& gene, const BurdenTestParameters& parameters, const QMap<QByteArray,BedFile>& ccr80_region, const QSet<int>& ps_ids_cases, const QSet<int>& ps_ids_controls,
-						 const QByteArrayList& ps_ids, const QSet<int>& callset_ids_cases, const QSet<int>& callset_ids_controls, const BedFile& cnv_polymorphism_region, bool test, bool debug);
+						 const QByteArrayList& ps_ids, const QSet<int>& callset_ids_cases, const QSet<int>& callset_ids_controls, const BedFile& cnv_polymorphism_region, const GenotypeMatrix* genotype_matrix, bool test, bool debug);
 	virtual void run() override;
 
 	BurdenTestResult result()
@@ -101,6 +102,7 @@ private:
 	const QSet<int>& callset_ids_cases_;
 	const QSet<int>& callset_ids_controls_;
 	const BedFile& cnv_polymorphism_region_;
+	const GenotypeMatrix* genotype_matrix_;
 
 	// NGSD* db_;
 	bool test_;
@@ -121,6 +123,9 @@ class CPPNGSDSHARED_EXPORT GeneBurdenTest : public QObject
 public:
 	GeneBurdenTest(const QSet<int>& ps_ids_cases, const QSet<int>& ps_ids_controls, const GeneSet& genes, BurdenTestParameters parameters, int threads, bool test=false, bool debug=false, bool skip_errors=false);
 
+	///Sets a genotype matrix exported from the NGSD. If set, small variants and genotypes are taken from the matrix instead of querying the NGSD for each gene. The matrix has to outlive the burden test.
+	void setGenotypeMatrix(const GenotypeMatrix* genotype_matrix);
+
 	///Perform burden test
 	QList<BurdenTestResult> run_burden_test();
 
@@ -134,6 +139,7 @@ private:
 	int threads_;
 	bool debug_;
 	bool skip_errors_;
+	const GenotypeMatrix* genotype_matrix_;
 
 	//helper to simplify SQL query generation
 	QByteArrayList ps_ids_;
@@ -0,0 +1,417 @@
+#include "GenotypeMatrix.h"
+#include "Exceptions.h"
+#include "Helper.h"
+#include <QDataStream>
+#include <cmath>
+#include <limits>
+
+//file format identifier and version
+static const QByteArray FILE_MAGIC = "NGSD_GENOTYPE_MATRIX";
+static const qint32 FILE_VERSION = 1;
+
+GenotypeMatrix::GenotypeMatrix()
+	: max_ngsd_count_(-1)
+	, max_length_(0)
+{
+}
+
+void GenotypeMatrix::createFromNGSD(NGSD& db, int max_ngsd_count, QTextStream* debug_out)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	if (max_ngsd_count<1) THROW(ArgumentException, "Invalid maximum NGSD count " + QString::number(max_ngsd_count) + " for genotype matrix!");
+	max_ngsd_count_ = max_ngsd_count;
+
+	//load variants
+	QString conditions = "(v.germline_het>0 OR v.germline_hom>0) AND v.germline_het+v.germline_hom<=" + QString::number(max_ngsd_count);
+	QHash<int, VariantData> data;
+	loadVariantData(db, conditions, data);
+	if (debug_out!=nullptr) (*debug_out) << "Loaded " << data.count() << " variants - took " << Helper::elapsedTime(timer.restart()) << Qt::endl;
+
+	//load genotypes (chromosome-wise to limit the size of the result set)
+	QSet<QByteArray> chrs;
+	for (auto it=data.cbegin(); it!=data.cend(); ++it)
+	{
+		chrs << it.value().chr.strNormalized(true);
+	}
+	long long c_entries = 0;
+	for (const QByteArray& chr : std::as_const(chrs))
+	{
+		SqlQuery query = db.getQuery();
+		query.setForwardOnly(true);
+		query.exec("SELECT dv.variant_id, dv.processed_sample_id, dv.genotype, dv.mosaic FROM detected_variant dv, variant v WHERE dv.variant_id=v.id AND v.chr='" + chr + "' AND " + conditions);
+		while (query.next())
+		{
+			int variant_id = query.value(0).toInt();
+			if (!data.contains(variant_id)) continue; //variant imported after loading variants
+
+			quint8 genotype = (query.value(2).toByteArray()=="hom" ? HOM : 0) | (query.value(3).toBool() ? MOSAIC : 0);
+			data[variant_id].entries << QPair<int, quint8>(query.value(1).toInt(), genotype);
+			++c_entries;
+		}
+	}
+	if (debug_out!=nullptr) (*debug_out) << "Loaded " << c_entries << " genotypes - took " << Helper::elapsedTime(timer.restart()) << Qt::endl;
+
+	//samples
+	ps_ids_ = Helper::listToSet(db.getValuesInt("SELECT DISTINCT processed_sample_id FROM detected_variant"));
+
+	//convert to matrix
+	setData(data.values());
+	last_update_ = QDateTime::currentDateTime();
+	if (debug_out!=nullptr) (*debug_out) << "Creating matrix took " << Helper::elapsedTime(timer.restart()) << Qt::endl;
+}
+
+int GenotypeMatrix::appendNewSamples(NGSD& db, QTextStream* debug_out)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	if (max_ngsd_count_<1) THROW(ProgrammingException, "Cannot append samples to genotype matrix that was not created/loaded!");
+
+	//determine new samples
+	QSet<int> ps_ids_new = Helper::listToSet(db.getValuesInt("SELECT DISTINCT processed_sample_id FROM detected_variant"));
+	ps_ids_new.subtract(ps_ids_);
+	if (debug_out!=nullptr) (*debug_out) << "New samples: " << ps_ids_new.count() << Qt::endl;
+	if (ps_ids_new.isEmpty()) return 0;
+
+	//convert matrix to variant data
+	QHash<int, VariantData> data;
+	for (const VariantData& var : getData())
+	{
+		data[var.id] = var;
+	}
+
+	//load genotypes of new samples (variants of all NGSD counts are loaded, because variants can exceed the maximum NGSD count because of the new samples)
+	QHash<int, QVector<QPair<int, quint8>>> new_entries;
+	QHash<int, int> new_counts;
+	QSet<int> removed_ids;
+	SqlQuery query = db.getQuery();
+	query.setForwardOnly(true);
+	query.prepare("SELECT dv.variant_id, dv.genotype, dv.mosaic, v.germline_het, v.germline_hom FROM detected_variant dv, variant v WHERE dv.processed_sample_id=:0 AND dv.variant_id=v.id");
+	for (int ps_id : std::as_const(ps_ids_new))
+	{
+		query.bindValue(0, ps_id);
+		query.exec();
+		while (query.next())
+		{
+			int variant_id = query.value(0).toInt();
+			int het = query.value(3).toInt();
+			int hom = query.value(4).toInt();
+			if ((het==0 && hom==0) || het+hom>max_ngsd_count_)
+			{
+				removed_ids << variant_id;
+				continue;
+			}
+
+			quint8 genotype = (query.value(1).toByteArray()=="hom" ? HOM : 0) | (query.value(2).toBool() ? MOSAIC : 0);
+			new_entries[variant_id] << QPair<int, quint8>(ps_id, genotype);
+			new_counts[variant_id] = het + hom;
+		}
+	}
+
+	//remove variants that exceed the maximum NGSD count now
+	int c_removed = 0;
+	for (int variant_id : std::as_const(removed_ids))
+	{
+		c_removed += data.remove(variant_id);
+	}
+	if (debug_out!=nullptr) (*debug_out) << "Removed variants exceeding the maximum NGSD count: " << c_removed << Qt::endl;
+
+	//update NGSD counts of contained variants and load data of new variants
+	QStringList ids;
+	for (auto it=new_counts.cbegin(); it!=new_counts.cend(); ++it)
+	{
+		if (data.contains(it.key()))
+		{
+			data[it.key()].ngsd_count = it.value();
+		}
+		else
+		{
+			ids << QString::number(it.key());
+		}
+	}
+	for (int i=0; i<ids.count(); i+=10000)
+	{
+		QString id_list = ids.mid(i, 10000).join(",");
+		loadVariantData(db, "v.id IN (" + id_list + ")", data);
+
+		//entries of samples already contained in the matrix (the variant can be contained in samples that are not counted, e.g. tumor samples)
+		SqlQuery query_entries = db.getQuery();
+		query_entries.setForwardOnly(true);
+		query_entries.exec("SELECT dv.variant_id, dv.processed_sample_id, dv.genotype, dv.mosaic FROM detected_variant dv WHERE dv.variant_id IN (" + id_list + ")");
+		while (query_entries.next())
+		{
+			int variant_id = query_entries.value(0).toInt();
+			int ps_id = query_entries.value(1).toInt();
+			if (ps_ids_new.contains(ps_id) || !data.contains(variant_id)) continue;
+
+			quint8 genotype = (query_entries.value(2).toByteArray()=="hom" ? HOM : 0) | (query_entries.value(3).toBool() ? MOSAIC : 0);
+			data[variant_id].entries << QPair<int, quint8>(ps_id, genotype);
+		}
+	}
+
+	//append entries
+	for (auto it=new_entries.cbegin(); it!=new_entries.cend(); ++it)
+	{
+		if (!data.contains(it.key())) continue; //variant deleted in the meantime
+		data[it.key()].entries << it.value();
+	}
+	ps_ids_.unite(ps_ids_new);
+	if (debug_out!=nullptr) (*debug_out) << "Loading data of new samples took " << Helper::elapsedTime(timer.restart()) << Qt::endl;
+
+	//convert to matrix
+	setData(data.values());
+	last_update_ = QDateTime::currentDateTime();
+	if (debug_out!=nullptr) (*debug_out) << "Updating matrix took " << Helper::elapsedTime(timer.restart()) << Qt::endl;
+
+	return ps_ids_new.count();
+}
+
+void GenotypeMatrix::load(QString filename)
+{
+	QSharedPointer<QFile> file = Helper::openFileForReading(filename);
+	QDataStream stream(file.data());
+
+	//header
+	QByteArray magic;
+	qint32 version;
+	stream >> magic >> version;
+	if (magic!=FILE_MAGIC) THROW(FileParseException, "File '" + filename + "' is not a NGSD genotype matrix file!");
+	if (version!=FILE_VERSION) THROW(FileParseException, "Genotype matrix file '" + filename + "' has unsupported version " + QString::number(version) + "! Expected version is " + QString::number(FILE_VERSION) + ".");
+
+	//data
+	QByteArray compressed;
+	stream >> compressed;
+	if (stream.status()!=QDataStream::Ok) THROW(FileParseException, "Could not read genotype matrix file '" + filename + "'!");
+	QByteArray payload = qUncompress(compressed);
+	compressed.clear();
+
+	QDataStream data_stream(payload);
+	data_stream >> max_ngsd_count_ >> last_update_ >> ps_ids_;
+	data_stream >> chrs_ >> chr_offsets_ >> variant_ids_ >> starts_ >> ends_ >> refs_ >> obs_ >> gnomad_ >> cadd_ >> spliceai_ >> ngsd_counts_;
+	data_stream >> offsets_ >> entry_ps_ids_ >> entry_genotypes_;
+	if (data_stream.status()!=QDataStream::Ok || offsets_.count()!=variant_ids_.count()+1) THROW(FileParseException, "Genotype matrix file '" + filename + "' is corrupt!");
+
+	initHelperData();
+}
+
+void GenotypeMatrix::store(QString filename) const
+{
+	//data
+	QByteArray payload;
+	QDataStream data_stream(&payload, QIODevice::WriteOnly);
+	data_stream << max_ngsd_count_ << last_update_ << ps_ids_;
+	data_stream << chrs_ << chr_offsets_ << variant_ids_ << starts_ << ends_ << refs_ << obs_ << gnomad_ << cadd_ << spliceai_ << ngsd_counts_;
+	data_stream << offsets_ << entry_ps_ids_ << entry_genotypes_;
+
+	//write file
+	QSharedPointer<QFile> file = Helper::openFileForWriting(filename);
+	QDataStream stream(file.data());
+	stream << FILE_MAGIC << FILE_VERSION << qCompress(payload);
+}
+
+QMap<int, Variant> GenotypeMatrix::variants(const BedFile& regions, int max_ngsd_count, double max_gnomad_af) const
+{
+	if (max_ngsd_count>max_ngsd_count_) THROW(ArgumentException, "Maximum NGSD count " + QString::number(max_ngsd_count) + " is larger than the maximum NGSD count of the genotype matrix (" + QString::number(max_ngsd_count_) + ")!");
+
+	QMap<int, Variant> output;
+	for (int r=0; r<regions.count(); ++r)
+	{
+		const BedLine& region = regions[r];
+		int c = chrs_.indexOf(region.chr().strNormalized(true));
+		if (c==-1) continue;
+
+		//find first variant that can overlap the region
+		auto it_begin = starts_.cbegin() + chr_offsets_[c];
+		auto it_end = starts_.cbegin() + chr_offsets_[c+1];
+		int i = std::lower_bound(it_begin, it_end, region.start() - max_length_) - starts_.cbegin();
+
+		for (; i<chr_offsets_[c+1] && starts_[i]<=region.end(); ++i)
+		{
+			if (ends_[i]<region.start()) continue;
+			if (ngsd_counts_[i]<1 || ngsd_counts_[i]>max_ngsd_count) continue;
+			if (!std::isnan(gnomad_[i]) && gnomad_[i]>max_gnomad_af) continue;
+
+			output.insert(variant_ids_[i], Variant(region.chr(), starts_[i], ends_[i], refs_[i], obs_[i], QByteArrayList() << toString(cadd_[i]) << toString(spliceai_[i])));
+		}
+	}
+
+	return output;
+}
+
+QMap<int, QSet<int>> GenotypeMatrix::detectedVariants(const QSet<int>& variant_ids, const QSet<int>& ps_ids, bool include_mosaic) const
+{
+	QMap<int, QSet<int>> output;
+	for (int variant_id : variant_ids)
+	{
+		int i = id2index_.value(variant_id, -1);
+		if (i==-1) continue;
+
+		for (int e=offsets_[i]; e<offsets_[i+1]; ++e)
+		{
+			if (!include_mosaic && (entry_genotypes_[e]&MOSAIC)) continue;
+			int ps_id = entry_ps_ids_[e];
+			if (!ps_ids.contains(ps_id)) continue;
+
+			output[ps_id] << variant_id;
+		}
+	}
+
+	return output;
+}
+
+QByteArray GenotypeMatrix::genotype(int variant_id, int ps_id) const
+{
+	int i = id2index_.value(variant_id, -1);
+	if (i==-1) return "";
+
+	for (int e=offsets_[i]; e<offsets_[i+1]; ++e)
+	{
+		if (entry_ps_ids_[e]==ps_id) return (entry_genotypes_[e]&HOM) ? "hom" : "het";
+	}
+
+	return "";
+}
+
+void GenotypeMatrix::loadVariantData(NGSD& db, QString conditions, QHash<int, VariantData>& output)
+{
+	SqlQuery query = db.getQuery();
+	query.setForwardOnly(true);
+	query.exec("SELECT v.id, v.chr, v.start, v.end, v.ref, v.obs, v.gnomad, v.cadd, v.spliceai, v.germline_het+v.germline_hom FROM variant v WHERE " + conditions);
+	while (query.next())
+	{
+		VariantData var;
+		var.id = query.value(0).toInt();
+		var.chr = Chromosome(query.value(1).toByteArray());
+		var.start = query.value(2).toInt();
+		var.end = query.value(3).toInt();
+		var.ref = query.value(4).toByteArray();
+		var.obs = query.value(5).toByteArray();
+		var.gnomad = toFloat(query.value(6));
+		var.cadd = toFloat(query.value(7));
+		var.spliceai = toFloat(query.value(8));
+		var.ngsd_count = query.value(9).toInt();
+		output[var.id] = var;
+	}
+}
+
+void GenotypeMatrix::setData(QList<VariantData> data)
+{
+	//sort variants by position
+	std::sort(data.begin(), data.end(), [](const VariantData& a, const VariantData& b)
+	{
+		if (a.chr!=b.chr) return a.chr<b.chr;
+		if (a.start!=b.start) return a.start<b.start;
+		if (a.end!=b.end) return a.end<b.end;
+		if (a.ref!=b.ref) return a.ref<b.ref;
+		return a.obs<b.obs;
+	});
+
+	//clear
+	chrs_.clear();
+	chr_offsets_.clear();
+	variant_ids_.clear();
+	starts_.clear();
+	ends_.clear();
+	refs_.clear();
+	obs_.clear();
+	gnomad_.clear();
+	cadd_.clear();
+	spliceai_.clear();
+	ngsd_counts_.clear();
+	offsets_.clear();
+	entry_ps_ids_.clear();
+	entry_genotypes_.clear();
+
+	//convert
+	offsets_ << 0;
+	for (int i=0; i<data.count(); ++i)
+	{
+		VariantData& var = data[i];
+
+		QByteArray chr = var.chr.strNormalized(true);
+		if (chrs_.isEmpty() || chrs_.last()!=chr)
+		{
+			chrs_ << chr;
+			chr_offsets_ << i;
+		}
+		variant_ids_ << var.id;
+		starts_ << var.start;
+		ends_ << var.end;
+		refs_ << var.ref;
+		obs_ << var.obs;
+		gnomad_ << var.gnomad;
+		cadd_ << var.cadd;
+		spliceai_ << var.spliceai;
+		ngsd_counts_ << var.ngsd_count;
+
+		std::sort(var.entries.begin(), var.entries.end());
+		for (const QPair<int, quint8>& entry : std::as_const(var.entries))
+		{
+			entry_ps_ids_ << entry.first;
+			entry_genotypes_ << entry.second;
+		}
+		offsets_ << entry_ps_ids_.count();
+	}
+	chr_offsets_ << data.count();
+
+	initHelperData();
+}
+
+QList<GenotypeMatrix::VariantData> GenotypeMatrix::getData() const
+{
+	QList<VariantData> output;
+	output.reserve(variant_ids_.count());
+	for (int c=0; c<chrs_.count(); ++c)
+	{
+		Chromosome chr(chrs_[c]);
+		for (int i=chr_offsets_[c]; i<chr_offsets_[c+1]; ++i)
+		{
+			VariantData var;
+			var.id = variant_ids_[i];
+			var.chr = chr;
+			var.start = starts_[i];
+			var.end = ends_[i];
+			var.ref = refs_[i];
+			var.obs = obs_[i];
+			var.gnomad = gnomad_[i];
+			var.cadd = cadd_[i];
+			var.spliceai = spliceai_[i];
+			var.ngsd_count = ngsd_counts_[i];
+			for (int e=offsets_[i]; e<offsets_[i+1]; ++e)
+			{
+				var.entries << QPair<int, quint8>(entry_ps_ids_[e], entry_genotypes_[e]);
+			}
+			output << var;
+		}
+	}
+
+	return output;
+}
+
+void GenotypeMatrix::initHelperData()
+{
+	id2index_.clear();
+	id2index_.reserve(variant_ids_.count());
+	max_length_ = 0;
+	for (int i=0; i<variant_ids_.count(); ++i)
+	{
+		id2index_[variant_ids_[i]] = i;
+		max_length_ = std::max(max_length_, ends_[i]-starts_[i]);
+	}
+}
+
+float GenotypeMatrix::toFloat(const QVariant& value)
+{
+	if (value.isNull()) return std::numeric_limits<float>::quiet_NaN();
+
+	return value.toFloat();
+}
+
+QByteArray GenotypeMatrix::toString(float value)
+{
+	if (std::isnan(value)) return "";
+
+	return QByteArray::number(value);
+}
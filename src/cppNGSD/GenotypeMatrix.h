@@ -0,0 +1,133 @@
+#ifndef GENOTYPEMATRIX_H
+#define GENOTYPEMATRIX_H
+
+#include "cppNGSD_global.h"
+#include "NGSD.h"
+#include <QTextStream>
+
+///Sparse sample-by-variant genotype matrix of rare germline variants exported from the NGSD.
+///Variants are stored in variant-major compressed sparse row (CSR) format, i.e. sorted by position with one contiguous block of (processed sample, genotype) entries per variant.
+///The matrix is read-only after creation/loading and can be shared between threads, e.g. by the workers of a gene burden test.
+class CPPNGSDSHARED_EXPORT GenotypeMatrix
+{
+public:
+	///Constructor.
+	GenotypeMatrix();
+
+	///Creates the matrix from the NGSD. Only variants detected in at least one and in at most 'max_ngsd_count' samples are contained.
+	void createFromNGSD(NGSD& db, int max_ngsd_count, QTextStream* debug_out = nullptr);
+	///Appends processed samples that were imported into the NGSD after the creation of the matrix. Returns the number of appended samples.
+	///Variants whose NGSD count exceeds the maximum NGSD count because of the new samples are removed, the NGSD counts of the other variants of the new samples are updated.
+	///Note: samples already contained in the matrix are not updated. Use a full export to reflect re-imported samples.
+	int appendNewSamples(NGSD& db, QTextStream* debug_out = nullptr);
+
+	///Loads the matrix from a binary file.
+	void load(QString filename);
+	///Stores the matrix as compressed binary file.
+	void store(QString filename) const;
+
+	///Returns the maximum NGSD count used for creating the matrix.
+	int maxNgsdCount() const
+	{
+		return max_ngsd_count_;
+	}
+	///Returns the creation/last update date of the matrix.
+	QDateTime lastUpdate() const
+	{
+		return last_update_;
+	}
+	///Returns the number of variants.
+	int variantCount() const
+	{
+		return variant_ids_.count();
+	}
+	///Returns the number of processed samples.
+	int sampleCount() const
+	{
+		return ps_ids_.count();
+	}
+	///Returns the number of non-zero entries, i.e. of detected variants.
+	int entryCount() const
+	{
+		return entry_ps_ids_.count();
+	}
+	///Returns if the matrix contains the processed sample.
+	bool containsSample(int ps_id) const
+	{
+		return ps_ids_.contains(ps_id);
+	}
+
+	///Returns the NGSD variants overlapping the regions. The variants contain the annotations CADD and SpliceAI (in that order, empty if not set in NGSD).
+	///Variants are filtered by NGSD count (only variants with count>0 and count<=max_ngsd_count) and gnomAD allele frequency (no gnomAD AF or AF<=max_gnomad_af).
+	QMap<int, Variant> variants(const BedFile& regions, int max_ngsd_count, double max_gnomad_af) const;
+	///Returns the variant IDs (values) detected in each processed sample (keys). Only the given variants and processed samples are considered.
+	QMap<int, QSet<int>> detectedVariants(const QSet<int>& variant_ids, const QSet<int>& ps_ids, bool include_mosaic) const;
+	///Returns the genotype ('het' or 'hom') of a variant in a processed sample, or an empty string if the variant was not detected in the sample.
+	QByteArray genotype(int variant_id, int ps_id) const;
+
+protected:
+	//meta data
+	int max_ngsd_count_;
+	QDateTime last_update_;
+	QSet<int> ps_ids_;
+
+	//variant attributes (sorted by chromosome and start position)
+	QByteArrayList chrs_;
+	QVector<int> chr_offsets_;
+	QVector<int> variant_ids_;
+	QVector<int> starts_;
+	QVector<int> ends_;
+	QByteArrayList refs_;
+	QByteArrayList obs_;
+	QVector<float> gnomad_;
+	QVector<float> cadd_;
+	QVector<float> spliceai_;
+	QVector<int> ngsd_counts_;
+
+	//genotype entries (CSR format - entries of variant i are in range [offsets_[i], offsets_[i+1]))
+	QVector<int> offsets_;
+	QVector<int> entry_ps_ids_;
+	QVector<quint8> entry_genotypes_;
+
+	//helper data (not stored)
+	QHash<int, int> id2index_;
+	int max_length_;
+
+	//genotype encoding in 'entry_genotypes_'
+	enum GenotypeFlags : quint8
+	{
+		HOM = 0x1,
+		MOSAIC = 0x2
+	};
+
+	///Single variant with its entries - used during creation/update of the matrix.
+	struct VariantData
+	{
+		int id;
+		Chromosome chr;
+		int start;
+		int end;
+		QByteArray ref;
+		QByteArray obs;
+		float gnomad;
+		float cadd;
+		float spliceai;
+		int ngsd_count;
+		QVector<QPair<int, quint8>> entries;
+	};
+	///Loads data of variants matching the SQL conditions (on table 'variant' with alias 'v') from the NGSD. Genotype entries are not loaded.
+	static void loadVariantData(NGSD& db, QString conditions, QHash<int, VariantData>& output);
+	///Converts variant data to matrix representation.
+	void setData(QList<VariantData> data);
+	///Converts the matrix representation back to variant data.
+	QList<VariantData> getData() const;
+	///Initializes helper data structures.
+	void initHelperData();
+
+	///Converts a nullable database value to float (NaN for NULL).
+	static float toFloat(const QVariant& value);
+	///Converts a float (NaN for NULL) to the string representation of a nullable database value.
+	static QByteArray toString(float value);
+};
+
+#endif // GENOTYPEMATRIX_H
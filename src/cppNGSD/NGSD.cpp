@@ -1690,6 +1690,259 @@ QList<int> NGSD::addVariants(const VariantList& variant_list, double max_af, int
 	return output;
 }
 
+QList<int> NGSD::addVariantsBatched(const VariantList& variant_list, double max_af, int& c_add, int& c_update, int batch_size, QStringList* timings)
+{
+	if (batch_size<1) THROW(ArgumentException, "Invalid batch size " + QString::number(batch_size) + " for batched variant import!");
+
+	//variant data needed for import (parsed from annotations)
+	struct VariantImportData
+	{
+		int index;
+		QByteArray chr;
+		QByteArray key;
+		QByteArray gnomad;
+		QByteArray coding;
+		QByteArray cadd;
+		double spliceai;
+		QByteArrayList pubmed_ids;
+	};
+	//variant data stored in NGSD
+	struct VariantDbData
+	{
+		int id;
+		QByteArray gnomad;
+		QByteArray coding;
+		QByteArray cadd;
+		QByteArray spliceai;
+	};
+
+	QElapsedTimer timer;
+	qint64 ms_parse = 0;
+	qint64 ms_select = 0;
+	qint64 ms_insert = 0;
+	qint64 ms_update = 0;
+	qint64 ms_pubmed = 0;
+
+	//get annotated column indices
+	int i_gnomad = variant_list.annotationIndexByName("gnomAD");
+	int i_co_sp = variant_list.annotationIndexByName("coding_and_splicing");
+	int i_cadd = variant_list.annotationIndexByName("CADD");
+	int i_spliceai = variant_list.annotationIndexByName("SpliceAI");
+	int i_pubmed = variant_list.annotationIndexByName("PubMed", true, false);
+
+	//unique key of a variant (same columns as unique index of 'variant' table)
+	auto variantKey = [](const QByteArray& chr, int start, int end, const QByteArray& ref, const QByteArray& obs)
+	{
+		return chr + '\t' + QByteArray::number(start) + '\t' + QByteArray::number(end) + '\t' + ref + '\t' + obs;
+	};
+
+	//looks up the variants of one chromosome and the given start positions
+	auto lookup = [&](const QByteArray& chr, const QSet<int>& starts, QHash<QByteArray, VariantDbData>& output)
+	{
+		QStringList start_strs;
+		foreach(int start, starts)
+		{
+			start_strs << QString::number(start);
+		}
+
+		SqlQuery q_id = getQuery();
+		q_id.prepare("SELECT id, start, end, ref, obs, gnomad, coding, cadd, spliceai FROM variant WHERE chr=:0 AND start IN (" + start_strs.join(",") + ")");
+		q_id.bindValue(0, chr);
+		q_id.exec();
+		while (q_id.next())
+		{
+			QByteArray key = variantKey(chr, q_id.value(1).toInt(), q_id.value(2).toInt(), q_id.value(3).toByteArray(), q_id.value(4).toByteArray());
+			output[key] = VariantDbData{q_id.value(0).toInt(), q_id.value(5).toByteArray(), q_id.value(6).toByteArray(), q_id.value(7).toByteArray(), q_id.value(8).toByteArray()};
+		}
+	};
+
+	//inserts/updates several variants with one statement
+	auto insertMultiRow = [&](const QList<const VariantImportData*>& rows, bool update)
+	{
+		if (rows.isEmpty()) return;
+
+		QStringList placeholders;
+		for (int r=0; r<rows.count(); ++r)
+		{
+			placeholders << "(?,?,?,?,?,?,?,?,?)";
+		}
+
+		SqlQuery q_insert = getQuery(); //use binding (user input)
+		QString on_duplicate = update ? "gnomad=VALUES(gnomad), coding=VALUES(coding), cadd=VALUES(cadd), spliceai=VALUES(spliceai)" : "id=id";
+		q_insert.prepare("INSERT INTO variant (chr, start, end, ref, obs, gnomad, coding, cadd, spliceai) VALUES " + placeholders.join(",") + " ON DUPLICATE KEY UPDATE " + on_duplicate);
+		foreach(const VariantImportData* data, rows)
+		{
+			const Variant& variant = variant_list[data->index];
+			q_insert.addBindValue(data->chr);
+			q_insert.addBindValue(variant.start());
+			q_insert.addBindValue(variant.end());
+			q_insert.addBindValue(variant.ref());
+			q_insert.addBindValue(variant.obs());
+			q_insert.addBindValue(data->gnomad.isEmpty() ? QVariant() : data->gnomad);
+			q_insert.addBindValue(data->coding);
+			q_insert.addBindValue(data->cadd.isEmpty() ? QVariant() : data->cadd);
+			q_insert.addBindValue(data->spliceai<0 ? QVariant() : data->spliceai);
+		}
+		q_insert.exec();
+	};
+
+	//process one batch of variants (all on the same chromosome)
+	QList<int> output;
+	output.reserve(variant_list.count());
+	for (int i=0; i<variant_list.count(); ++i) output << -1;
+	auto processBatch = [&](const QList<VariantImportData>& batch)
+	{
+		if (batch.isEmpty()) return;
+		const QByteArray& chr = batch.first().chr;
+
+		//determine existing variants
+		timer.start();
+		QSet<int> starts;
+		foreach(const VariantImportData& data, batch)
+		{
+			starts << variant_list[data.index].start();
+		}
+		QHash<QByteArray, VariantDbData> key2db;
+		lookup(chr, starts, key2db);
+		ms_select += timer.elapsed();
+
+		//determine variants to insert/update
+		QList<const VariantImportData*> inserts;
+		QList<const VariantImportData*> updates;
+		QSet<QByteArray> keys_handled;
+		for (int b=0; b<batch.count(); ++b)
+		{
+			const VariantImportData& data = batch[b];
+			if (keys_handled.contains(data.key)) continue;
+			keys_handled << data.key;
+
+			if (key2db.contains(data.key)) //update (common case)
+			{
+				//check if variant meta data needs to be updated
+				const VariantDbData& db_data = key2db[data.key];
+				if (db_data.gnomad.toDouble()!=data.gnomad.toDouble() //numeric comparison (NULL > "" > 0.0)
+					|| db_data.coding!=data.coding
+					|| db_data.cadd.toDouble()!=data.cadd.toDouble() //numeric comparison (NULL > "" > 0.0)
+					|| db_data.spliceai.toDouble()!=std::max(0.0, data.spliceai) //numeric comparison (NULL > "" > 0.0); no SpliceAI leads to a score of -1, so we use max to set it to 0.
+					)
+				{
+					updates << &data;
+				}
+			}
+			else //insert (rare case)
+			{
+				inserts << &data;
+			}
+		}
+
+		//update variants
+		timer.start();
+		insertMultiRow(updates, true);
+		c_update += updates.count();
+		ms_update += timer.elapsed();
+
+		//insert variants and determine IDs of inserted variants. Note: we cannot use 'lastInsertId()' because other imports might insert the same variants concurrently.
+		timer.start();
+		insertMultiRow(inserts, false);
+		c_add += inserts.count();
+		if (!inserts.isEmpty())
+		{
+			QSet<int> starts_inserted;
+			foreach(const VariantImportData* data, inserts)
+			{
+				starts_inserted << variant_list[data->index].start();
+			}
+			lookup(chr, starts_inserted, key2db);
+		}
+		ms_insert += timer.elapsed();
+
+		//store IDs
+		timer.start();
+		foreach(const VariantImportData& data, batch)
+		{
+			if (!key2db.contains(data.key)) THROW(DatabaseException, "Variant " + variant_list[data.index].toString() + " not found in NGSD after batched import!");
+			int id = key2db[data.key].id;
+			output[data.index] = id;
+
+			foreach (const QByteArray& pubmed_id, data.pubmed_ids)
+			{
+				if (pubmed_id.isEmpty()) continue;
+				addPubmedId(id, pubmed_id);
+			}
+		}
+		ms_pubmed += timer.elapsed();
+	};
+
+	c_add = 0;
+	c_update = 0;
+	transaction();
+	try
+	{
+		QList<VariantImportData> batch;
+		for (int i=0; i<variant_list.count(); ++i)
+		{
+			timer.start();
+			const Variant& variant = variant_list[i];
+
+			//skip variants over 500 bases length - the unique index of the variant table does not work for those
+			if (variant.ref().size()>MAX_VARIANT_SIZE || variant.obs().size()>MAX_VARIANT_SIZE) continue;
+
+			//skip variants with too high AF
+			QByteArray gnomad = variant.annotations()[i_gnomad].trimmed();
+			if (gnomad=="n/a") gnomad.clear();
+			if (!gnomad.isEmpty() && gnomad.toDouble()>max_af) continue;
+
+			VariantImportData data;
+			data.index = i;
+			data.chr = variant.chr().strNormalized(true);
+			data.key = variantKey(data.chr, variant.start(), variant.end(), variant.ref(), variant.obs());
+			data.gnomad = gnomad;
+			data.cadd = variant.annotations()[i_cadd].trimmed();
+			data.spliceai = NGSHelper::maxSpliceAiScore(variant.annotations()[i_spliceai]);
+			if (i_pubmed > 0) data.pubmed_ids = variant.annotations()[i_pubmed].split(',');
+
+			//prepare string inserted into 'coding' field (we need only gene name, ENST number, variant type and and variant impact in NGSD)
+			QByteArrayList entries = variant.annotations()[i_co_sp].split(',');
+			foreach(const QByteArray& entry, entries)
+			{
+				QByteArrayList parts = entry.split(':');
+				if (parts.count()<4) continue;
+
+				if (!data.coding.isEmpty()) data.coding += ",";
+				data.coding += parts.mid(0, 4).join(':');
+			}
+			ms_parse += timer.elapsed();
+
+			//process batch if it is full or the chromosome changes
+			if (batch.count()>=batch_size || (!batch.isEmpty() && batch.first().chr!=data.chr))
+			{
+				processBatch(batch);
+				batch.clear();
+			}
+			batch << data;
+		}
+		processBatch(batch);
+
+		commit();
+	}
+	catch(...)
+	{
+		rollback();
+		throw;
+	}
+
+	if (timings!=nullptr)
+	{
+		(*timings) << ("parsing variant annotations took: " + Helper::elapsedTime(ms_parse));
+		(*timings) << ("looking up existing variants took: " + Helper::elapsedTime(ms_select));
+		(*timings) << ("inserting new variants took: " + Helper::elapsedTime(ms_insert));
+		(*timings) << ("updating variant meta data took: " + Helper::elapsedTime(ms_update));
+		(*timings) << ("storing variant IDs/PubMed IDs took: " + Helper::elapsedTime(ms_pubmed));
+	}
+
+	return output;
+}
+
 QString NGSD::variantId(const Variant& variant, bool throw_if_fails)
 {
 	SqlQuery query = getQuery(); //use binding user input (safety)
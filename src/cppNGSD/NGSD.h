@@ -901,6 +901,8 @@ public:
 	QString addVariant(const Variant& variant, const VariantList& variant_list);
 	///Adds all missing variants to the NGSD and returns the variant DB identifiers (or -1 if the variant was skipped due to 'max_af' or because it is over 500 bases long)
 	QList<int> addVariants(const VariantList& variant_list, double max_af, int& c_add, int& c_update);
+	///Batched version of addVariants(): resolves/inserts/updates variants with multi-row statements (up to 'batch_size' variants of one chromosome per statement) inside one transaction. If 'timings' is given, per-phase timing information is appended.
+	QList<int> addVariantsBatched(const VariantList& variant_list, double max_af, int& c_add, int& c_update, int batch_size, QStringList* timings = nullptr);
 	///Returns the NGSD ID for a variant. Returns '' or throws an exception if the ID cannot be determined.
 	QString variantId(const Variant& variant, bool throw_if_fails = true);
 	///Returns the variant corresponding to the given identifier or throws an exception if the ID does not exist.
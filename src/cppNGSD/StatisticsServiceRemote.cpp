@@ -1,6 +1,9 @@
 #include "StatisticsServiceRemote.h"
 #include "ApiCaller.h"
 #include "Exceptions.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
 
 StatisticsServiceRemote::StatisticsServiceRemote()	
 {
@@ -11,7 +14,7 @@ BedFile StatisticsServiceRemote::lowCoverage(const BedFile& bed_file, const QStr
 	BedFile output;
 	QStringList bam_file_parts = bam_file.split("/");
 	if (bam_file_parts.count()<=1) THROW(ArgumentException, "BAM file URL id is missing");
-    output = output.fromText(ApiCaller().post("low_coverage_regions", RequestUrlParams(), HttpHeaders(), QString("roi="+bed_file.toText().toUtf8()+"&bam_url_id="+bam_file_parts[bam_file_parts.count()-2]+"&cutoff="+QString::number(cutoff)).toUtf8(), true, false, true));
+	output = output.fromText(runCoverageJob("low_coverage_regions", QString("roi="+bed_file.toText().toUtf8()+"&bam_url_id="+bam_file_parts[bam_file_parts.count()-2]+"&cutoff="+QString::number(cutoff)).toUtf8()));
 
 	return output;
 }
@@ -20,14 +23,37 @@ void StatisticsServiceRemote::avgCoverage(BedFile& bed_file, const QString& bam_
 {
 	QStringList bam_file_parts = bam_file.split("/");
 	if (bam_file_parts.count()<=1) THROW(ArgumentException, "BAM file URL id is missing");
-    bed_file = bed_file.fromText(ApiCaller().post("avg_coverage_gaps", RequestUrlParams(), HttpHeaders(), QString("roi="+bed_file.toText().toUtf8()+"&bam_url_id="+bam_file_parts[bam_file_parts.count()-2]).toUtf8(), true, false, true));
+	bed_file = bed_file.fromText(runCoverageJob("avg_coverage_gaps", QString("roi="+bed_file.toText().toUtf8()+"&bam_url_id="+bam_file_parts[bam_file_parts.count()-2]).toUtf8()));
 }
 
 double StatisticsServiceRemote::targetRegionReadDepth(const BedFile& bed_file, const QString& bam_file, int /*threads*/) const //number of threads is taken from the server config INI
 {
 	QStringList bam_file_parts = bam_file.split("/");
 	if (bam_file_parts.count()<=1) THROW(ArgumentException, "BAM file URL id is missing");
-    QByteArray response = ApiCaller().post("target_region_read_depth", RequestUrlParams(), HttpHeaders(), QString("roi="+bed_file.toText().toUtf8()+"&bam_url_id="+bam_file_parts[bam_file_parts.count()-2]).toUtf8(), true, false, true);
+	QByteArray response = runCoverageJob("target_region_read_depth", QString("roi="+bed_file.toText().toUtf8()+"&bam_url_id="+bam_file_parts[bam_file_parts.count()-2]).toUtf8());
 
 	return response.toDouble();
 }
+
+QByteArray StatisticsServiceRemote::runCoverageJob(QString api_path, const QByteArray& data) const
+{
+	//start the calculation on the server (or get the result, if it has been calculated before)
+	QJsonObject job = QJsonDocument::fromJson(ApiCaller().post(api_path, RequestUrlParams(), HttpHeaders(), data + "&async=true", true, false, true)).object();
+
+	//poll for the result
+	int poll_interval = 250;
+	while (true)
+	{
+		QString status = job.value("status").toString();
+		if (status=="finished") return job.value("result").toString().toUtf8();
+		if (status=="failed") THROW(Exception, "Coverage calculation failed on the server: " + job.value("error").toString());
+		if (status!="queued" && status!="running") THROW(Exception, "Unexpected status of the coverage calculation on the server: " + status);
+
+		QThread::msleep(poll_interval);
+		poll_interval = qMin(2 * poll_interval, 2000);
+
+		RequestUrlParams params;
+		params.insert("id", job.value("id").toString().toUtf8());
+		job = QJsonDocument::fromJson(ApiCaller().get("coverage_job", params, HttpHeaders(), true, false, true)).object();
+	}
+}
@@ -13,6 +13,10 @@ public:
 	virtual BedFile lowCoverage(const BedFile& bed_file, const QString& bam_file, int cutoff) const override;
 	virtual void avgCoverage(BedFile& bed_file, const QString& bam_file, int threads) const override;
 	virtual double targetRegionReadDepth(const BedFile& bed_file, const QString& bam_file, int threads) const override;
+
+protected:
+	//Runs a coverage calculation on the server and polls for the result (the calculation is not bound to the request)
+	QByteArray runCoverageJob(QString api_path, const QByteArray& data) const;
 };
 
 #endif // STATISTICSSERVICEREMOTE_H
@@ -36,6 +36,7 @@ SOURCES += \
     FileLocationProviderLocal.cpp \
     FileLocationProviderRemote.cpp \
     GeneBurdenTest.cpp \
+    GenotypeMatrix.cpp \
     SqlQuery.cpp\
     NGSD.cpp \
     GenLabDB.cpp \
@@ -63,6 +64,7 @@ HEADERS += \
     FileLocationProviderLocal.h \
     FileLocationProviderRemote.h \
     GeneBurdenTest.h \
+    GenotypeMatrix.h \
     SqlQuery.h \
     NGSD.h \
     GenLabDB.h \
@@ -0,0 +1,79 @@
+#include "TestFramework.h"
+#include "EndpointManager.h"
+#include "EndpointMetrics.h"
+#include <QJsonObject>
+#include <QJsonArray>
+
+TEST_CLASS(EndpointMetrics_Test)
+{
+private:
+	static HttpResponse emptyAction(const HttpRequest& /*request*/)
+	{
+		return HttpResponse();
+	}
+
+	TEST_METHOD(test_endpoint_routing)
+	{
+		EndpointManager::appendEndpoint(Endpoint{"Routing_Test", QMap<QString, ParamProps>{}, RequestMethod::GET, ContentType::TEXT_PLAIN, AuthType::NONE, "GET routing test", &emptyAction});
+		EndpointManager::appendEndpoint(Endpoint{"routing_test", QMap<QString, ParamProps>{}, RequestMethod::POST, ContentType::TEXT_PLAIN, AuthType::NONE, "POST routing test", &emptyAction});
+
+		Endpoint endpoint = EndpointManager::getEndpointByUrlAndMethod("routing_test", RequestMethod::GET);
+		S_EQUAL(endpoint.comment, "GET routing test");
+		endpoint = EndpointManager::getEndpointByUrlAndMethod("/ROUTING_TEST/", RequestMethod::POST);
+		S_EQUAL(endpoint.comment, "POST routing test");
+		endpoint = EndpointManager::getEndpointByUrlAndMethod("routing_test", RequestMethod::DELETE);
+		IS_TRUE(endpoint.action_func==nullptr);
+		endpoint = EndpointManager::getEndpointByUrlAndMethod("routing", RequestMethod::GET);
+		IS_TRUE(endpoint.action_func==nullptr);
+
+		QList<Endpoint> endpoints = EndpointManager::getEndpointsByUrl("routing_test");
+		I_EQUAL(endpoints.count(), 2);
+		S_EQUAL(endpoints[0].comment, "GET routing test");
+		S_EQUAL(endpoints[1].comment, "POST routing test");
+
+		//same endpoint again is ignored, same URL and method with different parameters is an error
+		EndpointManager::appendEndpoint(Endpoint{"Routing_Test", QMap<QString, ParamProps>{}, RequestMethod::GET, ContentType::TEXT_PLAIN, AuthType::NONE, "GET routing test", &emptyAction});
+		I_EQUAL(EndpointManager::getEndpointsByUrl("routing_test").count(), 2);
+		IS_THROWN(ProgrammingException, EndpointManager::appendEndpoint(Endpoint{"routing_test", QMap<QString, ParamProps>{{"id", ParamProps{ParamProps::ParamCategory::PATH_PARAM, false, "ID"}}}, RequestMethod::GET, ContentType::TEXT_PLAIN, AuthType::NONE, "duplicate", &emptyAction}));
+	}
+
+	TEST_METHOD(test_endpoint_statistics)
+	{
+		EndpointMetrics::clear();
+		I_EQUAL(EndpointMetrics::statistics().count(), 0);
+
+		EndpointMetrics::addRequest("bam", RequestMethod::GET, 200, 0, 1000, 3);
+		EndpointMetrics::addRequest("bam", RequestMethod::GET, 206, 0, 500, 40);
+		EndpointMetrics::addRequest("bam", RequestMethod::GET, 404, 0, 20, 60000);
+		EndpointMetrics::addRequest("bam", RequestMethod::HEAD, 200, 0, 0, 1);
+		EndpointMetrics::addRequest("upload", RequestMethod::POST, 200, 2048, 10, 120);
+
+		QList<EndpointStatistics> stats = EndpointMetrics::statistics();
+		I_EQUAL(stats.count(), 3);
+		S_EQUAL(stats[0].url, "bam");
+		IS_TRUE(stats[0].method==RequestMethod::GET);
+		I_EQUAL(stats[0].requests, 3);
+		I_EQUAL(stats[0].errors, 1);
+		I_EQUAL(stats[0].bytes_out, 1520);
+		I_EQUAL(stats[0].total_time_ms, 60043);
+		I_EQUAL(stats[0].max_time_ms, 60000);
+		I_EQUAL(stats[0].latency_histogram.count(), EndpointMetrics::latencyBuckets().count()+1);
+		I_EQUAL(stats[0].latency_histogram[0], 1);
+		I_EQUAL(stats[0].latency_histogram[3], 1);
+		I_EQUAL(stats[0].latency_histogram.last(), 1);
+		I_EQUAL(stats[0].latencyPercentile(0.5), 50);
+		I_EQUAL(stats[0].latencyPercentile(0.99), 60000);
+		IS_TRUE(stats[1].method==RequestMethod::HEAD);
+		S_EQUAL(stats[2].url, "upload");
+		I_EQUAL(stats[2].bytes_in, 2048);
+		I_EQUAL(stats[2].latencyPercentile(0.5), 120);
+
+		QJsonObject json = EndpointMetrics::statisticsAsJson().object();
+		I_EQUAL(json["endpoints"].toArray().count(), 3);
+		S_EQUAL(json["endpoints"].toArray()[2].toObject()["method"].toString(), "POST");
+		I_EQUAL(json["endpoints"].toArray()[0].toObject()["requests"].toInt(), 3);
+
+		EndpointMetrics::clear();
+		I_EQUAL(EndpointMetrics::statistics().count(), 0);
+	}
+};
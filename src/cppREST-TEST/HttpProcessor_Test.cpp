@@ -1,5 +1,9 @@
 #include "TestFramework.h"
 #include "HttpUtils.h"
+#include "HttpResponse.h"
+#include "GzipCompressor.h"
+#include <zlib.h>
+#include <QTimeZone>
 
 TEST_CLASS(HttpProcessor_Test)
 {
@@ -312,4 +316,180 @@ private:
 		code = HttpUtils::convertResponseStatusToStatusCodeNumber(ResponseStatus::UNKNOWN_STATUS_CODE);
 		I_EQUAL(code, 0);
 	}
+
+	TEST_METHOD(test_acceptsGzip)
+	{
+		IS_TRUE(HttpUtils::acceptsGzip(QList<QString>() << "gzip" << "deflate"));
+		IS_TRUE(HttpUtils::acceptsGzip(QList<QString>() << "deflate" << "GZIP;q=0.5"));
+		IS_TRUE(HttpUtils::acceptsGzip(QList<QString>() << "*"));
+		IS_FALSE(HttpUtils::acceptsGzip(QList<QString>() << "gzip;q=0"));
+		IS_FALSE(HttpUtils::acceptsGzip(QList<QString>() << "br" << "deflate"));
+		IS_FALSE(HttpUtils::acceptsGzip(QList<QString>()));
+	}
+
+	TEST_METHOD(test_convertHttpDate)
+	{
+		QDateTime date_time(QDate(1994, 11, 6), QTime(8, 49, 37), QTimeZone::utc());
+		S_EQUAL(HttpUtils::convertDateTimeToHttpDate(date_time), "Sun, 06 Nov 1994 08:49:37 GMT");
+		IS_TRUE(HttpUtils::convertHttpDateToDateTime("Sun, 06 Nov 1994 08:49:37 GMT")==date_time);
+		IS_FALSE(HttpUtils::convertHttpDateToDateTime("yesterday").isValid());
+	}
+
+	TEST_METHOD(test_createGzipEtag)
+	{
+		S_EQUAL(HttpUtils::createGzipEtag("\"abc\""), "\"abc-gzip\"");
+		S_EQUAL(HttpUtils::createGzipEtag("W/\"4d2-18df9e2b200\""), "W/\"4d2-18df9e2b200-gzip\"");
+		S_EQUAL(HttpUtils::createGzipEtag("\"abc-gzip\""), "\"abc-gzip\"");
+		S_EQUAL(HttpUtils::createGzipEtag(""), "");
+
+		//the identity representation is not valid for the compressed one
+		QByteArray etag = HttpUtils::createEtag(QByteArray("content"));
+		IS_FALSE(HttpUtils::isNotModified(QList<QString>() << etag, QList<QString>(), HttpUtils::createGzipEtag(etag), QDateTime()));
+		IS_TRUE(HttpUtils::isNotModified(QList<QString>() << HttpUtils::createGzipEtag(etag), QList<QString>(), HttpUtils::createGzipEtag(etag), QDateTime()));
+	}
+
+	TEST_METHOD(test_isNotModified)
+	{
+		QDateTime modified(QDate(2024, 3, 1), QTime(12, 0, 0), QTimeZone::utc());
+		QByteArray etag = HttpUtils::createEtag(1234, modified);
+		S_EQUAL(etag, "W/\"4d2-18df9e2b200\"");
+
+		//If-None-Match
+		IS_TRUE(HttpUtils::isNotModified(QList<QString>() << etag, QList<QString>(), etag, modified));
+		IS_TRUE(HttpUtils::isNotModified(QList<QString>() << "\"bla\"" << "\"4d2-18df9e2b200\"", QList<QString>(), etag, modified));
+		IS_TRUE(HttpUtils::isNotModified(QList<QString>() << "*", QList<QString>(), etag, modified));
+		IS_FALSE(HttpUtils::isNotModified(QList<QString>() << "\"bla\"", QList<QString>(), etag, modified));
+		IS_FALSE(HttpUtils::isNotModified(QList<QString>() << etag, QList<QString>(), HttpUtils::createEtag(1235, modified), modified));
+
+		//If-Modified-Since (split at comma by the request parser)
+		IS_TRUE(HttpUtils::isNotModified(QList<QString>(), QList<QString>() << "Fri" << "01 Mar 2024 12:00:00 GMT", etag, modified));
+		IS_TRUE(HttpUtils::isNotModified(QList<QString>(), QList<QString>() << "Sat" << "02 Mar 2024 12:00:00 GMT", etag, modified));
+		IS_FALSE(HttpUtils::isNotModified(QList<QString>(), QList<QString>() << "Fri" << "01 Mar 2024 11:59:59 GMT", etag, modified));
+		IS_FALSE(HttpUtils::isNotModified(QList<QString>(), QList<QString>() << "invalid date", etag, modified));
+
+		//If-None-Match has precedence over If-Modified-Since
+		IS_FALSE(HttpUtils::isNotModified(QList<QString>() << "\"bla\"", QList<QString>() << "Sat" << "02 Mar 2024 12:00:00 GMT", etag, modified));
+
+		//no conditional headers
+		IS_FALSE(HttpUtils::isNotModified(QList<QString>(), QList<QString>(), etag, modified));
+	}
+
+	TEST_METHOD(test_coalesceByteRanges)
+	{
+		QList<ByteRange> ranges;
+		foreach(auto bounds, QList<QPair<quint64, quint64>>{{0, 99}, {100, 199}, {250, 299}, {1000, 1099}, {500, 599}})
+		{
+			ByteRange range;
+			range.start = bounds.first;
+			range.end = bounds.second;
+			range.length = bounds.second - bounds.first + 1;
+			ranges << range;
+		}
+
+		//adjacent ranges only
+		QList<ByteRange> coalesced = HttpUtils::coalesceByteRanges(ranges, 0);
+		I_EQUAL(coalesced.count(), 4);
+		I_EQUAL(coalesced[0].start, 0);
+		I_EQUAL(coalesced[0].end, 199);
+		I_EQUAL(coalesced[0].length, 200);
+		I_EQUAL(coalesced[1].start, 250);
+
+		//small gaps (the order of the ranges is kept, i.e. the last range is not merged)
+		coalesced = HttpUtils::coalesceByteRanges(ranges, 50);
+		I_EQUAL(coalesced.count(), 3);
+		I_EQUAL(coalesced[0].end, 299);
+		I_EQUAL(coalesced[0].length, 300);
+		I_EQUAL(coalesced[1].start, 1000);
+		I_EQUAL(coalesced[2].start, 500);
+
+		I_EQUAL(HttpUtils::coalesceByteRanges(QList<ByteRange>(), 50).count(), 0);
+	}
+
+	TEST_METHOD(test_GzipCompressor)
+	{
+		QByteArray input;
+		for (int i=0; i<10000; ++i)
+		{
+			input.append("chr1\t" + QByteArray::number(i*100) + "\t" + QByteArray::number(i*100+50) + "\tgene" + QByteArray::number(i%17) + "\n");
+		}
+
+		//one step
+		QByteArray compressed = GzipCompressor::gzip(input);
+		IS_TRUE(compressed.startsWith("\x1f\x8b"));
+		IS_TRUE(compressed.size() < input.size()/4);
+		S_EQUAL(gunzip(compressed), input);
+
+		//chunk by chunk
+		GzipCompressor compressor;
+		QByteArray compressed2;
+		for (int pos=0; pos<input.size(); pos+=10240)
+		{
+			compressed2.append(compressor.compress(input.mid(pos, 10240)));
+		}
+		compressed2.append(compressor.finish());
+		S_EQUAL(gunzip(compressed2), input);
+
+		//empty input
+		S_EQUAL(gunzip(GzipCompressor::gzip(QByteArray())), QByteArray());
+	}
+
+	TEST_METHOD(test_HttpResponse_compressPayload)
+	{
+		QByteArray payload = QByteArray("{\"key\": \"value\"}\n").repeated(200);
+		BasicResponseData response_data;
+		response_data.length = payload.length();
+		response_data.content_type = ContentType::APPLICATION_JSON;
+		HttpResponse response(response_data, payload);
+		S_EQUAL(response.getHeaderValue("content-length"), QByteArray::number(payload.length()));
+		S_EQUAL(response.getHeaderValue("Content-Encoding"), "");
+
+		response.insertHeader("ETag", "\"abc\"");
+		S_EQUAL(response.getHeaderValue("ETag"), "\"abc\"");
+		IS_TRUE(response.getHeaders().endsWith("ETag: \"abc\"\r\n\r\n"));
+
+		response.compressPayload();
+		IS_TRUE(response.isCompressed());
+		S_EQUAL(response.getHeaderValue("Content-Encoding"), "gzip");
+		S_EQUAL(response.getHeaderValue("Content-Length"), QByteArray::number(response.getPayload().length()));
+		S_EQUAL(response.getHeaderValue("ETag"), "\"abc-gzip\"");
+		S_EQUAL(gunzip(response.getPayload()), payload);
+		IS_TRUE(response.getHeaders().endsWith("\r\n\r\n"));
+	}
+
+	TEST_METHOD(test_HttpResponse_notModified)
+	{
+		BasicResponseData response_data;
+		response_data.status = ResponseStatus::NOT_MODIFIED;
+		response_data.etag = "\"abc\"";
+		response_data.last_modified = QDateTime(QDate(1994, 11, 6), QTime(8, 49, 37), QTimeZone::utc());
+		HttpResponse response(response_data);
+
+		I_EQUAL(response.getStatusCode(), 304);
+		S_EQUAL(response.getHeaderValue("ETag"), "\"abc\"");
+		S_EQUAL(response.getHeaderValue("Last-Modified"), "Sun, 06 Nov 1994 08:49:37 GMT");
+		S_EQUAL(response.getHeaderValue("Content-Length"), "");
+		IS_TRUE(response.getPayload().isEmpty());
+	}
+
+	static QByteArray gunzip(const QByteArray& data)
+	{
+		z_stream stream = z_stream();
+		inflateInit2(&stream, 15+16);
+		stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.constData()));
+		stream.avail_in = static_cast<uInt>(data.size());
+
+		QByteArray output;
+		char buffer[4096];
+		int result = Z_OK;
+		while (result==Z_OK)
+		{
+			stream.next_out = reinterpret_cast<Bytef*>(buffer);
+			stream.avail_out = sizeof(buffer);
+			result = inflate(&stream, Z_NO_FLUSH);
+			output.append(buffer, static_cast<int>(sizeof(buffer) - stream.avail_out));
+		}
+		inflateEnd(&stream);
+
+		return output;
+	}
 };
@@ -25,6 +25,7 @@ INCLUDEPATH += $$PWD/../../htslib/include/
 LIBS += -L$$PWD/../../htslib/lib/ -lhts
 
 SOURCES += \
+        EndpointMetrics_Test.cpp \
         FileMetaCache_Test.cpp \
         HtmlEngine_Test.cpp \
         HttpProcessor_Test.cpp \
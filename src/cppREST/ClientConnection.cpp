@@ -0,0 +1,497 @@
+#include "ClientConnection.h"
+#include "RequestWorker.h"
+#include "RequestParser.h"
+#include "EndpointManager.h"
+#include "HttpUtils.h"
+
+ClientConnection::ClientConnection(const QSslConfiguration& ssl_configuration, const RequestWorkerParams& params, QThreadPool* thread_pool, QObject* parent)
+	: QObject(parent)
+	, ssl_configuration_(ssl_configuration)
+	, params_(params)
+	, thread_pool_(thread_pool)
+	, socket_(nullptr)
+	, timer_()
+	, buffer_()
+	, pending_()
+	, current_()
+	, requester_info_()
+	, busy_(false)
+	, closing_(false)
+	, closed_(false)
+	, stream_()
+{
+	timer_.setSingleShot(true);
+	connect(&timer_, SIGNAL(timeout()), this, SLOT(handleTimeout()));
+}
+
+bool ClientConnection::start(qintptr socket_descriptor)
+{
+	socket_ = new QSslSocket(this);
+	socket_->setSslConfiguration(ssl_configuration_);
+	if (!socket_->setSocketDescriptor(socket_descriptor))
+	{
+		Log::error("Could not set a socket descriptor: " + socket_->errorString());
+		return false;
+	}
+	socket_->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+	socket_->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+	connect(socket_, SIGNAL(readyRead()), this, SLOT(readRequestData()));
+	connect(socket_, SIGNAL(bytesWritten(qint64)), this, SLOT(writeStreamData()));
+	connect(socket_, SIGNAL(encryptedBytesWritten(qint64)), this, SLOT(writeStreamData()));
+	connect(socket_, SIGNAL(disconnected()), this, SLOT(handleDisconnect()));
+	connect(socket_, SIGNAL(sslErrors(QList<QSslError>)), this, SLOT(handleSslErrors(QList<QSslError>)));
+	connect(socket_, SIGNAL(errorOccurred(QAbstractSocket::SocketError)), this, SLOT(handleSocketError(QAbstractSocket::SocketError)));
+	connect(socket_, &QSslSocket::encrypted, this, &ClientConnection::updateTimer);
+
+	socket_->startServerEncryption();
+	updateTimer();
+
+	return true;
+}
+
+void ClientConnection::readRequestData()
+{
+	if (closing_)
+	{
+		socket_->readAll();
+		return;
+	}
+
+	buffer_.append(socket_->readAll());
+	extractRequests();
+	processNextRequest();
+	updateTimer();
+}
+
+void ClientConnection::extractRequests()
+{
+	while (!closing_ && pending_.count() < params_.max_pipelined_requests)
+	{
+		// empty lines between pipelined requests are allowed
+		while (buffer_.startsWith("\r\n")) buffer_.remove(0, 2);
+
+		int header_end = buffer_.indexOf("\r\n\r\n");
+		if ((header_end == -1 && buffer_.size() > MAX_HEADER_SIZE) || header_end > MAX_HEADER_SIZE)
+		{
+			PendingRequest pending;
+			pending.keep_alive = false;
+			pending.error = "Request headers exceed the maximum size of " + QString::number(MAX_HEADER_SIZE) + " bytes";
+			pending_.enqueue(pending);
+			buffer_.clear();
+			return;
+		}
+		if (header_end == -1) return;
+
+		// check headers that are needed to separate the request from the next one
+		qint64 body_size = 0;
+		QString body_size_error;
+		ResponseStatus body_size_status = ResponseStatus::BAD_REQUEST;
+		QList<QByteArray> header_lines = buffer_.left(header_end).split('\n');
+		bool keep_alive = !header_lines[0].trimmed().toUpper().endsWith("HTTP/1.0");
+		for (int i = 1; i < header_lines.count(); ++i)
+		{
+			int separator = header_lines[i].indexOf(':');
+			if (separator == -1) continue;
+
+			QByteArray name = header_lines[i].left(separator).trimmed().toLower();
+			QByteArray value = header_lines[i].mid(separator+1).trimmed().toLower();
+			if (name == "content-length")
+			{
+				bool ok = false;
+				body_size = value.toLongLong(&ok);
+				if (!ok || body_size < 0)
+				{
+					body_size_error = "Invalid Content-Length header: " + QString(value);
+				}
+				else if (body_size > params_.max_request_body_size)
+				{
+					body_size_error = "Request body of " + QString::number(body_size) + " bytes exceeds the maximum size of " + QString::number(params_.max_request_body_size) + " bytes";
+					body_size_status = ResponseStatus::ENTITY_TOO_LARGE;
+				}
+			}
+			else if (name == "connection")
+			{
+				if (value.contains("close")) keep_alive = false;
+				else if (value.contains("keep-alive")) keep_alive = true;
+			}
+		}
+
+		// the body cannot be separated from the next request, i.e. the connection is closed after the error response
+		if (!body_size_error.isEmpty())
+		{
+			PendingRequest pending;
+			pending.keep_alive = false;
+			pending.error = body_size_error;
+			pending.error_status = body_size_status;
+			pending_.enqueue(pending);
+			buffer_.clear();
+			return;
+		}
+
+		qint64 request_size = header_end + 4 + body_size;
+		if (buffer_.size() < request_size) return;
+
+		QByteArray raw_request = buffer_.left(request_size);
+		buffer_.remove(0, request_size);
+
+		PendingRequest pending;
+		pending.keep_alive = keep_alive;
+		try
+		{
+			pending.request = RequestParser().parse(&raw_request);
+			pending.request.setRemoteAddress(socket_->peerAddress().toString());
+		}
+		catch (Exception& e)
+		{
+			pending.error = e.message();
+			pending.keep_alive = false;
+		}
+		pending_.enqueue(pending);
+
+		// requests after a 'Connection: close' request are not processed
+		if (!pending.keep_alive)
+		{
+			buffer_.clear();
+			return;
+		}
+	}
+}
+
+void ClientConnection::processNextRequest()
+{
+	if (busy_ || closing_ || pending_.isEmpty()) return;
+
+	current_ = pending_.dequeue();
+	requester_info_.clear();
+	busy_ = true;
+
+	if (!current_.error.isEmpty())
+	{
+		Log::error("Could not parse the request: " + current_.error);
+		sendResponse(HttpResponse(current_.error_status, ContentType::TEXT_HTML, current_.error));
+		return;
+	}
+
+	RequestWorker* worker = new RequestWorker(current_.request);
+	connect(worker, SIGNAL(finished(HttpResponse,QString)), this, SLOT(workerFinished(HttpResponse,QString)), Qt::QueuedConnection);
+	thread_pool_->start(worker);
+}
+
+void ClientConnection::workerFinished(HttpResponse response, QString requester_info)
+{
+	if (closing_) return;
+
+	requester_info_ = requester_info;
+	sendResponse(response);
+}
+
+void ClientConnection::sendResponse(HttpResponse response)
+{
+	if (response.isStream())
+	{
+		startStream(response);
+		return;
+	}
+
+	if ((response.getStatusCode() > 200) && (response.getStatus() != ResponseStatus::NOT_MODIFIED)) Log::warn("The server returned " + QString::number(response.getStatusCode()) + " - " + HttpUtils::convertResponseStatusToReasonPhrase(response.getStatus()));
+
+	bool is_head = current_.error.isEmpty() && (current_.request.getMethod() == RequestMethod::HEAD);
+	socket_->write(response.getStatusLine());
+	socket_->write(response.getHeaders());
+	if (!is_head) socket_->write(response.getPayload());
+
+	// the client cannot determine the end of the response, i.e. the connection has to be closed
+	if (!is_head && !hasMessageFraming(response)) current_.keep_alive = false;
+
+	finishResponse();
+}
+
+void ClientConnection::startStream(HttpResponse& response)
+{
+	QString filename = response.getFilename();
+	ContentType error_type = HttpUtils::detectErrorContentType(current_.request.getHeaderByName("User-Agent"));
+	Log::info(EndpointManager::formatResponseMessage(current_.request, "Initiating a stream: " + filename + requester_info_));
+
+	if (filename.isEmpty())
+	{
+		QString error_message = EndpointManager::formatResponseMessage(current_.request, "Streaming request contains an empty file name");
+		Log::error(error_message + requester_info_);
+		sendResponse(HttpResponse(ResponseStatus::NOT_FOUND, error_type, error_message));
+		return;
+	}
+
+	QSharedPointer<QFile> streamed_file = QSharedPointer<QFile>(new QFile(filename));
+	if (!streamed_file->exists())
+	{
+		QString error_message = EndpointManager::formatResponseMessage(current_.request, "Requested file does not exist: " + filename);
+		Log::error(error_message + requester_info_);
+		sendResponse(HttpResponse(ResponseStatus::NOT_FOUND, error_type, error_message));
+		return;
+	}
+
+	// unbuffered: the data is read directly into the buffer that is written to the socket
+	if (!streamed_file->open(QFile::ReadOnly | QFile::Unbuffered))
+	{
+		QString error_message = EndpointManager::formatResponseMessage(current_.request, "Could not open a file for streaming: " + filename);
+		Log::error(error_message + requester_info_);
+		sendResponse(HttpResponse(ResponseStatus::INTERNAL_SERVER_ERROR, error_type, error_message));
+		return;
+	}
+
+	stream_ = StreamState();
+	stream_.file = streamed_file;
+	stream_.file_size = streamed_file->size();
+	stream_.ranges = response.getByteRanges();
+	if (stream_.ranges.isEmpty())
+	{
+		// the complete file is sent with the length announced in the headers (the file metadata cache might be outdated)
+		quint64 length = stream_.file_size;
+		QByteArray content_length = response.getHeaderValue("Content-Length");
+		if (!response.isCompressed() && !content_length.isEmpty()) length = content_length.toULongLong();
+		if (length > 0)
+		{
+			ByteRange range;
+			range.start = 0;
+			range.end = length - 1;
+			range.length = length;
+			stream_.ranges << range;
+		}
+	}
+	else
+	{
+		Log::info(EndpointManager::formatResponseMessage(current_.request, QString::number(stream_.ranges.count()) + " range(-s) found in request headers: " + filename + requester_info_));
+		if (stream_.ranges.count() > 1) stream_.boundary = response.getBoundary();
+	}
+	if (response.isCompressed()) stream_.compressor = QSharedPointer<GzipCompressor>(new GzipCompressor());
+
+	socket_->write(response.getStatusLine());
+	socket_->write(response.getHeaders());
+
+	stream_.active = true;
+	writeStreamData();
+}
+
+void ClientConnection::writeStreamPart(qint64 max_bytes)
+{
+	if (stream_.range_index < stream_.ranges.count())
+	{
+		const ByteRange& range = stream_.ranges[stream_.range_index];
+		if (!stream_.range_started)
+		{
+			stream_.range_started = true;
+			stream_.pos = range.start;
+			if (!stream_.boundary.isEmpty())
+			{
+				QByteArray part_header;
+				part_header.append("--" + stream_.boundary + "\r\n");
+				part_header.append("Content-Type: application/octet-stream\r\n");
+				part_header.append("Content-Range: bytes " + QByteArray::number(range.start) + "-" + QByteArray::number(range.end) + "/" + QByteArray::number(stream_.file_size) + "\r\n");
+				part_header.append("\r\n");
+				socket_->write(part_header);
+			}
+		}
+
+		quint64 end = range.end + 1;
+		if (stream_.pos < end)
+		{
+			QByteArray data = readStreamData(qMin<quint64>(max_bytes, end - stream_.pos));
+			if (stream_.compressor)
+			{
+				socket_->write(chunk(stream_.compressor->compress(data)));
+			}
+			else
+			{
+				socket_->write(data);
+			}
+			stream_.pos += data.size();
+		}
+		if (stream_.pos < end) return;
+
+		if (!stream_.boundary.isEmpty()) socket_->write("\r\n");
+		++stream_.range_index;
+		stream_.range_started = false;
+		if (stream_.range_index < stream_.ranges.count()) return;
+	}
+
+	// all data has been sent: closing multipart delimiter or gzip trailer and last chunk
+	if (!stream_.boundary.isEmpty()) socket_->write("--" + stream_.boundary + "--\r\n");
+	if (stream_.compressor) socket_->write(chunk(stream_.compressor->finish()) + "0\r\n\r\n");
+	stream_.active = false;
+}
+
+QByteArray ClientConnection::readStreamData(qint64 max_bytes)
+{
+	if (stream_.pos >= stream_.file_size) THROW(FileAccessException, "Unexpected end of file while streaming " + stream_.file->fileName());
+
+	// the file is read instead of memory-mapped: a file that is truncated while it is streamed results in an error (a memory-mapped file would crash the server with SIGBUS)
+	if (stream_.file->pos()!=static_cast<qint64>(stream_.pos) && !stream_.file->seek(stream_.pos)) THROW(FileAccessException, "Could not seek to position " + QString::number(stream_.pos) + " in " + stream_.file->fileName());
+	QByteArray data = stream_.file->read(max_bytes);
+	if (data.isEmpty()) THROW(FileAccessException, "Unexpected end of file while streaming " + stream_.file->fileName());
+
+	return data;
+}
+
+void ClientConnection::writeStreamData()
+{
+	if (!stream_.active || closing_) return;
+
+	try
+	{
+		// data is added only when the socket buffers (plain and encrypted) drain, i.e. slow clients do not make the server buffer whole files
+		while (stream_.active)
+		{
+			qint64 buffered = socket_->bytesToWrite() + socket_->encryptedBytesToWrite();
+			if (buffered >= MAX_WRITE_BUFFER_SIZE) break;
+			writeStreamPart(MAX_WRITE_BUFFER_SIZE - buffered);
+		}
+	}
+	catch (Exception& e)
+	{
+		Log::error(EndpointManager::formatResponseMessage(current_.request, "Streaming failed: " + e.message() + requester_info_));
+		stream_ = StreamState();
+		closeConnection(true);
+		return;
+	}
+
+	if (stream_.active)
+	{
+		updateTimer();
+		return;
+	}
+
+	stream_ = StreamState();
+	finishResponse();
+}
+
+void ClientConnection::finishResponse()
+{
+	busy_ = false;
+	if (!current_.keep_alive)
+	{
+		closeConnection();
+		return;
+	}
+
+	// requests held back because of the pipelining limit
+	extractRequests();
+	processNextRequest();
+	updateTimer();
+}
+
+void ClientConnection::handleTimeout()
+{
+	if (closed_) return;
+
+	if (closing_)
+	{
+		// the client did not acknowledge closing the connection
+		closeConnection(true);
+	}
+	else if (stream_.active)
+	{
+		Log::warn(EndpointManager::formatResponseMessage(current_.request, "Streaming request process has been terminated (write timeout): " + current_.request.getPath() + requester_info_));
+		closeConnection(true);
+	}
+	else if (!busy_)
+	{
+		// idle persistent connection, incomplete request or TLS handshake that did not finish in time
+		if (!buffer_.isEmpty()) Log::warn("Incomplete request from " + socket_->peerAddress().toString() + " - closing the connection");
+		closeConnection(!socket_->isEncrypted());
+	}
+}
+
+void ClientConnection::handleSslErrors(const QList<QSslError>& errors)
+{
+	foreach(const QSslError& error, errors)
+	{
+		Log::warn("SSL error: " + error.errorString());
+	}
+}
+
+void ClientConnection::handleSocketError(QAbstractSocket::SocketError error)
+{
+	if (error != QAbstractSocket::RemoteHostClosedError)
+	{
+		Log::warn("Connection cannot be continued: " + socket_->errorString());
+	}
+	if (socket_->state() == QAbstractSocket::UnconnectedState) handleDisconnect();
+}
+
+void ClientConnection::handleDisconnect()
+{
+	if (closed_) return;
+	closed_ = true;
+	closing_ = true;
+
+	if (stream_.active)
+	{
+		Log::info(EndpointManager::formatResponseMessage(current_.request, "Streaming request process has been terminated: " + current_.request.getPath() + requester_info_));
+	}
+	stream_ = StreamState();
+	timer_.stop();
+
+	emit closed();
+	deleteLater();
+}
+
+void ClientConnection::closeConnection(bool abort)
+{
+	if (closed_) return;
+
+	closing_ = true;
+	pending_.clear();
+	buffer_.clear();
+
+	if (abort || socket_->state() != QAbstractSocket::ConnectedState)
+	{
+		socket_->abort();
+		handleDisconnect();
+		return;
+	}
+
+	// pending data is written before the connection is closed
+	socket_->disconnectFromHost();
+	if (!closed_) updateTimer();
+}
+
+void ClientConnection::updateTimer()
+{
+	if (closed_) return;
+
+	if (closing_ || stream_.active)
+	{
+		timer_.start(params_.socket_write_timeout);
+	}
+	else if (!socket_->isEncrypted())
+	{
+		timer_.start(params_.socket_encryption_timeout);
+	}
+	else if (busy_)
+	{
+		timer_.stop();
+	}
+	else if (!buffer_.isEmpty())
+	{
+		timer_.start(params_.socket_read_timeout);
+	}
+	else
+	{
+		timer_.start(params_.keep_alive_timeout);
+	}
+}
+
+QByteArray ClientConnection::chunk(const QByteArray& data)
+{
+	// an empty chunk would terminate the transfer
+	if (data.isEmpty()) return QByteArray();
+
+	return QByteArray::number(data.size(), 16).toUpper() + "\r\n" + data + "\r\n";
+}
+
+bool ClientConnection::hasMessageFraming(const HttpResponse& response)
+{
+	if ((response.getStatus() == ResponseStatus::NOT_MODIFIED) || (response.getStatus() == ResponseStatus::NO_CONTENT)) return true;
+
+	return !response.getHeaderValue("Content-Length").isEmpty() || response.getHeaderValue("Transfer-Encoding").toLower().contains("chunked");
+}
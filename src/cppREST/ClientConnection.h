@@ -0,0 +1,99 @@
+#ifndef CLIENTCONNECTION_H
+#define CLIENTCONNECTION_H
+
+#include "cppREST_global.h"
+#include <QObject>
+#include <QSslSocket>
+#include <QSslConfiguration>
+#include <QThreadPool>
+#include <QTimer>
+#include <QQueue>
+#include <QFile>
+#include <QSharedPointer>
+#include "ServerHelper.h"
+#include "HttpRequest.h"
+#include "HttpResponse.h"
+#include "GzipCompressor.h"
+
+///Persistent (keep-alive) HTTPS connection of a client.
+///Requests are read incrementally and responses (incl. file streams) are written without blocking in the thread of the server.
+///Only the endpoint actions are executed in the worker thread pool. Pipelined requests are processed one after the other, i.e. the responses are sent in the order of the requests.
+class CPPRESTSHARED_EXPORT ClientConnection
+	: public QObject
+{
+	Q_OBJECT
+
+public:
+	ClientConnection(const QSslConfiguration& ssl_configuration, const RequestWorkerParams& params, QThreadPool* thread_pool, QObject* parent = nullptr);
+
+	///Takes over the socket and starts the TLS handshake. Returns false if the socket could not be set up.
+	bool start(qintptr socket_descriptor);
+
+signals:
+	///Emitted once when the connection has been closed. The object is deleted afterwards.
+	void closed();
+
+private slots:
+	void readRequestData();
+	void workerFinished(HttpResponse response, QString requester_info);
+	void writeStreamData();
+	void handleTimeout();
+	void handleSslErrors(const QList<QSslError>& errors);
+	void handleSocketError(QAbstractSocket::SocketError error);
+	void handleDisconnect();
+
+private:
+	const qint64 MAX_WRITE_BUFFER_SIZE = 1024*256; // stream data is added only when less data is waiting to be written (plain and encrypted)
+	const int MAX_HEADER_SIZE = 1024*64;
+
+	//Request read from the socket (or parser error)
+	struct PendingRequest
+	{
+		HttpRequest request;
+		bool keep_alive;
+		QString error;
+		ResponseStatus error_status = ResponseStatus::BAD_REQUEST;
+	};
+
+	//State of the file that is currently streamed
+	struct StreamState
+	{
+		bool active = false;
+		QSharedPointer<QFile> file;
+		quint64 file_size = 0;
+		QList<ByteRange> ranges; // a complete file is streamed as one range without multipart delimiters
+		QByteArray boundary; // multipart boundary, empty if no multipart response
+		int range_index = 0;
+		bool range_started = false;
+		quint64 pos = 0;
+		QSharedPointer<GzipCompressor> compressor; // set if the content is compressed on the fly (chunked transfer encoding)
+	};
+
+	void extractRequests();
+	void processNextRequest();
+	void sendResponse(HttpResponse response);
+	void startStream(HttpResponse& response);
+	void writeStreamPart(qint64 max_bytes);
+	QByteArray readStreamData(qint64 max_bytes);
+	void finishResponse();
+	void closeConnection(bool abort = false);
+	void updateTimer();
+	static QByteArray chunk(const QByteArray& data);
+	static bool hasMessageFraming(const HttpResponse& response);
+
+	QSslConfiguration ssl_configuration_;
+	RequestWorkerParams params_;
+	QThreadPool* thread_pool_;
+	QSslSocket* socket_;
+	QTimer timer_;
+	QByteArray buffer_;
+	QQueue<PendingRequest> pending_;
+	PendingRequest current_;
+	QString requester_info_; // user and client of the current request (for log messages)
+	bool busy_; // a request is processed by a worker or its response is being written
+	bool closing_;
+	bool closed_;
+	StreamState stream_;
+};
+
+#endif // CLIENTCONNECTION_H
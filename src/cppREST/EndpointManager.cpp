@@ -181,35 +181,37 @@ void EndpointManager::validateInputData(Endpoint* current_endpoint, const HttpRe
 
 void EndpointManager::appendEndpoint(Endpoint new_endpoint)
 {
-	if (!instance().endpoint_list_.contains(new_endpoint))
+	EndpointManager& manager = instance();
+	if (manager.endpoint_list_.contains(new_endpoint)) return;
+
+	QString url = normalizeUrl(new_endpoint.url);
+	QString key = routeKey(url, new_endpoint.method);
+	if (manager.route_index_.contains(key))
 	{
-		instance().endpoint_list_.append(new_endpoint);
+		THROW(ProgrammingException, "Endpoint " + HttpUtils::convertMethodTypeToString(new_endpoint.method).toUpper() + " - " + new_endpoint.url + " has already been registered");
 	}
+
+	manager.endpoint_list_.append(new_endpoint);
+	manager.route_index_.insert(key, manager.endpoint_list_.count()-1);
+	manager.url_index_[url].append(manager.endpoint_list_.count()-1);
 }
 
 Endpoint EndpointManager::getEndpointByUrlAndMethod(const QString& url, const RequestMethod& method)
 {
-	for (int i = 0; i < instance().endpoint_list_.count(); ++i)
-	{
-		if ((instance().endpoint_list_[i].url.toLower() == url.toLower()) &&
-			(instance().endpoint_list_[i].method == method))
-		{
-			return instance().endpoint_list_[i];
-		}
-	}
+	const EndpointManager& manager = instance();
+	int index = manager.route_index_.value(routeKey(normalizeUrl(url), method), -1);
+	if (index<0) return Endpoint();
 
-	return Endpoint();
+	return manager.endpoint_list_[index];
 }
 
 QList<Endpoint> EndpointManager::getEndpointsByUrl(const QString& url)
 {
+	const EndpointManager& manager = instance();
 	QList<Endpoint> results;
-	for (int i = 0; i < instance().endpoint_list_.count(); ++i)
+	foreach(int index, manager.url_index_.value(normalizeUrl(url)))
 	{
-		if (instance().endpoint_list_[i].url.toLower() == url.toLower())
-		{
-			results.append(instance().endpoint_list_[i]);
-		}
+		results.append(manager.endpoint_list_[index]);
 	}
 
 	return results;
@@ -285,3 +287,16 @@ bool EndpointManager::hasKey(const QString& key, const QMap<QString, QString>& m
     }
     return false;
 }
+
+QString EndpointManager::normalizeUrl(const QString& url)
+{
+	QString output = url.trimmed().toLower();
+	while (output.startsWith('/')) output.remove(0, 1);
+	while (output.endsWith('/')) output.chop(1);
+	return output;
+}
+
+QString EndpointManager::routeKey(const QString& normalized_url, const RequestMethod& method)
+{
+	return QString::number(static_cast<int>(method)) + " " + normalized_url;
+}
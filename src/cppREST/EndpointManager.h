@@ -2,6 +2,7 @@
 #define ENDPOINTMANAGER_H
 
 #include "cppREST_global.h"
+#include <QHash>
 #include "HttpRequest.h"
 #include "HttpResponse.h"
 #include "NGSD.h"
@@ -66,7 +67,9 @@ public:
 	static HttpResponse getDbTokenAuthStatus(const HttpRequest& request);
 
 	static void validateInputData(Endpoint* current_endpoint, const HttpRequest& request);
-	static void appendEndpoint(Endpoint new_endpoint);	
+	/// Registers an endpoint and adds it to the routing table. Endpoints have to be registered at startup, before the server starts processing requests (lookups are not synchronized)
+	static void appendEndpoint(Endpoint new_endpoint);
+	/// Returns the endpoint for the URL and method (case-insensitive, leading/trailing slashes are ignored). Returns an empty endpoint, if there is no match.
 	static Endpoint getEndpointByUrlAndMethod(const QString& url, const RequestMethod& method);
 	static QList<Endpoint> getEndpointsByUrl(const QString& url);
 	static QList<Endpoint> getEndpointEntities();
@@ -81,7 +84,11 @@ private:
 	static EndpointManager& instance();
     static bool hasKey(const QString& key, const QList<QString>& list);
     static bool hasKey(const QString& key, const QMap<QString, QString>& map);
+	static QString normalizeUrl(const QString& url);
+	static QString routeKey(const QString& normalized_url, const RequestMethod& method);
 	QList<Endpoint> endpoint_list_;
+	QHash<QString, int> route_index_; // method + normalized URL => index in the endpoint list
+	QHash<QString, QList<int>> url_index_; // normalized URL => indices in the endpoint list
 };
 
 #endif // ENDPOINTMANAGER_H
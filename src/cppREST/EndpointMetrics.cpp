@@ -0,0 +1,148 @@
+#include "EndpointMetrics.h"
+#include "HttpUtils.h"
+#include <QMutexLocker>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QtMath>
+#include <algorithm>
+
+qint64 EndpointStatistics::latencyPercentile(double percentile) const
+{
+	if (requests==0) return 0;
+
+	const QVector<qint64>& buckets = EndpointMetrics::latencyBuckets();
+	qint64 rank = qCeil(percentile * requests);
+	qint64 count = 0;
+	for (int i=0; i<buckets.count(); ++i)
+	{
+		count += latency_histogram[i];
+		if (count>=rank) return std::min(buckets[i], max_time_ms);
+	}
+
+	return max_time_ms;
+}
+
+EndpointMetrics::EndpointMetrics()
+	: mutex_()
+	, statistics_()
+	, start_(QDateTime::currentDateTime())
+{
+}
+
+EndpointMetrics& EndpointMetrics::instance()
+{
+	static EndpointMetrics endpoint_metrics;
+	return endpoint_metrics;
+}
+
+const QVector<qint64>& EndpointMetrics::latencyBuckets()
+{
+	static const QVector<qint64> buckets = {5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000};
+	return buckets;
+}
+
+void EndpointMetrics::addRequest(const QString& url, RequestMethod method, int status_code, qint64 bytes_in, qint64 bytes_out, qint64 time_ms)
+{
+	const QVector<qint64>& buckets = latencyBuckets();
+	int bucket = std::lower_bound(buckets.begin(), buckets.end(), time_ms) - buckets.begin();
+
+	EndpointMetrics& metrics = instance();
+	QMutexLocker locker(&metrics.mutex_);
+
+	QString key = HttpUtils::convertMethodTypeToString(method).toUpper() + " " + url;
+	if (!metrics.statistics_.contains(key))
+	{
+		EndpointStatistics stats;
+		stats.url = url;
+		stats.method = method;
+		stats.latency_histogram.fill(0, buckets.count()+1);
+		metrics.statistics_.insert(key, stats);
+	}
+
+	EndpointStatistics& stats = metrics.statistics_[key];
+	++stats.requests;
+	if (status_code>=400) ++stats.errors;
+	stats.bytes_in += bytes_in;
+	stats.bytes_out += bytes_out;
+	stats.total_time_ms += time_ms;
+	stats.max_time_ms = std::max(stats.max_time_ms, time_ms);
+	++stats.latency_histogram[bucket];
+}
+
+QList<EndpointStatistics> EndpointMetrics::statistics()
+{
+	EndpointMetrics& metrics = instance();
+	QMutexLocker locker(&metrics.mutex_);
+
+	QList<EndpointStatistics> output;
+	QStringList keys = metrics.statistics_.keys();
+	std::sort(keys.begin(), keys.end(), [&metrics](const QString& a, const QString& b)
+	{
+		const EndpointStatistics& sa = metrics.statistics_[a];
+		const EndpointStatistics& sb = metrics.statistics_[b];
+		if (sa.url!=sb.url) return sa.url<sb.url;
+		return sa.method<sb.method;
+	});
+	foreach(const QString& key, keys)
+	{
+		output << metrics.statistics_[key];
+	}
+
+	return output;
+}
+
+QJsonDocument EndpointMetrics::statisticsAsJson()
+{
+	QDateTime start;
+	{
+		QMutexLocker locker(&instance().mutex_);
+		start = instance().start_;
+	}
+
+	QJsonArray buckets;
+	foreach(qint64 bound, latencyBuckets())
+	{
+		buckets.append(bound);
+	}
+
+	QJsonArray endpoints;
+	foreach(const EndpointStatistics& stats, statistics())
+	{
+		QJsonObject endpoint;
+		endpoint.insert("url", stats.url);
+		endpoint.insert("method", HttpUtils::convertMethodTypeToString(stats.method).toUpper());
+		endpoint.insert("requests", stats.requests);
+		endpoint.insert("errors", stats.errors);
+		endpoint.insert("bytes_in", stats.bytes_in);
+		endpoint.insert("bytes_out", stats.bytes_out);
+		endpoint.insert("avg_time_ms", stats.requests==0 ? 0.0 : static_cast<double>(stats.total_time_ms) / stats.requests);
+		endpoint.insert("p50_time_ms", stats.latencyPercentile(0.5));
+		endpoint.insert("p99_time_ms", stats.latencyPercentile(0.99));
+		endpoint.insert("max_time_ms", stats.max_time_ms);
+
+		QJsonArray histogram;
+		foreach(qint64 count, stats.latency_histogram)
+		{
+			histogram.append(count);
+		}
+		endpoint.insert("latency_histogram", histogram);
+
+		endpoints.append(endpoint);
+	}
+
+	QJsonObject output;
+	output.insert("recorded_since", start.toString(Qt::ISODate));
+	output.insert("latency_buckets_ms", buckets);
+	output.insert("endpoints", endpoints);
+
+	return QJsonDocument(output);
+}
+
+void EndpointMetrics::clear()
+{
+	EndpointMetrics& metrics = instance();
+	QMutexLocker locker(&metrics.mutex_);
+
+	metrics.statistics_.clear();
+	metrics.start_ = QDateTime::currentDateTime();
+}
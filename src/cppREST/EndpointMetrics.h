@@ -0,0 +1,56 @@
+#ifndef ENDPOINTMETRICS_H
+#define ENDPOINTMETRICS_H
+
+#include "cppREST_global.h"
+#include <QMutex>
+#include <QHash>
+#include <QVector>
+#include <QJsonDocument>
+#include "HttpParts.h"
+
+///Aggregated statistics of one endpoint (URL and method)
+struct CPPRESTSHARED_EXPORT EndpointStatistics
+{
+	QString url;
+	RequestMethod method;
+	qint64 requests = 0;
+	qint64 errors = 0; // responses with status code >= 400
+	qint64 bytes_in = 0; // request body
+	qint64 bytes_out = 0; // response payload (Content-Length for streamed files)
+	qint64 total_time_ms = 0;
+	qint64 max_time_ms = 0;
+	QVector<qint64> latency_histogram; // number of requests per bucket (see EndpointMetrics::latencyBuckets)
+
+	///Returns an estimate of the given latency percentile (upper bound of the bucket containing it) in milliseconds
+	qint64 latencyPercentile(double percentile) const;
+};
+
+///Thread-safe per-endpoint request counts, transferred bytes and latency histograms of the server.
+///The latency is measured from the start of the endpoint action until the response is ready to be sent, i.e. it does not include the transfer of streamed files.
+class CPPRESTSHARED_EXPORT EndpointMetrics
+{
+public:
+	///Upper bounds of the latency histogram buckets in milliseconds. The last bucket collects all slower requests.
+	static const QVector<qint64>& latencyBuckets();
+
+	///Adds a processed request to the statistics of the endpoint
+	static void addRequest(const QString& url, RequestMethod method, int status_code, qint64 bytes_in, qint64 bytes_out, qint64 time_ms);
+	///Returns the statistics of all endpoints, sorted by URL and method
+	static QList<EndpointStatistics> statistics();
+	///Returns the statistics of all endpoints as JSON (incl. the start of the recording)
+	static QJsonDocument statisticsAsJson();
+	///Removes all statistics
+	static void clear();
+
+protected:
+	EndpointMetrics();
+
+private:
+	static EndpointMetrics& instance();
+
+	QMutex mutex_;
+	QHash<QString, EndpointStatistics> statistics_;
+	QDateTime start_;
+};
+
+#endif // ENDPOINTMETRICS_H
@@ -0,0 +1,60 @@
+#include "GzipCompressor.h"
+#include "Exceptions.h"
+
+GzipCompressor::GzipCompressor(int level)
+	: stream_()
+	, finished_(false)
+{
+	//window bits 15+16 makes zlib write a gzip header/trailer instead of a zlib header/trailer
+	if (deflateInit2(&stream_, level, Z_DEFLATED, 15+16, 8, Z_DEFAULT_STRATEGY)!=Z_OK)
+	{
+		THROW(Exception, "Could not initialize gzip compression stream!");
+	}
+}
+
+GzipCompressor::~GzipCompressor()
+{
+	deflateEnd(&stream_);
+}
+
+QByteArray GzipCompressor::compress(const QByteArray& data)
+{
+	if (finished_) THROW(ProgrammingException, "Data cannot be added to a finished gzip stream!");
+	if (data.isEmpty()) return QByteArray();
+
+	return deflateData(data, Z_NO_FLUSH);
+}
+
+QByteArray GzipCompressor::finish()
+{
+	if (finished_) return QByteArray();
+	finished_ = true;
+
+	return deflateData(QByteArray(), Z_FINISH);
+}
+
+QByteArray GzipCompressor::gzip(const QByteArray& data, int level)
+{
+	GzipCompressor compressor(level);
+	return compressor.compress(data) + compressor.finish();
+}
+
+QByteArray GzipCompressor::deflateData(const QByteArray& data, int flush)
+{
+	QByteArray output;
+	char buffer[16384];
+
+	stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.constData()));
+	stream_.avail_in = static_cast<uInt>(data.size());
+	do
+	{
+		stream_.next_out = reinterpret_cast<Bytef*>(buffer);
+		stream_.avail_out = sizeof(buffer);
+		int result = deflate(&stream_, flush);
+		if (result==Z_STREAM_ERROR) THROW(Exception, "Error during gzip compression!");
+		output.append(buffer, static_cast<int>(sizeof(buffer) - stream_.avail_out));
+	}
+	while (stream_.avail_out==0);
+
+	return output;
+}
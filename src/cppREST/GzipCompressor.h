@@ -0,0 +1,35 @@
+#ifndef GZIPCOMPRESSOR_H
+#define GZIPCOMPRESSOR_H
+
+#include "cppREST_global.h"
+#include <QByteArray>
+#include <zlib.h>
+
+///Incremental gzip compressor, e.g. for compressing a streamed file chunk by chunk.
+///The concatenation of all returned parts is a valid gzip member.
+class CPPRESTSHARED_EXPORT GzipCompressor
+{
+public:
+	GzipCompressor(int level = 6);
+	~GzipCompressor();
+
+	///Compresses the next part of the input. The result might be empty, because zlib buffers input internally.
+	QByteArray compress(const QByteArray& data);
+	///Flushes the remaining data and writes the gzip trailer. No data can be added afterwards.
+	QByteArray finish();
+
+	///Compresses data in one step.
+	static QByteArray gzip(const QByteArray& data, int level = 6);
+
+protected:
+	QByteArray deflateData(const QByteArray& data, int flush);
+
+	z_stream stream_;
+	bool finished_;
+
+	//declared away
+	GzipCompressor(const GzipCompressor&) = delete;
+	GzipCompressor& operator=(const GzipCompressor&) = delete;
+};
+
+#endif // GZIPCOMPRESSOR_H
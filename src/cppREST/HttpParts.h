@@ -4,6 +4,7 @@
 #include "cppREST_global.h"
 #include <QString>
 #include <QList>
+#include <QDateTime>
 
 enum ContentType
 {
@@ -95,6 +96,9 @@ struct CPPRESTSHARED_EXPORT BasicResponseData
 	qint64 file_size;
 	bool is_stream = false;
 	bool is_downloadable = false;
+	bool is_compressed = false; // gzip-compressed on the fly (streams are sent with chunked transfer encoding)
+	QByteArray etag;
+	QDateTime last_modified;
 };
 
 #endif // HTTPPARTS_H
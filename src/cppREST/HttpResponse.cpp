@@ -4,9 +4,12 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include "ServerHelper.h"
+#include "GzipCompressor.h"
 #include <QDir>
 
 HttpResponse::HttpResponse()
+	: is_stream_(false)
+	, is_compressed_(false)
 {
 	clear();
 }
@@ -29,6 +32,7 @@ HttpResponse::HttpResponse(ResponseStatus status, ContentType content_type, qlon
 	addHeader("Content-Length: " + QByteArray::number(content_length) + "\r\n");
 	addHeader("\r\n");
 	setIsStream(false);
+	setIsCompressed(false);
 }
 
 HttpResponse::HttpResponse(ResponseStatus status, ContentType content_type, QString message)
@@ -80,6 +84,7 @@ HttpResponse::HttpResponse(ResponseStatus status, ContentType content_type, QStr
 
 	addHeader("\r\n");
 	setIsStream(false);
+	setIsCompressed(false);
 }
 
 void HttpResponse::setIsStream(bool is_stream)
@@ -87,11 +92,21 @@ void HttpResponse::setIsStream(bool is_stream)
 	is_stream_ = is_stream;
 }
 
-bool HttpResponse::isStream()
+bool HttpResponse::isStream() const
 {
 	return is_stream_;
 }
 
+void HttpResponse::setIsCompressed(bool is_compressed)
+{
+	is_compressed_ = is_compressed;
+}
+
+bool HttpResponse::isCompressed() const
+{
+	return is_compressed_;
+}
+
 void HttpResponse::setFilename(QString filename)
 {
 	filename_ = filename;
@@ -145,6 +160,34 @@ void HttpResponse::addHeader(QByteArray header)
 	updateResponseData();
 }
 
+void HttpResponse::insertHeader(QByteArray name, QByteArray value)
+{
+	QByteArray header = name + ": " + value + "\r\n";
+	if (headers_.endsWith("\r\n\r\n"))
+	{
+		headers_.insert(headers_.length()-2, header);
+	}
+	else
+	{
+		headers_.append(header);
+	}
+	updateResponseData();
+}
+
+QByteArray HttpResponse::getHeaderValue(QByteArray name) const
+{
+	name = name.toLower() + ":";
+	foreach(const QByteArray& line, headers_.split('\n'))
+	{
+		if (line.toLower().startsWith(name))
+		{
+			return line.mid(name.length()).trimmed();
+		}
+	}
+
+	return QByteArray();
+}
+
 QByteArray HttpResponse::getHeaders() const
 {
 	return headers_;
@@ -176,6 +219,29 @@ void HttpResponse::setRangeNotSatisfiableHeaders(BasicResponseData data)
 	setHeaders(generateRangeNotSatisfiableHeaders(data));
 }
 
+void HttpResponse::compressPayload()
+{
+	if (is_compressed_) return;
+
+	payload_ = GzipCompressor::gzip(payload_);
+
+	QByteArray headers;
+	foreach(QByteArray line, headers_.split('\n'))
+	{
+		line = line.trimmed();
+		if (line.isEmpty() || line.toLower().startsWith("content-length:")) continue;
+		if (line.toLower().startsWith("etag:")) line = "ETag: " + HttpUtils::createGzipEtag(line.mid(5).trimmed());
+		headers.append(line + "\r\n");
+	}
+	headers.append("Content-Length: " + QByteArray::number(getContentLength()) + "\r\n");
+	headers.append("Content-Encoding: gzip\r\n");
+	headers.append("Vary: Accept-Encoding\r\n");
+	headers.append("\r\n");
+
+	setIsCompressed(true);
+	setHeaders(headers);
+}
+
 void HttpResponse::readBasicResponseData(BasicResponseData data)
 {
 	setStatus(data.status);
@@ -186,8 +252,20 @@ void HttpResponse::readBasicResponseData(BasicResponseData data)
 	}
 
 	setIsStream(data.is_stream);
+	setIsCompressed(data.is_compressed);
 	setFilename(data.filename);
-	setHeaders(generateRegularHeaders(data));
+	if (data.status == ResponseStatus::NOT_MODIFIED)
+	{
+		setHeaders(generateNotModifiedHeaders(data));
+	}
+	else if (data.is_stream && data.is_compressed)
+	{
+		setHeaders(generateChunkedStreamHeaders(data));
+	}
+	else
+	{
+		setHeaders(generateRegularHeaders(data));
+	}
 	if (data.byte_ranges.length() > 0)
 	{
 		setByteRanges(data.byte_ranges);
@@ -214,15 +292,18 @@ QByteArray HttpResponse::generateRegularHeaders(BasicResponseData data)
 			}
 			if (data.byte_ranges.count() > 1)
 			{
+				// part header: "--boundary", content type, content range, empty line - and the line break after the part data
 				metadata_length = metadata_length + 2 + data.boundary.length() + 2;
 				metadata_length = metadata_length + content_type.length();
 				metadata_length = metadata_length + range_header.length() + 2;
+				metadata_length = metadata_length + 2;
 			}
 		}
 
 		if (data.byte_ranges.count() > 1)
 		{
-			metadata_length = 2 + metadata_length + 2 + data.boundary.length() + 2 + 2;
+			// closing delimiter: "--boundary--"
+			metadata_length = metadata_length + 2 + data.boundary.length() + 2 + 2;
 			headers.append("Content-Type: multipart/byteranges; boundary=" + data.boundary.toUtf8() + "\r\n");
 		}
 
@@ -242,10 +323,12 @@ QByteArray HttpResponse::generateRegularHeaders(BasicResponseData data)
 	{
 		headers.append("WWW-Authenticate: Basic realm=\"Access to the secure area of GSvar\"\r\n");
 	}
-	if (data.byte_ranges.length() > 0)
+	if (data.is_compressed)
 	{
-
+		headers.append("Content-Encoding: gzip\r\n");
+		headers.append("Vary: Accept-Encoding\r\n");
 	}
+	headers.append(generateValidatorHeaders(data));
 	if (data.is_downloadable)
 	{
 		headers.append("Content-Disposition: form-data; name=file_download; filename=" + getFileNameWithExtension(data.filename).toUtf8() + "\r\n");
@@ -262,6 +345,12 @@ QByteArray HttpResponse::generateChunkedStreamHeaders(BasicResponseData data)
 	headers.append("Content-Type: " + HttpUtils::convertContentTypeToString(data.content_type).toUtf8() + "\r\n");
 	headers.append("Connection: Keep-Alive\r\n");
 	headers.append("Transfer-Encoding: chunked\r\n");
+	if (data.is_compressed)
+	{
+		headers.append("Content-Encoding: gzip\r\n");
+		headers.append("Vary: Accept-Encoding\r\n");
+	}
+	headers.append(generateValidatorHeaders(data));
 
 	if (data.is_downloadable)
 	{
@@ -277,10 +366,40 @@ QByteArray HttpResponse::generateRangeNotSatisfiableHeaders(BasicResponseData da
 	QByteArray headers;
 	headers.append("Date: " + QDateTime::currentDateTime().toUTC().toString().toUtf8() + "\r\n");
 	headers.append("Content-Range: bytes */" + QByteArray::number(data.file_size) + "\r\n");
+	headers.append("Content-Length: 0\r\n");
 	headers.append("\r\n");
 	return headers;
 }
 
+QByteArray HttpResponse::generateNotModifiedHeaders(BasicResponseData data)
+{
+	QByteArray headers;
+	headers.append("Date: " + QDateTime::currentDateTime().toUTC().toString().toUtf8() + "\r\n");
+	headers.append("Connection: Keep-Alive\r\n");
+	headers.append(generateValidatorHeaders(data));
+	headers.append("\r\n");
+	return headers;
+}
+
+QByteArray HttpResponse::generateValidatorHeaders(BasicResponseData data)
+{
+	QByteArray headers;
+	if (!data.etag.isEmpty())
+	{
+		headers.append("ETag: " + data.etag + "\r\n");
+	}
+	if (data.last_modified.isValid())
+	{
+		headers.append("Last-Modified: " + HttpUtils::convertDateTimeToHttpDate(data.last_modified) + "\r\n");
+	}
+	// clients may cache the content, but have to revalidate it before using it
+	if (!headers.isEmpty())
+	{
+		headers.append("Cache-Control: no-cache\r\n");
+	}
+	return headers;
+}
+
 QString HttpResponse::getFileNameWithExtension(QString filename_with_path) const
 {
 	QList<QString> path_items = filename_with_path.split(QDir::separator());
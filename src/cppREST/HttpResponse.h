@@ -16,7 +16,10 @@ public:
 	HttpResponse(ResponseStatus status, ContentType content_type, QString message);  
 
 	void setIsStream(bool is_stream);
-	bool isStream();
+	bool isStream() const;
+
+	void setIsCompressed(bool is_compressed);
+	bool isCompressed() const;
 
 	void setFilename(QString filename);
 	QString getFilename() const;
@@ -33,6 +36,10 @@ public:
 
 	void setHeaders(QByteArray headers);
 	void addHeader(QByteArray header);
+	///Inserts a header field before the empty line that terminates the header section.
+	void insertHeader(QByteArray name, QByteArray value);
+	///Returns the value of a header field (case-insensitive name) or an empty string if it is not set.
+	QByteArray getHeaderValue(QByteArray name) const;
 	QByteArray getHeaders() const;
 
 	void setBoundary(QByteArray boundary);
@@ -42,18 +49,23 @@ public:
 	QByteArray getPayload() const;
 
 	void setRangeNotSatisfiableHeaders(BasicResponseData data);
+	///Compresses the payload with gzip and updates the 'Content-Length', 'Content-Encoding' and 'ETag' headers accordingly.
+	void compressPayload();
 
 private:
 	void readBasicResponseData(BasicResponseData data);
 	QByteArray generateRegularHeaders(BasicResponseData data);
 	QByteArray generateChunkedStreamHeaders(BasicResponseData data);
 	QByteArray generateRangeNotSatisfiableHeaders(BasicResponseData data);
+	QByteArray generateNotModifiedHeaders(BasicResponseData data);
+	QByteArray generateValidatorHeaders(BasicResponseData data);
 	QString getFileNameWithExtension(QString filename_with_path) const;
 	int getContentLength() const;
 	void updateResponseData();
 
 protected:
 	bool is_stream_;
+	bool is_compressed_;
 	QString filename_;
 	ResponseStatus response_status_;
 	QByteArray status_line_;
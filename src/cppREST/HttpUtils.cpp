@@ -1,4 +1,7 @@
 #include "HttpUtils.h"
+#include <QCryptographicHash>
+#include <QLocale>
+#include <QTimeZone>
 
 HttpUtils::HttpUtils()
 {
@@ -245,3 +248,122 @@ ContentType HttpUtils::detectErrorContentType(const QList<QString> headers)
 	return error_type;
 }
 
+
+bool HttpUtils::isCompressible(const ContentType& type)
+{
+	switch(type)
+	{
+		case APPLICATION_JSON:
+		case APPLICATION_JAVASCRIPT:
+		case IMAGE_SVG_XML:
+		case TEXT_PLAIN:
+		case TEXT_CSV:
+		case TEXT_HTML:
+		case TEXT_XML:
+		case TEXT_CSS:
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool HttpUtils::acceptsGzip(const QList<QString>& accept_encoding)
+{
+	foreach(QString value, accept_encoding)
+	{
+		//e.g. 'gzip', 'gzip;q=0.8' or 'gzip;q=0'
+		QStringList parts = value.split(';');
+		if (parts[0].trimmed().toLower()!="gzip" && parts[0].trimmed()!="*") continue;
+
+		if (parts.count()>1)
+		{
+			QString quality = parts[1].trimmed().toLower();
+			if (quality.startsWith("q=") && quality.mid(2).toDouble()<=0.0) return false;
+		}
+		return true;
+	}
+
+	return false;
+}
+
+QByteArray HttpUtils::createEtag(qint64 size, const QDateTime& modified)
+{
+	return "W/\"" + QByteArray::number(size, 16) + "-" + QByteArray::number(modified.toMSecsSinceEpoch(), 16) + "\"";
+}
+
+QByteArray HttpUtils::createEtag(const QByteArray& content)
+{
+	return "\"" + QCryptographicHash::hash(content, QCryptographicHash::Md5).toHex() + "\"";
+}
+
+QByteArray HttpUtils::createGzipEtag(const QByteArray& etag)
+{
+	if (etag.isEmpty() || etag.endsWith("-gzip\"") || !etag.endsWith('"')) return etag;
+
+	return etag.left(etag.length()-1) + "-gzip\"";
+}
+
+QByteArray HttpUtils::convertDateTimeToHttpDate(const QDateTime& date_time)
+{
+	return QLocale::c().toString(date_time.toUTC(), "ddd, dd MMM yyyy hh:mm:ss 'GMT'").toUtf8();
+}
+
+QDateTime HttpUtils::convertHttpDateToDateTime(QString http_date)
+{
+	http_date = http_date.trimmed();
+	if (http_date.endsWith(" GMT")) http_date.chop(4);
+
+	QDateTime output = QLocale::c().toDateTime(http_date, "ddd, dd MMM yyyy hh:mm:ss");
+	output.setTimeZone(QTimeZone::utc());
+	return output;
+}
+
+bool HttpUtils::isNotModified(const QList<QString>& if_none_match, const QList<QString>& if_modified_since, const QByteArray& etag, const QDateTime& last_modified)
+{
+	if (!if_none_match.isEmpty())
+	{
+		if (etag.isEmpty()) return false;
+
+		//weak comparison (RFC 7232, section 2.3.2)
+		QByteArray etag_opaque = etag.startsWith("W/") ? etag.mid(2) : etag;
+		foreach(QString value, if_none_match)
+		{
+			value = value.trimmed();
+			if (value=="*") return true;
+			if (value.startsWith("W/")) value = value.mid(2);
+			if (value.toUtf8()==etag_opaque) return true;
+		}
+		return false;
+	}
+
+	if (!if_modified_since.isEmpty() && last_modified.isValid())
+	{
+		//the header parser splits values at commas, i.e. the day of week is a separate value
+		QDateTime since = convertHttpDateToDateTime(if_modified_since.join(", "));
+		if (!since.isValid()) return false;
+
+		//HTTP dates have a resolution of seconds
+		return last_modified.toSecsSinceEpoch() <= since.toSecsSinceEpoch();
+	}
+
+	return false;
+}
+
+QList<ByteRange> HttpUtils::coalesceByteRanges(const QList<ByteRange>& ranges, quint64 max_gap)
+{
+	QList<ByteRange> output;
+	foreach(const ByteRange& range, ranges)
+	{
+		if (!output.isEmpty() && (range.start > output.last().end) && (range.start - output.last().end - 1 <= max_gap))
+		{
+			output.last().end = range.end;
+			output.last().length = output.last().end - output.last().start + 1;
+		}
+		else
+		{
+			output << range;
+		}
+	}
+
+	return output;
+}
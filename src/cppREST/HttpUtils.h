@@ -3,6 +3,7 @@
 
 #include "cppREST_global.h"
 #include "HttpParts.h"
+#include <QDateTime>
 
 class CPPRESTSHARED_EXPORT HttpUtils
 {
@@ -20,6 +21,26 @@ public:
 
 	static ContentType detectErrorContentType(const QList<QString> headers);
 
+	///Returns if the content type is text-based and worth compressing.
+	static bool isCompressible(const ContentType& type);
+	///Returns if the client accepts gzip-compressed content (values of the 'Accept-Encoding' request header).
+	static bool acceptsGzip(const QList<QString>& accept_encoding);
+
+	///Creates a weak entity tag from file size and modification time.
+	static QByteArray createEtag(qint64 size, const QDateTime& modified);
+	///Creates a strong entity tag from the content.
+	static QByteArray createEtag(const QByteArray& content);
+	///Returns the entity tag of the gzip-compressed representation, e.g. '"abc-gzip"' for '"abc"' (strong entity tags have to differ for different content encodings).
+	static QByteArray createGzipEtag(const QByteArray& etag);
+	///Converts a date/time to the HTTP date format (RFC 7231), e.g. 'Sun, 06 Nov 1994 08:49:37 GMT'.
+	static QByteArray convertDateTimeToHttpDate(const QDateTime& date_time);
+	///Converts a HTTP date to a date/time. Returns an invalid date/time if the input cannot be parsed.
+	static QDateTime convertHttpDateToDateTime(QString http_date);
+	///Checks the conditional request headers 'If-None-Match' and 'If-Modified-Since' (the latter is ignored if the former is given, see RFC 7232).
+	static bool isNotModified(const QList<QString>& if_none_match, const QList<QString>& if_modified_since, const QByteArray& etag, const QDateTime& last_modified);
+	///Merges successive byte ranges that are adjacent or separated by at most 'max_gap' bytes (see RFC 7233). The order of the ranges is kept.
+	static QList<ByteRange> coalesceByteRanges(const QList<ByteRange>& ranges, quint64 max_gap);
+
 protected:
 	HttpUtils();
 
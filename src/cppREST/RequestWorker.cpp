@@ -1,439 +1,193 @@
 #include "RequestWorker.h"
-#include <QTemporaryFile>
+#include <QFile>
+#include <QElapsedTimer>
 #include "HttpUtils.h"
 #include "EndpointManager.h"
-#include "RequestParser.h"
+#include "EndpointMetrics.h"
 #include "SessionManager.h"
 
-RequestWorker::RequestWorker(QSslConfiguration ssl_configuration, qintptr socket, RequestWorkerParams params)
-    : QRunnable()
-    , ssl_configuration_(ssl_configuration)
-	, socket_(socket)
-    , params_(params)
-	, is_terminated_(false)
+RequestWorker::RequestWorker(const HttpRequest& request)
+	: QObject()
+	, QRunnable()
+	, request_(request)
 {
 }
 
 void RequestWorker::run()
 {
-	QSharedPointer<QSslSocket> ssl_socket = QSharedPointer<QSslSocket>(new QSslSocket());
-    QTemporaryFile temp_bed_file;
-
-    try
-    {
-        ssl_socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
-        if (!ssl_socket)
-        {
-            Log::error("Could not create a socket: " + ssl_socket->errorString());
-            return;
-        }
-        ssl_socket->setSslConfiguration(ssl_configuration_);
-
-        if (!ssl_socket->setSocketDescriptor(socket_))
-        {
-            Log::error("Could not set a socket descriptor: " + ssl_socket->errorString());
-            return;
-        }
-    }
-    catch (...)
-    {
-        Log::error("Could not configure the socket");
-        return;
-    }
+	QElapsedTimer timer;
+	timer.start();
 
+	QString requester_info;
+	HttpResponse response;
 	try
 	{
-        ssl_socket->startServerEncryption();
-
-		QByteArray all_request_parts;
-
-		if (!ssl_socket->isOpen())
-		{
-			Log::error("Could not open the socket for data exchange: " + ssl_socket->errorString());
-			return;
-		}
-
-		bool finished_reading_headers = false;
-		bool finished_reading_body = false;
-		qint64 request_headers_size = 0;
-		qint64 request_body_size = 0;
-
-        while (ssl_socket->waitForReadyRead(params_.socket_read_timeout))
-		{
-            ssl_socket->waitForEncrypted(params_.socket_encryption_timeout);
-
-			if (!ssl_socket->isEncrypted() || (ssl_socket->state() == QSslSocket::SocketState::UnconnectedState))
-			{
-				Log::error("Connection cannot be continued: " + ssl_socket->errorString());
-				closeConnection(ssl_socket);
-				return;
-			}
-
-			while(ssl_socket->bytesAvailable())
-			{
-				QByteArray line = ssl_socket->readLine();
-				if ((!finished_reading_headers) && (line.toLower().startsWith("content-length")))
-				{
-					QList<QByteArray> header_parts = line.trimmed().split(':');
-					if (header_parts.size() > 1) request_body_size = header_parts[1].toLongLong();
-				}
-
-				all_request_parts.append(line);
-				if ((line.trimmed().size() == 0) && (!finished_reading_headers))
-				{
-					finished_reading_headers = true;
-					request_headers_size = all_request_parts.size();
-				}
-
-				if ((finished_reading_headers) && ((all_request_parts.size() - request_headers_size) >= request_body_size))
-				{
-					finished_reading_body = true;
-					break;
-				}
-
-			}
+		response = processRequest(requester_info);
+	}
+	catch (...)
+	{
+		QString error_message = "Unexpected error inside the request worker. See logs for more details";
+		Log::error(error_message);
+		response = HttpResponse(ResponseStatus::INTERNAL_SERVER_ERROR, ContentType::TEXT_PLAIN, error_message);
+	}
 
-			if (finished_reading_body) break;
-		}
+	addToMetrics(response, timer.elapsed());
 
-		if (all_request_parts.size() == 0)
-		{
-			sendEntireResponse(ssl_socket, HttpResponse(ResponseStatus::INTERNAL_SERVER_ERROR, ContentType::TEXT_PLAIN, "Request could not be processed"));
-			Log::error("Was not able to read from the socket. Exiting. " + ssl_socket->errorString());
-			return;
-		}
+	emit finished(response, requester_info);
+}
 
-		HttpRequest parsed_request;
-		QSharedPointer<RequestParser> parser = QSharedPointer<RequestParser>(new RequestParser());
-		try
-		{
-			parsed_request = parser->parse(&all_request_parts);
-		}
-		catch (Exception& e)
-		{
-			Log::error("Could not parse the request: " + e.message());
-			sendEntireResponse(ssl_socket, HttpResponse(ResponseStatus::BAD_REQUEST, ContentType::TEXT_HTML, e.message()));
-			return;
-		}
+HttpResponse RequestWorker::processRequest(QString& requester_info)
+{
+	ContentType error_type = HttpUtils::detectErrorContentType(request_.getHeaderByName("User-Agent"));
 
-		ContentType error_type = HttpUtils::detectErrorContentType(parsed_request.getHeaderByName("User-Agent"));
+	// Process the request based on the endpoint info
+	Endpoint current_endpoint = EndpointManager::getEndpointByUrlAndMethod(request_.getPath(), request_.getMethod());
+	if (current_endpoint.action_func == nullptr)
+	{
+		return HttpResponse(ResponseStatus::BAD_REQUEST, error_type, "This action cannot be processed");
+	}
 
-		// Process the request based on the endpoint info
-		Endpoint current_endpoint = EndpointManager::getEndpointByUrlAndMethod(parsed_request.getPath(), parsed_request.getMethod());
-		if (current_endpoint.action_func == nullptr)
-		{
-			sendEntireResponse(ssl_socket, HttpResponse(ResponseStatus::BAD_REQUEST, error_type, "This action cannot be processed"));
-			return;
-		}
+	try
+	{
+		EndpointManager::validateInputData(&current_endpoint, request_);
+	}
+	catch (ArgumentException& e)
+	{
+		Log::warn(EndpointManager::formatResponseMessage(request_, "Parameter validation has failed: " + e.message()));
+		return HttpResponse(ResponseStatus::BAD_REQUEST, error_type, EndpointManager::formatResponseMessage(request_, e.message()));
+	}
 
-		try
+	QString user_token = EndpointManager::getTokenIfAvailable(request_);
+	QString user_info;
+	if (!user_token.isEmpty())
+	{
+		Session user_session = SessionManager::getSessionBySecureToken(user_token);
+		if (!user_session.isEmpty())
 		{
-			EndpointManager::validateInputData(&current_endpoint, parsed_request);
+			user_info = " - requested by " + user_session.user_login + " (" + user_session.user_name + ")";
 		}
-		catch (ArgumentException& e)
+	}
+	QString client_type = " - Unknown client";
+	QString user_agent = request_.getHeaderByName("User-Agent").join(" ").trimmed().toLower();
+	if (!user_agent.isEmpty())
+	{
+		if (user_agent.contains("igv"))
 		{
-            Log::warn(EndpointManager::formatResponseMessage(parsed_request, "Parameter validation has failed: " + e.message()));
-            sendEntireResponse(ssl_socket, HttpResponse(ResponseStatus::BAD_REQUEST, error_type, EndpointManager::formatResponseMessage(parsed_request, e.message())));
-			return;
+			client_type = " - IGV";
 		}
-
-		QString user_token = EndpointManager::getTokenIfAvailable(parsed_request);
-		QString user_info;
-		if (!user_token.isEmpty())
+		else if (user_agent.contains("gsvar") || user_agent.contains("qt"))
 		{
-			Session user_session = SessionManager::getSessionBySecureToken(user_token);
-			if (!user_session.isEmpty())
-            {
-                user_info = " - requested by " + user_session.user_login + " (" + user_session.user_name + ")";
-			}
+			client_type = " - GSvar";
 		}
-		QString client_type = " - Unknown client";
-		QString user_agent = parsed_request.getHeaderByName("User-Agent").join(" ").trimmed().toLower();
-		if (!user_agent.isEmpty())
+		else
 		{
-			if (user_agent.contains("igv"))
-			{
-				client_type = " - IGV";
-			}
-			else if (user_agent.contains("gsvar") || user_agent.contains("qt"))
-			{
-				client_type = " - GSvar";
-			}
-			else
-			{
-				client_type = " - Browser";
-			}
+			client_type = " - Browser";
 		}
+	}
+	requester_info = user_info + client_type;
 
-		if (current_endpoint.authentication_type != AuthType::NONE)
-		{
-			HttpResponse auth_response;
-
-			if (current_endpoint.authentication_type == AuthType::HTTP_BASIC_AUTH) auth_response = EndpointManager::getBasicHttpAuthStatus(parsed_request);
-			if (current_endpoint.authentication_type == AuthType::USER_TOKEN) auth_response = EndpointManager::getUserTokenAuthStatus(parsed_request);
-			if (current_endpoint.authentication_type == AuthType::DB_TOKEN) auth_response = EndpointManager::getDbTokenAuthStatus(parsed_request);
-
-			if (auth_response.getStatus() != ResponseStatus::OK)
-            {
-                Log::error(EndpointManager::formatResponseMessage(parsed_request, "Token check failed: response code " + QString::number(HttpUtils::convertResponseStatusToStatusCodeNumber(auth_response.getStatus())) + user_info + client_type));
-				sendEntireResponse(ssl_socket, auth_response);
-				return;
-			}
-		}
+	if (current_endpoint.authentication_type != AuthType::NONE)
+	{
+		HttpResponse auth_response;
 
-		HttpResponse (*endpoint_action_)(const HttpRequest& request) = current_endpoint.action_func;
-		HttpResponse response;
+		if (current_endpoint.authentication_type == AuthType::HTTP_BASIC_AUTH) auth_response = EndpointManager::getBasicHttpAuthStatus(request_);
+		if (current_endpoint.authentication_type == AuthType::USER_TOKEN) auth_response = EndpointManager::getUserTokenAuthStatus(request_);
+		if (current_endpoint.authentication_type == AuthType::DB_TOKEN) auth_response = EndpointManager::getDbTokenAuthStatus(request_);
 
-		try
+		if (auth_response.getStatus() != ResponseStatus::OK)
 		{
-			response = (*endpoint_action_)(parsed_request);
-		}
-		catch (Exception& e)
-        {
-            Log::error(EndpointManager::formatResponseMessage(parsed_request, "Error while executing an action: " + e.message()));
-            sendEntireResponse(ssl_socket, HttpResponse(ResponseStatus::INTERNAL_SERVER_ERROR, error_type, EndpointManager::formatResponseMessage(parsed_request, "Could not process endpoint action: " + e.message())));
-			return;
+			Log::error(EndpointManager::formatResponseMessage(request_, "Token check failed: response code " + QString::number(HttpUtils::convertResponseStatusToStatusCodeNumber(auth_response.getStatus())) + requester_info));
+			return auth_response;
 		}
+	}
 
-        Log::info(EndpointManager::formatResponseMessage(parsed_request, current_endpoint.comment + user_info + client_type));
-
-        if (response.isStream())
-        {
-            if (!response.getPayload().isEmpty())
-            {
-                QSharedPointer<QFile> roi_file;
-                if (temp_bed_file.open())
-                {
-                    Log::info("Temporary ROI file: " + temp_bed_file.fileName());
-                    response.setFilename(temp_bed_file.fileName());
-                    roi_file = Helper::openFileForWriting(response.getFilename());
-                    roi_file.data()->write(response.getPayload());
-                }
-            }
-
-            Log::info(EndpointManager::formatResponseMessage(parsed_request, "Initiating a stream: " + response.getFilename() + user_info + client_type));
-
-            if (response.getFilename().isEmpty())
-            {
-                QString error_message = EndpointManager::formatResponseMessage(parsed_request, "Streaming request contains an empty file name");
-				Log::error(error_message + user_info + client_type);
-				sendEntireResponse(ssl_socket, HttpResponse(ResponseStatus::NOT_FOUND, error_type, error_message));
-				return;
-			}
-
-			QSharedPointer<QFile> streamed_file = QSharedPointer<QFile>(new QFile(response.getFilename()));
-            if (!streamed_file->exists())
-            {
-                QString error_message = EndpointManager::formatResponseMessage(parsed_request, "Requested file does not exist: " + response.getFilename());
-				Log::error(error_message + user_info + client_type);
-				sendEntireResponse(ssl_socket, HttpResponse(ResponseStatus::NOT_FOUND, error_type, error_message));
-				return;
-			}
-
-            if (!streamed_file->open(QFile::ReadOnly))
-            {
-                QString error_message = EndpointManager::formatResponseMessage(parsed_request, "Could not open a file for streaming: " + response.getFilename());
-				Log::error(error_message + user_info + client_type);
-				sendEntireResponse(ssl_socket, HttpResponse(ResponseStatus::INTERNAL_SERVER_ERROR, error_type, error_message));
-				return;
-			}
-
-            if (!streamed_file->isOpen())
-            {
-                QString error_message = EndpointManager::formatResponseMessage(parsed_request, "File is not open: " + response.getFilename());
-				Log::error(error_message + user_info + client_type);
-				sendEntireResponse(ssl_socket, HttpResponse(ResponseStatus::INTERNAL_SERVER_ERROR, error_type, error_message));
-				return;
-			}
-
-			sendResponseDataPart(ssl_socket, response.getStatusLine());
-			sendResponseDataPart(ssl_socket, response.getHeaders());
-
-			quint64 pos = 0;
-            quint64 file_size = streamed_file->size();
-			bool transfer_encoding_chunked = false;
-
-			if (!parsed_request.getHeaderByName("Transfer-Encoding").isEmpty())
-			{
-				if (parsed_request.getHeaderByName("Transfer-Encoding")[0].toLower() == "chunked")
-				{
-					transfer_encoding_chunked = true;
-				}
-			}
-
-			long chunk_size = STREAM_CHUNK_SIZE;
-			QByteArray data;
-			QList<ByteRange> ranges = response.getByteRanges();
-			int ranges_count = ranges.count();
-
-            if (ranges_count>0)
-            {
-                Log::info(EndpointManager::formatResponseMessage(parsed_request, QString::number(ranges_count) + " range(-s) found in request headers: " + response.getFilename() + user_info + client_type));
-            }
-
-            // Range request
-			for (int i = 0; i < ranges_count; ++i)
-            {
-                Log::info(EndpointManager::formatResponseMessage(parsed_request, "Byte range [" + QString::number(ranges[i].start) + ", " + QString::number(ranges[i].end) + "] from " + QString::number(file_size) + " bytes in total: " + response.getFilename() + user_info + client_type));
-                chunk_size = STREAM_CHUNK_SIZE;
-				pos = ranges[i].start;
-				if (ranges_count > 1)
-				{
-					sendResponseDataPart(ssl_socket, "--"+response.getBoundary()+"\r\n");
-					sendResponseDataPart(ssl_socket, "Content-Type: application/octet-stream\r\n");
-					sendResponseDataPart(ssl_socket, "Content-Range: bytes " + QByteArray::number(ranges[i].start) + "-" + QByteArray::number(ranges[i].end) + "/" + QByteArray::number(file_size) + "\r\n");
-					sendResponseDataPart(ssl_socket, "\r\n");
-				}
-				while(pos<(ranges[i].end+1))
-				{
-					if ((is_terminated_) || (ssl_socket->state() == QSslSocket::SocketState::UnconnectedState) || (ssl_socket->state() == QSslSocket::SocketState::ClosingState))
-                    {
-                        Log::info(EndpointManager::formatResponseMessage(parsed_request, "Range streaming request process has been terminated: " + response.getFilename() + user_info + client_type));
-                        streamed_file->close();
-						return;
-					}
-
-					if (pos >= (file_size-1)) break;
-                    streamed_file->seek(pos);
+	HttpResponse (*endpoint_action_)(const HttpRequest& request) = current_endpoint.action_func;
+	HttpResponse response;
 
-					if ((pos+chunk_size)>(ranges[i].end+1))
-					{
-						chunk_size = ranges[i].end - pos + 1;
-					}
+	try
+	{
+		response = (*endpoint_action_)(request_);
+	}
+	catch (Exception& e)
+	{
+		Log::error(EndpointManager::formatResponseMessage(request_, "Error while executing an action: " + e.message()));
+		return HttpResponse(ResponseStatus::INTERNAL_SERVER_ERROR, error_type, EndpointManager::formatResponseMessage(request_, "Could not process endpoint action: " + e.message()));
+	}
 
-					if (chunk_size <= 0) break;
-                    data = streamed_file->read(chunk_size);
-					sendResponseDataPart(ssl_socket, data);
-					pos = pos + data.size();
-				}
-				if (is_terminated_) return;
-				if (ranges_count > 1) sendResponseDataPart(ssl_socket, "\r\n");
-				if ((i == (ranges_count-1)) && (ranges_count > 1))
-				{
-					sendResponseDataPart(ssl_socket, "--" + response.getBoundary() + "--\r\n");
-				}
+	Log::info(EndpointManager::formatResponseMessage(request_, current_endpoint.comment + requester_info));
 
-			}
+	postProcessResponse(response);
 
-			// Regular stream
-			if (ranges_count == 0)
-			{
-                while(!streamed_file->atEnd())
-				{
-					if ((pos > file_size) || (is_terminated_) || (ssl_socket->state() == QSslSocket::SocketState::UnconnectedState) || (ssl_socket->state() == QSslSocket::SocketState::ClosingState))
-                    {
-                        Log::info(EndpointManager::formatResponseMessage(parsed_request, "Streaming request process has been terminated: " + response.getFilename() + user_info + client_type));
-                        streamed_file->close();
-						return;
-					}
+	return response;
+}
 
-                    streamed_file->seek(pos);
-                    data = streamed_file->read(chunk_size);
-					pos = pos + chunk_size;
+void RequestWorker::addToMetrics(const HttpResponse& response, qint64 time_ms)
+{
+	// requests to unknown URLs are not recorded (the number of different URLs is not limited)
+	Endpoint endpoint = EndpointManager::getEndpointByUrlAndMethod(request_.getPath(), request_.getMethod());
+	if (endpoint.action_func == nullptr) return;
 
-					if (transfer_encoding_chunked)
-					{
-						// Should be used for chunked transfer (without content-lenght)
-						sendResponseDataPart(ssl_socket, intToHex(data.size()).toUtf8()+"\r\n");
-						sendResponseDataPart(ssl_socket, data.append("\r\n"));
-					}
-					else
-					{
-						// Keep connection alive and add data incrementally in parts (content-lenght is specified)
-						sendResponseDataPart(ssl_socket, data);
-					}
-				}
-			}
+	// streamed files are sent afterwards by the connection, their size is taken from the headers
+	qint64 bytes_out = response.getPayload().size();
+	if (response.isStream()) bytes_out = response.getHeaderValue("Content-Length").toLongLong();
 
-            streamed_file->close();
+	EndpointMetrics::addRequest(endpoint.url, endpoint.method, response.getStatusCode(), request_.getBody().size(), bytes_out, time_ms);
+}
 
-			// Should be used for chunked transfer (without content-lenght)
-			if (transfer_encoding_chunked)
-			{
-				sendResponseDataPart(ssl_socket, "0\r\n");
-				sendResponseDataPart(ssl_socket, "\r\n");
-			}
+void RequestWorker::postProcessResponse(HttpResponse& response)
+{
+	if (response.isStream())
+	{
+		// Streams with payload (e.g. calculated regions) are sent like regular responses
+		if (!response.getPayload().isEmpty()) response.setIsStream(false);
+		return;
+	}
 
-			closeConnection(ssl_socket);
-			return;
-		}
-		else if (!response.getPayload().isNull())
+	// Regular responses are validated by their content and compressed, if the client supports it
+	if ((request_.getMethod() == RequestMethod::GET) && (response.getStatus() == ResponseStatus::OK) && (!response.getPayload().isEmpty()))
+	{
+		QByteArray etag = response.getHeaderValue("ETag");
+		if (etag.isEmpty())
 		{
-			sendEntireResponse(ssl_socket, response);
-			return;
+			etag = HttpUtils::createEtag(response.getPayload());
+			response.insertHeader("ETag", etag);
+			response.insertHeader("Cache-Control", "no-cache");
 		}
-		// Returns headers with file size without fetching the file itself
-		else if (parsed_request.getMethod() == RequestMethod::HEAD)
+
+		// the compressed representation has its own entity tag (the client validates the representation it received)
+		bool compress = false;
+		if ((response.getPayload().size() >= MIN_COMPRESSION_SIZE) && (response.getHeaderValue("Content-Encoding").isEmpty()) && HttpUtils::acceptsGzip(request_.getHeaderByName("Accept-Encoding")))
 		{
-			sendEntireResponse(ssl_socket, response);
-			return;
+			ContentType content_type = HttpUtils::getContentTypeFromString(QString(response.getHeaderValue("Content-Type")).split(";").first().trimmed());
+			compress = HttpUtils::isCompressible(content_type);
 		}
-		else if ((response.getPayload().isNull()) && (parsed_request.getHeaders().contains("range")))
+		if (compress) etag = HttpUtils::createGzipEtag(etag);
+
+		if (HttpUtils::isNotModified(request_.getHeaderByName("If-None-Match"), QList<QString>(), etag, QDateTime()))
 		{
-			// Fetching non-existing range (e.g. larger than the file itself)
 			BasicResponseData response_data;
-			response_data.filename = response.getFilename();
-			response_data.file_size = QFile(response.getFilename()).size();
-			response.setStatus(ResponseStatus::RANGE_NOT_SATISFIABLE);
-			response.setRangeNotSatisfiableHeaders(response_data);
-			sendEntireResponse(ssl_socket, response);
-			return;
+			response_data.status = ResponseStatus::NOT_MODIFIED;
+			response_data.etag = etag;
+			response = HttpResponse(response_data);
 		}
-		else if (response.getPayload().isNull())
-        {
-            // send empty response
-            Log::warn("Sending an empty response: " + QString::number(response.getStatusCode()) + user_info + client_type);
-            sendEntireResponse(ssl_socket, response);
-            return;
+		else if (compress)
+		{
+			response.compressPayload();
 		}
-
-        QString error_message = EndpointManager::formatResponseMessage(parsed_request, "The requested resource does not exist: " + parsed_request.getPath() + ". Check the URL and try again");
-		Log::error(error_message + user_info + client_type);
-		sendEntireResponse(ssl_socket, HttpResponse(ResponseStatus::NOT_FOUND, error_type, error_message));
-	}
-	catch (...)
-    {
-        QString error_message = "Unexpected error inside the request worker. See logs for more details";
-		Log::error(error_message);
-		sendEntireResponse(ssl_socket, HttpResponse(ResponseStatus::INTERNAL_SERVER_ERROR, ContentType::TEXT_PLAIN, error_message));
-	}
-}
-
-QString RequestWorker::intToHex(int input)
-{
-	return QString("%1").arg(input, 10, 16, QLatin1Char('0')).toUpper();
-}
-
-void RequestWorker::closeConnection(QSharedPointer<QSslSocket> socket)
-{
-	is_terminated_ = true;
-
-    if ((socket->state() == QSslSocket::SocketState::UnconnectedState) || (socket->state() == QSslSocket::SocketState::ClosingState))
-    {
-        return;
+		return;
 	}
 
-    if (socket->bytesToWrite()) socket->waitForBytesWritten(params_.socket_write_timeout); //5000
-    socket->abort();
-}
-
-void RequestWorker::sendResponseDataPart(QSharedPointer<QSslSocket> socket, const QByteArray& data)
-{
-	if (socket->state() != QSslSocket::SocketState::UnconnectedState)
+	// Fetching non-existing range (e.g. larger than the file itself)
+	if ((response.getPayload().isNull()) && (request_.getMethod() != RequestMethod::HEAD) && (response.getStatus() != ResponseStatus::NOT_MODIFIED) && (request_.getHeaders().contains("range")))
 	{
-		socket->write(data, data.size());
-        if (socket->bytesToWrite()) socket->waitForBytesWritten(params_.socket_write_timeout);
+		BasicResponseData response_data;
+		response_data.filename = response.getFilename();
+		response_data.file_size = QFile(response.getFilename()).size();
+		response.setStatus(ResponseStatus::RANGE_NOT_SATISFIABLE);
+		response.setRangeNotSatisfiableHeaders(response_data);
 	}
-}
-
-void RequestWorker::sendEntireResponse(QSharedPointer<QSslSocket> socket, const HttpResponse& response)
-{
-	if (response.getStatusCode() > 200) Log::warn("The server returned " + QString::number(response.getStatusCode()) + " - " + HttpUtils::convertResponseStatusToReasonPhrase(response.getStatus()));
-	if (socket->state() != QSslSocket::SocketState::UnconnectedState)
+	else if ((response.getPayload().isNull()) && (request_.getMethod() != RequestMethod::HEAD) && (response.getStatus() != ResponseStatus::NOT_MODIFIED))
 	{
-		socket->write(response.getStatusLine());
-		socket->write(response.getHeaders());
-		socket->write(response.getPayload());
+		Log::warn("Sending an empty response: " + QString::number(response.getStatusCode()));
 	}
-	closeConnection(socket);
 }
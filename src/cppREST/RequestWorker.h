@@ -2,32 +2,36 @@
 #define REQUESTWORKER_H
 
 #include "cppREST_global.h"
+#include <QObject>
 #include <QRunnable>
-#include <QSslSocket>
-#include <QSslConfiguration>
 #include "ServerHelper.h"
+#include "HttpRequest.h"
 #include "HttpResponse.h"
 
+///Executes the endpoint action of a parsed request in the thread pool of the server.
+///Reading requests from and writing responses to the socket is done asynchronously by the ClientConnection the request belongs to.
 class CPPRESTSHARED_EXPORT RequestWorker
-	: public QRunnable
+	: public QObject
+	, public QRunnable
 {
+	Q_OBJECT
 
 public:
-	explicit RequestWorker(QSslConfiguration ssl_configuration, qintptr socket, RequestWorkerParams params);
+	explicit RequestWorker(const HttpRequest& request);
 	void run() override;
 
+signals:
+	///Emitted from the worker thread when the response has been created. 'requester_info' describes the user and client for log messages.
+	void finished(HttpResponse response, QString requester_info);
+
 private:
-	const int STREAM_CHUNK_SIZE = 1024*10;
-	QString intToHex(int input);
+	const int MIN_COMPRESSION_SIZE = 1024; // smaller payloads are not compressed
 
-	void closeConnection(QSharedPointer<QSslSocket> socket);
-	void sendResponseDataPart(QSharedPointer<QSslSocket> socket, const QByteArray& data);
-	void sendEntireResponse(QSharedPointer<QSslSocket>, const HttpResponse& response);
+	HttpResponse processRequest(QString& requester_info);
+	void postProcessResponse(HttpResponse& response);
+	void addToMetrics(const HttpResponse& response, qint64 time_ms);
 
-	QSslConfiguration ssl_configuration_;
-	qintptr socket_;
-	RequestWorkerParams params_;
-	bool is_terminated_;
+	HttpRequest request_;
 };
 
 #endif // REQUESTWORKER_H
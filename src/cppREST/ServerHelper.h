@@ -12,6 +12,9 @@ struct CPPRESTSHARED_EXPORT RequestWorkerParams
     int socket_read_timeout;
     int socket_encryption_timeout;
     int socket_write_timeout;
+    int keep_alive_timeout; // idle time after which a persistent connection is closed
+    int max_pipelined_requests; // maximum number of requests of a connection that are queued for processing
+    qint64 max_request_body_size; // maximum body size of a request (bytes), larger requests are rejected with 413
 };
 
 class CPPRESTSHARED_EXPORT ServerHelper
@@ -6,6 +6,7 @@ SslServer::SslServer(QObject *parent)
 	, thread_pool_()
 	, email_already_sent_(false)
 	, thread_pool_check_count_(0)
+	, open_connections_(0)
 	, monitor_timer_()
 	, reset_email_already_sent_flag_timer_()
 {
@@ -43,6 +44,23 @@ SslServer::SslServer(QObject *parent)
 		Log::error("Socket encryption timeout is not set or equals to zero");
 		exit(1);
 	}
+	// Optional settings of persistent connections
+	worker_params_.keep_alive_timeout = Settings::contains("keep_alive_timeout") ? Settings::integer("keep_alive_timeout")*1000 : worker_params_.socket_read_timeout;
+	worker_params_.max_pipelined_requests = Settings::contains("max_pipelined_requests") ? Settings::integer("max_pipelined_requests") : 16;
+	if ((worker_params_.keep_alive_timeout <= 0) || (worker_params_.max_pipelined_requests <= 0))
+	{
+		Log::error("Keep-alive timeout and max number of pipelined requests have to be greater than zero");
+		exit(1);
+	}
+	worker_params_.max_request_body_size = (Settings::contains("max_request_body_size") ? Settings::integer("max_request_body_size") : 1024) * 1024ll * 1024ll;
+	if (worker_params_.max_request_body_size <= 0)
+	{
+		Log::error("Maximum request body size has to be greater than zero");
+		exit(1);
+	}
+
+	// Responses are passed from the worker threads to the connections via queued signals
+	qRegisterMetaType<HttpResponse>("HttpResponse");
 
 	// Timers to handle the situation when the thread pool runs out of available threads
 	// and it is continuing for at least 30 seconds, which prevents the server from accepting
@@ -134,12 +152,24 @@ void SslServer::incomingConnection(qintptr socket)
 {
     try
     {
-        RequestWorker *request_worker = new RequestWorker(current_ssl_configuration_, socket, worker_params_);
-        thread_pool_.start(request_worker);
+        // The connection is handled asynchronously in this thread. Only the endpoint actions of its requests are executed in the thread pool
+        ClientConnection* connection = new ClientConnection(current_ssl_configuration_, worker_params_, &thread_pool_, this);
+        if (!connection->start(socket))
+        {
+            delete connection;
+            return;
+        }
+        connect(connection, SIGNAL(closed()), this, SLOT(connectionClosed()));
+        ++open_connections_;
     }
     catch (...)
     {
         Log::error("Unexpected error while processing a client request");
     }
-    Log::info("Number of active threads: " + QString::number(thread_pool_.activeThreadCount()) + ", thread pool size: " + QString::number(thread_pool_.maxThreadCount()));
+    Log::info("Number of open connections: " + QString::number(open_connections_) + ", number of active threads: " + QString::number(thread_pool_.activeThreadCount()) + ", thread pool size: " + QString::number(thread_pool_.maxThreadCount()));
+}
+
+void SslServer::connectionClosed()
+{
+    --open_connections_;
 }
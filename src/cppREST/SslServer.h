@@ -9,7 +9,7 @@
 #include <QList>
 #include <QThreadPool>
 #include <QTimer>
-#include "RequestWorker.h"
+#include "ClientConnection.h"
 
 class CPPRESTSHARED_EXPORT SslServer : public QTcpServer
 {
@@ -31,6 +31,7 @@ Q_SIGNALS:
 private slots:
 	void resetEmailAlreadySentFlag();
 	void checkPoolStatus();
+	void connectionClosed();
 
 protected:
 	virtual void incomingConnection(qintptr socket);
@@ -42,6 +43,7 @@ private:
 	RequestWorkerParams worker_params_;
 	bool email_already_sent_;
 	int thread_pool_check_count_;
+	int open_connections_;
 	QTimer monitor_timer_;
 	QTimer reset_email_already_sent_flag_timer_;
 };
@@ -37,9 +37,12 @@ unix: QMAKE_CXXFLAGS += $$system(pkg-config --cflags libxml-2.0)
 unix: LIBS += -lxml2
 
 SOURCES += \   
+    ClientConnection.cpp \
     EndpointManager.cpp \
+    EndpointMetrics.cpp \
     FastFileInfo.cpp \
     FileMetaCache.cpp \
+    GzipCompressor.cpp \
     HtmlEngine.cpp \
     HttpUtils.cpp \
     HttpRequest.cpp \
@@ -55,9 +58,12 @@ SOURCES += \
     UrlManager.cpp
 
 HEADERS += \   
+    ClientConnection.h \
     EndpointManager.h \
+    EndpointMetrics.h \
     FastFileInfo.h \
     FileMetaCache.h \
+    GzipCompressor.h \
     HtmlEngine.h \
     HttpParts.h \
     HttpUtils.h \
@@ -1,5 +1,24 @@
 #include "TestFramework.h"
+#include "BamReader.h"
 
+//Returns the alignments of a BAM file as sorted lines (the order of alignments is not relevant)
+QStringList bamAlignments(QString bam)
+{
+	QStringList output;
+
+	BamReader reader(bam);
+	BamAlignment al;
+	while(reader.getNextAlignment(al))
+	{
+		QStringList parts;
+		parts << al.name() << (al.isRead1() ? "R1" : "R2") << QString::number(al.chromosomeID()) << QString::number(al.start()) << al.cigarDataAsString() << QString::number(al.mappingQuality());
+		parts << QString::number(al.mateStart()) << QString::number(al.insertSize()) << al.bases() << al.qualities() << (al.containsTags() ? al.tag("BS") : "");
+		output << parts.join("\t");
+	}
+
+	output.sort();
+	return output;
+}
 
 TEST_CLASS(BamClipOverlap_Test)
 {
@@ -75,6 +94,42 @@ private:
 		COMPARE_FILES(lastLogFile(), TESTDATA("data_out/BamClipOverlap_out10.log"));
 	}
 
+	TEST_METHOD(multiple_threads)
+	{
+		EXECUTE("BamClipOverlap", "-in " + TESTDATA("data_in/BamClipOverlap_in1.bam") + " -out out/BamClipOverlap_out7.bam -v -threads 2");
+		IS_TRUE(QFile::exists("out/BamClipOverlap_out7.bam"));
+		COMPARE_FILES(lastLogFile(), TESTDATA("data_out/BamClipOverlap_out1.log"));
+
+		//several chromosomes: same output as single-threaded
+		EXECUTE("BamClipOverlap", "-in " + TESTDATA("data_in/BamClipOverlap_in4.bam") + " -out out/BamClipOverlap_out9.bam");
+		EXECUTE("BamClipOverlap", "-in " + TESTDATA("data_in/BamClipOverlap_in4.bam") + " -out out/BamClipOverlap_out10.bam -threads 3");
+		QStringList expected = bamAlignments("out/BamClipOverlap_out9.bam");
+		QStringList alignments = bamAlignments("out/BamClipOverlap_out10.bam");
+		I_EQUAL(alignments.count(), expected.count());
+		S_EQUAL(alignments.join("\n"), expected.join("\n"));
+	}
+
+	TEST_METHOD(max_cached)
+	{
+		EXECUTE("BamClipOverlap", "-in " + TESTDATA("data_in/BamClipOverlap_in1.bam") + " -out out/BamClipOverlap_out8.bam -max_cached 2");
+		IS_TRUE(QFile::exists("out/BamClipOverlap_out8.bam"));
+		QStringList log = Helper::loadTextFile(lastLogFile(), true, QChar::Null, true);
+		IS_TRUE(log.contains("Softclipped 256 of 322 reads (79.50 %)."));
+		IS_TRUE(log.contains("Softclipped 5418 of 23489 basepairs (23.07 %)."));
+
+		//several chromosomes: same output as without caching limit (single- and multi-threaded)
+		EXECUTE("BamClipOverlap", "-in " + TESTDATA("data_in/BamClipOverlap_in4.bam") + " -out out/BamClipOverlap_out11.bam");
+		EXECUTE("BamClipOverlap", "-in " + TESTDATA("data_in/BamClipOverlap_in4.bam") + " -out out/BamClipOverlap_out12.bam -max_cached 10");
+		EXECUTE("BamClipOverlap", "-in " + TESTDATA("data_in/BamClipOverlap_in4.bam") + " -out out/BamClipOverlap_out13.bam -max_cached 10 -threads 2");
+		QStringList expected = bamAlignments("out/BamClipOverlap_out11.bam");
+		QStringList alignments = bamAlignments("out/BamClipOverlap_out12.bam");
+		I_EQUAL(alignments.count(), expected.count());
+		S_EQUAL(alignments.join("\n"), expected.join("\n"));
+		alignments = bamAlignments("out/BamClipOverlap_out13.bam");
+		I_EQUAL(alignments.count(), expected.count());
+		S_EQUAL(alignments.join("\n"), expected.join("\n"));
+	}
+
 	TEST_METHOD(cigar_with_only_insertion)
 	{
 		EXECUTE("BamClipOverlap", "-in " + TESTDATA("../cppNGS-TEST/data_in/BamReader_insert_only.bam") + " -out out/BamClipOverlap_out6.bam -v");
@@ -0,0 +1,42 @@
+#include "TestFramework.h"
+
+TEST_CLASS(BamDepthIndex_Test)
+{
+private:
+
+	TEST_METHOD(default_parameters)
+	{
+		EXECUTE("BamDepthIndex", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bam") + " -out out/BamDepthIndex_out1.depth");
+
+		//average coverage
+		EXECUTE("BedCoverage", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -bam " + TESTDATA("../cppNGS-TEST/data_in/panel.bam") + " -depth_index out/BamDepthIndex_out1.depth -out out/BamDepthIndex_out1.tsv");
+		COMPARE_FILES_DELTA("out/BamDepthIndex_out1.tsv", TESTDATA("data_out/BedCoverage_test01_out.tsv"), 1.0, true, '\t'); //delta because of macOS rounding problem
+
+		//low/high coverage
+		EXECUTE("BedLowCoverage", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -bam " + TESTDATA("../cppNGS-TEST/data_in/panel.bam") + " -depth_index out/BamDepthIndex_out1.depth -out out/BamDepthIndex_out1_low.bed -cutoff 20");
+		COMPARE_FILES("out/BamDepthIndex_out1_low.bed", TESTDATA("data_out/BedLowCoverage_test01_out.bed"));
+		EXECUTE("BedHighCoverage", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -bam " + TESTDATA("../cppNGS-TEST/data_in/panel.bam") + " -depth_index out/BamDepthIndex_out1.depth -out out/BamDepthIndex_out1_high.bed -cutoff 20");
+		COMPARE_FILES("out/BamDepthIndex_out1_high.bed", TESTDATA("data_out/BedHighCoverage_test01_out.bed"));
+	}
+
+	TEST_METHOD(mq20_bq30_multiple_threads)
+	{
+		EXECUTE("BamDepthIndex", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bam") + " -out out/BamDepthIndex_out2.depth -min_mapq 20 -min_baseq 30 -threads 4");
+
+		EXECUTE("BedLowCoverage", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -bam " + TESTDATA("../cppNGS-TEST/data_in/panel.bam") + " -depth_index out/BamDepthIndex_out2.depth -out out/BamDepthIndex_out2_low.bed -cutoff 20 -min_mapq 20 -min_baseq 30");
+		COMPARE_FILES("out/BamDepthIndex_out2_low.bed", TESTDATA("data_out/BedLowCoverage_test03_out.bed"));
+		EXECUTE("BedHighCoverage", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -bam " + TESTDATA("../cppNGS-TEST/data_in/panel.bam") + " -depth_index out/BamDepthIndex_out2.depth -out out/BamDepthIndex_out2_high.bed -cutoff 20 -min_mapq 20 -min_baseq 30");
+		COMPARE_FILES("out/BamDepthIndex_out2_high.bed", TESTDATA("data_out/BedHighCoverage_test03_out.bed"));
+	}
+
+	TEST_METHOD(parameter_mismatch)
+	{
+		EXECUTE("BamDepthIndex", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bam") + " -out out/BamDepthIndex_out3.depth -min_mapq 20");
+
+		//different mapping quality
+		EXECUTE_FAIL("BedCoverage", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -bam " + TESTDATA("../cppNGS-TEST/data_in/panel.bam") + " -depth_index out/BamDepthIndex_out3.depth -out out/BamDepthIndex_out3.tsv");
+
+		//index of a different BAM file
+		EXECUTE_FAIL("BedCoverage", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -bam " + TESTDATA("../cppNGS-TEST/data_in/sry.bam") + " -depth_index out/BamDepthIndex_out3.depth -min_mapq 20 -out out/BamDepthIndex_out3.tsv");
+	}
+};
@@ -0,0 +1,32 @@
+#include "TestFrameworkNGS.h"
+#include "Settings.h"
+
+TEST_CLASS(BamReadNameIndex_Test)
+{
+private:
+	
+	TEST_METHOD(default_parameters)
+	{
+		SKIP_IF_NO_HG38_GENOME();
+
+		EXECUTE("BamReadNameIndex", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bam") + " -out out/BamReadNameIndex_out1.rni");
+
+		EXECUTE("BamExtract", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bam") + " -ids " + TESTDATA("data_in/BamExtract_ids.txt") + " -index out/BamReadNameIndex_out1.rni -out out/BamReadNameIndex_out1.bam");
+		BAM_TO_TEXT("out/BamReadNameIndex_out1.bam", "out/BamReadNameIndex_out1.bam.txt");
+		BAM_TO_TEXT(TESTDATA("data_out/BamExtract_out1.bam"), "out/BamReadNameIndex_out1.expected.txt");
+		COMPARE_FILES("out/BamReadNameIndex_out1.bam.txt", "out/BamReadNameIndex_out1.expected.txt");
+		COMPARE_FILES(lastLogFile(), TESTDATA("data_out/BamReadNameIndex_out1.log"));
+	}
+
+	TEST_METHOD(merge_of_chunks)
+	{
+		EXECUTE("BamReadNameIndex", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bam") + " -out out/BamReadNameIndex_out2a.rni");
+		EXECUTE("BamReadNameIndex", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bam") + " -out out/BamReadNameIndex_out2b.rni -max_entries 100000");
+
+		QFile file_a("out/BamReadNameIndex_out2a.rni");
+		IS_TRUE(file_a.open(QIODevice::ReadOnly));
+		QFile file_b("out/BamReadNameIndex_out2b.rni");
+		IS_TRUE(file_b.open(QIODevice::ReadOnly));
+		IS_TRUE(file_a.readAll()==file_b.readAll());
+	}
+};
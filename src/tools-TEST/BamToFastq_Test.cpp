@@ -1,6 +1,29 @@
 #include "TestFramework.h"
 #include "BamReader.h"
 #include "BamWriter.h"
+#include "FastqFileStream.h"
+
+//Returns the read pairs of paired-end FASTQ files as sorted lines (the order of pairs is not relevant)
+QStringList fastqPairs(QString in1, QString in2)
+{
+	QStringList output;
+
+	FastqFileStream stream1(in1, true);
+	FastqFileStream stream2(in2, true);
+	while(!stream1.atEnd() && !stream2.atEnd())
+	{
+		FastqEntry e1;
+		stream1.readEntry(e1);
+		FastqEntry e2;
+		stream2.readEntry(e2);
+
+		output << QString(e1.header + "\t" + e1.bases + "\t" + e1.qualities + "\t" + e2.header + "\t" + e2.bases + "\t" + e2.qualities);
+	}
+	if(!stream1.atEnd() || !stream2.atEnd()) output << "FASTQ files differ in length";
+
+	output.sort();
+	return output;
+}
 
 TEST_CLASS(BamToFastq_Test)
 {
@@ -38,6 +61,16 @@ private:
 		COMPARE_FILES("out/BamToFastq_out2_fix.fastq.gz", TESTDATA("data_out/BamToFastq_out2.fastq.gz"));
 	}
 
+	TEST_METHOD(test_max_cached) //uses data and results from first test, but caches most reads on disk
+	{
+		EXECUTE("BamToFastq", "-in " + TESTDATA("data_in/BamToFastq_in1.bam") + " -out1 out/BamToFastq_out1_cached.fastq.gz -out2 out/BamToFastq_out2_cached.fastq.gz -write_buffer_size 1 -max_cached 10");
+
+		QStringList expected = fastqPairs(TESTDATA("data_out/BamToFastq_out1.fastq.gz"), TESTDATA("data_out/BamToFastq_out2.fastq.gz"));
+		QStringList pairs = fastqPairs("out/BamToFastq_out1_cached.fastq.gz", "out/BamToFastq_out2_cached.fastq.gz");
+		I_EQUAL(pairs.count(), expected.count());
+		S_EQUAL(pairs.join("\n"), expected.join("\n"));
+	}
+
 	TEST_METHOD(test_remove_duplicates)
 	{
 		EXECUTE("BamToFastq", "-in " + TESTDATA("data_in/BamToFastq_in1.bam") + " -remove_duplicates -out1 out/BamToFastq_out3.fastq.gz -out2 out/BamToFastq_out4.fastq.gz -write_buffer_size 1");
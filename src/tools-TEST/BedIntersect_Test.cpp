@@ -1,4 +1,5 @@
 #include "TestFramework.h"
+#include "BedFile.h"
 
 TEST_CLASS(BedIntersect_Test)
 {
@@ -34,4 +35,43 @@ private:
 		COMPARE_FILES("out/BedIntersect_test03_out.bed", TESTDATA("data_out/BedIntersect_test03_out.bed"));
 	}
 
+	TEST_METHOD(stream_keep_anno_in)
+	{
+		//same lines as in-memory mode (test04), but split regions are not appended at the end
+		EXECUTE("BedIntersect", "-in " + TESTDATA("data_in/BedIntersect_in1.bed") + " -in2 " + TESTDATA("data_in/BedIntersect_in2.bed") + " -out out/BedIntersect_test06_out.bed -annotation in -stream");
+		COMPARE_FILES("out/BedIntersect_test06_out.bed", TESTDATA("data_out/BedIntersect_test06_out.bed"));
+	}
+
+	TEST_METHOD(stream_keep_anno_in2)
+	{
+		EXECUTE("BedIntersect", "-in " + TESTDATA("data_in/BedIntersect_in2.bed") + " -in2 " + TESTDATA("data_in/BedIntersect_in1.bed") + " -out out/BedIntersect_test07_out.bed -annotation in2 -stream");
+		COMPARE_FILES("out/BedIntersect_test07_out.bed", TESTDATA("data_out/BedIntersect_test06_out.bed"));
+	}
+
+	TEST_METHOD(stream_mode_in)
+	{
+		//compare with in-memory mode (the output order is the same)
+		EXECUTE("BedIntersect", "-in " + TESTDATA("data_in/BedIntersect_in1.bed") + " -in2 " + TESTDATA("data_in/BedIntersect_in2.bed") + " -out out/BedIntersect_test08_out.bed -mode in");
+		EXECUTE("BedIntersect", "-in " + TESTDATA("data_in/BedIntersect_in1.bed") + " -in2 " + TESTDATA("data_in/BedIntersect_in2.bed") + " -out out/BedIntersect_test08_out_stream.bed -mode in -stream");
+		COMPARE_FILES("out/BedIntersect_test08_out_stream.bed", "out/BedIntersect_test08_out.bed");
+	}
+
+	TEST_METHOD(stream_back_to_back_regions)
+	{
+		//in2 contains back-to-back regions, but no overlaps, i.e. it is not merged in in-memory mode
+		Helper::storeTextFile("out/BedIntersect_in9.bed", QStringList() << "chr1\t4\t15" << "chr1\t24\t45" << "chr2\t0\t100");
+		Helper::storeTextFile("out/BedIntersect_in9_2.bed", QStringList() << "chr1\t0\t10" << "chr1\t10\t20" << "chr1\t20\t30" << "chr1\t39\t50" << "chr2\t49\t60" << "chr2\t60\t70");
+		EXECUTE("BedIntersect", "-in out/BedIntersect_in9.bed -in2 out/BedIntersect_in9_2.bed -out out/BedIntersect_test09_out.bed");
+		EXECUTE("BedIntersect", "-in out/BedIntersect_in9.bed -in2 out/BedIntersect_in9_2.bed -out out/BedIntersect_test09_out_stream.bed -stream");
+
+		//compare with in-memory mode (split regions are appended at the end in in-memory mode)
+		BedFile expected;
+		expected.load("out/BedIntersect_test09_out.bed");
+		expected.sort();
+		BedFile output;
+		output.load("out/BedIntersect_test09_out_stream.bed");
+		I_EQUAL(output.count(), 6);
+		S_EQUAL(output.toText(), expected.toText());
+	}
+
 };
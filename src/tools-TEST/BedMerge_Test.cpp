@@ -16,4 +16,18 @@ private:
 		COMPARE_FILES("out/BedMerge_test02_out.bed", TESTDATA("data_out/BedMerge_test02_out.bed"));
 	}
 
+	TEST_METHOD(stream)
+	{
+		EXECUTE("BedMerge", "-in " + TESTDATA("data_in/BedMerge_in1.bed") + " -out out/BedMerge_test03_out.bed -stream");
+		COMPARE_FILES("out/BedMerge_test03_out.bed", TESTDATA("data_out/BedMerge_test02_out.bed"));
+	}
+
+	TEST_METHOD(stream_gz)
+	{
+		//bgzipped output is used as input of the second run (merging merged regions does not change them)
+		EXECUTE("BedMerge", "-in " + TESTDATA("data_in/BedMerge_in1.bed") + " -out out/BedMerge_test04_out.bed.gz -stream");
+		EXECUTE("BedMerge", "-in out/BedMerge_test04_out.bed.gz -out out/BedMerge_test04_out.bed -stream");
+		COMPARE_FILES("out/BedMerge_test04_out.bed", TESTDATA("data_out/BedMerge_test02_out.bed"));
+	}
+
 };
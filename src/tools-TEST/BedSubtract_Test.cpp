@@ -15,5 +15,11 @@ private:
 		EXECUTE("BedSubtract", "-in " + TESTDATA("data_in/BedSubtract_in2.bed") + " -in2 " + TESTDATA("data_in/BedSubtract_in1.bed") + " -out out/BedSubtract_test02_out.bed");
 		COMPARE_FILES("out/BedSubtract_test02_out.bed", TESTDATA("data_out/BedSubtract_test02_out.bed"));
 	}
+
+	TEST_METHOD(stream)
+	{
+		EXECUTE("BedSubtract", "-in " + TESTDATA("data_in/BedIntersect_in1.bed") + " -in2 " + TESTDATA("data_in/BedIntersect_in2.bed") + " -out out/BedSubtract_test03_out.bed -stream");
+		COMPARE_FILES("out/BedSubtract_test03_out.bed", TESTDATA("data_out/BedSubtract_test03_out.bed"));
+	}
 	
 };
@@ -12,6 +12,12 @@ private:
         COMPARE_FILES("out/GenePrioritization_out1.tsv", TESTDATA("data_out/GenePrioritization_out1.tsv"));
     }
 
+    TEST_METHOD(test_flooding_threads) //the graph is too small for parallel processing, the parallel code is tested in CompactGraph_Test::multiply_threads
+    {
+		EXECUTE("GenePrioritization", "-in " + TESTDATA("data_in/GenePrioritization_in.tsv") + " -graph " + TESTDATA("data_in/GenePrioritization_graph.tsv") + " -out out/GenePrioritization_out3.tsv -method flooding -threads 4");
+        COMPARE_FILES("out/GenePrioritization_out3.tsv", TESTDATA("data_out/GenePrioritization_out1.tsv"));
+    }
+
 	QMap<QByteArray, double> loadGeneScoreMap(QString filename)
 	{
 		QMap<QByteArray, double> output;
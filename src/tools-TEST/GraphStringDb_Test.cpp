@@ -1,4 +1,5 @@
 #include "TestFramework.h"
+#include "CompactGraph.h"
 
 
 TEST_CLASS(GraphStringDb_Test)
@@ -13,4 +14,23 @@ private:
         COMPARE_FILES("out/GraphStringDb_out.tsv", TESTDATA("data_out/GraphStringDb_out.tsv"));
     }
 
+    TEST_METHOD(create_graph_binary)
+    {
+        EXECUTE("GraphStringDb", "-string " + TESTDATA("data_in/GraphStringDb_in.txt") + " -alias " +
+                TESTDATA("data_in/GraphStringDb_alias.tsv") + " -out out/GraphStringDb_out2.tsv -out_bin out/GraphStringDb_out2.bin");
+        COMPARE_FILES("out/GraphStringDb_out2.tsv", TESTDATA("data_out/GraphStringDb_out.tsv"));
+
+        // binary file contains the same graph as the TSV file
+        CompactGraph graph = CompactGraph::load("out/GraphStringDb_out2.tsv");
+        IS_TRUE(CompactGraph::isBinaryFile("out/GraphStringDb_out2.bin"));
+        CompactGraph graph_bin = CompactGraph::load("out/GraphStringDb_out2.bin");
+        I_EQUAL(graph_bin.nodeCount(), graph.nodeCount());
+        I_EQUAL(graph_bin.edgeCount(), graph.edgeCount());
+        for(int n = 0; n < graph.nodeCount(); n++)
+        {
+            S_EQUAL(graph_bin.name(n), graph.name(n));
+            I_EQUAL(graph_bin.degree(n), graph.degree(n));
+        }
+    }
+
 };
@@ -52,6 +52,40 @@ private:
 	}
 
 
+	TEST_METHOD(test_panel_batch_size)
+	{
+		SKIP_IF_NO_TEST_NGSD();
+
+		//variants and genotypes of the sample (independent of variant IDs)
+		auto detected_variants = [](NGSD& db)
+		{
+			QString ps_id = db.processedSampleId("NA12878_18");
+			return db.getValues("SELECT CONCAT_WS(' ', v.chr, v.start, v.end, v.ref, v.obs, IFNULL(v.gnomad, ''), IFNULL(v.coding, ''), IFNULL(v.cadd, ''), IFNULL(v.spliceai, ''), dv.genotype, dv.mosaic) FROM detected_variant dv, variant v WHERE dv.variant_id=v.id AND dv.processed_sample_id='"+ps_id+"' ORDER BY v.chr, v.start, v.end, v.ref, v.obs");
+		};
+
+		//import without batching
+		NGSD db(true);
+		db.init();
+		db.executeQueriesFromFile(TESTDATA("data_in/NGSDAddVariantsGermline_init.sql"));
+		int variant_count_init = db.getValue("SELECT count(*) FROM variant").toInt();
+		EXECUTE("NGSDAddVariantsGermline", "-test -debug -no_time -batch_size 0 -ps NA12878_18 -var " + TESTDATA("data_in/NGSDAddVariantsGermline_in1.GSvar") + " -cnv " + TESTDATA("data_in/NGSDAddVariantsGermline_in1.tsv"));
+		REMOVE_LINES(lastLogFile(), QRegularExpression("^WARNING: transactions"));
+		REMOVE_LINES(lastLogFile(), QRegularExpression("^filename:"));
+		COMPARE_FILES(lastLogFile(), TESTDATA("data_out/NGSDAddVariantsGermline_out1.log"));
+		QStringList detected_unbatched = detected_variants(db);
+		int variant_count = db.getValue("SELECT count(*) FROM variant").toInt();
+		IS_TRUE(variant_count>variant_count_init);
+
+		//import into a fresh database with small batches (new variants and genotypes are inserted with several statements per chromosome)
+		db.init();
+		db.executeQueriesFromFile(TESTDATA("data_in/NGSDAddVariantsGermline_init.sql"));
+		EXECUTE("NGSDAddVariantsGermline", "-test -debug -no_time -batch_size 3 -ps NA12878_18 -var " + TESTDATA("data_in/NGSDAddVariantsGermline_in1.GSvar") + " -cnv " + TESTDATA("data_in/NGSDAddVariantsGermline_in1.tsv"));
+		QStringList detected_batched = detected_variants(db);
+		I_EQUAL(detected_batched.count(), detected_unbatched.count());
+		IS_TRUE(detected_batched==detected_unbatched);
+		I_EQUAL(db.getValue("SELECT count(*) FROM variant").toInt(), variant_count);
+	}
+
 	TEST_METHOD(test_wes)
 	{
 		SKIP_IF_NO_TEST_NGSD();
@@ -44,6 +44,46 @@ private:
 		COMPARE_FILES("out/NGSDExportAnnotationData_out2.vcf", TESTDATA("data_out/NGSDExportAnnotationData_out.vcf"));
 	}
 
+	TEST_METHOD(test_germline_delta)
+	{
+		SKIP_IF_NO_TEST_NGSD();
+		SKIP_IF_NO_HG38_GENOME();
+
+		//init
+		NGSD db(true);
+		db.init();
+		db.executeQueriesFromFile(TESTDATA("data_in/NGSDExportAnnotationData_init1.sql"));
+
+		//full export with sample states
+		EXECUTE("NGSDExportAnnotationData", "-test -germline out/NGSDExportAnnotationData_out6.vcf -germline_state out/NGSDExportAnnotationData_state6.tsv -threads 2");
+
+		//modify NGSD: new variant, new sample variants, sample/variant/classification changes, removed variant
+		SqlQuery query = db.getQuery();
+		query.exec("INSERT INTO variant (id, chr, start, end, ref, obs, comment, gnomad) VALUES (24, 'chr1', 62247553, 62247553, '-', 'TA', 'new variant', 0.01)");
+		query.exec("INSERT INTO detected_variant (processed_sample_id, variant_id, genotype, mosaic) VALUES (18, 1, 'het', 0), (18, 24, 'hom', 0), (18, 15, 'het', 0)");
+		query.exec("UPDATE variant SET gnomad=0.01 WHERE id=15");
+		query.exec("UPDATE variant SET comment='changed comment' WHERE id=9");
+		query.exec("UPDATE variant_classification SET class='2', comment='benign' WHERE variant_id=8");
+		query.exec("UPDATE sample SET disease_status='Unaffected' WHERE id=9");
+		query.exec("DELETE FROM variant WHERE id=20");
+
+		//delta export
+		EXECUTE("NGSDExportAnnotationData", "-test -germline out/NGSDExportAnnotationData_out7.vcf -germline_previous out/NGSDExportAnnotationData_out6.vcf -germline_previous_state out/NGSDExportAnnotationData_state6.tsv -germline_state out/NGSDExportAnnotationData_state7.tsv -threads 2");
+		EXECUTE("VcfCheck", "-in out/NGSDExportAnnotationData_out7.vcf -out out/NGSDExportAnnotationData_VcfCheck_out7.txt -info");
+
+		//full export for comparison
+		EXECUTE("NGSDExportAnnotationData", "-test -germline out/NGSDExportAnnotationData_out8.vcf -germline_state out/NGSDExportAnnotationData_state8.tsv -threads 2");
+
+		REMOVE_LINES("out/NGSDExportAnnotationData_out7.vcf", QRegularExpression("##fileDate="));
+		REMOVE_LINES("out/NGSDExportAnnotationData_out7.vcf", QRegularExpression("##source=NGSDExportAnnotationData"));
+		REMOVE_LINES("out/NGSDExportAnnotationData_out7.vcf", QRegularExpression("##reference="));
+		REMOVE_LINES("out/NGSDExportAnnotationData_out8.vcf", QRegularExpression("##fileDate="));
+		REMOVE_LINES("out/NGSDExportAnnotationData_out8.vcf", QRegularExpression("##source=NGSDExportAnnotationData"));
+		REMOVE_LINES("out/NGSDExportAnnotationData_out8.vcf", QRegularExpression("##reference="));
+		COMPARE_FILES("out/NGSDExportAnnotationData_out7.vcf", "out/NGSDExportAnnotationData_out8.vcf");
+		COMPARE_FILES("out/NGSDExportAnnotationData_state7.tsv", "out/NGSDExportAnnotationData_state8.tsv");
+	}
+
 	TEST_METHOD(test_somatic_one_thread)
 	{
 		SKIP_IF_NO_TEST_NGSD();
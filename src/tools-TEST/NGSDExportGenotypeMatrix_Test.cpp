@@ -0,0 +1,110 @@
+#include "TestFrameworkNGS.h"
+#include "NGSD.h"
+#include "GenotypeMatrix.h"
+
+TEST_CLASS(NGSDExportGenotypeMatrix_Test)
+{
+private:
+
+	TEST_METHOD(burden_test_with_matrix)
+	{
+		SKIP_IF_NO_TEST_NGSD();
+		SKIP_IF_NO_HG38_GENOME();
+
+		//init
+		NGSD db(true);
+		db.init();
+		db.executeQueriesFromFile(TESTDATA("data_in/NGSDGeneBurdenTest_in.sql"));
+		//import transcripts
+		EXECUTE("NGSDImportEnsembl", "-test -in " + TESTDATA("data_in/NGSDGeneBurdenTest_in.gff3"));
+
+		//export
+		EXECUTE("NGSDExportGenotypeMatrix", "-test -out out/NGSDExportGenotypeMatrix_out1.bin");
+		IS_TRUE(QFile::exists("out/NGSDExportGenotypeMatrix_out1.bin"));
+
+		//burden test results have to be the same as without matrix
+		EXECUTE("NGSDGeneBurdenTest", " -cases " + TESTDATA("data_in/NGSDGeneBurdenTest_in_cases.txt") + " -controls " + TESTDATA("data_in/NGSDGeneBurdenTest_in_controls.txt")
+										  + " -genes " + TESTDATA("data_in/NGSDGeneBurdenTest_in_genes.txt") + " -out out/NGSDExportGenotypeMatrix_out1.tsv -test -genotype_matrix out/NGSDExportGenotypeMatrix_out1.bin");
+		COMPARE_FILES("out/NGSDExportGenotypeMatrix_out1.tsv", TESTDATA("data_out/NGSDGeneBurdenTest_out1.tsv"));
+
+		EXECUTE("NGSDGeneBurdenTest", " -cases " + TESTDATA("data_in/NGSDGeneBurdenTest_in_cases.txt") + " -controls " + TESTDATA("data_in/NGSDGeneBurdenTest_in_controls.txt")
+										  + " -genes " + TESTDATA("data_in/NGSDGeneBurdenTest_in_genes.txt") + " -out out/NGSDExportGenotypeMatrix_out2.tsv -test -inheritance recessive -genotype_matrix out/NGSDExportGenotypeMatrix_out1.bin");
+		COMPARE_FILES("out/NGSDExportGenotypeMatrix_out2.tsv", TESTDATA("data_out/NGSDGeneBurdenTest_out4.tsv"));
+
+		//update without new samples
+		EXECUTE("NGSDExportGenotypeMatrix", "-test -update out/NGSDExportGenotypeMatrix_out1.bin -out out/NGSDExportGenotypeMatrix_out2.bin");
+		IS_TRUE(Helper::loadTextFile(lastLogFile()).contains("Appended samples: 0"));
+
+		EXECUTE("NGSDGeneBurdenTest", " -cases " + TESTDATA("data_in/NGSDGeneBurdenTest_in_cases.txt") + " -controls " + TESTDATA("data_in/NGSDGeneBurdenTest_in_controls.txt")
+										  + " -genes " + TESTDATA("data_in/NGSDGeneBurdenTest_in_genes.txt") + " -out out/NGSDExportGenotypeMatrix_out3.tsv -test -genotype_matrix out/NGSDExportGenotypeMatrix_out2.bin");
+		COMPARE_FILES("out/NGSDExportGenotypeMatrix_out3.tsv", TESTDATA("data_out/NGSDGeneBurdenTest_out1.tsv"));
+	}
+
+	TEST_METHOD(append_samples)
+	{
+		SKIP_IF_NO_TEST_NGSD();
+
+		//init (without sample 200)
+		NGSD db(true);
+		db.init();
+		db.executeQueriesFromFile(TESTDATA("data_in/NGSDGeneBurdenTest_in.sql"));
+		db.getQuery().exec("DELETE FROM detected_variant WHERE processed_sample_id=200");
+
+		//export (variants 1001 and 808 are not contained because their NGSD count is above 16)
+		EXECUTE("NGSDExportGenotypeMatrix", "-test -max_ngsd_count 16 -out out/NGSDExportGenotypeMatrix_out4.bin");
+
+		//import sample 200: the NGSD count of variant 807 rises above the maximum, the count of variant 504 is updated, variant 811 is unchanged and 1001 is not contained
+		db.getQuery().exec("INSERT INTO detected_variant (processed_sample_id, variant_id, genotype) VALUES (200, 1001, 'hom'), (200, 807, 'hom'), (200, 811, 'hom'), (200, 504, 'hom')");
+		db.getQuery().exec("UPDATE variant SET germline_hom=germline_hom+2 WHERE id=807");
+		db.getQuery().exec("UPDATE variant SET germline_hom=germline_hom+1 WHERE id=504");
+
+		//append sample
+		EXECUTE("NGSDExportGenotypeMatrix", "-test -update out/NGSDExportGenotypeMatrix_out4.bin -out out/NGSDExportGenotypeMatrix_out5.bin");
+		IS_TRUE(Helper::loadTextFile(lastLogFile()).contains("Appended samples: 1"));
+
+		//full export
+		EXECUTE("NGSDExportGenotypeMatrix", "-test -max_ngsd_count 16 -out out/NGSDExportGenotypeMatrix_out6.bin");
+
+		//appended matrix has to be the same as the full export
+		GenotypeMatrix appended;
+		appended.load("out/NGSDExportGenotypeMatrix_out5.bin");
+		GenotypeMatrix full;
+		full.load("out/NGSDExportGenotypeMatrix_out6.bin");
+		I_EQUAL(appended.sampleCount(), full.sampleCount());
+		I_EQUAL(appended.variantCount(), full.variantCount());
+		I_EQUAL(appended.entryCount(), full.entryCount());
+		IS_TRUE(appended.containsSample(200));
+
+		BedFile regions;
+		for (int i=1; i<=22; ++i)
+		{
+			regions.append(BedLine("chr" + QByteArray::number(i), 1, 250000000));
+		}
+		QMap<int, Variant> variants = appended.variants(regions, 16, 1.0);
+		QMap<int, Variant> variants_full = full.variants(regions, 16, 1.0);
+		IS_TRUE(variants.keys()==variants_full.keys());
+		IS_FALSE(variants.contains(807));
+		IS_TRUE(variants.contains(504));
+		for (auto it=variants.cbegin(); it!=variants.cend(); ++it)
+		{
+			S_EQUAL(it.value().toString(), variants_full[it.key()].toString());
+			IS_TRUE(it.value().annotations()==variants_full[it.key()].annotations());
+		}
+
+		QSet<int> ps_ids;
+		for (int ps_id=100; ps_id<210; ++ps_id)
+		{
+			ps_ids << ps_id;
+		}
+		QMap<int, QSet<int>> detected = appended.detectedVariants(Helper::listToSet(variants.keys()), ps_ids, true);
+		IS_TRUE(detected==full.detectedVariants(Helper::listToSet(variants.keys()), ps_ids, true));
+		IS_TRUE(detected[200]==(QSet<int>() << 811 << 504));
+		for (auto it=detected.cbegin(); it!=detected.cend(); ++it)
+		{
+			for (int variant_id : it.value())
+			{
+				S_EQUAL(appended.genotype(variant_id, it.key()), full.genotype(variant_id, it.key()));
+			}
+		}
+	}
+};
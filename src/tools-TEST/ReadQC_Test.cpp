@@ -12,6 +12,14 @@ private:
 		COMPARE_FILES("out/ReadQC_out1.qcML", TESTDATA("data_out/ReadQC_out1.qcML"));
 	}
 
+	TEST_METHOD(multiple_threads)
+	{
+		EXECUTE("ReadQC", "-in1 " + TESTDATA("data_in/ReadQC_in1.fastq.gz") + " -in2 " + TESTDATA("data_in/ReadQC_in2.fastq.gz") + " -out out/ReadQC_out8.qcML -threads 3 -block_size 100");
+		REMOVE_LINES("out/ReadQC_out8.qcML", QRegularExpression("creation "));
+		REMOVE_LINES("out/ReadQC_out8.qcML", QRegularExpression("<binary>"));
+		COMPARE_FILES("out/ReadQC_out8.qcML", TESTDATA("data_out/ReadQC_out1.qcML"));
+	}
+
 	TEST_METHOD(with_txt_parameter)
 	{
 		EXECUTE("ReadQC", "-in1 " + TESTDATA("data_in/ReadQC_in1.fastq.gz") + " -in2 " + TESTDATA("data_in/ReadQC_in2.fastq.gz") + " -out out/ReadQC_out2.txt -txt");
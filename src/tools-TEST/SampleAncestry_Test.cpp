@@ -15,5 +15,16 @@ private:
 		EXECUTE("SampleAncestry", "-build hg38 -in " + TESTDATA("../cppNGS-TEST/data_in/ancestry_hg38.vcf.gz") + " -out out/SampleAncestry_out2.tsv");
 		COMPARE_FILES("out/SampleAncestry_out2.tsv", TESTDATA("data_out/SampleAncestry_out2.tsv"));
 	}
+
+	TEST_METHOD(test_multi_sample_and_threads)
+	{
+		//multi-sample VCF with two copies of the sample of test_default
+		EXECUTE("SampleAncestry", "-in " + TESTDATA("data_in/SampleAncestry_in_multi.vcf.gz") + " -build hg19 -out out/SampleAncestry_out3.tsv");
+		COMPARE_FILES("out/SampleAncestry_out3.tsv", TESTDATA("data_out/SampleAncestry_out3.tsv"));
+
+		//several input files processed in parallel
+		EXECUTE("SampleAncestry", "-in " + TESTDATA("../cppNGS-TEST/data_in/ancestry.vcf.gz") + " " + TESTDATA("data_in/SampleAncestry_in_multi.vcf.gz") + " " + TESTDATA("../cppNGS-TEST/data_in/ancestry.vcf.gz") + " -build hg19 -threads 3 -out out/SampleAncestry_out4.tsv");
+		COMPARE_FILES("out/SampleAncestry_out4.tsv", TESTDATA("data_out/SampleAncestry_out4.tsv"));
+	}
 };
 
@@ -11,4 +11,11 @@ private:
 			COMPARE_FILES("out/TrioMaternalContamination_out1.txt", TESTDATA("data_out/TrioMaternalContamination_out1.txt"));
         }
 
+		TEST_METHOD(batch_mode)
+		{
+			//second trio has swapped parents
+			EXECUTE("TrioMaternalContamination", "-trios " + TESTDATA("data_in/TrioMaternalContamination_trios.tsv") + " -threads 2 -build hg19 -out out/TrioMaternalContamination_out2.tsv");
+			COMPARE_FILES("out/TrioMaternalContamination_out2.tsv", TESTDATA("data_out/TrioMaternalContamination_out2.tsv"));
+		}
+
 };
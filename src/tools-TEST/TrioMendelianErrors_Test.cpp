@@ -15,4 +15,11 @@ private:
 		EXECUTE("TrioMendelianErrors", "-vcf " + TESTDATA("data_in/TrioMendelianErrors_in1.vcf.gz") + " -c NA12878x2_80 -f NA12891_14 -m NA12892_18 -min_dp 15 -out out/TrioMendelianErrors_out2.txt");
 		COMPARE_FILES("out/TrioMendelianErrors_out2.txt", TESTDATA("data_out/TrioMendelianErrors_out2.txt"));
 	}
+
+	TEST_METHOD(batch_mode)
+	{
+		//first trio is the trio of 'min_depth', second trio has swapped child/father
+		EXECUTE("TrioMendelianErrors", "-vcf " + TESTDATA("data_in/TrioMendelianErrors_in1.vcf.gz") + " -trios " + TESTDATA("data_in/TrioMendelianErrors_trios.tsv") + " -min_dp 15 -threads 2 -out out/TrioMendelianErrors_out3.tsv");
+		COMPARE_FILES("out/TrioMendelianErrors_out3.tsv", TESTDATA("data_out/TrioMendelianErrors_out3.tsv"));
+	}
 };
@@ -1,4 +1,5 @@
 #include "TestFramework.h"
+#include "Helper.h"
 
 TEST_CLASS(UpdHunter_Test)
 {
@@ -21,4 +22,18 @@ private:
 		EXECUTE("UpdHunter", "-in " + TESTDATA("data_in/UpdHunter_in3.vcf.gz") + " -c CHILD -f FATHER -m MOTHER -out out/UpdHunter_out3.tsv");
 		COMPARE_FILES("out/UpdHunter_out3.tsv", TESTDATA("data_out/UpdHunter_out3.tsv"));
 	}
+
+	TEST_METHOD(batch_mode)
+	{
+		//single run with informative variants
+		EXECUTE("UpdHunter", "-in " + TESTDATA("data_in/UpdHunter_in2.vcf.gz") + " -c CHILD -f FATHER -m MOTHER -out out/UpdHunter_out4.tsv -out_informative out/UpdHunter_out4.igv");
+		COMPARE_FILES("out/UpdHunter_out4.tsv", TESTDATA("data_out/UpdHunter_out2.tsv"));
+
+		//batch mode (output paths are relative to the trios file)
+		Helper::storeTextFile("out/UpdHunter_trios.tsv", QStringList() << "#child\tfather\tmother\tout\tout_informative" << "CHILD\tFATHER\tMOTHER\tUpdHunter_out5.tsv" << "CHILD\tFATHER\tMOTHER\tUpdHunter_out6.tsv\tUpdHunter_out6.igv");
+		EXECUTE("UpdHunter", "-in " + TESTDATA("data_in/UpdHunter_in2.vcf.gz") + " -trios out/UpdHunter_trios.tsv -threads 2");
+		COMPARE_FILES("out/UpdHunter_out5.tsv", TESTDATA("data_out/UpdHunter_out2.tsv"));
+		COMPARE_FILES("out/UpdHunter_out6.tsv", TESTDATA("data_out/UpdHunter_out2.tsv"));
+		COMPARE_FILES("out/UpdHunter_out6.igv", "out/UpdHunter_out4.igv");
+	}
 };
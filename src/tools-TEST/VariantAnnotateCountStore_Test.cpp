@@ -0,0 +1,28 @@
+#include "TestFramework.h"
+
+TEST_CLASS(VariantAnnotateCountStore_Test)
+{
+private:
+	
+	TEST_METHOD(default_parameters)
+	{
+		EXECUTE("VariantCountStoreCreate", "-in " + TESTDATA("data_in/VariantCountStoreCreate_in1.vcf") + " -out out/VariantAnnotateCountStore.vcs");
+
+		EXECUTE("VariantAnnotateCountStore", "-in " + TESTDATA("data_in/VariantAnnotateCountStore_in1.GSvar") + " -store out/VariantAnnotateCountStore.vcs -out out/VariantAnnotateCountStore_out1.GSvar");
+		COMPARE_FILES("out/VariantAnnotateCountStore_out1.GSvar", TESTDATA("data_out/VariantAnnotateCountStore_out1.GSvar"));
+	}
+
+	TEST_METHOD(in_place_with_several_files)
+	{
+		EXECUTE("VariantCountStoreCreate", "-in " + TESTDATA("data_in/VariantCountStoreCreate_in1.vcf") + " -out out/VariantAnnotateCountStore.vcs");
+
+		QFile::remove("out/VariantAnnotateCountStore_out2a.GSvar");
+		QFile::copy(TESTDATA("data_in/VariantAnnotateCountStore_in1.GSvar"), "out/VariantAnnotateCountStore_out2a.GSvar");
+		QFile::remove("out/VariantAnnotateCountStore_out2b.GSvar");
+		QFile::copy(TESTDATA("data_in/VariantAnnotateCountStore_in1.GSvar"), "out/VariantAnnotateCountStore_out2b.GSvar");
+
+		EXECUTE("VariantAnnotateCountStore", "-in out/VariantAnnotateCountStore_out2a.GSvar out/VariantAnnotateCountStore_out2b.GSvar -store out/VariantAnnotateCountStore.vcs -threads 2");
+		COMPARE_FILES("out/VariantAnnotateCountStore_out2a.GSvar", TESTDATA("data_out/VariantAnnotateCountStore_out1.GSvar"));
+		COMPARE_FILES("out/VariantAnnotateCountStore_out2b.GSvar", TESTDATA("data_out/VariantAnnotateCountStore_out1.GSvar"));
+	}
+};
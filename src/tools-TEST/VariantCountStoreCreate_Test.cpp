@@ -0,0 +1,14 @@
+#include "TestFramework.h"
+
+TEST_CLASS(VariantCountStoreCreate_Test)
+{
+private:
+	
+	TEST_METHOD(default_parameters)
+	{
+		EXECUTE("VariantCountStoreCreate", "-in " + TESTDATA("data_in/VariantCountStoreCreate_in1.vcf") + " -out out/VariantCountStoreCreate_out1.vcs");
+
+		EXECUTE("VariantAnnotateCountStore", "-in " + TESTDATA("data_in/VariantAnnotateCountStore_in1.GSvar") + " -store out/VariantCountStoreCreate_out1.vcs -out out/VariantCountStoreCreate_out1.GSvar");
+		COMPARE_FILES("out/VariantCountStoreCreate_out1.GSvar", TESTDATA("data_out/VariantAnnotateCountStore_out1.GSvar"));
+	}
+};
@@ -19,6 +19,27 @@ private:
 		VCF_IS_VALID_HG19("out/VcfAnnotateFromBed_out2.vcf")
 	}
 
+	TEST_METHOD(stream)
+	{
+		EXECUTE("VcfAnnotateFromBed", "-in " + TESTDATA("data_in/VcfAnnotateFromBed_in1.vcf") + " -desc Custom_header_description! -out out/VcfAnnotateFromBed_out3.vcf -name OMIM -bed " + TESTDATA("data_in/VcfAnnotateFromBed_in2.bed") + " -stream -threads 3 -block_size 20" );
+		COMPARE_FILES("out/VcfAnnotateFromBed_out3.vcf", TESTDATA("data_out/VcfAnnotateFromBed_out1.vcf"));
+		VCF_IS_VALID_HG19("out/VcfAnnotateFromBed_out3.vcf")
+	}
+
+	TEST_METHOD(several_bed_files)
+	{
+		EXECUTE("VcfAnnotateFromBed", "-in " + TESTDATA("data_in/VcfAnnotateFromBed_in1.vcf") + " -out out/VcfAnnotateFromBed_out4.vcf -name OMIM,REGION -bed " + TESTDATA("data_in/VcfAnnotateFromBed_in2.bed") + " " + TESTDATA("data_in/VcfAnnotateFromBed_in3.bed.gz"));
+		COMPARE_FILES("out/VcfAnnotateFromBed_out4.vcf", TESTDATA("data_out/VcfAnnotateFromBed_out2.vcf"));
+		VCF_IS_VALID_HG19("out/VcfAnnotateFromBed_out4.vcf")
+	}
+
+	TEST_METHOD(several_bed_files_stream)
+	{
+		EXECUTE("VcfAnnotateFromBed", "-in " + TESTDATA("data_in/VcfAnnotateFromBed_in1.vcf") + " -out out/VcfAnnotateFromBed_out5.vcf -name OMIM,REGION -bed " + TESTDATA("data_in/VcfAnnotateFromBed_in2.bed") + " " + TESTDATA("data_in/VcfAnnotateFromBed_in3.bed.gz") + " -stream -threads 3 -block_size 7");
+		COMPARE_FILES("out/VcfAnnotateFromBed_out5.vcf", TESTDATA("data_out/VcfAnnotateFromBed_out2.vcf"));
+		VCF_IS_VALID_HG19("out/VcfAnnotateFromBed_out5.vcf")
+	}
+
 
 };
 
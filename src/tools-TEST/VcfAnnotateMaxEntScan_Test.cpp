@@ -1,4 +1,6 @@
 #include "TestFrameworkNGS.h"
+#include "Settings.h"
+#include "FastaFileIndex.h"
 
 TEST_CLASS(VcfAnnotateMaxEntScan_Test)
 {
@@ -22,6 +24,51 @@ private:
 		VCF_IS_VALID("out/VcfAnnotateMaxEntScan_out2.vcf");
 	}
 
+	TEST_METHOD(indels_at_donor_sites)
+	{
+		SKIP_IF_NO_HG38_GENOME();
+
+		//create deletions/insertions of different length at the same positions close to donor sites on the plus and minus strand
+		FastaFileIndex reference(Settings::string("reference_genome", true));
+		Chromosome chr("chr2");
+		QStringList lines;
+		lines << "##fileformat=VCFv4.2" << "##reference=GRCh38.fa" << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO";
+		foreach(int pos, QList<int>() << 42656300 << 42656303 << 214769227 << 214769230)
+		{
+			QByteArray base = reference.seq(chr, pos, 1);
+			lines << chr.str() + "\t" + QByteArray::number(pos) + "\t.\t" + base + "\t" + (base=="A" ? "C" : "A") + "\t.\t.\t.";
+			for (int length=2; length<=5; ++length)
+			{
+				lines << chr.str() + "\t" + QByteArray::number(pos) + "\t.\t" + reference.seq(chr, pos, length) + "\t" + base + "\t.\t.\t.";
+				lines << chr.str() + "\t" + QByteArray::number(pos) + "\t.\t" + base + "\t" + base + QByteArray(length-1, 'T') + "\t.\t.\t.";
+			}
+		}
+		Helper::storeTextFile("out/VcfAnnotateMaxEntScan_in3.vcf", lines);
+
+		//cached reference scores must not depend on the other variants of the chunk
+		EXECUTE("VcfAnnotateMaxEntScan", "-in out/VcfAnnotateMaxEntScan_in3.vcf -out out/VcfAnnotateMaxEntScan_out3.vcf -gff " + TESTDATA("data_in/VcfAnnotateMaxEntScan_transcripts.gff3") + " -swa");
+		EXECUTE("VcfAnnotateMaxEntScan", "-in out/VcfAnnotateMaxEntScan_in3.vcf -out out/VcfAnnotateMaxEntScan_out3_single.vcf -gff " + TESTDATA("data_in/VcfAnnotateMaxEntScan_transcripts.gff3") + " -swa -block_size 1");
+		COMPARE_FILES("out/VcfAnnotateMaxEntScan_out3.vcf", "out/VcfAnnotateMaxEntScan_out3_single.vcf");
+		VCF_IS_VALID("out/VcfAnnotateMaxEntScan_out3.vcf");
+
+		//native scores for SNVs only (42656303 and 214769230 are within donor sites), SWA scores for all variants
+		int indels = 0;
+		foreach(QString line, Helper::loadTextFile("out/VcfAnnotateMaxEntScan_out3.vcf", true, '#', true))
+		{
+			QStringList parts = line.split('\t');
+			IS_TRUE(parts[7].contains("MES_SWA="));
+			if (parts[3].length()==1 && parts[4].length()==1)
+			{
+				if (parts[1]=="42656303" || parts[1]=="214769230") IS_TRUE(parts[7].startsWith("MES="));
+			}
+			else
+			{
+				IS_FALSE(parts[7].startsWith("MES="));
+				++indels;
+			}
+		}
+		I_EQUAL(indels, 32);
+	}
 
 	//multi-thread test
 	TEST_METHOD(test_multithread)
@@ -82,4 +82,30 @@ private:
 		COMPARE_FILES("out/VcfCalculatePRS_out8_details.tsv", TESTDATA("data_out/VcfCalculatePRS_out6_details.tsv"));
 	}
 
+	TEST_METHOD(test_sweep)
+	{
+		SKIP_IF_NO_HG38_GENOME();
+
+		EXECUTE("VcfCalculatePRS", "-bam " + TESTDATA("data_in/VcfCalculatePRS_in1.bam") + " -in " + TESTDATA("data_in/VcfCalculatePRS_in1.vcf.gz") + " -prs "
+				+ TESTDATA("data_in/VcfCalculatePRS_prs2.vcf") + " " + TESTDATA("data_in/VcfCalculatePRS_prs3.vcf") + " -out out/VcfCalculatePRS_out9.tsv -details out/VcfCalculatePRS_out9_details.tsv -sweep");
+		COMPARE_FILES("out/VcfCalculatePRS_out9.tsv", TESTDATA("data_out/VcfCalculatePRS_out9.tsv"));
+		COMPARE_FILES("out/VcfCalculatePRS_out9_details.tsv", TESTDATA("data_out/VcfCalculatePRS_out9_details.tsv"));
+	}
+
+	TEST_METHOD(test_sweep_gvcf)
+	{
+		EXECUTE("VcfCalculatePRS", "-in " + TESTDATA("data_in/VcfCalculatePRS_in2.gvcf") + " -prs " + TESTDATA("data_in/VcfCalculatePRS_prs7.vcf") + " -out out/VcfCalculatePRS_out10.tsv -details out/VcfCalculatePRS_out10_details.tsv -sweep -gvcf");
+		COMPARE_FILES("out/VcfCalculatePRS_out10.tsv", TESTDATA("data_out/VcfCalculatePRS_out10.tsv"));
+		COMPARE_FILES("out/VcfCalculatePRS_out10_details.tsv", TESTDATA("data_out/VcfCalculatePRS_out10_details.tsv"));
+	}
+
+	TEST_METHOD(test_multiple_samples)
+	{
+		SKIP_IF_NO_HG38_GENOME();
+
+		EXECUTE("VcfCalculatePRS", "-bam " + TESTDATA("data_in/VcfCalculatePRS_in1.bam") + " " + TESTDATA("data_in/VcfCalculatePRS_in1.bam") + " -in " + TESTDATA("data_in/VcfCalculatePRS_in1.vcf.gz") + " " + TESTDATA("data_in/VcfCalculatePRS_in1.vcf.gz")
+				+ " -prs " + TESTDATA("data_in/VcfCalculatePRS_prs1.vcf") + " " + TESTDATA("data_in/VcfCalculatePRS_prs2.vcf") + " -out out/VcfCalculatePRS_out11.tsv -sweep -threads 2");
+		COMPARE_FILES("out/VcfCalculatePRS_out11.tsv", TESTDATA("data_out/VcfCalculatePRS_out11.tsv"));
+	}
+
 };
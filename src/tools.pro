@@ -17,10 +17,12 @@ tools-TEST.depends = cppNGSD
 TOOLS_NGS = \
 	BamCleanHaloplex \ 
 	BamClipOverlap \ 
+	BamDepthIndex \ 
 	BamDownsample \ 
 	BamExtract \ 
 	BamFilter \ 
 	BamInfo \ 
+	BamReadNameIndex \ 
 	BamRemoveVariants \ 
 	BamToFastq \ 
 	BedAdd \ 
@@ -102,7 +104,9 @@ TOOLS_NGS = \
 	TsvToQC \ 
 	UpdHunter \ 
 	VariantAnnotateASE \ 
+	VariantAnnotateCountStore \ 
 	VariantAnnotateFrequency \ 
+	VariantCountStoreCreate \ 
 	VariantFilterAnnotations \ 
 	VariantFilterRegions \ 
 	VariantQC \ 
@@ -152,6 +156,7 @@ TOOLS_NGSD = \
 	NGSDExportAnnotationData \ 
 	NGSDExportCnvTrack \ 
 	NGSDExportGenes \ 
+	NGSDExportGenotypeMatrix \ 
 	NGSDExportGff \ 
 	NGSDExportIgvGeneTrack \ 
 	NGSDExportSV \ 